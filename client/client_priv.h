@@ -110,6 +110,8 @@ enum options_client
   OPT_SEMISYNC_DEBUG,
   OPT_PRINT_ORDERING_KEY,
   OPT_FLUSH_RESULT_FILE,
+  OPT_COMPRESSION_ALGORITHM,
+  OPT_PRINT_WORKERS,
   OPT_MAX_CLIENT_OPTION,
 };
 
@@ -212,6 +212,7 @@ unsigned short terminal_width= 80;
 static char *shared_memory_base_name=0;
 #endif
 static uint opt_protocol=0;
+static char *opt_compression_algorithm= 0;
 static const CHARSET_INFO *charset_info= &my_charset_latin1;
 
 #include "sslopt-vars.h"
@@ -1565,6 +1566,11 @@ static struct my_option my_long_options[] =
   {"compress", 'C', "Use compression in server/client protocol.",
    &opt_compress, &opt_compress, 0, GET_BOOL, NO_ARG, 0, 0, 0,
    0, 0, 0},
+  {"compression-algorithm", OPT_COMPRESSION_ALGORITHM,
+   "Compression algorithm with --compress: zlib, zstd or lz4. zlib is used "
+   "if the server does not support the algorithm.",
+   &opt_compression_algorithm, &opt_compression_algorithm, 0, GET_STR,
+   REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
 #ifdef DBUG_OFF
   {"debug", '#', "This is a non-debug version. Catch this and exit.",
    0,0, 0, GET_DISABLED, OPT_ARG, 0, 0, 0, 0, 0, 0},
@@ -1873,6 +1879,10 @@ get_one_option(int optid, const struct my_option *opt __attribute__((unused)),
                                     opt->name);
 #endif
     break;
+  case OPT_COMPRESSION_ALGORITHM:
+    find_type_or_exit(argument, &net_compression_algorithm_typelib,
+                      opt->name);
+    break;
   case OPT_SERVER_ARG:
 #ifdef EMBEDDED_LIBRARY
     /*
@@ -4725,6 +4735,9 @@ sql_real_connect(char *host,char *database,char *user,char *password,
     mysql_options(&mysql, MYSQL_OPT_BIND, opt_bind_addr);
   if (opt_compress)
     mysql_options(&mysql,MYSQL_OPT_COMPRESS,NullS);
+  if (opt_compression_algorithm)
+    mysql_options(&mysql, MYSQL_OPT_COMPRESSION_ALGORITHM,
+                  opt_compression_algorithm);
   if (!opt_secure_auth)
     mysql_options(&mysql, MYSQL_SECURE_AUTH, (char *) &opt_secure_auth);
   if (using_opt_local_infile)
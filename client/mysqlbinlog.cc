@@ -38,6 +38,7 @@
 #include <signal.h>
 #include <my_dir.h>
 #include <map>
+#include <vector>
 #include <string>
 using std::map;
 using std::string;
@@ -104,7 +105,7 @@ static const char *load_default_groups[]= { "mysqlbinlog","client",0 };
 static my_bool one_database=0, disable_log_bin= 0;
 static my_bool opt_hexdump= 0;
 const char *base64_output_mode_names[]=
-{"NEVER", "AUTO", "UNSPEC", "DECODE-ROWS", NullS};
+{"NEVER", "AUTO", "UNSPEC", "DECODE-ROWS", "JSON", NullS};
 TYPELIB base64_output_mode_typelib=
   { array_elements(base64_output_mode_names) - 1, "",
     base64_output_mode_names, NULL };
@@ -199,12 +200,15 @@ static bool filter_based_on_gtids= false;
 
 static bool in_transaction= false;
 static bool seen_gtids= false;
+/* The events of a Transaction_payload_log_event are being processed */
+static bool in_trx_payload= false;
 static bool opt_use_semisync = false;
 static uint opt_semisync_debug = 0;
 ReplSemiSyncSlave repl_semisync;
 
 static uint opt_receive_buffer_size = 0;
 static uint opt_flush_result_file = 0;
+static uint opt_print_workers= 0;
 
 static Exit_status dump_local_log_entries(PRINT_EVENT_INFO *print_event_info,
                                           const char* logname);
@@ -826,6 +830,424 @@ static bool shall_skip_gtids(Log_event* ev)
   return filtered;
 }
 
+/*
+  With --print-workers, the main thread still reads, filters and prints
+  the events, but hands the table map and rows events of each row-based
+  statement to worker threads, which print them in parallel: encoding
+  and decoding the rows is where the time goes. The output of the main
+  thread is collected in memory meanwhile, and everything is written in
+  binlog order.
+*/
+
+/** The events of a row-based statement, printed by a worker */
+struct Print_job
+{
+  struct Entry
+  {
+    /* NULL for an event the main thread skipped, only "# at" is printed */
+    Log_event *ev;
+    my_off_t pos;
+  };
+
+  Print_job(PRINT_EVENT_INFO *main_info)
+    : end_marker(false), prefix(NULL), prefix_length(0), done(false),
+      failed(false), next(NULL)
+  {
+    print_event_info.short_form= main_info->short_form;
+    print_event_info.base64_output_mode= main_info->base64_output_mode;
+    print_event_info.printed_fd_event= main_info->printed_fd_event;
+    print_event_info.common_header_len= main_info->common_header_len;
+    print_event_info.verbose= main_info->verbose;
+    strmov(print_event_info.delimiter, main_info->delimiter);
+  }
+
+  ~Print_job()
+  {
+    for (size_t i= 0; i < entries.size(); i++)
+      delete entries[i].ev;
+    free(prefix);
+  }
+
+  std::vector<Entry> entries;
+  /* The last event of the statement was skipped, end the BINLOG statement */
+  bool end_marker;
+  /* Output of the main thread since the previous statement */
+  char *prefix;
+  size_t prefix_length;
+  /* The worker prints into these caches, and the main thread copies them */
+  PRINT_EVENT_INFO print_event_info;
+  bool done;
+  bool failed;
+  Print_job *next;
+};
+
+/* Submitted jobs, in binlog order, until the main thread writes them */
+static Print_job *print_jobs_head= NULL, *print_jobs_tail= NULL;
+/* First submitted job no worker has taken yet */
+static Print_job *print_jobs_todo= NULL;
+static uint print_jobs_count= 0;
+/* Job of the row-based statement being read */
+static Print_job *print_job= NULL;
+static bool print_pool_stopping= false;
+static pthread_mutex_t print_pool_mutex;
+static pthread_cond_t print_pool_work_cond;
+static pthread_cond_t print_pool_done_cond;
+static pthread_t *print_workers= NULL;
+static uint print_workers_started= 0;
+/* The real output, while result_file collects the main thread output */
+static FILE *print_pool_output= NULL;
+static char *print_chunk= NULL;
+static size_t print_chunk_length= 0;
+
+/* Main thread output written as soon as no job is pending before it */
+#define PRINT_CHUNK_SIZE (64 * 1024)
+
+
+/** Events of a row-based statement, which the workers print */
+static bool is_rows_statement_event(Log_event_type type)
+{
+  switch (type) {
+  case TABLE_MAP_EVENT:
+  case ROWS_QUERY_LOG_EVENT:
+  case WRITE_ROWS_EVENT:
+  case DELETE_ROWS_EVENT:
+  case UPDATE_ROWS_EVENT:
+  case WRITE_ROWS_EVENT_V1:
+  case UPDATE_ROWS_EVENT_V1:
+  case DELETE_ROWS_EVENT_V1:
+  case PRE_GA_WRITE_ROWS_EVENT:
+  case PRE_GA_DELETE_ROWS_EVENT:
+  case PRE_GA_UPDATE_ROWS_EVENT:
+    return true;
+  default:
+    return false;
+  }
+}
+
+
+static bool print_chunk_open()
+{
+#ifdef _WIN32
+  result_file= NULL;                    /* refused by args_post_process() */
+#else
+  result_file= open_memstream(&print_chunk, &print_chunk_length);
+#endif
+  if (!result_file)
+  {
+    error("Could not allocate memory for the output.");
+    return true;
+  }
+  return false;
+}
+
+
+/**
+  Takes the output the main thread printed so far, result_file
+  starts over empty.
+*/
+static bool print_chunk_take(char **buf, size_t *length)
+{
+  fclose(result_file);
+  *buf= print_chunk;
+  *length= print_chunk_length;
+  return print_chunk_open();
+}
+
+
+static bool print_pool_write_buf(const char *buf, size_t length)
+{
+  if (length && my_fwrite(print_pool_output, (const uchar*) buf, length,
+                          MYF(MY_NABP)))
+  {
+    error("Could not write to the output.");
+    return true;
+  }
+  return false;
+}
+
+
+static void print_job_events(Print_job *job)
+{
+  PRINT_EVENT_INFO *print_event_info= &job->print_event_info;
+  char ll_buff[21];
+
+  for (size_t i= 0; i < job->entries.size(); i++)
+  {
+    Print_job::Entry *entry= &job->entries[i];
+    if (!entry->ev)
+    {
+      my_b_printf(&print_event_info->head_cache, "# at %s\n",
+                  llstr(entry->pos, ll_buff));
+      continue;
+    }
+    print_event_info->hexdump_from= opt_hexdump ? entry->pos : 0;
+    entry->ev->print(NULL, print_event_info);
+    delete entry->ev;
+    entry->ev= NULL;
+  }
+  if (job->end_marker && my_b_tell(&print_event_info->body_cache))
+    my_b_printf(&print_event_info->body_cache, "'%s\n",
+                print_event_info->delimiter);
+  job->failed= print_event_info->head_cache.error == -1 ||
+               print_event_info->body_cache.error == -1;
+}
+
+
+pthread_handler_t print_worker(void *arg __attribute__((unused)))
+{
+  my_thread_init();
+  pthread_mutex_lock(&print_pool_mutex);
+  for (;;)
+  {
+    while (!print_jobs_todo && !print_pool_stopping)
+      pthread_cond_wait(&print_pool_work_cond, &print_pool_mutex);
+    Print_job *job= print_jobs_todo;
+    if (!job)
+      break;
+    print_jobs_todo= job->next;
+    pthread_mutex_unlock(&print_pool_mutex);
+
+    print_job_events(job);
+
+    pthread_mutex_lock(&print_pool_mutex);
+    job->done= true;
+    pthread_cond_signal(&print_pool_done_cond);
+  }
+  pthread_mutex_unlock(&print_pool_mutex);
+  my_thread_end();
+  return 0;
+}
+
+
+/**
+  Writes the printed jobs at the head of the queue, and the output of
+  the main thread when no job is pending before it.
+
+  @param wait  Wait until all jobs are printed and everything is written.
+               Otherwise wait only when too many jobs are pending.
+
+  @retval true  A job could not be printed or the output written
+*/
+static bool print_pool_write(bool wait)
+{
+  Print_job *job;
+  while ((job= print_jobs_head))
+  {
+    bool done;
+    pthread_mutex_lock(&print_pool_mutex);
+    while (!job->done && (wait || print_jobs_count > 4 * opt_print_workers))
+      pthread_cond_wait(&print_pool_done_cond, &print_pool_mutex);
+    if ((done= job->done))
+    {
+      if (!(print_jobs_head= job->next))
+        print_jobs_tail= NULL;
+      print_jobs_count--;
+    }
+    pthread_mutex_unlock(&print_pool_mutex);
+    if (!done)
+      return false;
+
+    bool failed= job->failed ||
+      print_pool_write_buf(job->prefix, job->prefix_length) ||
+      copy_event_cache_to_file_and_reinit(&job->print_event_info.head_cache,
+                                          print_pool_output, stop_never) ||
+      copy_event_cache_to_file_and_reinit(&job->print_event_info.body_cache,
+                                          print_pool_output, stop_never);
+    delete job;
+    if (failed)
+      return true;
+  }
+
+  if (wait || stop_never || ftell(result_file) >= PRINT_CHUNK_SIZE)
+  {
+    char *buf;
+    size_t length;
+    if (print_chunk_take(&buf, &length))
+      return true;
+    bool failed= print_pool_write_buf(buf, length);
+    free(buf);
+    if (stop_never)
+      fflush(print_pool_output);
+    return failed;
+  }
+  return false;
+}
+
+
+/**
+  Adds an event to the job of the current row-based statement, starting
+  the job if needed. The job takes the event over.
+
+  @param print_event_info  Printing state of the main thread
+  @param ev                Event, or NULL to only print the position
+  @param pos               Position of the event
+*/
+static bool print_pool_add(PRINT_EVENT_INFO *print_event_info,
+                           Log_event *ev, my_off_t pos)
+{
+  if (ev && opt_remote_proto != BINLOG_LOCAL && !in_trx_payload)
+  {
+    /* The event is in the network buffer, which the next read reuses */
+    uint32 length= uint4korr(ev->temp_buf + EVENT_LEN_OFFSET);
+    char *buf= (char *) my_malloc(length, MYF(MY_WME));
+    if (buf)
+      memcpy(buf, ev->temp_buf, length);
+    ev->temp_buf= buf;
+    if (!buf)
+      goto err;
+  }
+
+  if (!print_job)
+  {
+    /* "# at" of the first event, the job prints it for the others */
+    if (copy_event_cache_to_file_and_reinit(&print_event_info->head_cache,
+                                            result_file, false))
+      goto err;
+    print_job= new Print_job(print_event_info);
+    if (!print_job->print_event_info.init_ok())
+    {
+      delete print_job;
+      print_job= NULL;
+      goto err;
+    }
+  }
+
+  {
+    Print_job::Entry entry= { ev, pos };
+    print_job->entries.push_back(entry);
+  }
+  return false;
+
+err:
+  delete ev;
+  return true;
+}
+
+
+/**
+  Hands the job of the current row-based statement to the workers.
+
+  @param end_marker  The last event of the statement was skipped
+*/
+static bool print_pool_submit(bool end_marker)
+{
+  Print_job *job= print_job;
+  print_job= NULL;
+  job->end_marker= end_marker;
+  if (print_chunk_take(&job->prefix, &job->prefix_length))
+  {
+    delete job;
+    return true;
+  }
+
+  pthread_mutex_lock(&print_pool_mutex);
+  if (print_jobs_tail)
+    print_jobs_tail->next= job;
+  else
+    print_jobs_head= job;
+  print_jobs_tail= job;
+  if (!print_jobs_todo)
+    print_jobs_todo= job;
+  print_jobs_count++;
+  pthread_cond_signal(&print_pool_work_cond);
+  pthread_mutex_unlock(&print_pool_mutex);
+
+  return print_pool_write(false);
+}
+
+
+/**
+  Prints the events of the current row-based statement in the main
+  thread, when another event interrupts it (e.g. a rotate in the middle
+  of a statement in a relay log), to leave the head and body caches as
+  if there were no workers.
+*/
+static void print_pool_replay(PRINT_EVENT_INFO *print_event_info)
+{
+  char ll_buff[21];
+
+  for (size_t i= 0; i < print_job->entries.size(); i++)
+  {
+    Print_job::Entry *entry= &print_job->entries[i];
+    if (!entry->ev)
+    {
+      my_b_printf(&print_event_info->head_cache, "# at %s\n",
+                  llstr(entry->pos, ll_buff));
+      continue;
+    }
+    print_event_info->hexdump_from= opt_hexdump ? entry->pos : 0;
+    entry->ev->print(result_file, print_event_info);
+  }
+  delete print_job;
+  print_job= NULL;
+}
+
+
+/**
+  Waits for the workers and writes all output, at the end of a binlog.
+  Like without workers, an unfinished statement is not printed.
+*/
+static bool print_pool_flush()
+{
+  delete print_job;
+  print_job= NULL;
+  return print_pool_write(true);
+}
+
+
+static bool print_pool_start()
+{
+  pthread_mutex_init(&print_pool_mutex, NULL);
+  pthread_cond_init(&print_pool_work_cond, NULL);
+  pthread_cond_init(&print_pool_done_cond, NULL);
+
+  print_pool_output= result_file;
+  if (print_chunk_open())
+    return true;
+
+  if (!(print_workers= (pthread_t *) my_malloc(sizeof(pthread_t) *
+                                               opt_print_workers,
+                                               MYF(MY_WME))))
+    return true;
+  for (; print_workers_started < opt_print_workers; print_workers_started++)
+  {
+    if (pthread_create(&print_workers[print_workers_started], NULL,
+                       print_worker, NULL))
+    {
+      error("Could not create a print worker thread.");
+      return true;
+    }
+  }
+  return false;
+}
+
+
+static bool print_pool_stop()
+{
+  bool failed= print_pool_flush();
+
+  pthread_mutex_lock(&print_pool_mutex);
+  print_pool_stopping= true;
+  pthread_cond_broadcast(&print_pool_work_cond);
+  pthread_mutex_unlock(&print_pool_mutex);
+  for (uint i= 0; i < print_workers_started; i++)
+    pthread_join(print_workers[i], NULL);
+  my_free(print_workers);
+  print_workers= NULL;
+
+  fclose(result_file);
+  result_file= print_pool_output;
+  failed|= print_pool_write_buf(print_chunk, print_chunk_length);
+  free(print_chunk);
+  print_chunk= NULL;
+
+  pthread_cond_destroy(&print_pool_done_cond);
+  pthread_cond_destroy(&print_pool_work_cond);
+  pthread_mutex_destroy(&print_pool_mutex);
+  return failed;
+}
+
+
 /**
   Print the given event, and either delete it or delegate the deletion
   to someone else.
@@ -894,8 +1316,16 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
       goto end;
     }
     if (!short_form)
-      my_b_printf(&print_event_info->head_cache,
-                  "# at %s\n",llstr(pos,ll_buff));
+    {
+      if (print_job)
+      {
+        if (print_pool_add(print_event_info, NULL, pos))
+          goto err;
+      }
+      else
+        my_b_printf(&print_event_info->head_cache,
+                    "# at %s\n",llstr(pos,ll_buff));
+    }
 
     if (!opt_hexdump)
       print_event_info->hexdump_from= 0; /* Disabled */
@@ -909,6 +1339,10 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
     if (shall_skip_gtids(ev))
       goto end;
 
+    /* Other events interrupt the row-based statement of the workers */
+    if (print_job && !is_rows_statement_event(ev_type))
+      print_pool_replay(print_event_info);
+
     switch (ev_type) {
     case QUERY_EVENT:
     {
@@ -1084,6 +1518,9 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
       break;
     }
     case FORMAT_DESCRIPTION_EVENT:
+      /* The workers decode rows with the description event */
+      if (opt_print_workers && print_pool_write(true))
+        goto err;
       delete glob_description_event;
       glob_description_event= (Format_description_log_event*) ev;
       print_event_info->common_header_len=
@@ -1228,7 +1665,14 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
            result_file (as it would happen in ev->print(...) if
            event was not skipped).
         */
-        if (skip_event)
+        if (skip_event && print_job)
+        {
+          print_event_info->have_unflushed_events= FALSE;
+          /* The worker appends the END-MARKER */
+          if (print_pool_submit(true))
+            goto err;
+        }
+        else if (skip_event)
         {
           // set the unflushed_events flag to false
           print_event_info->have_unflushed_events= FALSE;
@@ -1263,7 +1707,8 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
       */
       if (!print_event_info->printed_fd_event && !short_form &&
           ev_type != TABLE_MAP_EVENT && ev_type != ROWS_QUERY_LOG_EVENT &&
-          opt_base64_output_mode != BASE64_OUTPUT_DECODE_ROWS)
+          opt_base64_output_mode != BASE64_OUTPUT_DECODE_ROWS &&
+          opt_base64_output_mode != BASE64_OUTPUT_JSON)
       {
         const char* type_str= ev->get_type_str();
         if (opt_base64_output_mode == BASE64_OUTPUT_NEVER)
@@ -1279,6 +1724,18 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
         goto err;
       }
 
+      if (opt_print_workers)
+      {
+        bool failed= print_pool_add(print_event_info, ev, pos);
+        ev= NULL;
+        if (failed)
+          goto err;
+        print_event_info->have_unflushed_events= !stmt_end;
+        if (stmt_end && print_pool_submit(false))
+          goto err;
+        goto end;
+      }
+
       ev->print(result_file, print_event_info);
       print_event_info->have_unflushed_events= TRUE;
       /* Flush head and body cache to result_file */
@@ -1343,6 +1800,39 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
         goto err;
       break;
     }
+    case TRANSACTION_PAYLOAD_EVENT:
+    {
+      /*
+        The events of a compressed transaction are printed as if they were
+        written uncompressed, at the position of the payload.
+      */
+      Transaction_payload_log_event *pev= (Transaction_payload_log_event*) ev;
+      Log_event *payload_ev;
+      const char *errmsg= NULL;
+      ev->print(result_file, print_event_info);
+      if (head->error == -1)
+        goto err;
+      if (pev->uncompress())
+      {
+        error("Could not uncompress the Transaction_payload event at "
+              "position %s.", llstr(pos, ll_buff));
+        goto err;
+      }
+      in_trx_payload= true;
+      while (retval == OK_CONTINUE &&
+             (payload_ev= pev->next_event(glob_description_event, &errmsg)))
+        retval= process_event(print_event_info, payload_ev, pos, logname);
+      in_trx_payload= false;
+      if (retval != OK_CONTINUE)
+        goto end;
+      if (errmsg)
+      {
+        error("Could not read the Transaction_payload event at "
+              "position %s: %s.", llstr(pos, ll_buff), errmsg);
+        goto err;
+      }
+      break;
+    }
     case PREVIOUS_GTIDS_LOG_EVENT:
       if (one_database && !opt_skip_gtids)
         warning("The option --database has been used. It may filter "
@@ -1368,13 +1858,15 @@ err:
   retval= ERROR_STOP;
 end:
   rec_count++;
+  if (opt_print_workers && retval != ERROR_STOP && print_pool_write(false))
+    retval= ERROR_STOP;
   /*
     Destroy the log_event object. If reading from a remote host,
     set the temp_buf to NULL so that memory isn't freed twice.
   */
   if (ev)
   {
-    if (opt_remote_proto != BINLOG_LOCAL)
+    if (opt_remote_proto != BINLOG_LOCAL && !in_trx_payload)
       ev->temp_buf= 0;
     if (destroy_evt) /* destroy it later if not set (ignored table map) */
       delete ev;
@@ -1392,7 +1884,9 @@ static struct my_option my_long_options[] =
    "Determine when the output statements should be base64-encoded BINLOG "
    "statements: 'never' disables it and works only for binlogs without "
    "row-based events; 'decode-rows' decodes row events into commented pseudo-SQL "
-   "statements if the --verbose option is also given; 'auto' prints base64 "
+   "statements if the --verbose option is also given; 'json' prints the rows "
+   "of row events as JSON objects, one per line, instead of BINLOG "
+   "statements; 'auto' prints base64 "
    "only when necessary (i.e., for row-based events and format description "
    "events).  If no --base64-output[=name] option is given at all, the "
    "default is 'auto'.",
@@ -1638,6 +2132,12 @@ static struct my_option my_long_options[] =
    "flushing the result file. ",
    &opt_flush_result_file, &opt_flush_result_file, 0,
    GET_UINT, REQUIRED_ARG, 1000, 1, UINT_MAX, 1, 0, 0},
+  {"print-workers", OPT_PRINT_WORKERS,
+   "Number of threads that print the row events of row-based statements "
+   "while the main thread reads the binlog. The output is the same as "
+   "without them. 0 prints everything in the main thread.",
+   &opt_print_workers, &opt_print_workers, 0,
+   GET_UINT, REQUIRED_ARG, 0, 0, 256, 0, 0, 0},
   {0, 0, 0, 0, 0, 0, GET_NO_ARG, NO_ARG, 0, 0, 0, 0, 0, 0}
 };
 
@@ -1960,6 +2460,9 @@ static Exit_status dump_log_entries(const char* logname)
     break;
   }
 
+  if (opt_print_workers && print_pool_flush())
+    rc= ERROR_STOP;
+
   if (buff_ev.elements > 0)
     warning("The range of printed events ends with an Intvar_event, "
             "Rand_event or User_var_event with no matching Query_log_event. "
@@ -2964,6 +3467,17 @@ static int args_post_process(void)
     error("--raw option must be used when using --use_semisync option");
     DBUG_RETURN(ERROR_STOP);
   }
+
+  /* Nothing is printed from row events in these modes */
+  if (raw_mode || short_form)
+    opt_print_workers= 0;
+#ifdef _WIN32
+  if (opt_print_workers)
+  {
+    error("--print-workers is not supported on this platform");
+    DBUG_RETURN(ERROR_STOP);
+  }
+#endif
   DBUG_RETURN(OK_CONTINUE);
 }
 
@@ -3286,6 +3800,9 @@ int main(int argc, char** argv)
               "\n/*!40101 SET NAMES %s */;\n", charset);
   }
 
+  if (opt_print_workers && print_pool_start())
+    exit(1);
+
   if (opt_start_gtid_str != NULL || opt_find_gtid_str != NULL)
   {
     if (opt_start_gtid_str != NULL && opt_remote_proto == BINLOG_DUMP_GTID)
@@ -3322,6 +3839,9 @@ int main(int argc, char** argv)
     }
   }
 
+  if (opt_print_workers && print_pool_stop())
+    retval= ERROR_STOP;
+
   if (!raw_mode && opt_find_gtid_str == NULL)
   {
     /*
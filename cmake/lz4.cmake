@@ -0,0 +1,57 @@
+# Copyright (c) 2013, Facebook, Inc. All rights reserved.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; version 2 of the License.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+# Usage:
+#  cmake -DWITH_LZ4="system"|"no"|</path/to/custom/installation>
+#
+# lz4 with the lz4frame API is used for the lz4 algorithm of the compressed
+# client/server protocol. With "system" (the default) it is used if it is
+# found, with a path it must be found there.
+
+MACRO (MYSQL_CHECK_LZ4)
+  IF(NOT WITH_LZ4)
+    SET(WITH_LZ4 "system" CACHE STRING
+        "Which lz4 to use (possible values are 'system', 'no' or a path)")
+  ENDIF()
+
+  IF(WITH_LZ4 STREQUAL "system")
+    FIND_PATH(LZ4_INCLUDE_DIR NAMES lz4frame.h)
+    FIND_LIBRARY(LZ4_LIBRARY NAMES lz4)
+  ELSEIF(NOT WITH_LZ4 STREQUAL "no")
+    FIND_PATH(LZ4_INCLUDE_DIR NAMES lz4frame.h
+      PATHS ${WITH_LZ4}/include NO_DEFAULT_PATH)
+    FIND_LIBRARY(LZ4_LIBRARY NAMES lz4
+      PATHS ${WITH_LZ4}/lib NO_DEFAULT_PATH)
+  ENDIF()
+
+  IF(LZ4_INCLUDE_DIR AND LZ4_LIBRARY)
+    INCLUDE(CheckFunctionExists)
+    SET(CMAKE_REQUIRED_LIBRARIES ${LZ4_LIBRARY})
+    CHECK_FUNCTION_EXISTS(LZ4F_compressBegin HAVE_LZ4_STREAM)
+    SET(CMAKE_REQUIRED_LIBRARIES)
+  ENDIF()
+
+  IF(HAVE_LZ4_STREAM)
+    SET(HAVE_LZ4 1)
+    MESSAGE(STATUS "Using lz4 ${LZ4_LIBRARY}")
+  ELSE()
+    SET(HAVE_LZ4 0)
+    SET(LZ4_LIBRARY "")
+    SET(LZ4_INCLUDE_DIR "")
+    IF(NOT WITH_LZ4 STREQUAL "system" AND NOT WITH_LZ4 STREQUAL "no")
+      MESSAGE(SEND_ERROR "Cannot find lz4 in ${WITH_LZ4}")
+    ENDIF()
+  ENDIF()
+ENDMACRO()
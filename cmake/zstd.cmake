@@ -0,0 +1,57 @@
+# Copyright (c) 2013, Facebook, Inc. All rights reserved.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; version 2 of the License.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+# Usage:
+#  cmake -DWITH_ZSTD="system"|"no"|</path/to/custom/installation>
+#
+# zstd with the streaming API of zstd 1.4 is used for the zstd algorithm of the compressed
+# client/server protocol. With "system" (the default) it is used if it is
+# found, with a path it must be found there.
+
+MACRO (MYSQL_CHECK_ZSTD)
+  IF(NOT WITH_ZSTD)
+    SET(WITH_ZSTD "system" CACHE STRING
+        "Which zstd to use (possible values are 'system', 'no' or a path)")
+  ENDIF()
+
+  IF(WITH_ZSTD STREQUAL "system")
+    FIND_PATH(ZSTD_INCLUDE_DIR NAMES zstd.h)
+    FIND_LIBRARY(ZSTD_LIBRARY NAMES zstd)
+  ELSEIF(NOT WITH_ZSTD STREQUAL "no")
+    FIND_PATH(ZSTD_INCLUDE_DIR NAMES zstd.h
+      PATHS ${WITH_ZSTD}/include NO_DEFAULT_PATH)
+    FIND_LIBRARY(ZSTD_LIBRARY NAMES zstd
+      PATHS ${WITH_ZSTD}/lib NO_DEFAULT_PATH)
+  ENDIF()
+
+  IF(ZSTD_INCLUDE_DIR AND ZSTD_LIBRARY)
+    INCLUDE(CheckFunctionExists)
+    SET(CMAKE_REQUIRED_LIBRARIES ${ZSTD_LIBRARY})
+    CHECK_FUNCTION_EXISTS(ZSTD_compressStream2 HAVE_ZSTD_STREAM)
+    SET(CMAKE_REQUIRED_LIBRARIES)
+  ENDIF()
+
+  IF(HAVE_ZSTD_STREAM)
+    SET(HAVE_ZSTD 1)
+    MESSAGE(STATUS "Using zstd ${ZSTD_LIBRARY}")
+  ELSE()
+    SET(HAVE_ZSTD 0)
+    SET(ZSTD_LIBRARY "")
+    SET(ZSTD_INCLUDE_DIR "")
+    IF(NOT WITH_ZSTD STREQUAL "system" AND NOT WITH_ZSTD STREQUAL "no")
+      MESSAGE(SEND_ERROR "Cannot find zstd in ${WITH_ZSTD}")
+    ENDIF()
+  ENDIF()
+ENDMACRO()
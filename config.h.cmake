@@ -604,6 +604,8 @@
 #cmakedefine HAVE_CHARSET_utf32 1
 #cmakedefine HAVE_UCA_COLLATIONS 1
 #cmakedefine HAVE_COMPRESS 1
+#cmakedefine HAVE_ZSTD 1
+#cmakedefine HAVE_LZ4 1
 #cmakedefine COMPILE_FLAG_WERROR 1
 
 /*
@@ -856,6 +856,21 @@ extern my_bool my_compress(uchar *, size_t *, size_t *, uint level);
 extern my_bool my_uncompress(uchar *, size_t , size_t *);
 extern uchar *my_compress_alloc(const uchar *packet, size_t *len,
                                 size_t *complen, uint level);
+typedef struct st_my_compress_stream MY_COMPRESS_STREAM;
+extern MY_COMPRESS_STREAM *my_compress_stream_init(uint algorithm, uint level);
+extern void my_compress_stream_end(MY_COMPRESS_STREAM *stream);
+extern size_t my_compress_stream_bound(MY_COMPRESS_STREAM *stream, size_t len);
+extern my_bool my_compress_stream(MY_COMPRESS_STREAM *stream,
+                                  const uchar *packet, size_t len,
+                                  uchar *dst, size_t *dst_len);
+extern my_bool my_uncompress_stream(MY_COMPRESS_STREAM *stream,
+                                    uchar *packet, size_t len,
+                                    size_t complen);
+extern size_t my_compress_buffer_bound(uint algorithm, size_t len);
+extern my_bool my_compress_buffer(uint algorithm, const uchar *src,
+                                  size_t len, uchar *dst, size_t *dst_len);
+extern my_bool my_uncompress_buffer(uint algorithm, const uchar *src,
+                                    size_t len, uchar *dst, size_t dst_len);
 extern int packfrm(uchar *, size_t, uchar **, size_t *);
 extern int unpackfrm(uchar **, size_t *, const uchar *);
 
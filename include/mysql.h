@@ -181,7 +181,8 @@ enum mysql_option
   MYSQL_OPT_NET_RECEIVE_BUFFER_SIZE,
   MYSQL_OPT_CONNECT_TIMEOUT_MS,  /* connection timeout in milli-second */
   MYSQL_OPT_READ_TIMEOUT_MS,     /* query recv timeout in milli-second */
-  MYSQL_OPT_WRITE_TIMEOUT_MS     /* query send timeout in milli-second */
+  MYSQL_OPT_WRITE_TIMEOUT_MS,    /* query send timeout in milli-second */
+  MYSQL_OPT_COMPRESSION_ALGORITHM /* zlib, zstd or lz4 */
 };
 
 /**
@@ -69,6 +69,11 @@ uint timeout_to_millis(const timeout_t t);
 uint timeout_to_seconds(const timeout_t t);
 struct st_vio;
 typedef struct st_vio Vio;
+enum enum_net_compression
+{
+  NET_COMPRESSION_ZLIB= 0, NET_COMPRESSION_ZSTD, NET_COMPRESSION_LZ4
+};
+struct st_my_compress_stream;
 typedef struct st_net {
   Vio *vio;
   unsigned char *buff,*buff_end,*write_pos,*read_pos;
@@ -113,6 +118,8 @@ typedef struct st_net {
   ulong async_multipacket_read_saved_whereb;
   ulong async_multipacket_read_total_len;
   my_bool async_multipacket_read_started;
+  unsigned int compress_algorithm;
+  struct st_my_compress_stream *compress_stream;
 } NET;
 enum enum_field_types { MYSQL_TYPE_DECIMAL, MYSQL_TYPE_TINY,
    MYSQL_TYPE_SHORT, MYSQL_TYPE_LONG,
@@ -162,6 +169,7 @@ enum enum_mysql_set_option
 my_bool my_net_init(NET *net, Vio* vio);
 void my_net_local_init(NET *net);
 void net_end(NET *net);
+void my_net_set_compression(NET *net, unsigned long capabilities);
 void net_clear(NET *net, my_bool check_buffer);
 my_bool net_realloc(NET *net, size_t length);
 my_bool net_flush(NET *net);
@@ -316,6 +324,7 @@ extern void make_type(char *to,unsigned int nr,TYPELIB *typelib);
 extern const char *get_type(TYPELIB *typelib,unsigned int nr);
 extern TYPELIB *copy_typelib(MEM_ROOT *root, TYPELIB *from);
 extern TYPELIB sql_protocol_typelib;
+extern TYPELIB net_compression_algorithm_typelib;
 my_ulonglong find_set_from_flags(const TYPELIB *lib, unsigned int default_name,
                               my_ulonglong cur_set, my_ulonglong default_set,
                               const char *str, unsigned int length,
@@ -359,7 +368,8 @@ enum mysql_option
   MYSQL_OPT_NET_RECEIVE_BUFFER_SIZE,
   MYSQL_OPT_CONNECT_TIMEOUT_MS,
   MYSQL_OPT_READ_TIMEOUT_MS,
-  MYSQL_OPT_WRITE_TIMEOUT_MS
+  MYSQL_OPT_WRITE_TIMEOUT_MS,
+  MYSQL_OPT_COMPRESSION_ALGORITHM
 };
 struct st_mysql_options_extention;
 struct st_mysql_options {
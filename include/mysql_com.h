@@ -185,6 +185,13 @@ enum enum_server_command
 /* Don't close the connection for a connection with expired password. */
 #define CLIENT_CAN_HANDLE_EXPIRED_PASSWORDS (1UL << 22)
 
+/*
+  Use zstd or lz4 streaming compression instead of zlib for the compressed
+  protocol. Only valid together with CLIENT_COMPRESS.
+*/
+#define CLIENT_COMPRESS_ZSTD (1UL << 23)
+#define CLIENT_COMPRESS_LZ4  (1UL << 24)
+
 #define CLIENT_SSL_VERIFY_SERVER_CERT (1UL << 30)
 #define CLIENT_REMEMBER_OPTIONS (1UL << 31)
 
@@ -194,6 +201,18 @@ enum enum_server_command
 #define CAN_CLIENT_COMPRESS 0
 #endif
 
+#if defined(HAVE_COMPRESS) && defined(HAVE_ZSTD)
+#define CAN_CLIENT_COMPRESS_ZSTD CLIENT_COMPRESS_ZSTD
+#else
+#define CAN_CLIENT_COMPRESS_ZSTD 0
+#endif
+
+#if defined(HAVE_COMPRESS) && defined(HAVE_LZ4)
+#define CAN_CLIENT_COMPRESS_LZ4 CLIENT_COMPRESS_LZ4
+#else
+#define CAN_CLIENT_COMPRESS_LZ4 0
+#endif
+
 /* Gather all possible capabilites (flags) supported by the server */
 #define CLIENT_ALL_FLAGS  (CLIENT_LONG_PASSWORD \
                            | CLIENT_FOUND_ROWS \
@@ -220,6 +239,8 @@ enum enum_server_command
                            | CLIENT_CONNECT_ATTRS \
                            | CLIENT_PLUGIN_AUTH_LENENC_CLIENT_DATA \
                            | CLIENT_CAN_HANDLE_EXPIRED_PASSWORDS \
+                           | CLIENT_COMPRESS_ZSTD \
+                           | CLIENT_COMPRESS_LZ4 \
 )
 
 /*
@@ -228,7 +249,9 @@ enum enum_server_command
   on before sending to the client during the connection handshake.
 */
 #define CLIENT_BASIC_FLAGS (((CLIENT_ALL_FLAGS & ~CLIENT_SSL) \
-                                               & ~CLIENT_COMPRESS) \
+                                               & ~(CLIENT_COMPRESS | \
+                                                   CLIENT_COMPRESS_ZSTD | \
+                                                   CLIENT_COMPRESS_LZ4)) \
                                                & ~CLIENT_SSL_VERIFY_SERVER_CERT)
 
 /**
@@ -402,6 +425,18 @@ typedef struct st_vio Vio;
 #define NET_HEADER_SIZE 4		/* standard header size */
 #define COMP_HEADER_SIZE 3		/* compression header extra size */
 
+/*
+  Compression algorithms of the compressed protocol. With zlib every packet
+  is compressed on its own, zstd and lz4 compress the packets as one stream
+  so that a packet is compressed with the history of the connection.
+*/
+enum enum_net_compression
+{
+  NET_COMPRESSION_ZLIB= 0, NET_COMPRESSION_ZSTD, NET_COMPRESSION_LZ4
+};
+
+struct st_my_compress_stream;
+
 typedef struct st_net {
 #if !defined(CHECK_EMBEDDED_DIFFERENCES) || !defined(EMBEDDED_LIBRARY)
   Vio *vio;
@@ -495,6 +530,11 @@ typedef struct st_net {
   ulong async_multipacket_read_saved_whereb;
   ulong async_multipacket_read_total_len;
   my_bool async_multipacket_read_started;
+
+  /* enum_net_compression of the compressed protocol */
+  unsigned int compress_algorithm;
+  /* Compression state of a zstd or lz4 connection, see my_compress.c */
+  struct st_my_compress_stream *compress_stream;
 } NET;
 
 
@@ -615,6 +655,7 @@ extern "C" {
 my_bool	my_net_init(NET *net, Vio* vio);
 void my_net_local_init(NET *net);
 void net_end(NET *net);
+void my_net_set_compression(NET *net, unsigned long capabilities);
 void net_clear(NET *net, my_bool check_buffer);
 my_bool net_realloc(NET *net, size_t length);
 my_bool	net_flush(NET *net);
@@ -38,6 +38,7 @@ struct st_mysql_options_extention {
   char *server_public_key_path;
   size_t connection_attributes_length;
   my_bool enable_cleartext_plugin;
+  unsigned int compression_algorithm;   /* enum_net_compression */
 };
 
 typedef struct st_mysql_methods
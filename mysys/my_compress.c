@@ -22,6 +22,13 @@
 #include <m_string.h>
 #endif
 #include <zlib.h>
+#include <mysql_com.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+#ifdef HAVE_LZ4
+#include <lz4frame.h>
+#endif
 
 /*
    This replaces the packet with a compressed packet
@@ -138,6 +145,445 @@ my_bool my_uncompress(uchar *packet, size_t len, size_t *complen)
   DBUG_RETURN(0);
 }
 
+/*
+  Streaming compression of the client/server protocol
+
+  With zstd and lz4 the packets of a connection are compressed as one
+  stream: the compressor is flushed at the end of every packet, so that a
+  packet can be uncompressed as soon as it is read, but every packet is
+  compressed with the earlier packets of the connection as history. Small
+  packets, like the rows of a result set, compress much better than with
+  zlib, which compresses every packet on its own.
+
+  A MY_COMPRESS_STREAM holds the compressor of the packets sent and the
+  uncompressor of the packets read on a connection. Every packet compressed
+  with my_compress_stream() must be uncompressed by the peer with
+  my_uncompress_stream(), in the same order.
+*/
+
+/* History kept by the zstd compressor, 128KB per direction */
+#define COMPRESS_STREAM_ZSTD_WINDOW_LOG 17
+/* Packets up to this length are uncompressed in MY_COMPRESS_STREAM::buff */
+#define COMPRESS_STREAM_BUFF_LENGTH (16 * IO_SIZE)
+
+struct st_my_compress_stream
+{
+  uint algorithm;
+  /* Buffer for my_uncompress_stream(), which can't work in place */
+  uchar *buff;
+#ifdef HAVE_ZSTD
+  ZSTD_CCtx *zstd_cctx;
+  ZSTD_DCtx *zstd_dctx;
+#endif
+#ifdef HAVE_LZ4
+  LZ4F_cctx *lz4_cctx;
+  LZ4F_dctx *lz4_dctx;
+  LZ4F_preferences_t lz4_prefs;
+  /* The lz4 frame header, sent before the first packet */
+  uchar lz4_header[LZ4F_HEADER_SIZE_MAX];
+  size_t lz4_header_length;
+#endif
+};
+
+
+/*
+  Create the compression stream of a connection
+
+  SYNOPSIS
+    my_compress_stream_init()
+    algorithm	NET_COMPRESSION_ZSTD or NET_COMPRESSION_LZ4
+    level	zstd compression level, 0 for the default. lz4 always uses
+		its fast default level.
+
+  RETURN
+    NULL if out of memory or the algorithm is not supported by the build
+*/
+
+MY_COMPRESS_STREAM *my_compress_stream_init(uint algorithm, uint level)
+{
+  MY_COMPRESS_STREAM *stream;
+  DBUG_ENTER("my_compress_stream_init");
+
+  if (!(stream= (MY_COMPRESS_STREAM *) my_malloc(sizeof(*stream),
+                                                 MYF(MY_WME | MY_ZEROFILL))))
+    DBUG_RETURN(NULL);
+  stream->algorithm= algorithm;
+  if (!(stream->buff= (uchar *) my_malloc(COMPRESS_STREAM_BUFF_LENGTH,
+                                          MYF(MY_WME))))
+    goto err;
+
+  switch (algorithm) {
+#ifdef HAVE_ZSTD
+  case NET_COMPRESSION_ZSTD:
+    if (!(stream->zstd_cctx= ZSTD_createCCtx()) ||
+        !(stream->zstd_dctx= ZSTD_createDCtx()) ||
+        ZSTD_isError(ZSTD_CCtx_setParameter(stream->zstd_cctx,
+                                            ZSTD_c_compressionLevel,
+                                            (int) level)) ||
+        ZSTD_isError(ZSTD_CCtx_setParameter(stream->zstd_cctx,
+                                            ZSTD_c_windowLog,
+                                            COMPRESS_STREAM_ZSTD_WINDOW_LOG)))
+      goto err;
+    break;
+#endif
+#ifdef HAVE_LZ4
+  case NET_COMPRESSION_LZ4:
+  {
+    size_t res;
+    if (LZ4F_isError(LZ4F_createCompressionContext(&stream->lz4_cctx,
+                                                   LZ4F_VERSION)) ||
+        LZ4F_isError(LZ4F_createDecompressionContext(&stream->lz4_dctx,
+                                                     LZ4F_VERSION)))
+      goto err;
+    /* Linked blocks: every block is compressed with the earlier ones */
+    stream->lz4_prefs.frameInfo.blockMode= LZ4F_blockLinked;
+    stream->lz4_prefs.frameInfo.blockSizeID= LZ4F_max64KB;
+    stream->lz4_prefs.autoFlush= 1;
+    res= LZ4F_compressBegin(stream->lz4_cctx, stream->lz4_header,
+                            sizeof(stream->lz4_header), &stream->lz4_prefs);
+    if (LZ4F_isError(res))
+      goto err;
+    stream->lz4_header_length= res;
+    break;
+  }
+#endif
+  default:
+    goto err;
+  }
+  DBUG_RETURN(stream);
+
+err:
+  my_compress_stream_end(stream);
+  DBUG_RETURN(NULL);
+}
+
+
+void my_compress_stream_end(MY_COMPRESS_STREAM *stream)
+{
+#ifdef HAVE_ZSTD
+  ZSTD_freeCCtx(stream->zstd_cctx);
+  ZSTD_freeDCtx(stream->zstd_dctx);
+#endif
+#ifdef HAVE_LZ4
+  LZ4F_freeCompressionContext(stream->lz4_cctx);
+  LZ4F_freeDecompressionContext(stream->lz4_dctx);
+#endif
+  my_free(stream->buff);
+  my_free(stream);
+}
+
+
+/*
+  Maximum length of a packet of 'len' bytes compressed by
+  my_compress_stream()
+*/
+
+size_t my_compress_stream_bound(MY_COMPRESS_STREAM *stream, size_t len)
+{
+  switch (stream->algorithm) {
+#ifdef HAVE_ZSTD
+  case NET_COMPRESSION_ZSTD:
+    return ZSTD_compressBound(len);
+#endif
+#ifdef HAVE_LZ4
+  case NET_COMPRESSION_LZ4:
+    return stream->lz4_header_length +
+           LZ4F_compressBound(len, &stream->lz4_prefs);
+#endif
+  }
+  return len;
+}
+
+
+/*
+  Compress a packet with the stream of the connection
+
+  SYNOPSIS
+    my_compress_stream()
+    stream	Compression stream of the connection
+    packet	Data to compress
+    len		Length of data to compress at 'packet'
+    dst		Buffer for the compressed data
+    dst_len	in: size of 'dst', at least my_compress_stream_bound(len)
+		out: length of the compressed data
+
+  NOTES
+    The compressed packet may be longer than 'len'. It must be sent
+    anyway, as the peer must uncompress all the packets the stream has
+    compressed.
+
+  RETURN
+    1   error. The stream can't be used any more.
+    0   ok
+*/
+
+my_bool my_compress_stream(MY_COMPRESS_STREAM *stream,
+                           const uchar *packet, size_t len,
+                           uchar *dst, size_t *dst_len)
+{
+  DBUG_ENTER("my_compress_stream");
+
+  switch (stream->algorithm) {
+#ifdef HAVE_ZSTD
+  case NET_COMPRESSION_ZSTD:
+  {
+    ZSTD_inBuffer in= { packet, len, 0 };
+    ZSTD_outBuffer out= { dst, *dst_len, 0 };
+    size_t res;
+    do
+    {
+      res= ZSTD_compressStream2(stream->zstd_cctx, &out, &in, ZSTD_e_flush);
+      if (ZSTD_isError(res))
+        DBUG_RETURN(1);
+    } while (res && out.pos < out.size);
+    if (res)
+      DBUG_RETURN(1);                           /* dst is too short */
+    *dst_len= out.pos;
+    DBUG_RETURN(0);
+  }
+#endif
+#ifdef HAVE_LZ4
+  case NET_COMPRESSION_LZ4:
+  {
+    size_t header_length= stream->lz4_header_length;
+    size_t res;
+    memcpy(dst, stream->lz4_header, header_length);
+    res= LZ4F_compressUpdate(stream->lz4_cctx, dst + header_length,
+                             *dst_len - header_length, packet, len, NULL);
+    if (LZ4F_isError(res))
+      DBUG_RETURN(1);
+    stream->lz4_header_length= 0;
+    *dst_len= header_length + res;
+    DBUG_RETURN(0);
+  }
+#endif
+  }
+  DBUG_RETURN(1);
+}
+
+
+/*
+  Uncompress a packet with the stream of the connection
+
+  SYNOPSIS
+    my_uncompress_stream()
+    stream	Compression stream of the connection
+    packet	Compressed data. This is is replaced with the orignal data.
+    len		Length of compressed data
+    complen	Length of the original data
+
+  RETURN
+    1   error
+    0   ok
+*/
+
+my_bool my_uncompress_stream(MY_COMPRESS_STREAM *stream,
+                             uchar *packet, size_t len, size_t complen)
+{
+  uchar *buff= stream->buff;
+  my_bool error= 1;
+  DBUG_ENTER("my_uncompress_stream");
+
+  if (complen > COMPRESS_STREAM_BUFF_LENGTH &&
+      !(buff= (uchar *) my_malloc(complen, MYF(MY_WME))))
+    DBUG_RETURN(1);
+
+  switch (stream->algorithm) {
+#ifdef HAVE_ZSTD
+  case NET_COMPRESSION_ZSTD:
+  {
+    ZSTD_inBuffer in= { packet, len, 0 };
+    ZSTD_outBuffer out= { buff, complen, 0 };
+    size_t res= 0;
+    while (!ZSTD_isError(res) && (in.pos < in.size || out.pos < out.size))
+    {
+      size_t in_pos= in.pos, out_pos= out.pos;
+      res= ZSTD_decompressStream(stream->zstd_dctx, &out, &in);
+      if (in.pos == in_pos && out.pos == out_pos)
+        break;                                  /* Probably wrong packet */
+    }
+    error= ZSTD_isError(res) || in.pos < in.size || out.pos < out.size;
+    break;
+  }
+#endif
+#ifdef HAVE_LZ4
+  case NET_COMPRESSION_LZ4:
+  {
+    size_t in_pos= 0, out_pos= 0, res= 0;
+    while (!LZ4F_isError(res) && (in_pos < len || out_pos < complen))
+    {
+      size_t src_size= len - in_pos, dst_size= complen - out_pos;
+      res= LZ4F_decompress(stream->lz4_dctx, buff + out_pos, &dst_size,
+                           packet + in_pos, &src_size, NULL);
+      if (!src_size && !dst_size)
+        break;                                  /* Probably wrong packet */
+      in_pos+= src_size;
+      out_pos+= dst_size;
+    }
+    error= LZ4F_isError(res) || in_pos < len || out_pos < complen;
+    break;
+  }
+#endif
+  }
+  if (!error)
+    memcpy(packet, buff, complen);
+  if (buff != stream->buff)
+    my_free(buff);
+  DBUG_RETURN(error);
+}
+
+
+/*
+  Compression of a whole buffer with any of the algorithms
+
+  Unlike the packets of a connection, the buffer is compressed on its own,
+  so it can be uncompressed with my_uncompress_buffer() at any time later,
+  e.g. when it was stored in a file.
+*/
+
+/*
+  Maximum length of a buffer of 'len' bytes compressed by
+  my_compress_buffer(), 0 if the algorithm is not supported by the build
+*/
+
+size_t my_compress_buffer_bound(uint algorithm, size_t len)
+{
+  switch (algorithm) {
+  case NET_COMPRESSION_ZLIB:
+    return compressBound((uLong) len);
+#ifdef HAVE_ZSTD
+  case NET_COMPRESSION_ZSTD:
+    return ZSTD_compressBound(len);
+#endif
+#ifdef HAVE_LZ4
+  case NET_COMPRESSION_LZ4:
+    return LZ4F_compressFrameBound(len, NULL);
+#endif
+  }
+  return 0;
+}
+
+
+/*
+  Compress a buffer
+
+  SYNOPSIS
+    my_compress_buffer()
+    algorithm	NET_COMPRESSION_ZLIB, NET_COMPRESSION_ZSTD or
+		NET_COMPRESSION_LZ4
+    src		Data to compress
+    len		Length of data to compress at 'src'
+    dst		Buffer for the compressed data
+    dst_len	in: size of 'dst', at least my_compress_buffer_bound(len)
+		out: length of the compressed data
+
+  RETURN
+    1   error
+    0   ok
+*/
+
+my_bool my_compress_buffer(uint algorithm, const uchar *src, size_t len,
+                           uchar *dst, size_t *dst_len)
+{
+  DBUG_ENTER("my_compress_buffer");
+
+  switch (algorithm) {
+  case NET_COMPRESSION_ZLIB:
+  {
+    uLongf tmp_len= (uLongf) *dst_len;
+    if (compress(dst, &tmp_len, src, (uLong) len) != Z_OK)
+      DBUG_RETURN(1);
+    *dst_len= tmp_len;
+    DBUG_RETURN(0);
+  }
+#ifdef HAVE_ZSTD
+  case NET_COMPRESSION_ZSTD:
+  {
+    size_t res= ZSTD_compress(dst, *dst_len, src, len, ZSTD_CLEVEL_DEFAULT);
+    if (ZSTD_isError(res))
+      DBUG_RETURN(1);
+    *dst_len= res;
+    DBUG_RETURN(0);
+  }
+#endif
+#ifdef HAVE_LZ4
+  case NET_COMPRESSION_LZ4:
+  {
+    size_t res= LZ4F_compressFrame(dst, *dst_len, src, len, NULL);
+    if (LZ4F_isError(res))
+      DBUG_RETURN(1);
+    *dst_len= res;
+    DBUG_RETURN(0);
+  }
+#endif
+  }
+  DBUG_RETURN(1);
+}
+
+
+/*
+  Uncompress a buffer compressed by my_compress_buffer()
+
+  SYNOPSIS
+    my_uncompress_buffer()
+    algorithm	Algorithm the buffer was compressed with
+    src		Compressed data
+    len		Length of compressed data
+    dst		Buffer for the original data
+    dst_len	Length of the original data
+
+  RETURN
+    1   error, also when the original data is not exactly 'dst_len' bytes
+    0   ok
+*/
+
+my_bool my_uncompress_buffer(uint algorithm, const uchar *src, size_t len,
+                             uchar *dst, size_t dst_len)
+{
+  DBUG_ENTER("my_uncompress_buffer");
+
+  switch (algorithm) {
+  case NET_COMPRESSION_ZLIB:
+  {
+    uLongf tmp_len= (uLongf) dst_len;
+    DBUG_RETURN(uncompress(dst, &tmp_len, src, (uLong) len) != Z_OK ||
+                tmp_len != dst_len);
+  }
+#ifdef HAVE_ZSTD
+  case NET_COMPRESSION_ZSTD:
+  {
+    size_t res= ZSTD_decompress(dst, dst_len, src, len);
+    DBUG_RETURN(ZSTD_isError(res) || res != dst_len);
+  }
+#endif
+#ifdef HAVE_LZ4
+  case NET_COMPRESSION_LZ4:
+  {
+    LZ4F_dctx *dctx;
+    size_t in_pos= 0, out_pos= 0, res= 0;
+    if (LZ4F_isError(LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION)))
+      DBUG_RETURN(1);
+    while (!LZ4F_isError(res) && in_pos < len)
+    {
+      size_t src_size= len - in_pos, dst_size= dst_len - out_pos;
+      res= LZ4F_decompress(dctx, dst + out_pos, &dst_size,
+                           src + in_pos, &src_size, NULL);
+      if (!src_size && !dst_size)
+        break;                                  /* Corrupted data */
+      in_pos+= src_size;
+      out_pos+= dst_size;
+    }
+    LZ4F_freeDecompressionContext(dctx);
+    /* res is 0 when the frame is complete */
+    DBUG_RETURN(LZ4F_isError(res) || res || in_pos < len ||
+                out_pos != dst_len);
+  }
+#endif
+  }
+  DBUG_RETURN(1);
+}
+
+
 /*
   Internal representation of the frm blob is:
 
@@ -17,6 +17,7 @@
 
 
 #include "semisync_master.h"
+#include "semisync_master_ack_receiver.h"
 
 #define TIME_THOUSAND 1000
 #define TIME_MILLION  1000000
@@ -41,6 +42,8 @@ unsigned long long rpl_semi_sync_master_net_wait_num = 0;
 unsigned long rpl_semi_sync_master_clients          = 0;
 unsigned long long rpl_semi_sync_master_net_wait_time = 0;
 unsigned long long rpl_semi_sync_master_trx_wait_time = 0;
+unsigned long long
+  rpl_semi_sync_master_ack_rtt_histogram[ACK_RTT_HISTOGRAM_BUCKETS];
 char rpl_semi_sync_master_wait_no_slave = 1;
 
 
@@ -332,6 +335,8 @@ ReplSemiSyncMaster::ReplSemiSyncMaster()
     init_done_(false),
     reply_file_name_inited_(false),
     reply_file_pos_(0L),
+    waiters_front_(NULL),
+    waiters_rear_(NULL),
     wait_file_name_inited_(false),
     wait_file_pos_(0),
     master_enabled_(false),
@@ -361,8 +366,6 @@ int ReplSemiSyncMaster::initObject()
   /* Mutex initialization can only be done after MY_INIT(). */
   mysql_mutex_init(key_ss_mutex_LOCK_binlog_,
                    &LOCK_binlog_, MY_MUTEX_INIT_FAST);
-  mysql_cond_init(key_ss_cond_COND_binlog_send_,
-                  &COND_binlog_send_, NULL);
 
   if (rpl_semi_sync_master_enabled)
     result = enableMaster();
@@ -436,10 +439,7 @@ int ReplSemiSyncMaster::disableMaster()
 ReplSemiSyncMaster::~ReplSemiSyncMaster()
 {
   if (init_done_)
-  {
     mysql_mutex_destroy(&LOCK_binlog_);
-    mysql_cond_destroy(&COND_binlog_send_);
-  }
 
   delete active_tranxs_;
 }
@@ -454,22 +454,69 @@ void ReplSemiSyncMaster::unlock()
   mysql_mutex_unlock(&LOCK_binlog_);
 }
 
-void ReplSemiSyncMaster::cond_broadcast()
-{
-  mysql_cond_broadcast(&COND_binlog_send_);
-}
-
-int ReplSemiSyncMaster::cond_timewait(struct timespec *wait_time)
+int ReplSemiSyncMaster::cond_timewait(SemiSyncWaiter *waiter,
+                                      struct timespec *wait_time)
 {
   const char *kWho = "ReplSemiSyncMaster::cond_timewait()";
   int wait_res;
 
   function_enter(kWho);
-  wait_res= mysql_cond_timedwait(&COND_binlog_send_,
+  wait_res= mysql_cond_timedwait(&waiter->cond_,
                                  &LOCK_binlog_, wait_time);
   return function_exit(kWho, wait_res);
 }
 
+void ReplSemiSyncMaster::add_waiter(SemiSyncWaiter *waiter)
+{
+  SemiSyncWaiter *prev= waiters_rear_;
+
+  /* Transactions mostly commit in binlog order, search from the rear. */
+  while (prev && ActiveTranx::compare(prev->log_name_, prev->log_pos_,
+                                      waiter->log_name_, waiter->log_pos_) > 0)
+    prev= prev->prev_;
+
+  waiter->prev_= prev;
+  waiter->next_= prev ? prev->next_ : waiters_front_;
+  if (waiter->next_)
+    waiter->next_->prev_= waiter;
+  else
+    waiters_rear_= waiter;
+  if (prev)
+    prev->next_= waiter;
+  else
+    waiters_front_= waiter;
+  waiter->waiting_= true;
+}
+
+void ReplSemiSyncMaster::remove_waiter(SemiSyncWaiter *waiter)
+{
+  if (waiter->prev_)
+    waiter->prev_->next_= waiter->next_;
+  else
+    waiters_front_= waiter->next_;
+  if (waiter->next_)
+    waiter->next_->prev_= waiter->prev_;
+  else
+    waiters_rear_= waiter->prev_;
+  waiter->prev_= waiter->next_= NULL;
+  waiter->waiting_= false;
+}
+
+void ReplSemiSyncMaster::signal_waiters(const char *log_file_name,
+                                        my_off_t log_file_pos)
+{
+  while (waiters_front_ &&
+         (!log_file_name ||
+          ActiveTranx::compare(waiters_front_->log_name_,
+                               waiters_front_->log_pos_,
+                               log_file_name, log_file_pos) <= 0))
+  {
+    SemiSyncWaiter *waiter= waiters_front_;
+    remove_waiter(waiter);
+    mysql_cond_signal(&waiter->cond_);
+  }
+}
+
 void ReplSemiSyncMaster::add_slave()
 {
   lock();
@@ -507,7 +554,6 @@ int ReplSemiSyncMaster::reportReplyBinlog(uint32 server_id,
 {
   const char *kWho = "ReplSemiSyncMaster::reportReplyBinlog";
   int   cmp;
-  bool  can_release_threads = false;
   bool  need_copy_send_pos = true;
   LOG_INFO linfo;
   char *log_name;
@@ -628,34 +674,34 @@ int ReplSemiSyncMaster::reportReplyBinlog(uint32 server_id,
     }
   }
 
-  if (rpl_semi_sync_master_wait_sessions > 0)
+  if (waiters_front_ &&
+      ActiveTranx::compare(reply_file_name_, reply_file_pos_,
+                           waiters_front_->log_name_,
+                           waiters_front_->log_pos_) >= 0)
   {
-    /* Let us check if some of the waiting threads doing a trx
-     * commit can now proceed.
+    /* Some of the waiting threads doing a trx commit can now proceed:
+     * let us wake up the threads waiting for positions up to the reply.
      */
-    cmp = ActiveTranx::compare(reply_file_name_, reply_file_pos_,
-                               wait_file_name_, wait_file_pos_);
-    if (cmp >= 0)
+    if (trace_level_ & kTraceDetail)
+      sql_print_information("%s: signal threads waiting up to (%s, %lu).",
+                            kWho, reply_file_name_,
+                            (unsigned long)reply_file_pos_);
+
+    signal_waiters(reply_file_name_, reply_file_pos_);
+
+    /* The smallest position that is still waited for. */
+    if (waiters_front_)
     {
-      /* Yes, at least one waiting thread can now proceed:
-       * let us release all waiting threads with a broadcast
-       */
-      can_release_threads = true;
-      wait_file_name_inited_ = false;
+      strcpy(wait_file_name_, waiters_front_->log_name_);
+      wait_file_pos_ = waiters_front_->log_pos_;
     }
+    else
+      wait_file_name_inited_ = false;
   }
 
  l_end:
   unlock();
 
-  if (can_release_threads)
-  {
-    if (trace_level_ & kTraceDetail)
-      sql_print_information("%s: signal all waiting threads.", kWho);
-
-    cond_broadcast();
-  }
-
   return function_exit(kWho, 0);
 }
 
@@ -673,14 +719,21 @@ int ReplSemiSyncMaster::commitTrx(const char* trx_wait_binlog_name,
     int wait_result;
     PSI_stage_info old_stage;
     bool first_loop= true;
+    SemiSyncWaiter waiter;
 
     set_timespec(start_ts, 0);
 
+    waiter.log_name_= trx_wait_binlog_name;
+    waiter.log_pos_= trx_wait_binlog_pos;
+    waiter.waiting_= false;
+    waiter.prev_= waiter.next_= NULL;
+    mysql_cond_init(key_ss_cond_COND_binlog_send_, &waiter.cond_, NULL);
+
     /* Acquire the mutex. */
     lock();
 
     /* This must be called after acquired the lock */
-    THD_ENTER_COND(NULL, &COND_binlog_send_, &LOCK_binlog_,
+    THD_ENTER_COND(NULL, &waiter.cond_, &LOCK_binlog_,
                    & stage_waiting_for_semi_sync_ack_from_slave,
                    & old_stage);
 
@@ -777,7 +830,11 @@ int ReplSemiSyncMaster::commitTrx(const char* trx_wait_binlog_name,
                               kWho, wait_timeout_,
                               wait_file_name_, (unsigned long)wait_file_pos_);
       
-      wait_result = cond_timewait(&abstime);
+      if (!waiter.waiting_)
+        add_waiter(&waiter);
+      wait_result = cond_timewait(&waiter, &abstime);
+      if (waiter.waiting_)
+        remove_waiter(&waiter);
       rpl_semi_sync_master_wait_sessions--;
       
       if (wait_result != 0)
@@ -834,6 +891,7 @@ int ReplSemiSyncMaster::commitTrx(const char* trx_wait_binlog_name,
     /* The lock held will be released by thd_exit_cond, so no need to
        call unlock() here */
     THD_EXIT_COND(NULL, & old_stage);
+    mysql_cond_destroy(&waiter.cond_);
   }
 
   return function_exit(kWho, 0);
@@ -875,7 +933,7 @@ int ReplSemiSyncMaster::switch_off()
   wait_file_name_inited_   = false;
   reply_file_name_inited_  = false;
   sql_print_information("Semi-sync replication switched OFF.");
-  cond_broadcast();                            /* wake up all waiting threads */
+  signal_waiters(NULL, 0);                     /* wake up all waiting threads */
 
   return function_exit(kWho, result);
 }
@@ -1139,12 +1197,12 @@ int ReplSemiSyncMaster::readSlaveReply(NET *net, uint32 server_id,
                                        const char *event_buf)
 {
   const char *kWho = "ReplSemiSyncMaster::readSlaveReply";
-  const unsigned char *packet;
   char     log_file_name[FN_REFLEN];
   my_off_t log_file_pos;
-  ulong    log_file_len = 0;
   ulong    packet_len;
   int      result = -1;
+  bool     ack_receiver_reads;
+  ulonglong request_time;
 
   struct timespec start_ts= { 0, 0 };
   ulong trc_level = trace_level_;
@@ -1159,8 +1217,12 @@ int ReplSemiSyncMaster::readSlaveReply(NET *net, uint32 server_id,
     goto l_end;
   }
 
+  /* The ACK receiver thread reads the reply if it polls the slave. */
+  ack_receiver_reads = ack_receiver.request_reply(net);
+
   if (trc_level & kTraceNetWait)
     set_timespec(start_ts, 0);
+  request_time = my_micro_time();
 
   /* We flush to make sure that the current event is sent to the network,
    * instead of being buffered in the TCP/IP stack.
@@ -1172,6 +1234,16 @@ int ReplSemiSyncMaster::readSlaveReply(NET *net, uint32 server_id,
     goto l_end;
   }
 
+  if (ack_receiver_reads)
+  {
+    /* The slave numbers the reply 0 and expects the events after it to be
+     * numbered from 1, as if we had read the reply here.
+     */
+    net->pkt_nr = net->compress_pkt_nr = 1;
+    result = 0;
+    goto l_end;
+  }
+
   net_clear(net, 0);
   if (trc_level & kTraceDetail)
     sql_print_information("%s: Wait for replica's reply", kWho);
@@ -1199,42 +1271,73 @@ int ReplSemiSyncMaster::readSlaveReply(NET *net, uint32 server_id,
     }
   }
 
-  if (packet_len == packet_error || packet_len < REPLY_BINLOG_NAME_OFFSET)
+  if (packet_len == packet_error)
   {
-    if (packet_len == packet_error)
-      sql_print_error("Read semi-sync reply network error: %s (errno: %d)",
-                      net->last_error, net->last_errno);
-    else
-      sql_print_error("Read semi-sync reply length error: %s (errno: %d)",
-                      net->last_error, net->last_errno);
+    sql_print_error("Read semi-sync reply network error: %s (errno: %d)",
+                    net->last_error, net->last_errno);
     goto l_end;
   }
 
-  packet = net->read_pos;
+  if (parseSlaveReply(net->read_pos, packet_len,
+                      log_file_name, &log_file_pos))
+    goto l_end;
+
+  countAckRoundTrip(my_micro_time() - request_time);
+
+  if (trc_level & kTraceDetail)
+    sql_print_information("%s: Got reply (%s, %lu)",
+                          kWho, log_file_name, (ulong)log_file_pos);
+
+  result = reportReplyBinlog(server_id, log_file_name, log_file_pos);
+
+ l_end:
+  return function_exit(kWho, result);
+}
+
+
+int ReplSemiSyncMaster::parseSlaveReply(const unsigned char *packet,
+                                        ulong packet_len,
+                                        char *log_file_name,
+                                        my_off_t *log_file_pos)
+{
+  ulong log_file_len;
+
+  if (packet_len < REPLY_BINLOG_NAME_OFFSET)
+  {
+    sql_print_error("Read semi-sync reply length error: packet length %lu",
+                    packet_len);
+    return -1;
+  }
+
   if (packet[REPLY_MAGIC_NUM_OFFSET] != ReplSemiSyncMaster::kPacketMagicNum)
   {
     sql_print_error("Read semi-sync reply magic number error");
-    goto l_end;
+    return -1;
   }
 
-  log_file_pos = uint8korr(packet + REPLY_BINLOG_POS_OFFSET);
+  *log_file_pos = uint8korr(packet + REPLY_BINLOG_POS_OFFSET);
   log_file_len = packet_len - REPLY_BINLOG_NAME_OFFSET;
   if (log_file_len >= FN_REFLEN)
   {
     sql_print_error("Read semi-sync reply binlog file length too large");
-    goto l_end;
+    return -1;
   }
   strncpy(log_file_name, (const char*)packet + REPLY_BINLOG_NAME_OFFSET, log_file_len);
   log_file_name[log_file_len] = 0;
 
-  if (trc_level & kTraceDetail)
-    sql_print_information("%s: Got reply (%s, %lu)",
-                          kWho, log_file_name, (ulong)log_file_pos);
-
-  result = reportReplyBinlog(server_id, log_file_name, log_file_pos);
+  return 0;
+}
 
- l_end:
-  return function_exit(kWho, result);
+void ReplSemiSyncMaster::countAckRoundTrip(ulonglong usecs)
+{
+  uint bucket = 0;
+
+  /* Buckets of 100us, 1ms, 10ms, 100ms, 1s and more. */
+  for (ulonglong limit = 100;
+       bucket < ACK_RTT_HISTOGRAM_BUCKETS - 1 && usecs >= limit;
+       limit *= 10)
+    bucket++;
+  rpl_semi_sync_master_ack_rtt_histogram[bucket]++;
 }
 
 
@@ -1264,6 +1367,8 @@ int ReplSemiSyncMaster::resetMaster()
   rpl_semi_sync_master_trx_wait_time = 0;
   rpl_semi_sync_master_net_wait_num = 0;
   rpl_semi_sync_master_net_wait_time = 0;
+  memset(rpl_semi_sync_master_ack_rtt_histogram, 0,
+         sizeof(rpl_semi_sync_master_ack_rtt_histogram));
 
   unlock();
 
@@ -365,6 +365,19 @@ public:
 
 };
 
+/**
+   A session waiting in commitTrx() for the reply to the ending position of
+   its transaction. The waiters are kept in a list sorted by the position, so
+   that a reply wakes up only the sessions whose transactions it covers.
+*/
+struct SemiSyncWaiter {
+  const char     *log_name_;
+  my_off_t        log_pos_;
+  mysql_cond_t    cond_;
+  bool            waiting_;                  /* the waiter is in the list */
+  SemiSyncWaiter *prev_, *next_;
+};
+
 /**
    The extension class for the master of semi-synchronous replication
 */
@@ -377,13 +390,8 @@ class ReplSemiSyncMaster
   /* True when initObject has been called */
   bool init_done_;
 
-  /* This cond variable is signaled when enough binlog has been sent to slave,
-   * so that a waiting trx can return the 'ok' to the client for a commit.
-   */
-  mysql_cond_t  COND_binlog_send_;
-
-  /* Mutex that protects the following state variables and the active
-   * transaction list.
+  /* Mutex that protects the following state variables, the active
+   * transaction list and the list of waiting sessions.
    * Under no cirumstances we can acquire mysql_bin_log.LOCK_log if we are
    * already holding LOCK_binlog_ because it can cause deadlocks.
    */
@@ -398,6 +406,11 @@ class ReplSemiSyncMaster
   /* The position in that file up to which we have the reply from any slaves. */
   my_off_t        reply_file_pos_;
 
+  /* The sessions waiting in commitTrx(), sorted by the wait position.  The
+   * waiter of each session is signaled when the position is replied to.
+   */
+  SemiSyncWaiter *waiters_front_, *waiters_rear_;
+
   /* This is set to true when we know the 'smallest' wait position. */
   bool            wait_file_name_inited_;
 
@@ -436,8 +449,18 @@ class ReplSemiSyncMaster
   MYSQL_BIN_LOG *mysql_bin_log_;
   void lock();
   void unlock();
-  void cond_broadcast();
-  int  cond_timewait(struct timespec *wait_time);
+  int  cond_timewait(SemiSyncWaiter *waiter, struct timespec *wait_time);
+
+  /* Add a session to the list of waiting sessions. */
+  void add_waiter(SemiSyncWaiter *waiter);
+
+  /* Remove a session from the list of waiting sessions. */
+  void remove_waiter(SemiSyncWaiter *waiter);
+
+  /* Wake up the waiting sessions up to(inclusive) the specified position,
+   * or all of them if log_file_name is NULL.
+   */
+  void signal_waiters(const char *log_file_name, my_off_t log_file_pos);
 
   /* Is semi-sync replication on? */
   bool is_on() {
@@ -588,6 +611,28 @@ class ReplSemiSyncMaster
    */
   int readSlaveReply(NET *net, uint32 server_id, const char *event_buf);
 
+  /* Get the binlog position from a reply packet of the slave.
+   *
+   * Input:
+   *  packet        - (IN)  the reply packet
+   *  packet_len    - (IN)  length of the reply packet
+   *  log_file_name - (OUT) binlog file name, FN_REFLEN bytes
+   *  log_file_pos  - (OUT) binlog file offset
+   *
+   * Return:
+   *  0: success;  non-zero: error
+   */
+  static int parseSlaveReply(const unsigned char *packet, ulong packet_len,
+                             char *log_file_name, my_off_t *log_file_pos);
+
+  /* Count the round trip time of a reply in the ACK latency histogram.
+   *
+   * Input:
+   *  usecs         - (IN)  time from the request to the reply, in
+   *                        microseconds
+   */
+  static void countAckRoundTrip(ulonglong usecs);
+
   /* In semi-sync replication, this method simulates the reception of
    * an reply and executes reportReplyBinlog directly when a transaction
    * is skipped in the master.
@@ -638,6 +683,15 @@ extern unsigned long long rpl_semi_sync_master_trx_wait_num;
 extern unsigned long long rpl_semi_sync_master_net_wait_time;
 extern unsigned long long rpl_semi_sync_master_trx_wait_time;
 
+/* Histogram of the ACK round trip times: under 100us, 1ms, 10ms, 100ms, 1s
+ * and the rest.
+ */
+#define ACK_RTT_HISTOGRAM_BUCKETS 6
+extern unsigned long long
+  rpl_semi_sync_master_ack_rtt_histogram[ACK_RTT_HISTOGRAM_BUCKETS];
+
+extern ReplSemiSyncMaster repl_semisync;
+
 /*
   This indicates whether we should keep waiting if no semi-sync slave
   is available.
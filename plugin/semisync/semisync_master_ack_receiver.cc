@@ -0,0 +1,382 @@
+/* Copyright (c) 2013, Facebook, Inc. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+
+#include "semisync_master_ack_receiver.h"
+#include "sql_class.h"                          // THD
+
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
+
+#if defined(HAVE_EPOLL) && defined(HAVE_SYS_EPOLL_H)
+#define HAVE_ACK_RECEIVER
+#endif
+
+/* How long the thread waits for replies before it checks whether it must
+ * stop, in milliseconds.
+ */
+#define ACK_RECEIVER_POLL_TIMEOUT 100
+
+/* How many sockets are read in one round. */
+#define ACK_RECEIVER_MAX_EVENTS 64
+
+AckReceiver ack_receiver;
+
+#ifdef HAVE_ACK_RECEIVER
+extern "C" {
+static void *ack_receiver_thread(void *arg)
+{
+  my_thread_init();
+  ((AckReceiver *) arg)->run();
+  my_thread_end();
+  pthread_exit(0);
+  return NULL;
+}
+}
+#endif /* HAVE_ACK_RECEIVER */
+
+AckReceiver::AckReceiver()
+  : status_(ST_DOWN),
+    epoll_fd_(-1)
+{
+  memset(&slaves_, 0, sizeof(slaves_));
+}
+
+AckReceiver::~AckReceiver()
+{
+  if (slaves_.buffer)
+  {
+    delete_dynamic(&slaves_);
+    mysql_mutex_destroy(&LOCK_ack_receiver_);
+    mysql_cond_destroy(&COND_ack_receiver_);
+  }
+}
+
+int AckReceiver::start()
+{
+  const char *kWho = "AckReceiver::start";
+
+  function_enter(kWho);
+
+  if (!slaves_.buffer)
+  {
+    mysql_mutex_init(key_ss_mutex_LOCK_ack_receiver_,
+                     &LOCK_ack_receiver_, MY_MUTEX_INIT_FAST);
+    mysql_cond_init(key_ss_cond_COND_ack_receiver_,
+                    &COND_ack_receiver_, NULL);
+    if (my_init_dynamic_array(&slaves_, sizeof(AckSlave), 16, 16))
+      return function_exit(kWho, 1);
+  }
+
+#ifdef HAVE_ACK_RECEIVER
+  pthread_attr_t attr;
+
+  if ((epoll_fd_= epoll_create(ACK_RECEIVER_MAX_EVENTS)) < 0)
+  {
+    sql_print_error("Semi-sync master failed to create the epoll instance "
+                    "of the ACK receiver (errno: %d)", errno);
+    return function_exit(kWho, 1);
+  }
+
+  status_= ST_UP;
+  if (pthread_attr_init(&attr) ||
+      pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE) ||
+      mysql_thread_create(key_ss_thread_ack_receiver, &thread_, &attr,
+                          ack_receiver_thread, this))
+  {
+    sql_print_error("Semi-sync master failed to create the ACK receiver "
+                    "thread (errno: %d)", errno);
+    status_= ST_DOWN;
+    close(epoll_fd_);
+    epoll_fd_= -1;
+    pthread_attr_destroy(&attr);
+    return function_exit(kWho, 1);
+  }
+  pthread_attr_destroy(&attr);
+#endif /* HAVE_ACK_RECEIVER */
+
+  return function_exit(kWho, 0);
+}
+
+void AckReceiver::stop()
+{
+  const char *kWho = "AckReceiver::stop";
+
+  function_enter(kWho);
+
+  if (status_ == ST_UP)
+  {
+    mysql_mutex_lock(&LOCK_ack_receiver_);
+    status_= ST_STOPPING;
+    mysql_cond_broadcast(&COND_ack_receiver_);
+    mysql_mutex_unlock(&LOCK_ack_receiver_);
+
+    pthread_join(thread_, NULL);
+
+    mysql_mutex_lock(&LOCK_ack_receiver_);
+    status_= ST_DOWN;
+    close(epoll_fd_);
+    epoll_fd_= -1;
+    mysql_mutex_unlock(&LOCK_ack_receiver_);
+  }
+
+  function_exit(kWho, 0);
+}
+
+AckSlave *AckReceiver::find_slave(NET *net)
+{
+  for (uint i= 0; i < slaves_.elements; i++)
+  {
+    AckSlave *slave= dynamic_element(&slaves_, i, AckSlave *);
+    if (slave->net_ == net)
+      return slave;
+  }
+  return NULL;
+}
+
+AckSlave *AckReceiver::find_slave(my_socket fd)
+{
+  for (uint i= 0; i < slaves_.elements; i++)
+  {
+    AckSlave *slave= dynamic_element(&slaves_, i, AckSlave *);
+    if (slave->fd_ == fd && !slave->broken_)
+      return slave;
+  }
+  return NULL;
+}
+
+void AckReceiver::remove_from_poll(AckSlave *slave)
+{
+#ifdef HAVE_ACK_RECEIVER
+  struct epoll_event event;
+
+  /* A non-NULL event is needed by kernels before 2.6.9. */
+  memset(&event, 0, sizeof(event));
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, slave->fd_, &event);
+#endif
+  slave->broken_= true;
+}
+
+void AckReceiver::add_slave(NET *net, uint32 server_id)
+{
+  const char *kWho = "AckReceiver::add_slave";
+  AckSlave slave;
+
+  function_enter(kWho);
+
+  /* The replies are compressed with the history of the connection, only
+   * the dump thread can decompress them.
+   */
+  if (net->compress && net->compress_algorithm != NET_COMPRESSION_ZLIB)
+  {
+    function_exit(kWho, 0);
+    return;
+  }
+
+  slave.net_= net;
+  slave.server_id_= server_id;
+  slave.fd_= vio_fd(net->vio);
+  slave.request_time_= 0;
+  slave.broken_= false;
+
+  mysql_mutex_lock(&LOCK_ack_receiver_);
+  if (status_ == ST_UP && !insert_dynamic(&slaves_, &slave))
+  {
+#ifdef HAVE_ACK_RECEIVER
+    struct epoll_event event;
+
+    memset(&event, 0, sizeof(event));
+    event.events= EPOLLIN;
+    event.data.fd= slave.fd_;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, slave.fd_, &event))
+    {
+      sql_print_warning("Semi-sync master failed to poll the replies of "
+                        "slave (server_id: %d) (errno: %d), the binlog dump "
+                        "thread reads them", server_id, errno);
+      dynamic_element(&slaves_, slaves_.elements - 1, AckSlave *)->broken_=
+        true;
+    }
+#endif
+    if (slaves_.elements == 1)
+      mysql_cond_broadcast(&COND_ack_receiver_);
+  }
+  mysql_mutex_unlock(&LOCK_ack_receiver_);
+
+  function_exit(kWho, 0);
+}
+
+void AckReceiver::remove_slave(NET *net)
+{
+  const char *kWho = "AckReceiver::remove_slave";
+
+  function_enter(kWho);
+
+  mysql_mutex_lock(&LOCK_ack_receiver_);
+  for (uint i= 0; i < slaves_.elements; i++)
+  {
+    AckSlave *slave= dynamic_element(&slaves_, i, AckSlave *);
+    if (slave->net_ == net)
+    {
+      if (!slave->broken_ && status_ != ST_DOWN)
+        remove_from_poll(slave);
+      delete_dynamic_element(&slaves_, i);
+      break;
+    }
+  }
+  mysql_mutex_unlock(&LOCK_ack_receiver_);
+
+  function_exit(kWho, 0);
+}
+
+bool AckReceiver::request_reply(NET *net)
+{
+  bool result= false;
+
+  mysql_mutex_lock(&LOCK_ack_receiver_);
+  if (status_ == ST_UP)
+  {
+    AckSlave *slave= find_slave(net);
+    if (slave && !slave->broken_)
+    {
+      if (!slave->request_time_)
+        slave->request_time_= my_micro_time();
+      result= true;
+    }
+  }
+  mysql_mutex_unlock(&LOCK_ack_receiver_);
+
+  return result;
+}
+
+void AckReceiver::run()
+{
+#ifdef HAVE_ACK_RECEIVER
+  const char *kWho = "AckReceiver::run";
+  struct epoll_event events[ACK_RECEIVER_MAX_EVENTS];
+  NET net;
+  THD *thd;
+
+  function_enter(kWho);
+
+  thd= new THD;
+  thd->thread_stack= (char*) &thd;
+  thd->store_globals();
+  thd->security_ctx->skip_grants();
+
+  my_net_init(&net, NULL);
+
+  sql_print_information("Starting ack receiver thread");
+
+  mysql_mutex_lock(&LOCK_ack_receiver_);
+  while (status_ == ST_UP)
+  {
+    char     log_file_name[FN_REFLEN];
+    char     reply_file_name[FN_REFLEN];
+    my_off_t log_file_pos;
+    my_off_t reply_file_pos= 0;
+    uint32   reply_server_id= 0;
+    int      count;
+
+    if (!slaves_.elements)
+    {
+      mysql_cond_wait(&COND_ack_receiver_, &LOCK_ack_receiver_);
+      continue;
+    }
+
+    mysql_mutex_unlock(&LOCK_ack_receiver_);
+    count= epoll_wait(epoll_fd_, events, ACK_RECEIVER_MAX_EVENTS,
+                      ACK_RECEIVER_POLL_TIMEOUT);
+    mysql_mutex_lock(&LOCK_ack_receiver_);
+
+    /* Read the replies of all slaves, and report the largest position. */
+    reply_file_name[0]= 0;
+    for (int i= 0; i < count && status_ == ST_UP; i++)
+    {
+      AckSlave *slave= find_slave((my_socket) events[i].data.fd);
+
+      /* The slave was removed while we were waiting. */
+      if (!slave)
+        continue;
+
+      net.vio= slave->net_->vio;
+      net.compress= slave->net_->compress;
+      do
+      {
+        ulong packet_len;
+
+        net_clear(&net, 0);
+        net.error= 0;
+        packet_len= my_net_read(&net);
+        if (packet_len == packet_error)
+        {
+          /* Mostly the slave disconnected, the dump thread will notice. */
+          if (trace_level_ & kTraceGeneral)
+            sql_print_information("%s: Read semi-sync reply network error "
+                                  "from slave (server_id: %d): %s (errno: %d)",
+                                  kWho, slave->server_id_, net.last_error,
+                                  net.last_errno);
+          remove_from_poll(slave);
+          break;
+        }
+        if (ReplSemiSyncMaster::parseSlaveReply(net.read_pos, packet_len,
+                                                log_file_name, &log_file_pos))
+          continue;
+
+        if (slave->request_time_)
+        {
+          ulonglong now= my_micro_time();
+          ReplSemiSyncMaster::countAckRoundTrip(now > slave->request_time_ ?
+                                                now - slave->request_time_ :
+                                                0);
+          slave->request_time_= 0;
+        }
+
+        if (trace_level_ & kTraceDetail)
+          sql_print_information("%s: Got reply (%s, %lu) from slave "
+                                "(server_id: %d)", kWho, log_file_name,
+                                (ulong) log_file_pos, slave->server_id_);
+
+        if (!reply_file_name[0] ||
+            ActiveTranx::compare(log_file_name, log_file_pos,
+                                 reply_file_name, reply_file_pos) > 0)
+        {
+          strcpy(reply_file_name, log_file_name);
+          reply_file_pos= log_file_pos;
+          reply_server_id= slave->server_id_;
+        }
+      } while (net.vio->has_data(net.vio));
+    }
+
+    if (reply_file_name[0])
+    {
+      mysql_mutex_unlock(&LOCK_ack_receiver_);
+      repl_semisync.reportReplyBinlog(reply_server_id, reply_file_name,
+                                      reply_file_pos);
+      mysql_mutex_lock(&LOCK_ack_receiver_);
+    }
+  }
+  mysql_mutex_unlock(&LOCK_ack_receiver_);
+
+  sql_print_information("Stopping ack receiver thread");
+
+  net.vio= NULL;
+  net_end(&net);
+  delete thd;
+  my_pthread_setspecific_ptr(THR_THD, NULL);
+
+  function_exit(kWho, 0);
+#endif /* HAVE_ACK_RECEIVER */
+}
@@ -0,0 +1,119 @@
+/* Copyright (c) 2013, Facebook, Inc. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+
+#ifndef SEMISYNC_MASTER_ACK_RECEIVER_H
+#define SEMISYNC_MASTER_ACK_RECEIVER_H
+
+#include "semisync_master.h"
+#include "violite.h"
+
+#ifdef HAVE_PSI_INTERFACE
+extern PSI_mutex_key key_ss_mutex_LOCK_ack_receiver_;
+extern PSI_cond_key key_ss_cond_COND_ack_receiver_;
+extern PSI_thread_key key_ss_thread_ack_receiver;
+#endif
+
+/**
+   A semi-sync slave whose replies are read by the ACK receiver thread.
+*/
+struct AckSlave {
+  NET      *net_;                  /* the network of the binlog dump thread */
+  uint32    server_id_;
+  my_socket fd_;
+  /* When the oldest request for a reply that was not answered yet was sent,
+   * in microseconds; 0 if there is none.
+   */
+  ulonglong request_time_;
+  /* Reading a reply failed, the dump thread reads the replies itself. */
+  bool      broken_;
+};
+
+/**
+   The ACK receiver thread.
+
+   Without it every binlog dump thread of a semi-sync slave reads the
+   slave's reply right after sending an event that requests one, so the
+   events that follow are not sent before the reply arrives. The ACK
+   receiver thread polls the sockets of all semi-sync slaves with epoll and
+   reads their replies instead, while the dump threads keep sending. The
+   replies that arrive together are reported to ReplSemiSyncMaster as one
+   reply, with the largest binlog position among them.
+
+   Slaves whose connections use streaming compression, where the replies
+   can only be decompressed by the dump thread, and all slaves on platforms
+   without epoll are served by the dump threads as before.
+*/
+class AckReceiver
+  :public Trace {
+public:
+  AckReceiver();
+  ~AckReceiver();
+
+  /* Start the thread, called when the master plugin is initialized.
+   *
+   * Return:
+   *  0: success;  non-zero: error
+   */
+  int start();
+
+  /* Stop the thread, called when the master plugin is uninstalled. */
+  void stop();
+
+  /* Let the thread read the replies of a slave, called by the binlog dump
+   * thread when the dump starts.
+   */
+  void add_slave(NET *net, uint32 server_id);
+
+  /* Stop reading the replies of a slave, called by the binlog dump thread
+   * when the dump ends.
+   */
+  void remove_slave(NET *net);
+
+  /* Called by the binlog dump thread before it sends an event that requests
+   * a reply.
+   *
+   * Return:
+   *  true:  the thread reads the reply
+   *  false: the dump thread must read the reply itself
+   */
+  bool request_reply(NET *net);
+
+  /* The body of the thread. */
+  void run();
+
+private:
+  enum status { ST_DOWN, ST_UP, ST_STOPPING };
+
+  AckSlave *find_slave(NET *net);
+  AckSlave *find_slave(my_socket fd);
+  void remove_from_poll(AckSlave *slave);
+
+  /* Protects the members below.  The thread only releases it to wait
+   * for replies, so slaves are not removed while their replies are read.
+   */
+  mysql_mutex_t   LOCK_ack_receiver_;
+  /* Signaled when the first slave is added or the thread must stop. */
+  mysql_cond_t    COND_ack_receiver_;
+
+  status          status_;
+  pthread_t       thread_;
+  int             epoll_fd_;
+  DYNAMIC_ARRAY   slaves_;                  /* AckSlave of each slave */
+};
+
+extern AckReceiver ack_receiver;
+
+#endif /* SEMISYNC_MASTER_ACK_RECEIVER_H */
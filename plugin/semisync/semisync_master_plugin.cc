@@ -17,6 +17,7 @@
 
 
 #include "semisync_master.h"
+#include "semisync_master_ack_receiver.h"
 #include "sql_class.h"                          // THD
 
 ReplSemiSyncMaster repl_semisync;
@@ -82,6 +83,9 @@ int repl_semi_binlog_dump_start(Binlog_transmit_param *param,
   /* One more semi-sync slave */
   repl_semisync.add_slave();
 
+  /* Let the ACK receiver thread read the replies of the slave */
+  ack_receiver.add_slave(&current_thd->net, param->server_id);
+
   /*
     Let's assume this semi-sync slave has already received all
     binlog events before the filename and position it requests.
@@ -102,6 +106,8 @@ int repl_semi_binlog_dump_end(Binlog_transmit_param *param)
   sql_print_information("Stop %s binlog_dump to slave (server_id: %d)",
                         "semi-sync",
                         param->server_id);
+  ack_receiver.remove_slave(&current_thd->net);
+
   /* One less semi-sync slave */
   repl_semisync.remove_slave();
   return 0;
@@ -230,6 +236,7 @@ static void fix_rpl_semi_sync_master_trace_level(MYSQL_THD thd,
 {
   *(unsigned long *)ptr= *(unsigned long *)val;
   repl_semisync.setTraceLevel(rpl_semi_sync_master_trace_level);
+  ack_receiver.trace_level_= rpl_semi_sync_master_trace_level;
   return;
 }
 
@@ -300,6 +307,11 @@ DEF_SHOW_FUNC(net_wait_num, SHOW_LONGLONG)
 DEF_SHOW_FUNC(avg_net_wait_time, SHOW_LONG)
 DEF_SHOW_FUNC(avg_trx_wait_time, SHOW_LONG)
 
+#define SHOW_ACK_RTT(name, bucket)                                      \
+  {"Rpl_semi_sync_master_ack_rtt_" name,                                \
+   (char*) &rpl_semi_sync_master_ack_rtt_histogram[bucket],             \
+   SHOW_LONGLONG}
+
 
 /* plugin status variables */
 static SHOW_VAR semi_sync_master_status_vars[]= {
@@ -345,22 +357,40 @@ static SHOW_VAR semi_sync_master_status_vars[]= {
   {"Rpl_semi_sync_master_net_avg_wait_time",
    (char*) &SHOW_FNAME(avg_net_wait_time),
    SHOW_FUNC},
+  SHOW_ACK_RTT("under_100us", 0),
+  SHOW_ACK_RTT("under_1ms", 1),
+  SHOW_ACK_RTT("under_10ms", 2),
+  SHOW_ACK_RTT("under_100ms", 3),
+  SHOW_ACK_RTT("under_1s", 4),
+  SHOW_ACK_RTT("over_1s", 5),
   {NULL, NULL, SHOW_LONG},
 };
 
 #ifdef HAVE_PSI_INTERFACE
 PSI_mutex_key key_ss_mutex_LOCK_binlog_;
 
+PSI_mutex_key key_ss_mutex_LOCK_ack_receiver_;
+
 static PSI_mutex_info all_semisync_mutexes[]=
 {
-  { &key_ss_mutex_LOCK_binlog_, "LOCK_binlog_", 0}
+  { &key_ss_mutex_LOCK_binlog_, "LOCK_binlog_", 0},
+  { &key_ss_mutex_LOCK_ack_receiver_, "LOCK_ack_receiver_", 0}
 };
 
 PSI_cond_key key_ss_cond_COND_binlog_send_;
+PSI_cond_key key_ss_cond_COND_ack_receiver_;
 
 static PSI_cond_info all_semisync_conds[]=
 {
-  { &key_ss_cond_COND_binlog_send_, "COND_binlog_send_", 0}
+  { &key_ss_cond_COND_binlog_send_, "COND_binlog_send_", 0},
+  { &key_ss_cond_COND_ack_receiver_, "COND_ack_receiver_", 0}
+};
+
+PSI_thread_key key_ss_thread_ack_receiver;
+
+static PSI_thread_info all_semisync_threads[]=
+{
+  { &key_ss_thread_ack_receiver, "Ack_receiver", PSI_FLAG_GLOBAL}
 };
 #endif /* HAVE_PSI_INTERFACE */
 
@@ -384,6 +414,9 @@ static void init_semisync_psi_keys(void)
   count= array_elements(all_semisync_conds);
   mysql_cond_register(category, all_semisync_conds, count);
 
+  count= array_elements(all_semisync_threads);
+  mysql_thread_register(category, all_semisync_threads, count);
+
   count= array_elements(all_semisync_stages);
   mysql_stage_register(category, all_semisync_stages, count);
 }
@@ -397,6 +430,9 @@ static int semi_sync_master_plugin_init(void *p)
 
   if (repl_semisync.initObject())
     return 1;
+  ack_receiver.trace_level_= rpl_semi_sync_master_trace_level;
+  if (ack_receiver.start())
+    return 1;
   if (register_trans_observer(&trans_observer, p))
     return 1;
   if (register_binlog_storage_observer(&storage_observer, p))
@@ -408,6 +444,8 @@ static int semi_sync_master_plugin_init(void *p)
 
 static int semi_sync_master_plugin_deinit(void *p)
 {
+  ack_receiver.stop();
+
   if (unregister_trans_observer(&trans_observer, p))
   {
     sql_print_error("unregister_trans_observer failed");
@@ -1215,6 +1215,7 @@ static const char *default_options[]=
   "multi-results", "multi-statements", "multi-queries", "secure-auth",
   "report-data-truncation", "plugin-dir", "default-auth",
   "bind-address", "ssl-crl", "ssl-crlpath", "enable-cleartext-plugin",
+  "compression-algorithm",
   NullS
 };
 enum option_id {
@@ -1227,6 +1228,7 @@ enum option_id {
   OPT_multi_results, OPT_multi_statements, OPT_multi_queries, OPT_secure_auth, 
   OPT_report_data_truncation, OPT_plugin_dir, OPT_default_auth,
   OPT_bind_address, OPT_ssl_crl, OPT_ssl_crlpath, OPT_enable_cleartext_plugin,
+  OPT_compression_algorithm,
   OPT_keep_this_one_last
 };
 
@@ -1238,6 +1240,13 @@ const char *sql_protocol_names_lib[] =
 TYPELIB sql_protocol_typelib = {array_elements(sql_protocol_names_lib)-1,"",
 				sql_protocol_names_lib, NULL};
 
+/* Names of enum_net_compression */
+const char *net_compression_algorithm_names[]=
+{ "zlib", "zstd", "lz4", NullS };
+TYPELIB net_compression_algorithm_typelib=
+{ array_elements(net_compression_algorithm_names)-1, "",
+  net_compression_algorithm_names, NULL };
+
 static int add_init_command(struct st_mysql_options *options, const char *cmd)
 {
   char *tmp;
@@ -1532,6 +1541,22 @@ void mysql_read_default_options(struct st_mysql_options *options,
           options->extension->enable_cleartext_plugin= 
             (!opt_arg || atoi(opt_arg) != 0) ? TRUE : FALSE;
           break;
+        case OPT_compression_algorithm:
+        {
+          int algorithm;
+          if (!opt_arg ||
+              (algorithm= find_type(opt_arg,
+                                    &net_compression_algorithm_typelib,
+                                    FIND_TYPE_BASIC)) <= 0)
+          {
+            fprintf(stderr, "Unknown compression algorithm: %s\n",
+                    opt_arg ? opt_arg : "");
+            exit(1);
+          }
+          ENSURE_EXTENSIONS_PRESENT(options);
+          options->extension->compression_algorithm= algorithm - 1;
+          break;
+        }
 
 	default:
 	  DBUG_PRINT("warning",("unknown option: %s",option[0]));
@@ -2824,6 +2849,25 @@ static my_bool prep_client_reply_packet(MCPVIO_EXT *mpvio,
   mysql->client_flag&= ~CLIENT_COMPRESS;
 #endif
 
+  /*
+    Ask for the compression algorithm of the options if the server has it,
+    zlib is used otherwise.
+  */
+  mysql->client_flag&= ~(CLIENT_COMPRESS_ZSTD | CLIENT_COMPRESS_LZ4);
+  if ((mysql->client_flag & CLIENT_COMPRESS) && mysql->options.extension)
+  {
+    switch (mysql->options.extension->compression_algorithm) {
+    case NET_COMPRESSION_ZSTD:
+      mysql->client_flag|= CAN_CLIENT_COMPRESS_ZSTD &
+                           mysql->server_capabilities;
+      break;
+    case NET_COMPRESSION_LZ4:
+      mysql->client_flag|= CAN_CLIENT_COMPRESS_LZ4 &
+                           mysql->server_capabilities;
+      break;
+    }
+  }
+
   if (mysql->client_flag & CLIENT_PROTOCOL_41)
   {
     /* 4.1 server and 4.1 client has a 32 byte option flag */
@@ -4627,7 +4671,7 @@ csm_prep_select_database(csm_context* ctx)
   DBUG_ENTER(__func__);
 
   if (mysql->client_flag & CLIENT_COMPRESS)      /* We will use compression */
-    net->compress=1;
+    my_net_set_compression(net, mysql->client_flag);
 
 #ifdef CHECK_LICENSE 
   if (check_license(mysql))
@@ -5663,6 +5707,17 @@ mysql_options(MYSQL *mysql,enum mysql_option option, const void *arg)
     mysql->options.compress= 1;			/* Remember for connect */
     mysql->options.client_flag|= CLIENT_COMPRESS;
     break;
+  case MYSQL_OPT_COMPRESSION_ALGORITHM:
+  {
+    int algorithm= find_type((const char *) arg,
+                             &net_compression_algorithm_typelib,
+                             FIND_TYPE_BASIC);
+    if (algorithm <= 0)
+      DBUG_RETURN(1);
+    ENSURE_EXTENSIONS_PRESENT(&mysql->options);
+    mysql->options.extension->compression_algorithm= algorithm - 1;
+    break;
+  }
   case MYSQL_OPT_NAMED_PIPE:			/* This option is depricated */
     mysql->options.protocol=MYSQL_PROTOCOL_PIPE; /* Force named pipe */
     break;
@@ -29,6 +29,7 @@
 #include "sql_show.h"
 #include "sql_parse.h"
 #include "rpl_mi.h"
+#include "binlog_tail_cache.h"
 #include <list>
 
 using std::max;
@@ -374,6 +375,17 @@ public:
   Group_cache group_cache;
 
 protected:
+  /**
+    Replace the events of the finalized cache with a
+    Transaction_payload_log_event that holds them compressed, see
+    binlog_trx_compression. A leading Gtid_log_event is kept, as
+    gtid_before_write_cache() may still rewrite it.
+
+    The cache is kept as it is when compressing it does not make it
+    smaller, or when it can't be compressed.
+  */
+  int compress(THD *thd);
+
   /*
     It truncates the cache to a certain position. This includes deleting the
     pending event.
@@ -1100,12 +1112,85 @@ binlog_cache_data::finalize(THD *thd, Log_event *end_event)
       DBUG_RETURN(error);
     if (int error= write_event(thd, end_event))
       DBUG_RETURN(error);
+    if (is_trx_cache() && thd->variables.binlog_trx_compression)
+      if (int error= compress(thd))
+        DBUG_RETURN(error);
     flags.finalized= true;
     DBUG_PRINT("debug", ("flags.finalized: %s", YESNO(flags.finalized)));
   }
   DBUG_RETURN(0);
 }
 
+int
+binlog_cache_data::compress(THD *thd)
+{
+  DBUG_ENTER("binlog_cache_data::compress");
+  my_off_t length= my_b_tell(&cache_log);
+  uint algorithm= (uint) opt_binlog_trx_compression_type;
+  uchar *events, *payload= NULL;
+  size_t payload_length;
+  uint header_length= 0;
+
+  /*
+    Transactions with several groups, whose GTIDs are written to the cache
+    later, and transactions that could not be sent to a slave in one event
+    are not compressed.
+  */
+  if (group_cache.get_n_groups() > 1 || length > slave_max_allowed_packet ||
+      !(events= (uchar *) my_malloc(length, MYF(0))))
+    DBUG_RETURN(0);
+
+  if (reinit_io_cache(&cache_log, READ_CACHE, 0, 0, 0) ||
+      my_b_read(&cache_log, events, length))
+    goto err;
+
+  if (length >= LOG_EVENT_MINIMAL_HEADER_LEN &&
+      (events[EVENT_TYPE_OFFSET] == GTID_LOG_EVENT ||
+       events[EVENT_TYPE_OFFSET] == ANONYMOUS_GTID_LOG_EVENT))
+    header_length= uint4korr(events + EVENT_LEN_OFFSET);
+
+  payload_length= my_compress_buffer_bound(algorithm, length - header_length);
+  if (payload_length &&
+      (payload= (uchar *) my_malloc(payload_length, MYF(0))) &&
+      !my_compress_buffer(algorithm, events + header_length,
+                          length - header_length, payload, &payload_length) &&
+      LOG_EVENT_HEADER_LEN + Transaction_payload_log_event::HEADER_LENGTH +
+      payload_length < length - header_length)
+  {
+    Transaction_payload_log_event payload_ev(thd, algorithm, payload,
+                                             (uint) payload_length,
+                                             (uint) (length - header_length));
+    payload= NULL;                              // Owned by payload_ev
+    if (reinit_io_cache(&cache_log, WRITE_CACHE, header_length, 0, 0))
+      goto err;
+    cache_log.end_of_file= saved_max_binlog_cache_size;
+    my_free(events);
+    if (payload_ev.write(&cache_log))
+      DBUG_RETURN(1);
+    my_atomic_add64((longlong*) &binlog_trx_compression_bytes_before,
+                    (longlong) (length - header_length));
+    my_atomic_add64((longlong*) &binlog_trx_compression_bytes_after,
+                    (longlong) payload_ev.data_written);
+    DBUG_PRINT("info", ("compressed %llu bytes into %lu",
+                        (ulonglong) (length - header_length),
+                        (ulong) payload_ev.data_written));
+    DBUG_RETURN(0);
+  }
+  my_free(payload);
+  my_free(events);
+
+  /* Continue writing after the uncompressed events */
+  if (reinit_io_cache(&cache_log, WRITE_CACHE, length, 0, 0))
+    DBUG_RETURN(1);
+  cache_log.end_of_file= saved_max_binlog_cache_size;
+  DBUG_RETURN(0);
+
+err:
+  my_free(payload);
+  my_free(events);
+  DBUG_RETURN(1);
+}
+
 /**
   Flush caches to the binary log.
 
@@ -2758,6 +2843,49 @@ MYSQL_BIN_LOG::read_gtids_from_binlog(const char *filename,
   DBUG_RETURN(ret);
 }
 
+int MYSQL_BIN_LOG::find_last_previous_gtid_set(
+  Gtid_set *previous_gtid_set, Previous_gtid_set_predicate predicate,
+  const void *arg)
+{
+  DBUG_ENTER("MYSQL_BIN_LOG::find_last_previous_gtid_set");
+  mysql_mutex_assert_owner(&LOCK_index);
+
+  /*
+    Invariant: the predicate holds for all binary logs before low and for
+    none from high on.
+  */
+  int low= 0, high= (int) previous_gtid_sets.size();
+  while (low < high)
+  {
+    int middle= low + (high - low) / 2;
+    const std::string &encoded= previous_gtid_sets[middle].second;
+
+    previous_gtid_set->clear();
+    if (previous_gtid_set->add_gtid_encoding((const uchar*) encoded.data(),
+                                             encoded.length()) !=
+        RETURN_STATUS_OK)
+    {
+      /* Do not start from a binary log we know nothing about. */
+      high= middle;
+      continue;
+    }
+    if (predicate(previous_gtid_set, arg))
+      low= middle + 1;
+    else
+      high= middle;
+  }
+  previous_gtid_set->clear();
+
+  DBUG_PRINT("info", ("last binary log: %d", low - 1));
+  DBUG_RETURN(low - 1);
+}
+
+static bool previous_gtid_set_is_subset(const Gtid_set *previous_gtid_set,
+                                        const void *gtid_set)
+{
+  return previous_gtid_set->is_subset((const Gtid_set*) gtid_set);
+}
+
 bool MYSQL_BIN_LOG::find_first_log_not_in_gtid_set(char *binlog_file_name,
                                                    const Gtid_set *gtid_set,
                                                    const char **errmsg)
@@ -2767,21 +2895,14 @@ bool MYSQL_BIN_LOG::find_first_log_not_in_gtid_set(char *binlog_file_name,
   Gtid_set previous_gtid_set(gtid_set->get_sid_map());
 
   mysql_mutex_lock(&LOCK_index);
-  std::map<std::string, std::string>::reverse_iterator rit;
-  for (rit = previous_gtid_set_map.rbegin();
-       rit != previous_gtid_set_map.rend(); ++rit)
+  int index= find_last_previous_gtid_set(&previous_gtid_set,
+                                         previous_gtid_set_is_subset,
+                                         gtid_set);
+  if (index >= 0)
   {
-
-    previous_gtid_set.add_gtid_encoding((const uchar*)rit->second.c_str(),
-                                        rit->second.length());
-
-    if (previous_gtid_set.is_subset(gtid_set))
-    {
-      strcpy(binlog_file_name, rit->first.c_str());
-      mysql_mutex_unlock(&LOCK_index);
-      DBUG_RETURN(false);
-    }
-    previous_gtid_set.clear();
+    strcpy(binlog_file_name, previous_gtid_sets[index].first.c_str());
+    mysql_mutex_unlock(&LOCK_index);
+    DBUG_RETURN(false);
   }
 
   *errmsg= ER(ER_MASTER_HAS_PURGED_REQUIRED_GTIDS);
@@ -2797,10 +2918,16 @@ bool MYSQL_BIN_LOG::init_gtid_sets(Gtid_set *all_gtids, Gtid_set *lost_gtids,
   char file_name_and_gtid_set_length[FILE_AND_GTID_SET_LENGTH];
   uchar *previous_gtid_set_in_file = NULL;
   bool found_lost_gtids = false;
-  uint last_previous_gtid_encoded_length = 0;
+  int last_binlog_with_gtids = -1;
   int error = 0, length;
-  std::pair<std::map<string, string>::iterator, bool> iterator, save_iterator;
-  previous_gtid_set_map.clear();
+  /*
+    Whether the previous gtid sets missing in the index file are read from
+    the binary logs; only done at server startup, see below.
+  */
+  const bool recover_index = all_gtids != NULL && !is_relay_log &&
+                             gtid_mode > 0;
+  bool index_recovered = false;
+  previous_gtid_sets.clear();
 
   DBUG_ENTER("MYSQL_BIN_LOG::init_gtid_sets");
   DBUG_PRINT("info", ("lost_gtids=%p; so we are recovering a %s log",
@@ -2856,38 +2983,71 @@ bool MYSQL_BIN_LOG::init_gtid_sets(Gtid_set *all_gtids, Gtid_set *lost_gtids,
         my_free(previous_gtid_set_in_file);
         goto end;
       }
-
-      if (lost_gtids != NULL && !found_lost_gtids)
+    }
+    else if (recover_index)
+    {
+      /*
+        The index file lacks the previous gtid set of the binary log, e.g.
+        because it was written by a server that did not store them. Read
+        the Previous_gtids_log_event of the binary log instead, so that the
+        binary logs do not have to be read again after the index file is
+        rewritten below.
+      */
+      Gtid_set previous_gtids(global_sid_map);
+      switch (read_gtids_from_binlog(file_name_and_gtid_set_length, NULL,
+                                     &previous_gtids, NULL, verify_checksum))
       {
-        DBUG_PRINT("info", ("first binlog with gtids %s\n",
-                            file_name_and_gtid_set_length));
-        lost_gtids->add_gtid_encoding(previous_gtid_set_in_file,
-                                      gtid_string_length);
-        found_lost_gtids = true;
+        case ERROR:
+          error= 1;
+          goto end;
+        case GOT_GTIDS:
+        case GOT_PREVIOUS_GTIDS:
+          previous_gtid_set_in_file= previous_gtids.encode(&gtid_string_length);
+          if (previous_gtid_set_in_file == NULL)
+          {
+            error= 2;
+            goto end;
+          }
+          sql_print_information("Read the previous gtid set of binlog %s "
+                                "missing in the index file from the binlog.",
+                                file_name_and_gtid_set_length);
+          index_recovered= true;
+          break;
+        default:
+          break;
       }
     }
-    iterator = previous_gtid_set_map.insert(
-      std::pair<string, string>(string(file_name_and_gtid_set_length),
-                                string((char*)previous_gtid_set_in_file,
-                                       gtid_string_length)));
 
-    if (all_gtids != NULL && gtid_string_length > 0)
+    if (gtid_string_length > 0 && lost_gtids != NULL && !found_lost_gtids)
     {
-      last_previous_gtid_encoded_length = gtid_string_length;
-      save_iterator = iterator;
+      DBUG_PRINT("info", ("first binlog with gtids %s\n",
+                          file_name_and_gtid_set_length));
+      lost_gtids->add_gtid_encoding(previous_gtid_set_in_file,
+                                    gtid_string_length);
+      found_lost_gtids = true;
     }
+    previous_gtid_sets.push_back(
+      Binlog_previous_gtid_set(string(file_name_and_gtid_set_length),
+                               string((char*)previous_gtid_set_in_file,
+                                      gtid_string_length)));
+
+    if (all_gtids != NULL && gtid_string_length > 0)
+      last_binlog_with_gtids = (int) previous_gtid_sets.size() - 1;
     my_free(previous_gtid_set_in_file);
     previous_gtid_set_in_file = NULL;
   }
 
-  if (all_gtids != NULL && last_previous_gtid_encoded_length)
+  if (all_gtids != NULL && last_binlog_with_gtids >= 0)
   {
-    const char *last_binlog_file_with_gtids =
-      save_iterator.first->first.c_str();
+    Binlog_previous_gtid_set &last=
+      previous_gtid_sets[last_binlog_with_gtids];
+    const char *last_binlog_file_with_gtids = last.first.c_str();
+    Gtid_set previous_gtids(global_sid_map);
     DBUG_PRINT("info", ("last binlog with gtids %s\n",
                         last_binlog_file_with_gtids));
     switch (read_gtids_from_binlog(last_binlog_file_with_gtids, all_gtids,
-                                   NULL, last_gtid, verify_checksum))
+                                   recover_index ? &previous_gtids : NULL,
+                                   last_gtid, verify_checksum))
     {
       case ERROR:
         error= 1;
@@ -2903,12 +3063,48 @@ bool MYSQL_BIN_LOG::init_gtid_sets(Gtid_set *all_gtids, Gtid_set *lost_gtids,
     */
     if (all_gtids->is_empty())
     {
-      all_gtids->add_gtid_encoding(
-        (const uchar*)save_iterator.first->second.c_str(),
-        last_previous_gtid_encoded_length);
+      all_gtids->add_gtid_encoding((const uchar*)last.second.data(),
+                                   last.second.length());
+    }
+    else if (recover_index && !previous_gtids.is_empty())
+    {
+      /*
+        The index file is stale if the previous gtid set of the last binary
+        log with gtids does not match its Previous_gtids_log_event; the
+        binary log is right.
+      */
+      Gtid_set previous_gtids_in_index(global_sid_map);
+      previous_gtids_in_index.add_gtid_encoding(
+        (const uchar*)last.second.data(), last.second.length());
+      if (!previous_gtids.is_subset(&previous_gtids_in_index) ||
+          !previous_gtids_in_index.is_subset(&previous_gtids))
+      {
+        uint encoded_length;
+        uchar *encoded= previous_gtids.encode(&encoded_length);
+        if (encoded == NULL)
+        {
+          error= 2;
+          goto end;
+        }
+        sql_print_warning("The previous gtid set of binlog %s in the index "
+                          "file does not match the binlog, using the one in "
+                          "the binlog.", last_binlog_file_with_gtids);
+        last.second.assign((char*)encoded, encoded_length);
+        my_free(encoded);
+        index_recovered= true;
+      }
     }
   }
 
+  /*
+    Store the previous gtid sets read from the binary logs, so that they
+    are not read again at the next startup. The server works with the
+    sets in memory even if this fails.
+  */
+  if (index_recovered && rewrite_index_file())
+    sql_print_warning("Failed to store the previous gtid sets read from the "
+                      "binlogs in the index file.");
+
 end:
   if (all_gtids)
     all_gtids->dbug_print("all_gtids");
@@ -2926,6 +3122,23 @@ end:
 }
 
 
+/**
+  write_function of the IO_CACHE of the active binary log: the buffer is
+  full and is about to be written to the file, pass its bytes and the
+  bytes that did not fit in it to the binlog tail cache.
+*/
+
+static int binlog_tail_cache_write(IO_CACHE *info, const uchar *buf,
+                                   size_t count)
+{
+  binlog_tail_cache.append(info);
+  binlog_tail_cache.append(info->pos_in_file +
+                           (info->write_pos - info->write_buffer),
+                           buf, count);
+  return _my_b_write(info, buf, count);
+}
+
+
 /**
   Open a (new) binlog file.
 
@@ -3011,6 +3224,12 @@ bool MYSQL_BIN_LOG::open_binlog(const char *log_name,
 
   open_count++;
 
+  if (!is_relay_log && log_file.type == WRITE_CACHE)
+  {
+    binlog_tail_cache.start_file(log_file_name, my_b_tell(&log_file));
+    log_file.write_function= binlog_tail_cache_write;
+  }
+
   bool write_file_name_to_index_file=0;
 
   /* This must be before goto err. */
@@ -3114,7 +3333,7 @@ bool MYSQL_BIN_LOG::open_binlog(const char *log_name,
       goto err;
     bytes_written+= extra_description_event->data_written;
   }
-  if (flush_io_cache(&log_file) ||
+  if (flush_log_file() ||
       mysql_file_sync(log_file.file, MYF(MY_WME)))
     goto err;
 
@@ -3319,10 +3538,10 @@ int MYSQL_BIN_LOG::add_log_to_index(uchar* log_name,
                     "append new_line");
   }
 
-  previous_gtid_set_map.insert(
-      std::pair<string, string>(string((char*)log_name, log_name_len),
-                                string((char*)previous_gtid_set_buffer,
-                                       gtid_set_length)));
+  previous_gtid_sets.push_back(
+      Binlog_previous_gtid_set(string((char*)log_name, log_name_len),
+                               string((char*)previous_gtid_set_buffer,
+                                      gtid_set_length)));
 
   if (flush_io_cache(&crash_safe_index_file) ||
       mysql_file_sync(crash_safe_index_file.file, MYF(MY_WME)))
@@ -3355,6 +3574,85 @@ err:
   DBUG_RETURN(-1);
 }
 
+/**
+  Rewrite the index file with the binary logs and previous gtid sets in
+  previous_gtid_sets, through the crash safe index file.
+
+  The caller must hold LOCK_index.
+
+  @retval
+    0   ok
+  @retval
+    -1   error
+*/
+int MYSQL_BIN_LOG::rewrite_index_file()
+{
+  char gtid_set_length_buffer[11];
+  DBUG_ENTER("MYSQL_BIN_LOG::rewrite_index_file");
+
+  mysql_mutex_assert_owner(&LOCK_index);
+
+  if (open_crash_safe_index_file())
+  {
+    sql_print_error("MYSQL_BIN_LOG::rewrite_index_file failed to "
+                    "open the crash safe index file.");
+    DBUG_RETURN(-1);
+  }
+
+  for (Previous_gtid_set_list::const_iterator it= previous_gtid_sets.begin();
+       it != previous_gtid_sets.end(); ++it)
+  {
+    bool error= my_b_write(&crash_safe_index_file,
+                           (const uchar*) it->first.c_str(),
+                           it->first.length());
+    if (!error && it->second.length() > 0)
+    {
+      int10_to_str(it->second.length(), gtid_set_length_buffer, 10);
+      error= my_b_write(&crash_safe_index_file, (uchar*) " ", 1) ||
+             my_b_write(&crash_safe_index_file,
+                        (uchar*) gtid_set_length_buffer,
+                        strlen(gtid_set_length_buffer)) ||
+             my_b_write(&crash_safe_index_file, (uchar*) "\n", 1) ||
+             my_b_write(&crash_safe_index_file,
+                        (const uchar*) it->second.data(),
+                        it->second.length());
+    }
+    if (error || my_b_write(&crash_safe_index_file, (uchar*) "\n", 1))
+    {
+      sql_print_error("MYSQL_BIN_LOG::rewrite_index_file failed to "
+                      "write log file name: %s, to crash safe index file.",
+                      it->first.c_str());
+      close_crash_safe_index_file();
+      DBUG_RETURN(-1);
+    }
+  }
+
+  if (flush_io_cache(&crash_safe_index_file) ||
+      mysql_file_sync(crash_safe_index_file.file, MYF(MY_WME)))
+  {
+    sql_print_error("MYSQL_BIN_LOG::rewrite_index_file failed to "
+                    "sync crash safe index file.");
+    close_crash_safe_index_file();
+    DBUG_RETURN(-1);
+  }
+
+  if (close_crash_safe_index_file())
+  {
+    sql_print_error("MYSQL_BIN_LOG::rewrite_index_file failed to "
+                    "close the crash safe index file.");
+    DBUG_RETURN(-1);
+  }
+
+  if (move_crash_safe_index_file_to_index_file(false/*need_lock_index=false*/))
+  {
+    sql_print_error("MYSQL_BIN_LOG::rewrite_index_file failed to "
+                    "move crash safe index file to index file.");
+    DBUG_RETURN(-1);
+  }
+
+  DBUG_RETURN(0);
+}
+
 int MYSQL_BIN_LOG::get_current_log(LOG_INFO* linfo)
 {
   mysql_mutex_lock(&LOCK_log);
@@ -3686,7 +3984,7 @@ bool MYSQL_BIN_LOG::reset_logs(THD* thd)
     in order to make the operation safe.
   */
 
-  previous_gtid_set_map.clear();
+  previous_gtid_sets.clear();
   if ((err= find_log_pos(&linfo, NullS, false/*need_lock_index=false*/)) != 0)
   {
     uint errcode= purge_log_get_error_code(err);
@@ -4809,7 +5107,7 @@ int MYSQL_BIN_LOG::new_file_impl(bool need_lock_log, Format_description_log_even
 
   // Need flush before updating binlog_end_pos, otherwise dump thread
   // may give errors.
-  if (flush_io_cache(&log_file))
+  if (flush_log_file())
   {
     error = 1;
     close_on_error = TRUE;
@@ -5015,7 +5313,7 @@ bool MYSQL_BIN_LOG::flush_and_sync(bool async, const bool force)
 {
   mysql_mutex_assert_owner(&LOCK_log);
 
-  if (flush_io_cache(&log_file))
+  if (flush_log_file())
     return 1;
 
   std::pair<bool, bool> result= sync_binlog_file(force, async);
@@ -6109,6 +6407,7 @@ void MYSQL_BIN_LOG::update_binlog_end_pos()
   {
     lock_binlog_end_pos();
     binlog_end_pos = my_b_tell(&log_file);
+    binlog_tail_cache.set_end_pos(binlog_end_pos);
     signal_update();
     unlock_binlog_end_pos();
   }
@@ -6773,6 +7072,19 @@ MYSQL_BIN_LOG::change_stage(THD *thd,
 
 
 
+/**
+  Flush the IO_CACHE of the log file. The bytes written to the active
+  binary log are passed to the binlog tail cache on the way.
+*/
+
+int MYSQL_BIN_LOG::flush_log_file()
+{
+  if (!is_relay_log)
+    binlog_tail_cache.append(&log_file);
+  return flush_io_cache(&log_file);
+}
+
+
 /**
   Flush the I/O cache to file.
 
@@ -6784,7 +7096,7 @@ MYSQL_BIN_LOG::change_stage(THD *thd,
 int
 MYSQL_BIN_LOG::flush_cache_to_file(my_off_t *end_pos_var)
 {
-  if (flush_io_cache(&log_file))
+  if (flush_log_file())
     return ER_ERROR_ON_WRITE;
   *end_pos_var= my_b_tell(&log_file);
   return 0;
@@ -7161,6 +7473,32 @@ int MYSQL_BIN_LOG::recover(IO_CACHE *log, Format_description_log_event *fdle,
       if (!x || my_hash_insert(&xids, x))
         goto err2;
     }
+    else if (ev->get_type_code() == TRANSACTION_PAYLOAD_EVENT)
+    {
+      /* A compressed transaction, its XID is in the payload */
+      Transaction_payload_log_event *pev= (Transaction_payload_log_event *) ev;
+      Log_event *payload_ev;
+      const char *errmsg;
+      if (pev->uncompress())
+        goto err2;
+      while ((payload_ev= pev->next_event(fdle, &errmsg)))
+      {
+        if (payload_ev->get_type_code() == XID_EVENT)
+        {
+          Xid_log_event *xev= (Xid_log_event *) payload_ev;
+          uchar *x= (uchar *) memdup_root(&mem_root, (uchar*) &xev->xid,
+                                          sizeof(xev->xid));
+          if (!x || my_hash_insert(&xids, x))
+          {
+            delete payload_ev;
+            goto err2;
+          }
+        }
+        delete payload_ev;
+      }
+      if (errmsg)
+        goto err2;
+    }
 
     /*
       Recorded valid position for the crashed binlog file
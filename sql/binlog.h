@@ -19,8 +19,8 @@
 #include "mysqld.h"                             /* opt_relay_logname */
 #include "log_event.h"
 #include "log.h"
-#include <map>
 #include <string>
+#include <vector>
 
 extern ulong rpl_read_size;
 
@@ -249,6 +249,20 @@ private:
 };
 
 
+/**
+  A binary log file name and the previous gtid set of the binary log in
+  encoded form, as stored in the index file.
+*/
+typedef std::pair<std::string, std::string> Binlog_previous_gtid_set;
+typedef std::vector<Binlog_previous_gtid_set> Previous_gtid_set_list;
+
+/**
+  Predicate for MYSQL_BIN_LOG::find_last_previous_gtid_set().
+*/
+typedef bool (*Previous_gtid_set_predicate)(const Gtid_set *previous_gtid_set,
+                                            const void *arg);
+
+
 class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
 {
  private:
@@ -294,13 +308,13 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   IO_CACHE index_file;
   char index_file_name[FN_REFLEN];
   /*
-     Mapping from binlog file name to the previous gtid set in
-     encoded form which is found at the top of the binlog as
-     Previous_gtids_log_event. This structure is protected by LOCK_index
-     mutex. A new mapping is added in add_log_to_index() function,
-     and this is totally rebuilt in init_gtid_sets() function.
+     Binlog file names and the previous gtid sets in encoded form which are
+     found at the top of the binlogs as Previous_gtids_log_event, in the
+     order of the index file. This structure is protected by LOCK_index
+     mutex. A new entry is added in add_log_to_index() function, and this
+     is totally rebuilt in init_gtid_sets() function.
   */
-  std::map<std::string, std::string> previous_gtid_set_map;
+  Previous_gtid_set_list previous_gtid_sets;
   /*
     crash_safe_index_file is temp file used for guaranteeing
     index file crash safe when master server restarts.
@@ -500,10 +514,31 @@ public:
     m_key_file_log_index= key_file_log_index;
   }
 #endif
+  /**
+    Find the last binary log whose previous gtid set satisfies a
+    predicate. The previous gtid set of a binary log contains the previous
+    gtid sets of all older binary logs, so the predicates used here, which
+    hold for a set whenever they hold for a superset of it, hold for all
+    binary logs up to some binary log. That one is found with a binary
+    search over previous_gtid_sets, which decodes only a logarithmic number
+    of the previous gtid sets.
+
+    The caller must hold LOCK_index.
+
+    @param previous_gtid_set Empty set used to decode the previous gtid
+    sets, the sid map of which is used for the decoded sids.
+    @param predicate The predicate.
+    @param arg Passed to the predicate.
+    @return index in previous_gtid_sets, or -1 if the predicate holds for
+    no binary log.
+  */
+  int find_last_previous_gtid_set(Gtid_set *previous_gtid_set,
+                                  Previous_gtid_set_predicate predicate,
+                                  const void *arg);
   /**
     Find the oldest binary log that contains any GTID that
-    is not in the given gtid set. This is done by scanning the map
-    structure previous_gtid_set_map in reverse order.
+    is not in the given gtid set. This is done by a binary search
+    over previous_gtid_sets, see find_last_previous_gtid_set().
 
     @param[out] binlog_file_name, the file name of oldest binary log found
     @param[in]  gtid_set, the given gtid set
@@ -519,10 +554,18 @@ public:
     Builds the set of all GTIDs in the binary log, and the set of all
     lost GTIDs in the binary log, and stores each set in respective
     argument. This scans the index file from the beginning and builds
-    previous_gtid_set_map. Since index file contains the previous gtid
+    previous_gtid_sets. Since index file contains the previous gtid
     set in binary string format, this function doesn't open every
     binary log file.
 
+    When the binary log index lacks the previous gtid set of a binary log
+    (e.g., it was written by a server that did not store them) or the
+    previous gtid set of the last binary log with gtids does not match the
+    Previous_gtids_log_event of the binary log, the sets are read from the
+    binary logs instead, and the index file is rewritten with them. This
+    is only done when the sets of the binary log (not relay log) are
+    initialized at server startup.
+
     @param gtid_set Will be filled with all GTIDs in this binary log.
     @param lost_groups Will be filled with all GTIDs in the
     Previous_gtids_log_event of the first binary log that has a
@@ -556,6 +599,7 @@ private:
                     THD* queue, mysql_mutex_t *leave, mysql_mutex_t *enter);
   std::pair<int,my_off_t> flush_thread_caches(THD *thd, bool async);
   int flush_cache_to_file(my_off_t *flush_end_pos);
+  int flush_log_file();
   int finish_commit(THD *thd, bool async);
   std::pair<bool, bool> sync_binlog_file(bool force, bool async);
   void process_semisync_stage_queue(THD *queue_head);
@@ -695,6 +739,7 @@ public:
   int add_log_to_index(uchar* log_file_name, int name_len,
                        bool need_lock_index, bool need_sid_lock);
   int move_crash_safe_index_file_to_index_file(bool need_lock_index);
+  int rewrite_index_file();
   int set_purge_index_file_name(const char *base_file_name);
   int open_purge_index_file(bool destroy);
   bool is_inited_purge_index_file();
@@ -728,9 +773,9 @@ public:
   inline void lock_index() { mysql_mutex_lock(&LOCK_index);}
   inline void unlock_index() { mysql_mutex_unlock(&LOCK_index);}
   inline IO_CACHE *get_index_file() { return &index_file;}
-  inline std::map<std::string, std::string> *get_previous_gtid_set_map()
+  inline Previous_gtid_set_list *get_previous_gtid_sets()
   {
-    return &previous_gtid_set_map;
+    return &previous_gtid_sets;
   }
   inline uint32 get_open_count() { return open_count; }
   /*
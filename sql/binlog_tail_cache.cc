@@ -0,0 +1,181 @@
+/* Copyright (c) 2013, Facebook, Inc. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include "binlog_tail_cache.h"
+#include "sql_string.h"
+#include "log_event.h"
+#include "mysqld.h"
+#include "my_atomic.h"
+
+#include <algorithm>
+
+Binlog_tail_cache binlog_tail_cache;
+
+
+Binlog_tail_cache::Binlog_tail_cache()
+  : m_buffer(NULL), m_size(0), m_start(0), m_end(0), m_end_pos(0),
+    m_inited(false)
+{
+  m_file_name[0]= 0;
+}
+
+
+bool Binlog_tail_cache::init(ulong size)
+{
+  mysql_rwlock_init(key_rwlock_binlog_tail_cache, &m_lock);
+  m_inited= true;
+  return resize(size);
+}
+
+
+void Binlog_tail_cache::cleanup()
+{
+  if (!m_inited)
+    return;
+  my_free(m_buffer);
+  m_buffer= NULL;
+  m_size= 0;
+  mysql_rwlock_destroy(&m_lock);
+  m_inited= false;
+}
+
+
+bool Binlog_tail_cache::resize(ulong size)
+{
+  uchar *buffer= NULL;
+
+  if (size && !(buffer= (uchar*) my_malloc(size, MYF(MY_WME))))
+    return true;
+
+  mysql_rwlock_wrlock(&m_lock);
+  my_free(m_buffer);
+  m_buffer= buffer;
+  m_size= size;
+  /* The next append starts over at its position */
+  m_start= m_end= m_end_pos;
+  mysql_rwlock_unlock(&m_lock);
+  return false;
+}
+
+
+void Binlog_tail_cache::start_file(const char *file_name, my_off_t pos)
+{
+  mysql_rwlock_wrlock(&m_lock);
+  strmake(m_file_name, file_name, sizeof(m_file_name) - 1);
+  m_start= m_end= m_end_pos= pos;
+  mysql_rwlock_unlock(&m_lock);
+}
+
+
+void Binlog_tail_cache::append(my_off_t pos, const uchar *buf, size_t length)
+{
+  if (!is_enabled())
+    return;
+  mysql_rwlock_wrlock(&m_lock);
+  if (!m_size)
+    goto end;
+
+  if (pos > m_end || pos < m_start)
+  {
+    /* Some bytes were written without passing through the cache */
+    m_start= m_end= pos;
+  }
+  if (pos + length <= m_end)
+    goto end;
+  buf+= m_end - pos;
+  length-= (size_t) (m_end - pos);
+
+  if (length > m_size)
+  {
+    /* Only the last m_size bytes fit */
+    buf+= length - m_size;
+    m_end+= length - m_size;
+    length= m_size;
+  }
+  while (length)
+  {
+    size_t offset= (size_t) (m_end % m_size);
+    size_t chunk= std::min(length, (size_t) (m_size - offset));
+    memcpy(m_buffer + offset, buf, chunk);
+    buf+= chunk;
+    length-= chunk;
+    m_end+= chunk;
+  }
+  if (m_end - m_start > m_size)
+    m_start= m_end - m_size;
+
+end:
+  mysql_rwlock_unlock(&m_lock);
+}
+
+
+void Binlog_tail_cache::set_end_pos(my_off_t end_pos)
+{
+  if (!is_enabled())
+    return;
+  mysql_rwlock_wrlock(&m_lock);
+  m_end_pos= end_pos;
+  mysql_rwlock_unlock(&m_lock);
+}
+
+
+void Binlog_tail_cache::copy_out(my_off_t pos, size_t length,
+                                 uchar *buf) const
+{
+  while (length)
+  {
+    size_t offset= (size_t) (pos % m_size);
+    size_t chunk= std::min(length, (size_t) (m_size - offset));
+    memcpy(buf, m_buffer + offset, chunk);
+    buf+= chunk;
+    length-= chunk;
+    pos+= chunk;
+  }
+}
+
+
+bool Binlog_tail_cache::read_event(const char *file_name, my_off_t pos,
+                                   String *packet, ulong *length)
+{
+  bool found= false;
+
+  if (!is_enabled())
+    return false;
+  mysql_rwlock_rdlock(&m_lock);
+  my_off_t end= std::min(m_end, m_end_pos);
+  if (m_size && pos >= m_start && pos + LOG_EVENT_MINIMAL_HEADER_LEN <= end &&
+      !strcmp(file_name, m_file_name))
+  {
+    uchar header[LOG_EVENT_MINIMAL_HEADER_LEN];
+    copy_out(pos, sizeof(header), header);
+    ulong event_length= uint4korr(header + EVENT_LEN_OFFSET);
+    uint32 packet_length= packet->length();
+
+    if (event_length >= LOG_EVENT_MINIMAL_HEADER_LEN &&
+        pos + event_length <= end &&
+        !packet->realloc(packet_length + event_length))
+    {
+      copy_out(pos, event_length, (uchar*) packet->ptr() + packet_length);
+      packet->length(packet_length + event_length);
+      *length= event_length;
+      found= true;
+    }
+  }
+  mysql_rwlock_unlock(&m_lock);
+
+  if (found)
+    my_atomic_add64((longlong*) &binlog_tail_cache_hits, 1);
+  return found;
+}
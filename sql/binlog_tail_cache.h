@@ -0,0 +1,135 @@
+#ifndef BINLOG_TAIL_CACHE_INCLUDED
+#define BINLOG_TAIL_CACHE_INCLUDED
+
+/* Copyright (c) 2013, Facebook, Inc. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/**
+  @file
+
+  @brief
+  In-memory copy of the tail of the active binary log, shared by the
+  binlog dump threads.
+
+  Every binlog dump thread reads the binary log through its own IO_CACHE,
+  so with many slaves the same events are read from the file and their
+  checksums verified once per slave. The tail cache is a ring buffer with
+  the last binlog_tail_cache_size bytes written to the active binary log.
+  It is filled by MYSQL_BIN_LOG as the bytes leave the IO_CACHE of the
+  log file, and a dump thread that is caught up copies the events from it
+  instead of reading the file. A dump thread that lags behind the ring
+  buffer, or reads another binary log, reads the file as before.
+
+  The bytes in the ring buffer are positions [start, end) of the active
+  binary log. Only the positions up to binlog_end_pos, which were flushed
+  and synced, are read from it.
+*/
+
+#include "my_global.h"
+#include "my_sys.h"
+#include "mysql/psi/mysql_thread.h"
+
+class String;
+
+class Binlog_tail_cache
+{
+public:
+  Binlog_tail_cache();
+
+  /**
+    Allocate the ring buffer.
+
+    @param size  size of the ring buffer, 0 to disable the cache
+
+    @retval false  OK
+    @retval true   Out of memory
+  */
+  bool init(ulong size);
+  void cleanup();
+
+  /**
+    Replace the ring buffer with an empty one of another size.
+
+    @retval false  OK
+    @retval true   Out of memory, the cache is not changed
+  */
+  bool resize(ulong size);
+
+  ulong size() const { return m_size; }
+  bool is_enabled() const { return m_size != 0; }
+
+  /**
+    Start caching a new active binary log.
+
+    @param file_name  name of the binary log
+    @param pos        position of the first byte that will be appended
+  */
+  void start_file(const char *file_name, my_off_t pos);
+
+  /**
+    Append bytes written to the active binary log at position pos. Bytes
+    that the cache already has are skipped. If bytes between the end of
+    the cache and pos were not appended, the cache starts over at pos.
+  */
+  void append(my_off_t pos, const uchar *buf, size_t length);
+
+  /** Append the bytes in the write buffer of the binary log IO_CACHE. */
+  void append(IO_CACHE *log_file)
+  {
+    if (log_file->write_pos > log_file->write_buffer)
+      append(log_file->pos_in_file, log_file->write_buffer,
+             (size_t) (log_file->write_pos - log_file->write_buffer));
+  }
+
+  /** Positions up to end_pos were flushed and may be read. */
+  void set_end_pos(my_off_t end_pos);
+
+  /**
+    Copy the event at position pos of a binary log from the cache to
+    the end of packet.
+
+    @param       file_name  name of the binary log
+    @param       pos        position of the event
+    @param       packet     packet to append the event to
+    @param[out]  length     length of the event
+
+    @retval true   the event was copied
+    @retval false  the cache does not have the event
+  */
+  bool read_event(const char *file_name, my_off_t pos, String *packet,
+                  ulong *length);
+
+private:
+  /** Copy length bytes at position pos out of the ring buffer. */
+  void copy_out(my_off_t pos, size_t length, uchar *buf) const;
+
+  mysql_rwlock_t m_lock;
+  /** The ring buffer, position pos is at m_buffer[pos % m_size]. */
+  uchar *m_buffer;
+  volatile ulong m_size;
+  /** Name of the binary log in the cache. */
+  char m_file_name[FN_REFLEN];
+  /** First position in the ring buffer. */
+  my_off_t m_start;
+  /** Position after the last byte in the ring buffer. */
+  my_off_t m_end;
+  /** Position after the last byte that may be read. */
+  my_off_t m_end_pos;
+  bool m_inited;
+};
+
+extern Binlog_tail_cache binlog_tail_cache;
+
+#endif /* BINLOG_TAIL_CACHE_INCLUDED */
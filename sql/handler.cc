@@ -38,6 +38,7 @@
 #include "probes_mysql.h"
 #include <mysql/psi/mysql_table.h>
 #include "debug_sync.h"         // DEBUG_SYNC
+#include "histogram.h"          // histogram_eq_range_rows
 #include <my_bit.h>
 #include <list>
 
@@ -198,6 +199,7 @@ st_system_tablename mysqld_system_tables[]= {
   {mysqld_system_database, "tables_priv"},
   {mysqld_system_database, "proxies_priv"},
   {mysqld_system_database, "columns_priv"},
+  {mysqld_system_database, "column_stats"},
   {mysqld_system_database, "time_zone"},
   {mysqld_system_database, "time_zone_name"},
   {mysqld_system_database, "time_zone_leap_second"},
@@ -5729,11 +5731,22 @@ handler::multi_range_read_info_const(uint keyno, RANGE_SEQ_IF *seq,
            Ranges of the form "x IS NULL" will not use index statistics 
            because the number of rows with this value are likely to be 
            very different than the values in the index statistics.
+        3) As 2), but the range is on the first keypart only and the
+           column has a histogram, which gives a per-value estimate
+           instead of the average of the index statistics.
     */
     int keyparts_used= 0;
+    ha_rows histogram_rows;
     if ((range.range_flag & UNIQUE_RANGE) &&                        // 1)
         !(range.range_flag & NULL_RANGE))
       rows= 1; /* there can be at most one row */
+    else if ((range.range_flag & EQ_RANGE) &&                       // 3)
+             (range.range_flag & USE_INDEX_STATISTICS) &&
+             !(range.range_flag & NULL_RANGE) &&
+             my_count_bits(range.start_key.keypart_map) == 1 &&
+             (histogram_rows= histogram_eq_range_rows(table, keyno,
+                                                      &range.start_key)))
+      rows= histogram_rows;
     else if ((range.range_flag & EQ_RANGE) &&                       // 2a)
              (range.range_flag & USE_INDEX_STATISTICS) &&           // 2b)
              (keyparts_used= my_count_bits(range.start_key.keypart_map)) &&
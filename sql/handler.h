@@ -702,6 +702,8 @@ enum enum_schema_tables
   SCH_SCHEMA_PRIVILEGES,
   SCH_SESSION_STATUS,
   SCH_SESSION_VARIABLES,
+  SCH_SLAVE_APPLY_LATENCY,
+  SCH_SLAVE_WORKER_STATISTICS,
   SCH_STATISTICS,
   SCH_STATUS,
   SCH_TABLES,
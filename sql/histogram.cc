@@ -0,0 +1,1425 @@
+/* Copyright (c) 2013, Facebook, Inc. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include "histogram.h"
+#include "sql_class.h"                          // THD
+#include "sql_base.h"                           // open_ltable
+#include "sql_admin.h"                          // SQL_ADMIN_MSG_TEXT_SIZE
+#include "key.h"                                // key_copy
+#include "transaction.h"                        // trans_commit_stmt
+#include "item_cmpfunc.h"                       // Item_equal
+#include "mem_root_array.h"
+#include "myisampack.h"                         // mi_uint8korr
+#include "my_atomic.h"
+#include <algorithm>
+
+/*
+  Layout of mysql.column_stats, see scripts/mysql_system_tables.sql.
+  The primary key is (db_name, table_name, column_name).
+*/
+enum enum_column_stats_field
+{
+  COLUMN_STATS_FIELD_DB= 0,
+  COLUMN_STATS_FIELD_TABLE_NAME,
+  COLUMN_STATS_FIELD_COLUMN_NAME,
+  COLUMN_STATS_FIELD_HISTOGRAM_TYPE,
+  COLUMN_STATS_FIELD_NULL_FRACTION,
+  COLUMN_STATS_FIELD_SAMPLING_RATE,
+  COLUMN_STATS_FIELD_BUCKETS,
+  COLUMN_STATS_FIELD_LAST_UPDATE,
+  COLUMN_STATS_FIELD_COUNT
+};
+
+static const LEX_STRING COLUMN_STATS_NAME= { C_STRING_WITH_LEN("column_stats") };
+
+/**
+  Version of the contents of mysql.column_stats, incremented whenever
+  ANALYZE TABLE stores histograms, and the version read_histograms()
+  last found the table empty at. While the two are equal there is
+  nothing to load, and load_histograms() does not open the table; rows
+  written to it by other means are seen after the next ANALYZE TABLE
+  ... UPDATE HISTOGRAM or restart.
+*/
+static int32 column_stats_version= 0;
+static int32 column_stats_empty_version= -1;
+
+static inline bool column_stats_known_empty()
+{
+  return my_atomic_load32(&column_stats_empty_version) ==
+         my_atomic_load32(&column_stats_version);
+}
+
+/*
+  Number of sort key bytes computed for a string value. Only the first 8
+  are used, the rest leaves room for the length suffix that binary
+  VARCHAR columns append to their sort keys.
+*/
+#define HISTOGRAM_SORT_KEY_LENGTH 10
+
+
+/****************************************************************************
+  Histogram
+****************************************************************************/
+
+/**
+  Build a histogram from the sorted non-NULL values of a sample.
+
+  A singleton histogram is built if the sample has at most max_buckets
+  distinct values, an equi-height one otherwise. Equal values never span
+  two buckets of an equi-height histogram.
+
+  @param mem_root       Where to allocate the histogram
+  @param values         Sorted sample values
+  @param value_count    Number of values
+  @param null_count     Number of NULLs in the sample
+  @param sampling_rate  Fraction of the table rows that was sampled
+  @param max_buckets    Largest number of buckets to create
+
+  @return The histogram, NULL if out of memory.
+*/
+
+Histogram *Histogram::build(MEM_ROOT *mem_root, double *values,
+                            ha_rows value_count, ha_rows null_count,
+                            double sampling_rate, uint max_buckets)
+{
+  const double total= (double) (value_count + null_count);
+  ha_rows ndv= 0;
+
+  for (ha_rows i= 0; i < value_count; i++)
+  {
+    if (i == 0 || values[i] != values[i - 1])
+      ndv++;
+  }
+
+  const enum_histogram_type type= (ndv <= max_buckets) ? SINGLETON
+                                                       : EQUI_HEIGHT;
+  const uint bucket_count= (uint) std::min<ha_rows>(ndv, max_buckets);
+  Bucket *buckets= NULL;
+
+  if (bucket_count &&
+      !(buckets= (Bucket*) alloc_root(mem_root,
+                                      bucket_count * sizeof(Bucket))))
+    return NULL;
+
+  uint n= 0;
+  ha_rows i= 0;
+  while (i < value_count)
+  {
+    Bucket *bucket= &buckets[n];
+    /* Number of values the buckets up to and including this one hold. */
+    const ha_rows target= (type == SINGLETON) ? 0 :
+      (ha_rows) ((double) value_count * (n + 1) / bucket_count);
+
+    bucket->lower= values[i];
+    bucket->ndv= 0;
+    do
+    {
+      const double value= values[i];
+      while (i < value_count && values[i] == value)
+        i++;
+      bucket->ndv++;
+    } while (i < value_count && i < target);
+    bucket->upper= values[i - 1];
+    bucket->cumulative_frequency= i / total;
+    n++;
+  }
+
+  return new (mem_root) Histogram(type, total ? null_count / total : 0.0,
+                                  sampling_rate, n, buckets);
+}
+
+
+/**
+  Create a histogram from the image written by serialize().
+
+  @return The histogram, NULL if the image is malformed or out of memory.
+*/
+
+Histogram *Histogram::deserialize(MEM_ROOT *mem_root,
+                                  enum_histogram_type type,
+                                  double null_fraction, double sampling_rate,
+                                  const uchar *image, size_t length)
+{
+  if ((uint) type > EQUI_HEIGHT || length % BUCKET_IMAGE_LENGTH ||
+      length / BUCKET_IMAGE_LENGTH > HISTOGRAM_MAX_BUCKETS ||
+      null_fraction < 0.0 || null_fraction > 1.0)
+    return NULL;
+
+  const uint bucket_count= length / BUCKET_IMAGE_LENGTH;
+  Bucket *buckets= NULL;
+
+  if (bucket_count &&
+      !(buckets= (Bucket*) alloc_root(mem_root,
+                                      bucket_count * sizeof(Bucket))))
+    return NULL;
+
+  for (uint i= 0; i < bucket_count; i++, image+= BUCKET_IMAGE_LENGTH)
+  {
+    Bucket *bucket= &buckets[i];
+    float8get(bucket->lower, image);
+    float8get(bucket->upper, image + sizeof(double));
+    float8get(bucket->cumulative_frequency, image + 2 * sizeof(double));
+    float8get(bucket->ndv, image + 3 * sizeof(double));
+
+    if (bucket->upper < bucket->lower || bucket->ndv < 1.0 ||
+        bucket->cumulative_frequency > 1.0 ||
+        (i && (bucket->lower < buckets[i - 1].upper ||
+               bucket->cumulative_frequency <
+               buckets[i - 1].cumulative_frequency)))
+      return NULL;
+  }
+
+  return new (mem_root) Histogram(type, null_fraction, sampling_rate,
+                                  bucket_count, buckets);
+}
+
+
+Histogram *Histogram::clone(MEM_ROOT *mem_root) const
+{
+  Bucket *buckets= NULL;
+
+  if (m_bucket_count)
+  {
+    if (!(buckets= (Bucket*) memdup_root(mem_root, m_buckets,
+                                         m_bucket_count * sizeof(Bucket))))
+      return NULL;
+  }
+  return new (mem_root) Histogram(m_type, m_null_fraction, m_sampling_rate,
+                                  m_bucket_count, buckets);
+}
+
+
+/**
+  Write the buckets to image, which must be serialized_length() bytes.
+  Each bucket is stored as four portable doubles: lower, upper,
+  cumulative frequency and number of distinct values.
+*/
+
+void Histogram::serialize(uchar *image) const
+{
+  for (uint i= 0; i < m_bucket_count; i++, image+= BUCKET_IMAGE_LENGTH)
+  {
+    const Bucket *bucket= &m_buckets[i];
+    double lower= bucket->lower, upper= bucket->upper;
+    double cumulative_frequency= bucket->cumulative_frequency;
+    double ndv= bucket->ndv;
+    float8store(image, lower);
+    float8store(image + sizeof(double), upper);
+    float8store(image + 2 * sizeof(double), cumulative_frequency);
+    float8store(image + 3 * sizeof(double), ndv);
+  }
+}
+
+
+/**
+  @return Index of the first bucket whose upper bound is not less than
+          value, bucket_count() if there is none.
+*/
+
+uint Histogram::find_bucket(double value) const
+{
+  uint low= 0, high= m_bucket_count;
+
+  while (low < high)
+  {
+    const uint middle= low + (high - low) / 2;
+    if (m_buckets[middle].upper < value)
+      low= middle + 1;
+    else
+      high= middle;
+  }
+  return low;
+}
+
+
+static inline double clamp_selectivity(double selectivity)
+{
+  return std::max(0.0, std::min(1.0, selectivity));
+}
+
+
+double Histogram::equal_selectivity(double value) const
+{
+  const uint idx= find_bucket(value);
+
+  if (idx == m_bucket_count || value < m_buckets[idx].lower)
+    return 0.0;
+  return clamp_selectivity(bucket_frequency(idx) / m_buckets[idx].ndv);
+}
+
+
+/**
+  Estimate the fraction of rows whose value is less than (or, if
+  inclusive, equal to) value. Within an equi-height bucket the distinct
+  values are assumed to be evenly spread between the bounds.
+*/
+
+double Histogram::less_selectivity(double value, bool inclusive) const
+{
+  const uint idx= find_bucket(value);
+
+  if (idx == m_bucket_count)
+    return not_null_selectivity();
+
+  const Bucket *bucket= &m_buckets[idx];
+  double selectivity= idx ? m_buckets[idx - 1].cumulative_frequency : 0.0;
+
+  if (value < bucket->lower)
+    return clamp_selectivity(selectivity);
+
+  if (bucket->upper > bucket->lower)
+  {
+    /* The part of the bucket strictly below value, excluding value itself */
+    selectivity+= bucket_frequency(idx) *
+      (value - bucket->lower) / (bucket->upper - bucket->lower) *
+      (bucket->ndv - 1.0) / bucket->ndv;
+  }
+  if (inclusive)
+    selectivity+= equal_selectivity(value);
+  return clamp_selectivity(std::min(selectivity,
+                                    bucket->cumulative_frequency));
+}
+
+
+double Histogram::greater_selectivity(double value, bool inclusive) const
+{
+  return clamp_selectivity(not_null_selectivity() -
+                           less_selectivity(value, !inclusive));
+}
+
+
+double Histogram::between_selectivity(double min_value,
+                                      double max_value) const
+{
+  return clamp_selectivity(less_selectivity(max_value, true) -
+                           less_selectivity(min_value, false));
+}
+
+
+/****************************************************************************
+  Mapping of column values to histogram values
+****************************************************************************/
+
+static bool histogram_supported(const Field *field)
+{
+  switch (field->real_type()) {
+  case MYSQL_TYPE_TINY_BLOB:
+  case MYSQL_TYPE_MEDIUM_BLOB:
+  case MYSQL_TYPE_LONG_BLOB:
+  case MYSQL_TYPE_BLOB:
+  case MYSQL_TYPE_GEOMETRY:
+  case MYSQL_TYPE_BIT:
+  case MYSQL_TYPE_ENUM:
+  case MYSQL_TYPE_SET:
+    return false;
+  default:
+    return true;
+  }
+}
+
+
+static inline bool is_string_field(const Field *field)
+{
+  return field->result_type() == STRING_RESULT && !field->is_temporal();
+}
+
+
+/**
+  Map the non-NULL value of field to a double. Strings are mapped to the
+  first 8 bytes of their sort key, so that values compare as they do in
+  the column's collation.
+*/
+
+static double histogram_field_value(Field *field)
+{
+  if (is_string_field(field))
+  {
+    uchar key[HISTOGRAM_SORT_KEY_LENGTH];
+    field->make_sort_key(key, sizeof(key));
+    return ulonglong2double(mi_uint8korr(key));
+  }
+  return field->val_real();
+}
+
+
+/**
+  Map the constant item, compared with field, to a histogram value.
+
+  Values that cannot be stored in the column without conversion errors,
+  and NULL, are not mapped: the predicate is then not estimated.
+
+  @note Like the range optimizer, this uses the record buffer of the
+        table to convert the value.
+
+  @return true if value was set, false otherwise
+*/
+
+static bool histogram_item_value(Field *field, Item *item, double *value)
+{
+  if (!item->const_item() || item->is_expensive())
+    return false;
+
+  if (!is_string_field(field) && !field->is_temporal())
+  {
+    /* Converting a string could raise warnings, leave it to execution */
+    if (item->result_type() == STRING_RESULT)
+      return false;
+    *value= item->val_real();
+    return !item->null_value;
+  }
+
+  if (is_string_field(field) && item->result_type() != STRING_RESULT)
+    return false;
+
+  TABLE *table= field->table;
+  my_bitmap_map *old_write_map= dbug_tmp_use_all_columns(table,
+                                                         table->write_set);
+  my_bitmap_map *old_read_map= dbug_tmp_use_all_columns(table,
+                                                        table->read_set);
+  const bool stored= item->save_in_field_no_warnings(field, true) == TYPE_OK &&
+                     !field->is_null();
+  if (stored)
+    *value= histogram_field_value(field);
+  dbug_tmp_restore_column_map(table->read_set, old_read_map);
+  dbug_tmp_restore_column_map(table->write_set, old_write_map);
+  return stored;
+}
+
+
+/****************************************************************************
+  mysql.column_stats access
+****************************************************************************/
+
+static void init_column_stats_table_list(TABLE_LIST *tables,
+                                         thr_lock_type lock_type)
+{
+  tables->init_one_table(MYSQL_SCHEMA_NAME.str, MYSQL_SCHEMA_NAME.length,
+                         COLUMN_STATS_NAME.str, COLUMN_STATS_NAME.length,
+                         COLUMN_STATS_NAME.str, lock_type);
+}
+
+
+static bool check_column_stats_table(TABLE *table)
+{
+  if (table->s->fields != COLUMN_STATS_FIELD_COUNT || !table->s->keys ||
+      table->key_info->user_defined_key_parts != 3)
+  {
+    my_error(ER_CANNOT_LOAD_FROM_TABLE_V2, MYF(0), MYSQL_SCHEMA_NAME.str,
+             COLUMN_STATS_NAME.str);
+    return true;
+  }
+  return false;
+}
+
+
+/**
+  Open mysql.column_stats for writing in a new open tables state, like
+  open_log_table() does. Close it with close_system_tables().
+
+  @return The table, NULL if an error was reported.
+*/
+
+static TABLE *open_column_stats_for_write(THD *thd, TABLE_LIST *tables,
+                                          Open_tables_backup *backup)
+{
+  TABLE *table;
+
+  init_column_stats_table_list(tables, TL_WRITE);
+  thd->reset_n_backup_open_tables_state(backup);
+
+  if (!(table= open_ltable(thd, tables, TL_WRITE,
+                           MYSQL_LOCK_IGNORE_TIMEOUT |
+                           MYSQL_LOCK_IGNORE_GLOBAL_READ_ONLY)))
+  {
+    thd->restore_backup_open_tables_state(backup);
+    return NULL;
+  }
+
+  table->use_all_columns();
+  if (check_column_stats_table(table))
+  {
+    close_system_tables(thd, backup);
+    return NULL;
+  }
+  return table;
+}
+
+
+static void store_key_prefix(TABLE *table, const char *db,
+                             const char *table_name, const char *column_name)
+{
+  table->field[COLUMN_STATS_FIELD_DB]->store(db, strlen(db),
+                                             system_charset_info);
+  table->field[COLUMN_STATS_FIELD_TABLE_NAME]->store(table_name,
+                                                     strlen(table_name),
+                                                     system_charset_info);
+  if (column_name)
+    table->field[COLUMN_STATS_FIELD_COLUMN_NAME]->store(column_name,
+                                                        strlen(column_name),
+                                                        system_charset_info);
+}
+
+
+/** Length of the (db_name, table_name) prefix of the primary key. */
+
+static uint key_prefix_length(TABLE *table)
+{
+  return table->key_info->key_part[0].store_length +
+         table->key_info->key_part[1].store_length;
+}
+
+
+/**
+  Insert or replace the histogram of a column.
+
+  @return 0 on success, handler error code otherwise
+*/
+
+static int store_histogram(THD *thd, TABLE *table, const char *db,
+                           const char *table_name, const char *column_name,
+                           const Histogram *histogram)
+{
+  uchar key[MAX_KEY_LENGTH];
+  uchar *image;
+  const size_t image_length= histogram->serialized_length();
+  timeval now= thd->query_start_timeval();
+  int error;
+
+  if (!(image= (uchar*) thd->alloc(image_length + 1)))
+    return HA_ERR_OUT_OF_MEM;
+  histogram->serialize(image);
+
+  restore_record(table, s->default_values);
+  store_key_prefix(table, db, table_name, column_name);
+  key_copy(key, table->record[0], table->key_info,
+           table->key_info->key_length);
+
+  table->field[COLUMN_STATS_FIELD_HISTOGRAM_TYPE]->store(
+    (longlong) histogram->type() + 1, true);
+  table->field[COLUMN_STATS_FIELD_NULL_FRACTION]->store(
+    histogram->null_selectivity());
+  table->field[COLUMN_STATS_FIELD_SAMPLING_RATE]->store(
+    histogram->sampling_rate());
+  table->field[COLUMN_STATS_FIELD_BUCKETS]->store((char*) image, image_length,
+                                                  &my_charset_bin);
+  table->field[COLUMN_STATS_FIELD_LAST_UPDATE]->store_timestamp(&now);
+
+  if (!(error= table->file->ha_index_read_idx_map(table->record[1], 0, key,
+                                                  HA_WHOLE_KEY,
+                                                  HA_READ_KEY_EXACT)))
+  {
+    error= table->file->ha_update_row(table->record[1], table->record[0]);
+    if (error == HA_ERR_RECORD_IS_THE_SAME)
+      error= 0;
+  }
+  else if (error == HA_ERR_KEY_NOT_FOUND || error == HA_ERR_END_OF_FILE)
+    error= table->file->ha_write_row(table->record[0]);
+  return error;
+}
+
+
+/**
+  Delete the histograms of a table, or of one of its columns.
+
+  @param column_name  Column to delete the histogram of, NULL for all.
+                      Compared case insensitively, like column names.
+  @param[out] deleted Number of histograms deleted
+
+  @return 0 on success, handler error code otherwise
+*/
+
+static int delete_histograms(TABLE *table, const char *db,
+                             const char *table_name, const char *column_name,
+                             uint *deleted)
+{
+  uchar key[MAX_KEY_LENGTH];
+  const uint key_length= key_prefix_length(table);
+  char name_buff[NAME_LEN + 1];
+  String name(name_buff, sizeof(name_buff), system_charset_info);
+  int error;
+
+  *deleted= 0;
+  store_key_prefix(table, db, table_name, NULL);
+  key_copy(key, table->record[0], table->key_info, key_length);
+
+  if ((error= table->file->ha_index_init(0, true)))
+    return error;
+
+  error= table->file->ha_index_read_map(table->record[0], key,
+                                        make_prev_keypart_map(2),
+                                        HA_READ_KEY_EXACT);
+  while (!error)
+  {
+    if (column_name)
+      table->field[COLUMN_STATS_FIELD_COLUMN_NAME]->val_str(&name);
+    if (!column_name ||
+        !my_strcasecmp(system_charset_info, name.c_ptr_safe(), column_name))
+    {
+      if ((error= table->file->ha_delete_row(table->record[0])))
+        break;
+      (*deleted)++;
+    }
+    error= table->file->ha_index_next_same(table->record[0], key, key_length);
+  }
+  table->file->ha_index_end();
+
+  if (error == HA_ERR_END_OF_FILE || error == HA_ERR_KEY_NOT_FOUND)
+    error= 0;
+  return error;
+}
+
+
+/**
+  Move the histograms of a table to a new table name, replacing the
+  histograms stored under the new name.
+
+  @return 0 on success, handler error code otherwise
+*/
+
+static int rename_histograms(TABLE *table, const char *db,
+                             const char *table_name, const char *new_db,
+                             const char *new_table_name)
+{
+  uchar key[MAX_KEY_LENGTH];
+  const uint key_length= key_prefix_length(table);
+  uint deleted;
+  int error;
+
+  if ((error= delete_histograms(table, new_db, new_table_name, NULL,
+                                &deleted)))
+    return error;
+
+  store_key_prefix(table, db, table_name, NULL);
+  key_copy(key, table->record[0], table->key_info, key_length);
+
+  /*
+    Updating the key moves the row out of the searched prefix, so look
+    up the first remaining row every time.
+  */
+  while (!(error= table->file->ha_index_read_idx_map(table->record[0], 0,
+                                                     key,
+                                                     make_prev_keypart_map(2),
+                                                     HA_READ_KEY_EXACT)))
+  {
+    store_record(table, record[1]);
+    store_key_prefix(table, new_db, new_table_name, NULL);
+    if ((error= table->file->ha_update_row(table->record[1],
+                                           table->record[0])))
+      return error;
+  }
+
+  if (error == HA_ERR_END_OF_FILE || error == HA_ERR_KEY_NOT_FOUND)
+    error= 0;
+  return error;
+}
+
+
+/**
+  Remove the histograms of a dropped table. Errors are ignored: a missing
+  mysql.column_stats must not make DROP TABLE fail.
+*/
+
+void drop_table_histograms(THD *thd, const char *db, const char *table_name)
+{
+  TABLE_LIST tables;
+  Open_tables_backup backup;
+  Dummy_error_handler error_handler;
+  TABLE *table;
+  uint deleted;
+  DBUG_ENTER("drop_table_histograms");
+
+  if (column_stats_known_empty())
+    DBUG_VOID_RETURN;
+
+  thd->push_internal_handler(&error_handler);
+  if ((table= open_column_stats_for_write(thd, &tables, &backup)))
+  {
+    tmp_disable_binlog(thd);
+    (void) delete_histograms(table, db, table_name, NULL, &deleted);
+    reenable_binlog(thd);
+    close_system_tables(thd, &backup);
+  }
+  thd->pop_internal_handler();
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  Move the histograms of a renamed table to its new name. Errors are
+  ignored like in drop_table_histograms().
+*/
+
+void rename_table_histograms(THD *thd, const char *db, const char *table_name,
+                             const char *new_db, const char *new_table_name)
+{
+  TABLE_LIST tables;
+  Open_tables_backup backup;
+  Dummy_error_handler error_handler;
+  TABLE *table;
+  DBUG_ENTER("rename_table_histograms");
+
+  if (column_stats_known_empty())
+    DBUG_VOID_RETURN;
+
+  thd->push_internal_handler(&error_handler);
+  if ((table= open_column_stats_for_write(thd, &tables, &backup)))
+  {
+    tmp_disable_binlog(thd);
+    (void) rename_histograms(table, db, table_name, new_db, new_table_name);
+    reenable_binlog(thd);
+    close_system_tables(thd, &backup);
+  }
+  thd->pop_internal_handler();
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  Read the histograms of a table from mysql.column_stats.
+
+  @return Array of histograms indexed by field number, allocated on
+          mem_root, or NULL if the table has no histograms.
+*/
+
+static Histogram **read_histograms(THD *thd, TABLE *table, MEM_ROOT *mem_root)
+{
+  TABLE_SHARE *share= table->s;
+  TABLE_LIST tables;
+  Open_tables_backup backup;
+  Dummy_error_handler error_handler;
+  Histogram **histograms= NULL;
+  TABLE *stats;
+  uchar key[MAX_KEY_LENGTH];
+  char name_buff[NAME_LEN + 1];
+  String name(name_buff, sizeof(name_buff), system_charset_info);
+  String image;
+  int error;
+  DBUG_ENTER("read_histograms");
+
+  const int32 version= my_atomic_load32(&column_stats_version);
+  if (column_stats_known_empty())
+    DBUG_RETURN(NULL);
+
+  init_column_stats_table_list(&tables, TL_READ);
+  thd->push_internal_handler(&error_handler);
+  if (open_system_tables_for_read(thd, &tables, &backup))
+  {
+    thd->pop_internal_handler();
+    DBUG_RETURN(NULL);
+  }
+  stats= tables.table;
+
+  if (check_column_stats_table(stats) ||
+      stats->file->ha_index_init(0, true))
+    goto end;
+
+  if (stats->file->ha_index_first(stats->record[0]) == HA_ERR_END_OF_FILE)
+  {
+    /*
+      No table has histograms: skip the reads until ANALYZE TABLE stores
+      some, and don't keep the definition of the statistics table cached
+      on behalf of the user table that happened to be opened first.
+    */
+    stats->file->ha_index_end();
+    close_system_tables(thd, &backup);
+    thd->pop_internal_handler();
+    my_atomic_store32(&column_stats_empty_version, version);
+    if (!thd->locked_tables_mode)
+      tdc_remove_table(thd, TDC_RT_REMOVE_UNUSED, MYSQL_SCHEMA_NAME.str,
+                       COLUMN_STATS_NAME.str, false);
+    DBUG_RETURN(NULL);
+  }
+
+  store_key_prefix(stats, share->db.str, share->table_name.str, NULL);
+  key_copy(key, stats->record[0], stats->key_info, key_prefix_length(stats));
+
+  error= stats->file->ha_index_read_map(stats->record[0], key,
+                                        make_prev_keypart_map(2),
+                                        HA_READ_KEY_EXACT);
+  for (; !error;
+       error= stats->file->ha_index_next_same(stats->record[0], key,
+                                              key_prefix_length(stats)))
+  {
+    Field *field;
+    Histogram *histogram;
+
+    stats->field[COLUMN_STATS_FIELD_COLUMN_NAME]->val_str(&name);
+    if (!(field= find_field_in_table_sef(table, name.c_ptr_safe())) ||
+        !histogram_supported(field))
+      continue;
+
+    stats->field[COLUMN_STATS_FIELD_BUCKETS]->val_str(&image);
+    histogram= Histogram::deserialize(
+      mem_root,
+      (Histogram::enum_histogram_type)
+      (stats->field[COLUMN_STATS_FIELD_HISTOGRAM_TYPE]->val_int() - 1),
+      stats->field[COLUMN_STATS_FIELD_NULL_FRACTION]->val_real(),
+      stats->field[COLUMN_STATS_FIELD_SAMPLING_RATE]->val_real(),
+      (const uchar*) image.ptr(), image.length());
+    if (!histogram)
+      continue;
+
+    if (!histograms)
+    {
+      if (!(histograms= (Histogram**) alloc_root(mem_root, share->fields *
+                                                 sizeof(Histogram*))))
+        break;
+      memset(histograms, 0, share->fields * sizeof(Histogram*));
+    }
+    histograms[field->field_index]= histogram;
+  }
+  stats->file->ha_index_end();
+
+end:
+  close_system_tables(thd, &backup);
+  thd->pop_internal_handler();
+  DBUG_RETURN(histograms);
+}
+
+
+/**
+  Make the histograms of a table available in table->histograms.
+
+  The histograms are read from mysql.column_stats the first time any
+  instance of the table needs them and cached in its TABLE_SHARE, so
+  ANALYZE TABLE ... HISTOGRAM evicts the share to make the changes
+  visible.
+*/
+
+void load_histograms(THD *thd, TABLE *table)
+{
+  TABLE_SHARE *share= table->s;
+
+  if (table->histograms_checked)
+    return;
+  table->histograms_checked= true;
+
+  if (share->tmp_table != NO_TMP_TABLE ||
+      share->table_category != TABLE_CATEGORY_USER)
+    return;
+
+  mysql_mutex_lock(&share->LOCK_ha_data);
+  const bool loaded= share->histograms_loaded;
+  mysql_mutex_unlock(&share->LOCK_ha_data);
+
+  if (!loaded)
+  {
+    /* Don't let reading the statistics affect THD's status variables */
+    struct system_status_var save_thd_status_var= thd->status_var;
+    Histogram **histograms= read_histograms(thd, table, thd->mem_root);
+    thd->status_var= save_thd_status_var;
+
+    mysql_mutex_lock(&share->LOCK_ha_data);
+    if (!share->histograms_loaded && histograms)
+    {
+      Histogram **copy= (Histogram**) alloc_root(&share->mem_root,
+                                                 share->fields *
+                                                 sizeof(Histogram*));
+      if (copy)
+      {
+        for (uint i= 0; i < share->fields; i++)
+          copy[i]= histograms[i] ? histograms[i]->clone(&share->mem_root)
+                                 : NULL;
+        share->histograms= copy;
+      }
+    }
+    share->histograms_loaded= true;
+    mysql_mutex_unlock(&share->LOCK_ha_data);
+  }
+
+  table->histograms= share->histograms;
+}
+
+
+/****************************************************************************
+  Selectivity estimates
+****************************************************************************/
+
+/**
+  @return The field of table that item refers to if the field has a
+          histogram and is not indexed, NULL otherwise. Conditions on
+          indexed fields are left to the range optimizer.
+*/
+
+static Field *histogram_field(TABLE *table, Item *item,
+                              const Histogram **histogram)
+{
+  item= item->real_item();
+  if (item->type() != Item::FIELD_ITEM)
+    return NULL;
+
+  Field *field= ((Item_field*) item)->field;
+  if (field->table != table || !table->histograms ||
+      !table->histograms[field->field_index] ||
+      !field->part_of_key.is_clear_all())
+    return NULL;
+
+  *histogram= table->histograms[field->field_index];
+  return field;
+}
+
+
+static double comparison_selectivity(TABLE *table, Item_func *func)
+{
+  Item **args= func->arguments();
+  Item_func::Functype type= func->functype();
+  Item *value_item= args[1];
+  const Histogram *histogram;
+  Field *field;
+  double value;
+
+  if (!(field= histogram_field(table, args[0], &histogram)))
+  {
+    if (!(field= histogram_field(table, args[1], &histogram)))
+      return 1.0;
+    value_item= args[0];
+    type= ((Item_bool_func2*) func)->rev_functype();
+  }
+
+  if (!histogram_item_value(field, value_item, &value))
+    return 1.0;
+
+  switch (type) {
+  case Item_func::EQ_FUNC:
+  case Item_func::EQUAL_FUNC:
+    return histogram->equal_selectivity(value);
+  case Item_func::NE_FUNC:
+    return histogram->not_null_selectivity() -
+           histogram->equal_selectivity(value);
+  case Item_func::LT_FUNC:
+    return histogram->less_selectivity(value, false);
+  case Item_func::LE_FUNC:
+    return histogram->less_selectivity(value, true);
+  case Item_func::GT_FUNC:
+    return histogram->greater_selectivity(value, false);
+  case Item_func::GE_FUNC:
+    return histogram->greater_selectivity(value, true);
+  default:
+    return 1.0;
+  }
+}
+
+
+static double predicate_selectivity(TABLE *table, Item_func *func)
+{
+  Item **args= func->arguments();
+  const Histogram *histogram;
+  Field *field;
+  double selectivity;
+
+  switch (func->functype()) {
+  case Item_func::EQ_FUNC:
+  case Item_func::EQUAL_FUNC:
+  case Item_func::NE_FUNC:
+  case Item_func::LT_FUNC:
+  case Item_func::LE_FUNC:
+  case Item_func::GT_FUNC:
+  case Item_func::GE_FUNC:
+    return comparison_selectivity(table, func);
+
+  case Item_func::BETWEEN:
+  {
+    double min_value, max_value;
+    if (!(field= histogram_field(table, args[0], &histogram)) ||
+        !histogram_item_value(field, args[1], &min_value) ||
+        !histogram_item_value(field, args[2], &max_value))
+      return 1.0;
+    selectivity= histogram->between_selectivity(min_value, max_value);
+    if (((Item_func_opt_neg*) func)->negated)
+      selectivity= histogram->not_null_selectivity() - selectivity;
+    return selectivity;
+  }
+
+  case Item_func::IN_FUNC:
+  {
+    if (!(field= histogram_field(table, args[0], &histogram)))
+      return 1.0;
+    selectivity= 0.0;
+    for (uint i= 1; i < func->argument_count(); i++)
+    {
+      double value;
+      if (!histogram_item_value(field, args[i], &value))
+        return 1.0;
+      selectivity+= histogram->equal_selectivity(value);
+    }
+    selectivity= std::min(selectivity, histogram->not_null_selectivity());
+    if (((Item_func_opt_neg*) func)->negated)
+      selectivity= histogram->not_null_selectivity() - selectivity;
+    return selectivity;
+  }
+
+  case Item_func::ISNULL_FUNC:
+    if (!(field= histogram_field(table, args[0], &histogram)))
+      return 1.0;
+    return histogram->null_selectivity();
+
+  case Item_func::ISNOTNULL_FUNC:
+    if (!(field= histogram_field(table, args[0], &histogram)))
+      return 1.0;
+    return histogram->not_null_selectivity();
+
+  case Item_func::MULT_EQUAL_FUNC:
+  {
+    Item_equal *item_equal= (Item_equal*) func;
+    Item *const_item= item_equal->get_const();
+    Item_equal_iterator it(*item_equal);
+    Item_field *item_field;
+    Field *eq_field= NULL;
+    double value;
+
+    if (!const_item)
+      return 1.0;
+    while ((item_field= it++))
+    {
+      Field *field= item_field->field;
+      if (field->table != table)
+        continue;
+      /* The range optimizer has estimated the equality already */
+      if (!field->part_of_key.is_clear_all())
+        return 1.0;
+      if (!eq_field && table->histograms[field->field_index])
+        eq_field= field;
+    }
+    if (!eq_field || !histogram_item_value(eq_field, const_item, &value))
+      return 1.0;
+    return table->histograms[eq_field->field_index]->
+      equal_selectivity(value);
+  }
+
+  default:
+    return 1.0;
+  }
+}
+
+
+/**
+  Estimate the fraction of the rows of table that satisfy the predicates
+  of cond on non-indexed columns with histograms. Conjuncts are assumed
+  to be independent, other predicates do not filter.
+
+  @param table  Table whose histograms are used, see load_histograms()
+  @param cond   Condition, typically the WHERE clause of a query block
+
+  @return Selectivity in [0, 1]
+*/
+
+double histogram_cond_selectivity(TABLE *table, Item *cond)
+{
+  if (!table->histograms || !cond ||
+      (cond->type() != Item::FUNC_ITEM && cond->type() != Item::COND_ITEM))
+    return 1.0;
+
+  if (cond->type() == Item::COND_ITEM)
+  {
+    if (((Item_cond*) cond)->functype() != Item_func::COND_AND_FUNC)
+      return 1.0;
+
+    double selectivity= 1.0;
+    List_iterator_fast<Item> li(*((Item_cond*) cond)->argument_list());
+    Item *item;
+    while ((item= li++))
+      selectivity*= histogram_cond_selectivity(table, item);
+    return selectivity;
+  }
+
+  return clamp_selectivity(predicate_selectivity(table, (Item_func*) cond));
+}
+
+
+/**
+  Estimate the number of rows of an equality range on the first part of
+  an index. Used instead of index statistics when index dives are
+  skipped because of eq_range_index_dive_limit.
+
+  @return Estimated number of rows, at least 1; 0 if the column has no
+          histogram.
+*/
+
+ha_rows histogram_eq_range_rows(TABLE *table, uint keyno,
+                                const key_range *key)
+{
+  const KEY_PART_INFO *key_part= table->key_info[keyno].key_part;
+  Field *field= key_part->field;
+  const uchar *ptr= key->key;
+  const Histogram *histogram;
+
+  if (!table->histograms ||
+      !(histogram= table->histograms[field->field_index]) ||
+      (key_part->key_part_flag & HA_PART_KEY_SEG))
+    return 0;
+
+  if (key_part->null_bit && *ptr++)
+    return 0;
+
+  my_bitmap_map *old_write_map= dbug_tmp_use_all_columns(table,
+                                                         table->write_set);
+  my_bitmap_map *old_read_map= dbug_tmp_use_all_columns(table,
+                                                        table->read_set);
+  field->set_key_image(ptr, key_part->length);
+  const double value= histogram_field_value(field);
+  dbug_tmp_restore_column_map(table->read_set, old_read_map);
+  dbug_tmp_restore_column_map(table->write_set, old_write_map);
+
+  const ha_rows rows= (ha_rows) rint(histogram->equal_selectivity(value) *
+                                     table->file->stats.records);
+  return std::max<ha_rows>(rows, 1);
+}
+
+
+/****************************************************************************
+  ANALYZE TABLE ... UPDATE | DROP HISTOGRAM
+****************************************************************************/
+
+/**
+  Sample the rows of table and build a histogram for each of fields.
+
+  The table is scanned once; each row is kept with probability
+  histogram_sample_rows / number of rows.
+
+  @return false on success, true if an error was reported
+*/
+
+static bool build_histograms(THD *thd, TABLE *table, Field **fields,
+                             uint field_count, uint buckets,
+                             Histogram **histograms)
+{
+  typedef Mem_root_array<double, true> Value_array;
+  handler *file= table->file;
+  Value_array *values;
+  ha_rows *null_counts;
+  int error;
+
+  (void) file->info(HA_STATUS_VARIABLE | HA_STATUS_NO_LOCK);
+  const double sampling_rate=
+    (file->stats.records > thd->variables.histogram_sample_rows) ?
+    (double) thd->variables.histogram_sample_rows / file->stats.records : 1.0;
+
+  if (!(values= (Value_array*) thd->alloc(field_count * sizeof(Value_array))) ||
+      !(null_counts= (ha_rows*) thd->calloc(field_count * sizeof(ha_rows))))
+    return true;
+
+  bitmap_clear_all(table->read_set);
+  for (uint i= 0; i < field_count; i++)
+  {
+    new (&values[i]) Value_array(thd->mem_root);
+    bitmap_set_bit(table->read_set, fields[i]->field_index);
+  }
+
+  if ((error= file->ha_rnd_init(true)))
+  {
+    file->print_error(error, MYF(0));
+    return true;
+  }
+
+  for (;;)
+  {
+    if (thd->killed)
+    {
+      file->ha_rnd_end();
+      thd->send_kill_message();
+      return true;
+    }
+    if ((error= file->ha_rnd_next(table->record[0])))
+    {
+      if (error == HA_ERR_RECORD_DELETED)
+        continue;
+      break;
+    }
+    if (sampling_rate < 1.0 && my_rnd(&thd->rand) >= sampling_rate)
+      continue;
+
+    for (uint i= 0; i < field_count; i++)
+    {
+      if (fields[i]->is_null())
+        null_counts[i]++;
+      else if (values[i].push_back(histogram_field_value(fields[i])))
+      {
+        file->ha_rnd_end();
+        return true;
+      }
+    }
+  }
+  file->ha_rnd_end();
+
+  if (error != HA_ERR_END_OF_FILE)
+  {
+    file->print_error(error, MYF(0));
+    return true;
+  }
+
+  for (uint i= 0; i < field_count; i++)
+  {
+    double *begin= values[i].empty() ? NULL : values[i].begin();
+    std::sort(begin, begin + values[i].size());
+    if (!(histograms[i]= Histogram::build(thd->mem_root, begin,
+                                          values[i].size(), null_counts[i],
+                                          sampling_rate, buckets)))
+      return true;
+  }
+  return false;
+}
+
+
+static bool send_histogram_row(Protocol *protocol, const char *table_name,
+                               const char *msg_type, const char *msg_text)
+{
+  protocol->prepare_for_resend();
+  protocol->store(table_name, system_charset_info);
+  protocol->store(STRING_WITH_LEN("histogram"), system_charset_info);
+  protocol->store(msg_type, system_charset_info);
+  protocol->store(msg_text, system_charset_info);
+  return protocol->write();
+}
+
+
+/**
+  Execute ANALYZE TABLE t UPDATE HISTOGRAM ON c1, ... [WITH n BUCKETS]
+  and ANALYZE TABLE t DROP HISTOGRAM ON c1, ...
+
+  Sends one result row per column, in the format of the other table
+  maintenance statements.
+
+  @param thd         Thread handle
+  @param table_list  The table, privileges have been checked
+  @param command     HISTOGRAM_UPDATE or HISTOGRAM_DROP
+  @param columns     Names of the columns
+  @param buckets     Maximum number of buckets of the new histograms
+
+  @return false on success, true if an error was reported
+*/
+
+bool mysql_histogram_table(THD *thd, TABLE_LIST *table_list,
+                           enum_histogram_command command,
+                           List<String> *columns, uint buckets)
+{
+  Protocol *protocol= thd->protocol;
+  List<Item> field_list;
+  Item *item;
+  const uint column_count= columns->elements;
+  const char **column_names;
+  const char **msg_types;
+  const char **msg_texts;
+  Histogram **histograms;
+  char table_name[NAME_LEN * 2 + 2];
+  TABLE_LIST tables;
+  Open_tables_backup backup;
+  TABLE *stats;
+  int error= 0;
+  DBUG_ENTER("mysql_histogram_table");
+
+  DBUG_ASSERT(command != HISTOGRAM_NONE);
+
+  if (table_list->next_local)
+  {
+    my_error(ER_WRONG_USAGE, MYF(0), "HISTOGRAM", "multiple tables");
+    DBUG_RETURN(true);
+  }
+  if (thd->locked_tables_mode)
+  {
+    my_error(ER_LOCK_OR_ACTIVE_TRANSACTION, MYF(0));
+    DBUG_RETURN(true);
+  }
+  if (buckets < 1 || buckets > HISTOGRAM_MAX_BUCKETS)
+  {
+    my_error(ER_HISTOGRAM_BUCKETS_OUT_OF_RANGE, MYF(0),
+             HISTOGRAM_MAX_BUCKETS);
+    DBUG_RETURN(true);
+  }
+
+  strxnmov(table_name, sizeof(table_name) - 1, table_list->db, ".",
+           table_list->table_name, NullS);
+
+  if (!(column_names= (const char**) thd->calloc(column_count *
+                                                 sizeof(char*))) ||
+      !(msg_types= (const char**) thd->calloc(column_count *
+                                              sizeof(char*))) ||
+      !(msg_texts= (const char**) thd->calloc(column_count *
+                                              sizeof(char*))) ||
+      !(histograms= (Histogram**) thd->calloc(column_count *
+                                              sizeof(Histogram*))))
+    DBUG_RETURN(true);
+
+  {
+    List_iterator_fast<String> it(*columns);
+    String *name;
+    for (uint i= 0; (name= it++); i++)
+      column_names[i]= name->c_ptr_safe();
+  }
+
+  if (command == HISTOGRAM_UPDATE)
+  {
+    Field **fields;
+    uint *field_slots;
+    uint field_count= 0;
+    TABLE *table;
+    bool res;
+
+    if (!(fields= (Field**) thd->alloc(column_count * sizeof(Field*))) ||
+        !(field_slots= (uint*) thd->alloc(column_count * sizeof(uint))))
+      DBUG_RETURN(true);
+
+    table_list->lock_type= TL_READ;
+    table_list->mdl_request.set_type(MDL_SHARED_READ);
+    if (open_and_lock_tables(thd, table_list, FALSE, 0))
+      DBUG_RETURN(true);
+
+    table= table_list->table;
+    if (table_list->view || !table || table->s->tmp_table != NO_TMP_TABLE)
+    {
+      my_error(ER_WRONG_OBJECT, MYF(0), table_list->db,
+               table_list->table_name, "BASE TABLE");
+      goto err;
+    }
+
+    for (uint i= 0; i < column_count; i++)
+    {
+      Field *field= find_field_in_table_sef(table, column_names[i]);
+      char buff[MYSQL_ERRMSG_SIZE];
+
+      if (!field)
+      {
+        my_snprintf(buff, sizeof(buff), ER(ER_BAD_FIELD_ERROR),
+                    column_names[i], table_name);
+        msg_types[i]= "error";
+        msg_texts[i]= thd->strdup(buff);
+        continue;
+      }
+      if (!histogram_supported(field))
+      {
+        my_snprintf(buff, sizeof(buff),
+                    "The type of column '%s' does not support histograms.",
+                    field->field_name);
+        msg_types[i]= "error";
+        msg_texts[i]= thd->strdup(buff);
+        continue;
+      }
+
+      /* Field names are freed with the table, keep a copy */
+      column_names[i]= thd->strdup(field->field_name);
+      field_slots[i]= field_count;
+      for (uint j= 0; j < field_count; j++)
+      {
+        if (fields[j] == field)
+          field_slots[i]= j;
+      }
+      if (field_slots[i] == field_count)
+        fields[field_count++]= field;
+
+      my_snprintf(buff, sizeof(buff),
+                  "Histogram statistics created for column '%s'.",
+                  column_names[i]);
+      msg_types[i]= "status";
+      msg_texts[i]= thd->strdup(buff);
+    }
+
+    res= build_histograms(thd, table, fields, field_count, buckets,
+                          histograms);
+    if (res)
+      goto err;
+
+    if (trans_commit_stmt(thd) || trans_commit_implicit(thd))
+      goto err;
+    close_thread_tables(thd);
+    thd->mdl_context.release_transactional_locks();
+
+    if (!(stats= open_column_stats_for_write(thd, &tables, &backup)))
+      DBUG_RETURN(true);
+
+    tmp_disable_binlog(thd);
+    for (uint i= 0; i < column_count && !error; i++)
+    {
+      if (strcmp(msg_types[i], "status"))
+        continue;
+      error= store_histogram(thd, stats, table_list->db,
+                             table_list->table_name, column_names[i],
+                             histograms[field_slots[i]]);
+    }
+    my_atomic_add32(&column_stats_version, 1);
+    reenable_binlog(thd);
+  }
+  else
+  {
+    if (!(stats= open_column_stats_for_write(thd, &tables, &backup)))
+      DBUG_RETURN(true);
+
+    tmp_disable_binlog(thd);
+    for (uint i= 0; i < column_count && !error; i++)
+    {
+      char buff[MYSQL_ERRMSG_SIZE];
+      uint deleted;
+
+      if ((error= delete_histograms(stats, table_list->db,
+                                    table_list->table_name, column_names[i],
+                                    &deleted)))
+        break;
+      if (deleted)
+      {
+        my_snprintf(buff, sizeof(buff),
+                    "Histogram statistics removed for column '%s'.",
+                    column_names[i]);
+        msg_types[i]= "status";
+      }
+      else
+      {
+        my_snprintf(buff, sizeof(buff),
+                    "No histogram statistics found for column '%s'.",
+                    column_names[i]);
+        msg_types[i]= "error";
+      }
+      msg_texts[i]= thd->strdup(buff);
+    }
+    reenable_binlog(thd);
+  }
+
+  if (error)
+    stats->file->print_error(error, MYF(0));
+  close_system_tables(thd, &backup);
+  if (error)
+    DBUG_RETURN(true);
+
+  /* Make the new histograms visible to new instances of the table */
+  tdc_remove_table(thd, TDC_RT_REMOVE_UNUSED, table_list->db,
+                   table_list->table_name, FALSE);
+
+  field_list.push_back(item= new Item_empty_string("Table", NAME_CHAR_LEN*2));
+  item->maybe_null= 1;
+  field_list.push_back(item= new Item_empty_string("Op", 10));
+  item->maybe_null= 1;
+  field_list.push_back(item= new Item_empty_string("Msg_type", 10));
+  item->maybe_null= 1;
+  field_list.push_back(item= new Item_empty_string("Msg_text",
+                                                   SQL_ADMIN_MSG_TEXT_SIZE));
+  item->maybe_null= 1;
+  if (protocol->send_result_set_metadata(&field_list,
+                                         Protocol::SEND_NUM_ROWS |
+                                         Protocol::SEND_EOF))
+    DBUG_RETURN(true);
+
+  for (uint i= 0; i < column_count; i++)
+  {
+    if (send_histogram_row(protocol, table_name, msg_types[i], msg_texts[i]))
+      DBUG_RETURN(true);
+  }
+
+  my_eof(thd);
+  DBUG_RETURN(false);
+
+err:
+  trans_rollback_stmt(thd);
+  trans_rollback(thd);
+  close_thread_tables(thd);
+  thd->mdl_context.release_transactional_locks();
+  DBUG_RETURN(true);
+}
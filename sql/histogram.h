@@ -0,0 +1,154 @@
+#ifndef HISTOGRAM_INCLUDED
+#define HISTOGRAM_INCLUDED
+
+/* Copyright (c) 2013, Facebook, Inc. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/**
+  @file
+
+  @brief
+  Column value histograms.
+
+  A histogram describes the distribution of the values of one column. It
+  is built from a sample of the rows by
+  ANALYZE TABLE t UPDATE HISTOGRAM ON c1, c2 [WITH n BUCKETS], stored in
+  mysql.column_stats and loaded into the TABLE_SHARE the first time the
+  optimizer needs it. ANALYZE TABLE t DROP HISTOGRAM ON c1 removes it.
+
+  Column values are mapped to doubles: numeric and temporal values by
+  their numeric value, strings by the leading bytes of their sort key.
+  The mapping preserves the order of the values, which is all the
+  selectivity estimates rely on.
+
+  The optimizer uses histograms to estimate the selectivity of WHERE
+  predicates on non-indexed columns, and in place of index statistics for
+  equality ranges when eq_range_index_dive_limit disables index dives.
+*/
+
+#include "my_global.h"
+#include "sql_alloc.h"
+#include "my_base.h"                            // ha_rows
+
+class Field;
+class Item;
+class String;
+class THD;
+struct TABLE;
+struct TABLE_LIST;
+template <class T> class List;
+
+/** Number of buckets used when ANALYZE TABLE does not specify it. */
+#define HISTOGRAM_DEFAULT_BUCKETS 100
+/** Largest number of buckets a histogram can have. */
+#define HISTOGRAM_MAX_BUCKETS 1024
+
+class Histogram : public Sql_alloc
+{
+public:
+  enum enum_histogram_type
+  {
+    /** One bucket per distinct value. */
+    SINGLETON= 0,
+    /** Buckets holding about the same number of rows each. */
+    EQUI_HEIGHT
+  };
+
+  /**
+    A bucket covers the values in [lower, upper]. cumulative_frequency is
+    the fraction of all rows of the table, NULLs included, whose value is
+    not NULL and not greater than upper. ndv is the number of distinct
+    values seen in the bucket.
+  */
+  struct Bucket
+  {
+    double lower;
+    double upper;
+    double cumulative_frequency;
+    double ndv;
+  };
+
+  Histogram(enum_histogram_type type, double null_fraction,
+            double sampling_rate, uint bucket_count, Bucket *buckets)
+    : m_type(type), m_null_fraction(null_fraction),
+      m_sampling_rate(sampling_rate), m_bucket_count(bucket_count),
+      m_buckets(buckets)
+  {}
+
+  static Histogram *build(MEM_ROOT *mem_root, double *values,
+                          ha_rows value_count, ha_rows null_count,
+                          double sampling_rate, uint max_buckets);
+  static Histogram *deserialize(MEM_ROOT *mem_root, enum_histogram_type type,
+                                double null_fraction, double sampling_rate,
+                                const uchar *image, size_t length);
+  Histogram *clone(MEM_ROOT *mem_root) const;
+
+  /** Size of the binary image of the buckets, see serialize(). */
+  size_t serialized_length() const
+  { return m_bucket_count * BUCKET_IMAGE_LENGTH; }
+  void serialize(uchar *image) const;
+
+  enum_histogram_type type() const { return m_type; }
+  uint bucket_count() const { return m_bucket_count; }
+  double sampling_rate() const { return m_sampling_rate; }
+
+  /*
+    Selectivity estimates, as fractions of all rows of the table.
+  */
+  double null_selectivity() const { return m_null_fraction; }
+  double not_null_selectivity() const { return 1.0 - m_null_fraction; }
+  double equal_selectivity(double value) const;
+  double less_selectivity(double value, bool inclusive) const;
+  double greater_selectivity(double value, bool inclusive) const;
+  double between_selectivity(double min_value, double max_value) const;
+
+private:
+  static const size_t BUCKET_IMAGE_LENGTH= 4 * sizeof(double);
+
+  uint find_bucket(double value) const;
+  double bucket_frequency(uint idx) const
+  {
+    return m_buckets[idx].cumulative_frequency -
+      (idx ? m_buckets[idx - 1].cumulative_frequency : 0.0);
+  }
+
+  enum_histogram_type m_type;
+  double m_null_fraction;
+  double m_sampling_rate;
+  uint m_bucket_count;
+  Bucket *m_buckets;
+};
+
+enum enum_histogram_command
+{
+  HISTOGRAM_NONE= 0,
+  HISTOGRAM_UPDATE,
+  HISTOGRAM_DROP
+};
+
+bool mysql_histogram_table(THD *thd, TABLE_LIST *table_list,
+                           enum_histogram_command command,
+                           List<String> *columns, uint buckets);
+
+void load_histograms(THD *thd, TABLE *table);
+double histogram_cond_selectivity(TABLE *table, Item *cond);
+ha_rows histogram_eq_range_rows(TABLE *table, uint keyno,
+                                const key_range *key);
+
+void drop_table_histograms(THD *thd, const char *db, const char *table_name);
+void rename_table_histograms(THD *thd, const char *db, const char *table_name,
+                             const char *new_db, const char *new_table_name);
+
+#endif /* HISTOGRAM_INCLUDED */
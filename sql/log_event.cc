@@ -45,6 +45,8 @@
 #include "rpl_rli_pdb.h"
 #include "sql_show.h"    // append_identifier
 #include "rpl_info_factory.h"
+#include "mem_root_array.h"
+#include "my_atomic.h"
 
 #endif /* MYSQL_CLIENT */
 
@@ -696,6 +698,7 @@ const char* Log_event::get_type_str(Log_event_type type)
   case GTID_LOG_EVENT: return "Gtid";
   case ANONYMOUS_GTID_LOG_EVENT: return "Anonymous_Gtid";
   case PREVIOUS_GTIDS_LOG_EVENT: return "Previous_gtids";
+  case TRANSACTION_PAYLOAD_EVENT: return "Transaction_payload";
   case HEARTBEAT_LOG_EVENT: return "Heartbeat";
   default: return "Unknown";				/* impossible */
   }
@@ -1554,7 +1557,8 @@ Log_event* Log_event::read_log_event(const char* buf, uint event_len,
   }
 
   if (event_type > description_event->number_of_event_types &&
-      event_type != FORMAT_DESCRIPTION_EVENT)
+      event_type != FORMAT_DESCRIPTION_EVENT &&
+      event_type != TRANSACTION_PAYLOAD_EVENT)
   {
     /*
       It is unsafe to use the description_event if its post_header_len
@@ -1680,6 +1684,9 @@ Log_event* Log_event::read_log_event(const char* buf, uint event_len,
     case PREVIOUS_GTIDS_LOG_EVENT:
       ev= new Previous_gtids_log_event(buf, event_len, description_event);
       break;
+    case TRANSACTION_PAYLOAD_EVENT:
+      ev= new Transaction_payload_log_event(buf, event_len, description_event);
+      break;
 #if defined(HAVE_REPLICATION)
     case WRITE_ROWS_EVENT:
       ev = new Write_rows_log_event(buf, event_len, description_event);
@@ -1914,23 +1921,79 @@ my_b_write_quoted(IO_CACHE *file, const uchar *ptr, uint length)
 
 
 /**
-  Prints a bit string to io cache in format  b'1010'.
+  Prints a string to io cache as a JSON string.
+  Quotes, backslashes and control characters are escaped, e.g. \u0000
+
+  @param[in] file              IO cache
+  @param[in] ptr               Pointer to string
+  @param[in] length            String length
+*/
+static void
+my_b_write_json_quoted(IO_CACHE *file, const uchar *ptr, uint length)
+{
+  const uchar *s, *start= ptr;
+  my_b_write(file, (const uchar*) "\"", 1);
+  for (s= ptr; length > 0 ; s++, length--)
+  {
+    if (*s > 0x1F && *s != '"' && *s != '\\')
+      continue;
+    my_b_write(file, start, s - start);
+    start= s + 1;
+    if (*s == '"' || *s == '\\')
+    {
+      uchar esc[2]= { '\\', *s };
+      my_b_write(file, esc, 2);
+    }
+    else
+    {
+      uchar hex[10];
+      size_t len= my_snprintf((char*) hex, sizeof(hex), "\\u%04x", *s);
+      my_b_write(file, hex, len);
+    }
+  }
+  my_b_write(file, start, s - start);
+  my_b_write(file, (const uchar*) "\"", 1);
+}
+
+
+/**
+  Prints a string value to io cache, SQL quoted or as a JSON string.
+
+  @param[in] file              IO cache
+  @param[in] ptr               Pointer to string
+  @param[in] length            String length
+  @param[in] json              Whether to print a JSON string
+*/
+static void
+my_b_write_quoted_value(IO_CACHE *file, const uchar *ptr, uint length,
+                        bool json)
+{
+  if (json)
+    my_b_write_json_quoted(file, ptr, length);
+  else
+    my_b_write_quoted(file, ptr, length);
+}
+
+
+/**
+  Prints a bit string to io cache in format  b'1010', or "1010" for JSON.
   
   @param[in] file              IO cache
   @param[in] ptr               Pointer to string
   @param[in] nbits             Number of bits
+  @param[in] json              Whether to print a JSON string
 */
 static void
-my_b_write_bit(IO_CACHE *file, const uchar *ptr, uint nbits)
+my_b_write_bit(IO_CACHE *file, const uchar *ptr, uint nbits, bool json)
 {
   uint bitnum, nbits8= ((nbits + 7) / 8) * 8, skip_bits= nbits8 - nbits;
-  my_b_printf(file, "b'");
+  my_b_printf(file, json ? "\"" : "b'");
   for (bitnum= skip_bits ; bitnum < nbits8; bitnum++)
   {
     int is_set= (ptr[(bitnum) / 8] >> (7 - bitnum % 8))  & 0x01;
     my_b_write(file, (const uchar*) (is_set ? "1" : "0"), 1);
   }
-  my_b_printf(file, "'");
+  my_b_printf(file, json ? "\"" : "'");
 }
 
 
@@ -1942,39 +2005,43 @@ my_b_write_bit(IO_CACHE *file, const uchar *ptr, uint nbits)
   @param[in] file              IO cache
   @param[in] ptr               Pointer to string
   @param[in] length            String size
+  @param[in] json              Whether to print a JSON string
   
   @retval   - number of bytes scanned.
 */
 static size_t
-my_b_write_quoted_with_length(IO_CACHE *file, const uchar *ptr, uint length)
+my_b_write_quoted_with_length(IO_CACHE *file, const uchar *ptr, uint length,
+                              bool json)
 {
   if (length < 256)
   {
     length= *ptr;
-    my_b_write_quoted(file, ptr + 1, length);
+    my_b_write_quoted_value(file, ptr + 1, length, json);
     return length + 1;
   }
   else
   {
     length= uint2korr(ptr);
-    my_b_write_quoted(file, ptr + 2, length);
+    my_b_write_quoted_value(file, ptr + 2, length, json);
     return length + 2;
   }
 }
 
 
 /**
-  Prints a 32-bit number in both signed and unsigned representation
+  Prints a 32-bit number in both signed and unsigned representation,
+  JSON gets the signed one only
   
   @param[in] file              IO cache
   @param[in] sl                Signed number
   @param[in] ul                Unsigned number
+  @param[in] json              Whether to print a JSON number
 */
 static void
-my_b_write_sint32_and_uint32(IO_CACHE *file, int32 si, uint32 ui)
+my_b_write_sint32_and_uint32(IO_CACHE *file, int32 si, uint32 ui, bool json)
 {
   my_b_printf(file, "%d", si);
-  if (si < 0)
+  if (si < 0 && !json)
     my_b_printf(file, " (%u)", ui);
 }
 
@@ -1988,14 +2055,17 @@ my_b_write_sint32_and_uint32(IO_CACHE *file, int32 si, uint32 ui)
   @param[in] meta              Column meta information
   @param[out] typestr          SQL type string buffer (for verbose output)
   @param[out] typestr_length   Size of typestr
+  @param[in] json              Whether to print a JSON value
   
   @retval   - number of bytes scanned from ptr.
 */
 static size_t
 log_event_print_value(IO_CACHE *file, const uchar *ptr,
                       uint type, uint meta,
-                      char *typestr, size_t typestr_length)
+                      char *typestr, size_t typestr_length, bool json)
 {
+  /* Dates and times are quoted for SQL, and printed as strings in JSON */
+  const char *quote= json ? "\"" : "'";
   uint32 length= 0;
 
   if (type == MYSQL_TYPE_STRING)
@@ -2023,7 +2093,7 @@ log_event_print_value(IO_CACHE *file, const uchar *ptr,
     {
       int32 si= sint4korr(ptr);
       uint32 ui= uint4korr(ptr);
-      my_b_write_sint32_and_uint32(file, si, ui);
+      my_b_write_sint32_and_uint32(file, si, ui, json);
       my_snprintf(typestr, typestr_length, "INT");
       return 4;
     }
@@ -2031,7 +2101,7 @@ log_event_print_value(IO_CACHE *file, const uchar *ptr,
   case MYSQL_TYPE_TINY:
     {
       my_b_write_sint32_and_uint32(file, (int) (signed char) *ptr,
-                                  (uint) (unsigned char) *ptr);
+                                  (uint) (unsigned char) *ptr, json);
       my_snprintf(typestr, typestr_length, "TINYINT");
       return 1;
     }
@@ -2040,7 +2110,7 @@ log_event_print_value(IO_CACHE *file, const uchar *ptr,
     {
       int32 si= (int32) sint2korr(ptr);
       uint32 ui= (uint32) uint2korr(ptr);
-      my_b_write_sint32_and_uint32(file, si, ui);
+      my_b_write_sint32_and_uint32(file, si, ui, json);
       my_snprintf(typestr, typestr_length, "SHORTINT");
       return 2;
     }
@@ -2049,7 +2119,7 @@ log_event_print_value(IO_CACHE *file, const uchar *ptr,
     {
       int32 si= sint3korr(ptr);
       uint32 ui= uint3korr(ptr);
-      my_b_write_sint32_and_uint32(file, si, ui);
+      my_b_write_sint32_and_uint32(file, si, ui, json);
       my_snprintf(typestr, typestr_length, "MEDIUMINT");
       return 3;
     }
@@ -2060,7 +2130,7 @@ log_event_print_value(IO_CACHE *file, const uchar *ptr,
       longlong si= sint8korr(ptr);
       longlong10_to_str(si, tmp, -10);
       my_b_printf(file, "%s", tmp);
-      if (si < 0)
+      if (si < 0 && !json)
       {
         ulonglong ui= uint8korr(ptr);
         longlong10_to_str((longlong) ui, tmp, 10);
@@ -2080,6 +2150,15 @@ log_event_print_value(IO_CACHE *file, const uchar *ptr,
                         precision, decimals);
       int i, end;
       char buff[512], *pos;
+      if (json)
+      {
+        int len= sizeof(buff);
+        decimal2string(&dec, buff, &len, 0, 0, 0);
+        my_b_write(file, (uchar*) buff, len);
+        my_snprintf(typestr, typestr_length, "DECIMAL(%d,%d)",
+                    precision, decimals);
+        return bin_size;
+      }
       pos= buff;
       pos+= sprintf(buff, "%s", dec.sign() ? "-" : "");
       end= ROUND_UP(dec.frac) + ROUND_UP(dec.intg)-1;
@@ -2097,7 +2176,7 @@ log_event_print_value(IO_CACHE *file, const uchar *ptr,
       float fl;
       float4get(fl, ptr);
       char tmp[320];
-      sprintf(tmp, "%-20g", (double) fl);
+      sprintf(tmp, json ? "%g" : "%-20g", (double) fl);
       my_b_printf(file, "%s", tmp); /* my_snprintf doesn't support %-20g */
       my_snprintf(typestr, typestr_length, "FLOAT");
       return 4;
@@ -2119,7 +2198,7 @@ log_event_print_value(IO_CACHE *file, const uchar *ptr,
       /* Meta-data: bit_len, bytes_in_rec, 2 bytes */
       uint nbits= ((meta >> 8) * 8) + (meta & 0xFF);
       length= (nbits + 7) / 8;
-      my_b_write_bit(file, ptr, nbits);
+      my_b_write_bit(file, ptr, nbits, json);
       my_snprintf(typestr, typestr_length, "BIT(%d)", nbits);
       return length;
     }
@@ -2149,7 +2228,8 @@ log_event_print_value(IO_CACHE *file, const uchar *ptr,
       uint64 i64= uint8korr(ptr); /* YYYYMMDDhhmmss */
       d= i64 / 1000000;
       t= i64 % 1000000;
-      my_b_printf(file, "%04d-%02d-%02d %02d:%02d:%02d",
+      my_b_printf(file, json ? "\"%04d-%02d-%02d %02d:%02d:%02d\"" :
+                               "%04d-%02d-%02d %02d:%02d:%02d",
                   static_cast<int>(d / 10000),
                   static_cast<int>(d % 10000) / 100,
                   static_cast<int>(d % 100),
@@ -2167,7 +2247,7 @@ log_event_print_value(IO_CACHE *file, const uchar *ptr,
       longlong packed= my_datetime_packed_from_binary(ptr, meta);
       TIME_from_longlong_datetime_packed(&ltime, packed);
       int buflen= my_datetime_to_str(&ltime, buf, meta);
-      my_b_write_quoted(file, (uchar *) buf, buflen);
+      my_b_write_quoted_value(file, (uchar *) buf, buflen, json);
       my_snprintf(typestr, typestr_length, "DATETIME(%d)", meta);
       return my_datetime_binary_length(meta);
     }
@@ -2175,8 +2255,8 @@ log_event_print_value(IO_CACHE *file, const uchar *ptr,
   case MYSQL_TYPE_TIME:
     {
       uint32 i32= uint3korr(ptr);
-      my_b_printf(file, "'%02d:%02d:%02d'",
-                  i32 / 10000, (i32 % 10000) / 100, i32 % 100);
+      my_b_printf(file, "%s%02d:%02d:%02d%s", quote,
+                  i32 / 10000, (i32 % 10000) / 100, i32 % 100, quote);
       my_snprintf(typestr, typestr_length, "TIME");
       return 3;
     }
@@ -2188,7 +2268,7 @@ log_event_print_value(IO_CACHE *file, const uchar *ptr,
       longlong packed= my_time_packed_from_binary(ptr, meta);
       TIME_from_longlong_time_packed(&ltime, packed);
       int buflen= my_time_to_str(&ltime, buf, meta);
-      my_b_write_quoted(file, (uchar *) buf, buflen);
+      my_b_write_quoted_value(file, (uchar *) buf, buflen, json);
       my_snprintf(typestr, typestr_length, "TIME(%d)", meta);
       return my_time_binary_length(meta);
     }
@@ -2199,23 +2279,24 @@ log_event_print_value(IO_CACHE *file, const uchar *ptr,
       int part;
       char buf[11];
       char *pos= &buf[10];  // start from '\0' to the beginning
+      const char separator= json ? '-' : ':';
 
       /* Copied from field.cc */
       *pos--=0;					// End NULL
       part=(int) (tmp & 31);
       *pos--= (char) ('0'+part%10);
       *pos--= (char) ('0'+part/10);
-      *pos--= ':';
+      *pos--= separator;
       part=(int) (tmp >> 5 & 15);
       *pos--= (char) ('0'+part%10);
       *pos--= (char) ('0'+part/10);
-      *pos--= ':';
+      *pos--= separator;
       part=(int) (tmp >> 9);
       *pos--= (char) ('0'+part%10); part/=10;
       *pos--= (char) ('0'+part%10); part/=10;
       *pos--= (char) ('0'+part%10); part/=10;
       *pos=   (char) ('0'+part);
-      my_b_printf(file , "'%s'", buf);
+      my_b_printf(file , "%s%s%s", quote, buf, quote);
       my_snprintf(typestr, typestr_length, "DATE");
       return 3;
     }
@@ -2248,7 +2329,7 @@ log_event_print_value(IO_CACHE *file, const uchar *ptr,
     break;
     
   case MYSQL_TYPE_SET:
-    my_b_write_bit(file, ptr , (meta & 0xFF) * 8);
+    my_b_write_bit(file, ptr , (meta & 0xFF) * 8, json);
     my_snprintf(typestr, typestr_length, "SET(%d bytes)", meta & 0xFF);
     return meta & 0xFF;
   
@@ -2256,22 +2337,22 @@ log_event_print_value(IO_CACHE *file, const uchar *ptr,
     switch (meta) {
     case 1:
       length= *ptr;
-      my_b_write_quoted(file, ptr + 1, length);
+      my_b_write_quoted_value(file, ptr + 1, length, json);
       my_snprintf(typestr, typestr_length, "TINYBLOB/TINYTEXT");
       return length + 1;
     case 2:
       length= uint2korr(ptr);
-      my_b_write_quoted(file, ptr + 2, length);
+      my_b_write_quoted_value(file, ptr + 2, length, json);
       my_snprintf(typestr, typestr_length, "BLOB/TEXT");
       return length + 2;
     case 3:
       length= uint3korr(ptr);
-      my_b_write_quoted(file, ptr + 3, length);
+      my_b_write_quoted_value(file, ptr + 3, length, json);
       my_snprintf(typestr, typestr_length, "MEDIUMBLOB/MEDIUMTEXT");
       return length + 3;
     case 4:
       length= uint4korr(ptr);
-      my_b_write_quoted(file, ptr + 4, length);
+      my_b_write_quoted_value(file, ptr + 4, length, json);
       my_snprintf(typestr, typestr_length, "LONGBLOB/LONGTEXT");
       return length + 4;
     default:
@@ -2283,19 +2364,22 @@ log_event_print_value(IO_CACHE *file, const uchar *ptr,
   case MYSQL_TYPE_VAR_STRING:
     length= meta;
     my_snprintf(typestr, typestr_length, "VARSTRING(%d)", length);
-    return my_b_write_quoted_with_length(file, ptr, length);
+    return my_b_write_quoted_with_length(file, ptr, length, json);
 
   case MYSQL_TYPE_STRING:
     my_snprintf(typestr, typestr_length, "STRING(%d)", length);
-    return my_b_write_quoted_with_length(file, ptr, length);
+    return my_b_write_quoted_with_length(file, ptr, length, json);
 
   default:
     {
       char tmp[5];
       my_snprintf(tmp, sizeof(tmp), "%04x", meta);
-      my_b_printf(file,
-                  "!! Don't know how to handle column type=%d meta=%d (%s)",
-                  type, meta, tmp);
+      if (json)
+        my_b_printf(file, "null");
+      else
+        my_b_printf(file,
+                    "!! Don't know how to handle column type=%d meta=%d (%s)",
+                    type, meta, tmp);
     }
     break;
   }
@@ -2350,7 +2434,7 @@ Rows_log_event::print_verbose_one_row(IO_CACHE *file, table_def *td,
       my_b_printf(file, "###   @%d=", static_cast<int>(i + 1));
       size_t size= log_event_print_value(file, value,
                                          td->type(i), td->field_metadata(i),
-                                         typestr, sizeof(typestr));
+                                         typestr, sizeof(typestr), false);
       if (!size)
         return 0;
 
@@ -2502,6 +2586,135 @@ end:
   delete td;
 }
 
+
+/**
+  Print the columns of a packed row into IO cache as a JSON object
+  with the same @N names as the verbose output
+
+  @param[in] file              IO cache
+  @param[in] td                Table definition
+  @param[in] cols_bitmap       Column bitmaps.
+  @param[in] value             Pointer to packed row
+
+  @retval   - number of bytes scanned.
+*/
+size_t
+Rows_log_event::print_json_one_row(IO_CACHE *file, table_def *td,
+                                   MY_BITMAP *cols_bitmap,
+                                   const uchar *value)
+{
+  const uchar *value0= value;
+  const uchar *null_bits= value;
+  uint null_bit_index= 0;
+  char typestr[64]= "";
+  const char *separator= "";
+
+  value+= (m_width + 7) / 8;
+
+  my_b_printf(file, "{");
+  for (size_t i= 0; i < td->size(); i ++)
+  {
+    int is_null= (null_bits[null_bit_index / 8]
+                  >> (null_bit_index % 8))  & 0x01;
+
+    if (bitmap_is_set(cols_bitmap, i) == 0)
+      continue;
+
+    my_b_printf(file, "%s\"@%d\":", separator, static_cast<int>(i + 1));
+    separator= ",";
+    if (is_null)
+      my_b_printf(file, "null");
+    else
+    {
+      size_t size= log_event_print_value(file, value,
+                                         td->type(i), td->field_metadata(i),
+                                         typestr, sizeof(typestr), true);
+      if (!size)
+        return 0;
+
+      value+= size;
+    }
+    null_bit_index++;
+  }
+  my_b_printf(file, "}");
+  return value - value0;
+}
+
+
+/**
+  Print a row event into IO cache as JSON, one object per row:
+
+    {"type":"update","db":"test","table":"t1","before":{...},"after":{...}}
+
+  @param[in] file              IO cache
+  @param[in] print_event_into  Print parameters
+*/
+void Rows_log_event::print_json(IO_CACHE *file,
+                                PRINT_EVENT_INFO *print_event_info)
+{
+  Table_map_log_event *map;
+  table_def *td;
+  const char *type, *image1, *image2;
+  Log_event_type general_type_code= get_general_type_code();
+
+  switch (general_type_code) {
+  case WRITE_ROWS_EVENT:
+    type= "insert";
+    image1= "after";
+    image2= NULL;
+    break;
+  case DELETE_ROWS_EVENT:
+    type= "delete";
+    image1= "before";
+    image2= NULL;
+    break;
+  case UPDATE_ROWS_EVENT:
+    type= "update";
+    image1= "before";
+    image2= "after";
+    break;
+  default:
+    type= image1= image2= NULL;
+    DBUG_ASSERT(0); /* Not possible */
+  }
+
+  if (!(map= print_event_info->m_table_map.get_table(m_table_id)) ||
+      !(td= map->create_table_def()))
+  {
+    char llbuff[22];
+    my_b_printf(file, "{\"type\":\"%s\",\"table_id\":%s}\n",
+                type, llstr(m_table_id, llbuff));
+    return;
+  }
+
+  for (const uchar *value= m_rows_buf; value < m_rows_end; )
+  {
+    size_t length;
+    my_b_printf(file, "{\"type\":\"%s\",\"db\":", type);
+    my_b_write_json_quoted(file, (const uchar*) map->get_db_name(),
+                           strlen(map->get_db_name()));
+    my_b_printf(file, ",\"table\":");
+    my_b_write_json_quoted(file, (const uchar*) map->get_table_name(),
+                           strlen(map->get_table_name()));
+
+    my_b_printf(file, ",\"%s\":", image1);
+    if (!(length= print_json_one_row(file, td, &m_cols, value)))
+      break;
+    value+= length;
+
+    if (image2)
+    {
+      my_b_printf(file, ",\"%s\":", image2);
+      if (!(length= print_json_one_row(file, td, &m_cols_ai, value)))
+        break;
+      value+= length;
+    }
+    my_b_printf(file, "}\n");
+  }
+
+  delete td;
+}
+
 #ifdef MYSQL_CLIENT
 void free_table_map_log_event(Table_map_log_event *event)
 {
@@ -2515,23 +2728,26 @@ void Log_event::print_base64(IO_CACHE* file,
 {
   const uchar *ptr= (const uchar *)temp_buf;
   uint32 size= uint4korr(ptr + EVENT_LEN_OFFSET);
+  bool const json=
+    print_event_info->base64_output_mode == BASE64_OUTPUT_JSON;
   DBUG_ENTER("Log_event::print_base64");
 
-  size_t const tmp_str_sz= base64_needed_encoded_length((int) size);
-  char *const tmp_str= (char *) my_malloc(tmp_str_sz, MYF(MY_WME));
-  if (!tmp_str) {
-    fprintf(stderr, "\nError: Out of memory. "
-            "Could not print correct binlog event.\n");
-    DBUG_VOID_RETURN;
-  }
-
-  if (base64_encode(ptr, (size_t) size, tmp_str))
+  if (print_event_info->base64_output_mode != BASE64_OUTPUT_DECODE_ROWS &&
+      !json)
   {
-    DBUG_ASSERT(0);
-  }
+    size_t const tmp_str_sz= base64_needed_encoded_length((int) size);
+    char *const tmp_str= (char *) my_malloc(tmp_str_sz, MYF(MY_WME));
+    if (!tmp_str) {
+      fprintf(stderr, "\nError: Out of memory. "
+              "Could not print correct binlog event.\n");
+      DBUG_VOID_RETURN;
+    }
+
+    if (base64_encode(ptr, (size_t) size, tmp_str))
+    {
+      DBUG_ASSERT(0);
+    }
 
-  if (print_event_info->base64_output_mode != BASE64_OUTPUT_DECODE_ROWS)
-  {
     if (my_b_tell(file) == 0)
       my_b_printf(file, "\nBINLOG '\n");
 
@@ -2539,9 +2755,11 @@ void Log_event::print_base64(IO_CACHE* file,
 
     if (!more)
       my_b_printf(file, "'%s\n", print_event_info->delimiter);
+
+    my_free(tmp_str);
   }
   
-  if (print_event_info->verbose)
+  if (print_event_info->verbose || json)
   {
     Rows_log_event *ev= NULL;
     Log_event_type et= (Log_event_type) ptr[EVENT_TYPE_OFFSET];
@@ -2587,12 +2805,14 @@ void Log_event::print_base64(IO_CACHE* file,
     
     if (ev)
     {
-      ev->print_verbose(file, print_event_info);
+      if (json)
+        ev->print_json(file, print_event_info);
+      else
+        ev->print_verbose(file, print_event_info);
       delete ev;
     }
   }
     
-  my_free(tmp_str);
   DBUG_VOID_RETURN;
 }
 
@@ -2612,12 +2832,9 @@ void Log_event::print_timestamp(IO_CACHE* file, time_t *ts)
   */
   time_t ts_tmp= ts ? *ts : (ulong)when.tv_sec;
   DBUG_ENTER("Log_event::print_timestamp");
-#ifdef MYSQL_SERVER				// This is always false
+  /* mysqlbinlog prints events in several threads with --print-workers */
   struct tm tm_tmp;
   localtime_r(&ts_tmp, (res= &tm_tmp));
-#else
-  res= localtime(&ts_tmp);
-#endif
 
   my_b_printf(file,"%02d%02d%02d %2d:%02d:%02d",
               res->tm_year % 100,
@@ -5301,7 +5518,8 @@ void Start_log_event_v3::print(FILE* file, PRINT_EVENT_INFO* print_event_info)
       print_event_info->base64_output_mode != BASE64_OUTPUT_NEVER &&
       !print_event_info->short_form)
   {
-    if (print_event_info->base64_output_mode != BASE64_OUTPUT_DECODE_ROWS)
+    if (print_event_info->base64_output_mode != BASE64_OUTPUT_DECODE_ROWS &&
+        print_event_info->base64_output_mode != BASE64_OUTPUT_JSON)
       my_b_printf(head, "BINLOG '\n");
     print_base64(head, print_event_info, FALSE);
     print_event_info->printed_fd_event= TRUE;
@@ -10686,6 +10904,170 @@ end:
 
 }
 
+/**
+  Range sequence over the sorted before images of a rows event, used by
+  Rows_log_event::do_batch_key_lookup(). Each row is an equality range on
+  the lookup key.
+*/
+struct Rows_key_seq
+{
+  TABLE *table;
+  KEY *keyinfo;
+  uchar **rows;
+  uint n_rows;
+  uint next_row;
+  uchar *key;
+  uint range_flag;
+};
+
+static range_seq_t rows_key_seq_init(void *init_param, uint n_ranges,
+                                     uint flags)
+{
+  Rows_key_seq *seq= (Rows_key_seq *) init_param;
+  seq->next_row= 0;
+  return init_param;
+}
+
+static uint rows_key_seq_next(range_seq_t rseq, KEY_MULTI_RANGE *range)
+{
+  Rows_key_seq *seq= (Rows_key_seq *) rseq;
+  if (seq->next_row == seq->n_rows)
+    return 1;
+
+  /* key_copy() reads the key parts through the fields, i.e. record[0] */
+  memcpy(seq->table->record[0], seq->rows[seq->next_row++],
+         seq->table->s->reclength);
+  key_copy(seq->key, seq->table->record[0], seq->keyinfo, 0);
+
+  range->start_key.key= seq->key;
+  range->start_key.length= seq->keyinfo->key_length;
+  range->start_key.keypart_map=
+    make_prev_keypart_map(seq->keyinfo->user_defined_key_parts);
+  range->start_key.flag= HA_READ_KEY_EXACT;
+  range->end_key= range->start_key;
+  range->end_key.flag= HA_READ_AFTER_KEY;
+  range->ptr= NULL;
+  range->range_flag= seq->range_flag;
+  return 0;
+}
+
+static int rows_key_cmp(const void *keys, const void *a, const void *b)
+{
+  return key_rec_cmp((void *) keys, *(uchar **) a, *(uchar **) b);
+}
+
+int Rows_log_event::do_batch_key_lookup(Relay_log_info const *rli)
+{
+  DBUG_ENTER("Rows_log_event::do_batch_key_lookup");
+  DBUG_ASSERT(m_rows_lookup_algorithm == ROW_LOOKUP_INDEX_SCAN);
+  DBUG_ASSERT(!m_table->file->inited);
+
+  TABLE *table= m_table;
+  KEY *keyinfo= table->key_info + m_key_index;
+  KEY *keys[]= { keyinfo, NULL };
+  const uchar *saved_m_curr_row= m_curr_row;
+  const uchar *saved_m_curr_row_end= m_curr_row_end;
+  MEM_ROOT mem_root;
+  Mem_root_array<uchar *, true> rows(&mem_root);
+  uchar key[MAX_KEY_LENGTH];
+  Rows_key_seq seq;
+  RANGE_SEQ_IF seq_funcs= { rows_key_seq_init, rows_key_seq_next, 0, 0 };
+  char *range_info;
+  int error= 0;
+
+  /*
+    Engines that can change a row without reading it first by primary
+    key have nothing to gain from reading it in advance.
+  */
+  if (m_key_index == table->s->primary_key &&
+      (table->file->ha_table_flags() & HA_READ_BEFORE_WRITE_REMOVAL))
+    DBUG_RETURN(0);
+
+  init_sql_alloc(&mem_root, 8192, 0);
+
+  /*
+    Unpack the before images, skipping the after images of update events.
+    An unpack error is left to the apply loop, which reports it.
+  */
+  while (m_curr_row < m_rows_end)
+  {
+    prepare_record(table, &m_cols, false);
+    if (unpack_current_row(rli, &m_cols))
+      goto end;
+    uchar *row= (uchar *) memdup_root(&mem_root, table->record[0],
+                                      table->s->reclength);
+    if (!row || rows.push_back(row))
+      goto end;
+    if (get_general_type_code() == UPDATE_ROWS_EVENT)
+    {
+      m_curr_row= m_curr_row_end;
+      prepare_record(table, &m_cols, false);
+      if (unpack_current_row(rli, &m_cols_ai))
+        goto end;
+    }
+    m_curr_row= m_curr_row_end;
+  }
+
+  if (rows.size() < opt_slave_rows_batch_lookup_min_rows)
+    goto end;
+
+  /* key_rec_cmp() only compares the key parts that are in the read set */
+  memcpy(table->read_set->bitmap, m_cols.bitmap,
+         (table->read_set->n_bits + 7) / 8);
+  my_qsort2(rows.begin(), rows.size(), sizeof(uchar *), rows_key_cmp, keys);
+
+  seq.table= table;
+  seq.keyinfo= keyinfo;
+  seq.rows= rows.begin();
+  seq.n_rows= 0;
+  seq.key= key;
+  seq.range_flag= EQ_RANGE;
+  if ((keyinfo->flags & HA_NOSAME || m_key_index == table->s->primary_key) &&
+      !(keyinfo->flags & HA_NULL_PART_KEY))
+    seq.range_flag|= UNIQUE_RANGE;
+
+  /* Rows changed more than once in the event are read once */
+  for (uint i= 0; i < rows.size(); i++)
+    if (seq.n_rows == 0 ||
+        key_rec_cmp(keys, seq.rows[seq.n_rows - 1], rows.at(i)) != 0)
+      seq.rows[seq.n_rows++]= rows.at(i);
+
+  if ((error= table->file->ha_index_init(m_key_index, true)))
+    goto err;
+
+  if (!(error= table->file->multi_range_read_init(&seq_funcs, &seq,
+                                                  seq.n_rows,
+                                                  HA_MRR_SORTED |
+                                                  HA_MRR_NO_ASSOCIATION,
+                                                  NULL)))
+  {
+    while (!(error= table->file->multi_range_read_next(&range_info)) ||
+           error == HA_ERR_RECORD_DELETED)
+    {}
+    if (error == HA_ERR_END_OF_FILE || error == HA_ERR_KEY_NOT_FOUND)
+      error= 0;
+  }
+
+  if (error)
+    (void) table->file->ha_index_end();
+  else
+    error= table->file->ha_index_end();
+
+  if (!error)
+    my_atomic_add64((int64 *) &slave_rows_batch_lookups, 1);
+
+err:
+  if (error)
+    table->file->print_error(error, MYF(0));
+  table->default_column_bitmaps();
+
+end:
+  m_curr_row= saved_m_curr_row;
+  m_curr_row_end= saved_m_curr_row_end;
+  free_root(&mem_root, MYF(0));
+  DBUG_RETURN(error);
+}
+
 int Rows_log_event::do_hash_row(Relay_log_info const *rli)
 {
   DBUG_ENTER("Rows_log_event::do_hash_row");
@@ -11344,6 +11726,11 @@ int Rows_log_event::do_apply_event(Relay_log_info const *rli)
         break;
     }
 
+    if (m_rows_lookup_algorithm == ROW_LOOKUP_INDEX_SCAN &&
+        m_key_index < MAX_KEY && opt_slave_rows_batch_lookup_min_rows > 0 &&
+        (error= do_batch_key_lookup(rli)))
+      goto AFTER_MAIN_EXEC_ROW_LOOP;
+
     do {
 
       error= (this->*do_apply_row_ptr)(rli);
@@ -13608,6 +13995,203 @@ int Previous_gtids_log_event::do_update_pos(Relay_log_info *rli)
 #endif
 
 
+#ifdef MYSQL_SERVER
+Transaction_payload_log_event::
+Transaction_payload_log_event(THD *thd_arg, uint algorithm,
+                              uchar *payload, uint payload_length,
+                              uint uncompressed_length)
+  : Log_event(thd_arg, 0, Log_event::EVENT_TRANSACTIONAL_CACHE,
+              Log_event::EVENT_NORMAL_LOGGING),
+    m_algorithm(algorithm), m_payload(payload),
+    m_payload_length(payload_length),
+    m_uncompressed_length(uncompressed_length),
+    m_events(NULL), m_events_pos(0)
+{
+}
+#endif
+
+
+Transaction_payload_log_event::
+Transaction_payload_log_event(const char *buf, uint event_len,
+                              const Format_description_log_event *descr_event)
+  : Log_event(buf, descr_event),
+    m_algorithm(0), m_payload(NULL), m_payload_length(0),
+    m_uncompressed_length(0), m_events(NULL), m_events_pos(0)
+{
+  DBUG_ENTER("Transaction_payload_log_event::Transaction_payload_log_event");
+  uint8 const common_header_len= descr_event->common_header_len;
+
+  if (event_len < common_header_len + HEADER_LENGTH)
+    DBUG_VOID_RETURN;
+  const uchar *ptr= (const uchar *) buf + common_header_len;
+  m_algorithm= ptr[0];
+  m_uncompressed_length= uint4korr(ptr + 1);
+  m_payload_length= event_len - common_header_len - HEADER_LENGTH;
+  DBUG_PRINT("info", ("algorithm: %u; payload_length: %u; "
+                      "uncompressed_length: %u", m_algorithm,
+                      m_payload_length, m_uncompressed_length));
+  /*
+    The payload is copied, as callers may free buf before they are done
+    with the events of the payload.
+  */
+  m_payload= (uchar *) my_memdup(ptr + HEADER_LENGTH, m_payload_length,
+                                 MYF(MY_WME));
+  DBUG_VOID_RETURN;
+}
+
+
+Transaction_payload_log_event::~Transaction_payload_log_event()
+{
+  my_free(m_payload);
+  my_free(m_events);
+}
+
+
+bool Transaction_payload_log_event::uncompress()
+{
+  DBUG_ENTER("Transaction_payload_log_event::uncompress");
+  if (m_events == NULL &&
+      (!(m_events= (uchar *) my_malloc(m_uncompressed_length + 1,
+                                       MYF(MY_WME))) ||
+       my_uncompress_buffer(m_algorithm, m_payload, m_payload_length,
+                            m_events, m_uncompressed_length)))
+  {
+    my_free(m_events);
+    m_events= NULL;
+    DBUG_RETURN(true);
+  }
+  m_events_pos= 0;
+  DBUG_RETURN(false);
+}
+
+
+Log_event *Transaction_payload_log_event::
+next_event(const Format_description_log_event *description_event,
+           const char **error)
+{
+  DBUG_ENTER("Transaction_payload_log_event::next_event");
+  DBUG_ASSERT(m_events != NULL);
+  *error= NULL;
+  if (m_events_pos == m_uncompressed_length)
+    DBUG_RETURN(NULL);
+
+  const uchar *event= m_events + m_events_pos;
+  uint event_len;
+  if (m_uncompressed_length - m_events_pos < LOG_EVENT_MINIMAL_HEADER_LEN ||
+      (event_len= uint4korr(event + EVENT_LEN_OFFSET)) <
+      LOG_EVENT_MINIMAL_HEADER_LEN ||
+      event_len > m_uncompressed_length - m_events_pos)
+  {
+    *error= "Truncated event in transaction payload";
+    DBUG_RETURN(NULL);
+  }
+
+  /*
+    The events were compressed without checksums, give them the checksum
+    of the binary log, so they are read like the other events in it.
+  */
+  bool has_checksum=
+    description_event->checksum_alg == BINLOG_CHECKSUM_ALG_CRC32;
+  uint buf_len= event_len + (has_checksum ? BINLOG_CHECKSUM_LEN : 0);
+  char *buf;
+  if (!(buf= (char *) my_malloc(buf_len + 1, MYF(MY_WME))))
+  {
+    *error= "Out of memory";
+    DBUG_RETURN(NULL);
+  }
+  memcpy(buf, event, event_len);
+  int4store(buf + LOG_POS_OFFSET, log_pos);
+  if (has_checksum)
+  {
+    int4store(buf + EVENT_LEN_OFFSET, buf_len);
+    ha_checksum crc= my_checksum(0L, NULL, 0);
+    crc= my_checksum(crc, (uchar *) buf, event_len);
+    int4store(buf + event_len, crc);
+  }
+
+  Log_event *ev= Log_event::read_log_event(buf, buf_len, error,
+                                           description_event, false);
+  if (ev == NULL)
+  {
+    if (*error == NULL)
+      *error= "Invalid event in transaction payload";
+    my_free(buf);
+    DBUG_RETURN(NULL);
+  }
+  ev->register_temp_buf(buf);
+  m_events_pos+= event_len;
+  DBUG_RETURN(ev);
+}
+
+
+#ifdef MYSQL_SERVER
+int Transaction_payload_log_event::pack_info(Protocol *protocol)
+{
+  char buf[128];
+  size_t bytes;
+  bytes= my_snprintf(buf, sizeof(buf),
+                     "compression='%s', payload_size=%u, "
+                     "uncompressed_size=%u",
+                     net_compression_algorithm_typelib.type_names[
+                       m_algorithm],
+                     m_payload_length, m_uncompressed_length);
+  protocol->store(buf, bytes, &my_charset_bin);
+  return 0;
+}
+
+
+bool Transaction_payload_log_event::write_data_header(IO_CACHE *file)
+{
+  DBUG_ENTER("Transaction_payload_log_event::write_data_header");
+  uchar buf[HEADER_LENGTH];
+  buf[0]= (uchar) m_algorithm;
+  int4store(buf + 1, m_uncompressed_length);
+  DBUG_RETURN(wrapper_my_b_safe_write(file, buf, sizeof(buf)));
+}
+
+
+bool Transaction_payload_log_event::write_data_body(IO_CACHE *file)
+{
+  DBUG_ENTER("Transaction_payload_log_event::write_data_body");
+  DBUG_RETURN(wrapper_my_b_safe_write(file, m_payload, m_payload_length));
+}
+#endif
+
+
+#ifdef MYSQL_CLIENT
+void Transaction_payload_log_event::print(FILE *file,
+                                          PRINT_EVENT_INFO *print_event_info)
+{
+  if (print_event_info->short_form)
+    return;
+
+  print_header(&print_event_info->head_cache, print_event_info, FALSE);
+  my_b_printf(&print_event_info->head_cache,
+              "\tTransaction_payload\tcompression=%s\tpayload_size=%u"
+              "\tuncompressed_size=%u\n",
+              m_algorithm < net_compression_algorithm_typelib.count ?
+              net_compression_algorithm_typelib.type_names[m_algorithm] :
+              "unknown",
+              m_payload_length, m_uncompressed_length);
+}
+#endif
+
+
+#if defined(MYSQL_SERVER) && defined(HAVE_REPLICATION)
+int
+Transaction_payload_log_event::do_apply_event(Relay_log_info const *rli)
+{
+  DBUG_ENTER("Transaction_payload_log_event::do_apply_event");
+  /* The slave SQL thread applies the events of the payload instead */
+  DBUG_ASSERT(0);
+  rli->report(ERROR_LEVEL, ER_SLAVE_RELAY_LOG_READ_FAILURE,
+              ER(ER_SLAVE_RELAY_LOG_READ_FAILURE),
+              "Transaction payload event can't be applied");
+  DBUG_RETURN(1);
+}
+#endif
+
+
 #ifdef MYSQL_CLIENT
 /**
   The default values for these variables should be values that are
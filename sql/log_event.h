@@ -715,6 +715,13 @@ enum Log_event_type
   ANONYMOUS_GTID_LOG_EVENT= 34,
 
   PREVIOUS_GTIDS_LOG_EVENT= 35,
+
+  /*
+    A transaction whose events are compressed together, see
+    Transaction_payload_log_event. It is not described by the
+    Format_description_log_event, see LOG_EVENT_TYPES.
+  */
+  TRANSACTION_PAYLOAD_EVENT= 36,
   /*
     Add new events here - right above this comment!
     Existing events (except ENUM_END_EVENT) should never change their numbers
@@ -735,8 +742,12 @@ extern ulonglong repl_event_time_other;
    The number of types we handle in Format_description_log_event (UNKNOWN_EVENT
    is not to be handled, it does not exist in binlogs, it does not have a
    format).
+
+   TRANSACTION_PAYLOAD_EVENT is not included: it has no post-header, and
+   leaving it out keeps the Format_description_log_event, and the binary
+   logs read by older servers and tools, unchanged.
 */
-#define LOG_EVENT_TYPES (ENUM_END_EVENT-1)
+#define LOG_EVENT_TYPES PREVIOUS_GTIDS_LOG_EVENT
 
 enum Int_event_type
 {
@@ -761,6 +772,8 @@ enum enum_base64_output_mode {
   BASE64_OUTPUT_AUTO= 1,
   BASE64_OUTPUT_UNSPEC= 2,
   BASE64_OUTPUT_DECODE_ROWS= 3,
+  /* Print the rows of row events as JSON objects, one per line */
+  BASE64_OUTPUT_JSON= 4,
   /* insert new output modes here */
   BASE64_OUTPUT_MODE_COUNT
 };
@@ -4060,6 +4073,9 @@ public:
                                PRINT_EVENT_INFO *print_event_info,
                                MY_BITMAP *cols_bitmap,
                                const uchar *ptr, const uchar *prefix);
+  void print_json(IO_CACHE *file, PRINT_EVENT_INFO *print_event_info);
+  size_t print_json_one_row(IO_CACHE *file, table_def *td,
+                            MY_BITMAP *cols_bitmap, const uchar *ptr);
 #endif
 
 #ifdef MYSQL_SERVER
@@ -4350,7 +4366,17 @@ private:
      found it updates it.
    */
   int do_index_scan_and_update(Relay_log_info const *rli);
-  
+
+  /**
+     Used before do_index_scan_and_update() for events with at least
+     slave_rows_batch_lookup_min_rows rows. It unpacks the before image
+     of every row, sorts them on the m_key_index'th key and reads them
+     with one multi-range read, so the storage engine reads the index
+     in key order instead of once per row in event order. The rows are
+     then changed in event order as usual.
+   */
+  int do_batch_key_lookup(Relay_log_info const *rli);
+
   /**
      Implementation of the hash_scan and update algorithm. It collects
      rows positions in a hashtable until the last row is
@@ -5107,6 +5133,123 @@ private:
   const uchar *buf;
 };
 
+
+/**
+  @class Transaction_payload_log_event
+
+  The events of a transaction, compressed together.
+
+  With binlog_trx_compression the events of a transaction are compressed
+  when the transaction cache is flushed to the binary log. Only the
+  Gtid_log_event stays outside of the payload, so the transaction can
+  still be found and skipped by its GTID without uncompressing it.
+
+  The payload is the events of the transaction as they would be written
+  to the binary log, but without checksums. The slave SQL thread,
+  mysqlbinlog and crash recovery read them with next_event(), which adds
+  the checksums of the binary log back, so the events look the same as if
+  they had been written uncompressed.
+
+  <table id="TransactionPayloadFormat">
+  <caption>Transaction payload event format</caption>
+  <tr>
+    <th>Symbol</th>
+    <th>Format</th>
+    <th>Description</th>
+  </tr>
+  <tr>
+    <td>ALGORITHM</td>
+    <td align="right">1</td>
+    <td>The compression algorithm, one of enum_net_compression</td>
+  </tr>
+  <tr>
+    <td>UNCOMPRESSED_LENGTH</td>
+    <td align="right">4</td>
+    <td>Length of the events when uncompressed</td>
+  </tr>
+  <tr>
+    <td>PAYLOAD</td>
+    <td align="right">remaining event length</td>
+    <td>The compressed events</td>
+  </tr>
+  </table>
+*/
+class Transaction_payload_log_event : public Log_event
+{
+public:
+#ifdef MYSQL_SERVER
+  /**
+    Create the event from compressed events.
+
+    @param payload  The compressed events, allocated with my_malloc(). The
+                    event takes ownership of them.
+  */
+  Transaction_payload_log_event(THD *thd_arg, uint algorithm,
+                                uchar *payload, uint payload_length,
+                                uint uncompressed_length);
+  int pack_info(Protocol*);
+  virtual bool write_data_header(IO_CACHE *file);
+  virtual bool write_data_body(IO_CACHE *file);
+#endif
+
+  Transaction_payload_log_event(const char *buf, uint event_len,
+                                const Format_description_log_event
+                                *descr_event);
+  virtual ~Transaction_payload_log_event();
+
+#ifdef MYSQL_CLIENT
+  virtual void print(FILE *file, PRINT_EVENT_INFO *print_event_info);
+#endif
+
+#if defined(MYSQL_SERVER) && defined(HAVE_REPLICATION)
+  virtual int do_apply_event(Relay_log_info const *rli);
+#endif
+
+  Log_event_type get_type_code() { return TRANSACTION_PAYLOAD_EVENT; }
+  bool is_valid() const { return m_payload != NULL; }
+  int get_data_size() { return HEADER_LENGTH + m_payload_length; }
+
+  uint get_algorithm() const { return m_algorithm; }
+  uint get_payload_length() const { return m_payload_length; }
+  uint get_uncompressed_length() const { return m_uncompressed_length; }
+
+  /**
+    Uncompress the events, before they are read by next_event().
+
+    @retval false Success
+    @retval true  Out of memory or the payload is corrupted.
+  */
+  bool uncompress();
+
+  /**
+    Read the next event of the payload.
+
+    The event is given the checksum of the binary log the payload was read
+    from, as described by description_event, and the log_pos of the
+    payload event.
+
+    @param[out] error  Set to an error message on failure, and to NULL at
+                       the end of the payload.
+
+    @return The event, or NULL at the end of the payload or on error.
+  */
+  Log_event *next_event(const Format_description_log_event *description_event,
+                        const char **error);
+
+  /// Length of the fields before the payload
+  static const uint HEADER_LENGTH= 1 + 4;
+
+private:
+  uint m_algorithm;
+  uchar *m_payload;
+  uint m_payload_length;
+  uint m_uncompressed_length;
+  /// The uncompressed events, NULL before uncompress()
+  uchar *m_events;
+  /// Offset of the event next_event() reads in m_events
+  uint m_events_pos;
+};
+
 inline bool is_gtid_event(Log_event* evt)
 {
   return (evt->get_type_code() == GTID_LOG_EVENT ||
@@ -60,6 +60,7 @@
 #include "rpl_gtid.h"
 #include "rpl_slave.h"
 #include "rpl_master.h"
+#include "binlog_tail_cache.h"
 #include "rpl_mi.h"
 #include "rpl_filter.h"
 #include <sql_common.h>
@@ -95,6 +96,7 @@
 #include "rpl_injector.h"
 
 #include "rpl_handler.h"
+#include "rpl_apply_stats.h"     // init_slave_apply_stats
 
 #ifdef HAVE_SYS_PRCTL_H
 #include <sys/prctl.h>
@@ -445,6 +447,7 @@ my_bool opt_skip_slave_start = 0; ///< If set, slave is not autostarted
 my_bool opt_reckless_slave = 0;
 my_bool opt_enable_named_pipe= 0;
 my_bool opt_local_infile, opt_slave_compressed_protocol;
+ulong opt_slave_compression_algorithm= NET_COMPRESSION_ZLIB;
 my_bool opt_safe_user_create = 0;
 my_bool opt_show_slave_auth_info;
 my_bool opt_log_slave_updates= 0;
@@ -593,6 +596,22 @@ ulong sql_slave_skip_counter_usage = 0;
 
 my_bool opt_log_slow_extra= FALSE;
 ulonglong binlog_fsync_count = 0;
+ulong opt_binlog_tail_cache_size= 0;
+ulonglong binlog_tail_cache_hits= 0;
+ulonglong binlog_tail_cache_misses= 0;
+ulong opt_binlog_trx_compression_type= NET_COMPRESSION_ZLIB;
+ulonglong binlog_trx_compression_bytes_before= 0;
+ulonglong binlog_trx_compression_bytes_after= 0;
+ulong opt_slave_prefetch_threads= 0;
+ulonglong opt_slave_prefetch_lookahead= 0;
+ulonglong slave_prefetch_events= 0;
+ulonglong slave_prefetch_skips= 0;
+ulong opt_slave_rows_batch_lookup_min_rows= 0;
+ulonglong slave_rows_batch_lookups= 0;
+ulonglong opt_slave_relay_log_bypass_size= 0;
+ulonglong slave_relay_log_bypass_events= 0;
+ulonglong slave_relay_log_bypass_overflows= 0;
+my_bool opt_slave_apply_latency_stats= 0;
 ulong opt_peak_lag_time;
 ulong opt_peak_lag_sample_rate;
 
@@ -751,7 +770,7 @@ MY_LOCALE *my_default_lc_time_names;
 
 SHOW_COMP_OPTION have_ssl, have_symlink, have_dlopen, have_query_cache;
 SHOW_COMP_OPTION have_geometry, have_rtree_keys;
-SHOW_COMP_OPTION have_crypt, have_compress;
+SHOW_COMP_OPTION have_crypt, have_compress, have_zstd, have_lz4;
 SHOW_COMP_OPTION have_profiling;
 
 /* Thread specific variables */
@@ -1910,6 +1929,7 @@ void clean_up(bool print_message)
 
   injector::free_instance();
   mysql_bin_log.cleanup();
+  binlog_tail_cache.cleanup();
   gtid_server_cleanup();
 
 #ifdef HAVE_REPLICATION
@@ -1956,6 +1976,7 @@ void clean_up(bool print_message)
   bitmap_free(&temp_pool);
   free_global_table_stats();
   free_global_db_stats();
+  free_slave_apply_stats();
   free_max_user_conn();
 #ifdef HAVE_REPLICATION
   end_slave_list();
@@ -4011,6 +4032,11 @@ int init_common_variables()
     inited before MY_INIT(). So we do it here.
   */
   mysql_bin_log.init_pthread_objects();
+  if (binlog_tail_cache.init(opt_binlog_tail_cache_size))
+  {
+    sql_print_error("Could not allocate the binlog tail cache");
+    unireg_abort(1);
+  }
 
   /* TODO: remove this when my_time_t is 64 bit compatible */
   if (!IS_TIME_T_VALID_FOR_TIMESTAMP(server_start_time))
@@ -5057,6 +5083,7 @@ a file name for --log-bin-index option", opt_binlog_index_name);
 
   init_global_table_stats();
   init_global_db_stats();
+  init_slave_apply_stats();
 
   /* call ha_init_key_cache() on all key caches to init them */
   process_key_caches(&ha_init_key_cache);
@@ -7789,6 +7816,15 @@ static int show_net_compression(THD *thd, SHOW_VAR *var, char *buff)
   return 0;
 }
 
+static int show_net_compression_algorithm(THD *thd, SHOW_VAR *var, char *buff)
+{
+  var->type= SHOW_CHAR;
+  var->value= (char *) (thd->net.compress ?
+    net_compression_algorithm_typelib.type_names[thd->net.compress_algorithm] :
+    "");
+  return 0;
+}
+
 static int show_starttime(THD *thd, SHOW_VAR *var, char *buff)
 {
   var->type= SHOW_LONGLONG;
@@ -8332,11 +8368,16 @@ SHOW_VAR status_vars[]= {
   {"Binlog_fsync_count",       (char*) &binlog_fsync_count, SHOW_LONGLONG},
   {"Binlog_stmt_cache_disk_use",(char*) &binlog_stmt_cache_disk_use,  SHOW_LONG},
   {"Binlog_stmt_cache_use",    (char*) &binlog_stmt_cache_use,       SHOW_LONG},
+  {"Binlog_tail_cache_hits",   (char*) &binlog_tail_cache_hits, SHOW_LONGLONG},
+  {"Binlog_tail_cache_misses", (char*) &binlog_tail_cache_misses, SHOW_LONGLONG},
+  {"Binlog_trx_compression_bytes_after", (char*) &binlog_trx_compression_bytes_after, SHOW_LONGLONG},
+  {"Binlog_trx_compression_bytes_before", (char*) &binlog_trx_compression_bytes_before, SHOW_LONGLONG},
   {"Bytes_received",           (char*) offsetof(STATUS_VAR, bytes_received), SHOW_LONGLONG_STATUS},
   {"Bytes_sent",               (char*) offsetof(STATUS_VAR, bytes_sent), SHOW_LONGLONG_STATUS},
   {"Com",                      (char*) com_status_vars, SHOW_ARRAY},
   {"Command_slave_seconds",    (char*) &command_slave_seconds,  SHOW_TIMER},
   {"Compression",              (char*) &show_net_compression, SHOW_FUNC},
+  {"Compression_algorithm",    (char*) &show_net_compression_algorithm, SHOW_FUNC},
   {"Connections",              (char*) &thread_id,              SHOW_LONG_NOFLUSH},
   {"Connection_errors_accept", (char*) &connection_errors_accept, SHOW_LONG},
   {"Connection_errors_internal", (char*) &connection_errors_internal, SHOW_LONG},
@@ -8370,6 +8411,7 @@ SHOW_VAR status_vars[]= {
   {"Handler_savepoint_rollback",(char*) offsetof(STATUS_VAR, ha_savepoint_rollback_count), SHOW_LONGLONG_STATUS},
   {"Handler_update",           (char*) offsetof(STATUS_VAR, ha_update_count), SHOW_LONGLONG_STATUS},
   {"Handler_write",            (char*) offsetof(STATUS_VAR, ha_write_count), SHOW_LONGLONG_STATUS},
+  {"Hash_aggregation_spills",  (char*) offsetof(STATUS_VAR, hash_aggregation_spills), SHOW_LONGLONG_STATUS},
 #ifdef HAVE_JEMALLOC
 #ifndef EMBEDDED_LIBRARY
   {"Jemalloc_arenas_narenas",  (char*) &show_jemalloc_arenas_narenas,   SHOW_FUNC},
@@ -8483,12 +8525,18 @@ SHOW_VAR status_vars[]= {
 #endif
   {"Select_full_join",         (char*) offsetof(STATUS_VAR, select_full_join_count), SHOW_LONGLONG_STATUS},
   {"Select_full_range_join",   (char*) offsetof(STATUS_VAR, select_full_range_join_count), SHOW_LONGLONG_STATUS},
+  {"Select_point_fast_path",   (char*) offsetof(STATUS_VAR, select_point_fast_path_count), SHOW_LONGLONG_STATUS},
   {"Select_range",             (char*) offsetof(STATUS_VAR, select_range_count), SHOW_LONGLONG_STATUS},
   {"Select_range_check",       (char*) offsetof(STATUS_VAR, select_range_check_count), SHOW_LONGLONG_STATUS},
   {"Select_scan",	       (char*) offsetof(STATUS_VAR, select_scan_count), SHOW_LONGLONG_STATUS},
   {"Slave_open_temp_tables",   (char*) &slave_open_temp_tables, SHOW_INT},
 #ifdef HAVE_REPLICATION
+  {"Slave_prefetch_events",    (char*) &slave_prefetch_events, SHOW_LONGLONG},
+  {"Slave_prefetch_skips",     (char*) &slave_prefetch_skips, SHOW_LONGLONG},
+  {"Slave_relay_log_bypass_events", (char*) &slave_relay_log_bypass_events, SHOW_LONGLONG},
+  {"Slave_relay_log_bypass_overflows", (char*) &slave_relay_log_bypass_overflows, SHOW_LONGLONG},
   {"Slave_retried_transactions",(char*) &show_slave_retried_trans, SHOW_FUNC},
+  {"Slave_rows_batch_lookups", (char*) &slave_rows_batch_lookups, SHOW_LONGLONG},
   {"Slave_heartbeat_period",   (char*) &show_heartbeat_period, SHOW_FUNC},
   {"Slave_received_heartbeats",(char*) &show_slave_received_heartbeats, SHOW_FUNC},
   {"Slave_last_heartbeat",     (char*) &show_slave_last_heartbeat, SHOW_FUNC},
@@ -8729,6 +8777,11 @@ static int mysql_init_variables(void)
   binlog_bytes_written= 0;
   binlog_cache_use=  binlog_cache_disk_use= 0;
   binlog_fsync_count= 0;
+  binlog_tail_cache_hits= binlog_tail_cache_misses= 0;
+  binlog_trx_compression_bytes_before= binlog_trx_compression_bytes_after= 0;
+  slave_prefetch_events= slave_prefetch_skips= 0;
+  slave_rows_batch_lookups= 0;
+  slave_relay_log_bypass_events= slave_relay_log_bypass_overflows= 0;
   relay_log_bytes_written= 0;
   max_used_connections= slow_launch_threads = 0;
   mysqld_user= mysqld_chroot= opt_init_file= opt_bin_logname = 0;
@@ -8861,6 +8914,8 @@ static int mysql_init_variables(void)
 #else
   have_compress= SHOW_OPTION_NO;
 #endif
+  have_zstd= CAN_CLIENT_COMPRESS_ZSTD ? SHOW_OPTION_YES : SHOW_OPTION_NO;
+  have_lz4= CAN_CLIENT_COMPRESS_LZ4 ? SHOW_OPTION_YES : SHOW_OPTION_NO;
 #ifdef HAVE_LIBWRAP
   libwrapName= NullS;
 #endif
@@ -9881,7 +9936,7 @@ PSI_mutex_key
   key_mutex_slave_parallel_worker,
   key_structure_guard_mutex, key_TABLE_SHARE_LOCK_ha_data,
   key_LOCK_error_messages, key_LOG_INFO_lock, key_LOCK_thread_count,
-  key_LOCK_global_table_stats,
+  key_LOCK_global_table_stats, key_LOCK_slave_apply_latency,
   key_LOCK_log_throttle_qni,
   key_gtid_info_run_lock,
   key_gtid_info_data_lock,
@@ -9980,6 +10035,7 @@ static PSI_mutex_info all_server_mutexes[]=
   { &key_LOCK_thread_count, "LOCK_thread_count", PSI_FLAG_GLOBAL},
   { &key_LOCK_log_throttle_qni, "LOCK_log_throttle_qni", PSI_FLAG_GLOBAL},
   { &key_LOCK_global_table_stats, "LOCK_global_table_stats", PSI_FLAG_GLOBAL},
+  { &key_LOCK_slave_apply_latency, "LOCK_slave_apply_latency", PSI_FLAG_GLOBAL},
   { &key_gtid_ensure_index_mutex, "Gtid_state", PSI_FLAG_GLOBAL},
   { &key_LOCK_thread_created, "LOCK_thread_created", PSI_FLAG_GLOBAL },
   { &key_gtid_info_run_lock, "Gtid_info::run_lock", 0},
@@ -9990,7 +10046,7 @@ static PSI_mutex_info all_server_mutexes[]=
 PSI_rwlock_key key_rwlock_LOCK_grant, key_rwlock_LOCK_logger,
   key_rwlock_LOCK_sys_init_connect, key_rwlock_LOCK_sys_init_slave,
   key_rwlock_LOCK_system_variables_hash, key_rwlock_query_cache_query_lock,
-  key_rwlock_global_sid_lock;
+  key_rwlock_global_sid_lock, key_rwlock_binlog_tail_cache;
 
 static PSI_rwlock_info all_server_rwlocks[]=
 {
@@ -10003,7 +10059,8 @@ static PSI_rwlock_info all_server_rwlocks[]=
   { &key_rwlock_LOCK_sys_init_slave, "LOCK_sys_init_slave", PSI_FLAG_GLOBAL},
   { &key_rwlock_LOCK_system_variables_hash, "LOCK_system_variables_hash", PSI_FLAG_GLOBAL},
   { &key_rwlock_query_cache_query_lock, "Query_cache_query::lock", 0},
-  { &key_rwlock_global_sid_lock, "gtid_commit_rollback", PSI_FLAG_GLOBAL}
+  { &key_rwlock_global_sid_lock, "gtid_commit_rollback", PSI_FLAG_GLOBAL},
+  { &key_rwlock_binlog_tail_cache, "Binlog_tail_cache::m_lock", PSI_FLAG_GLOBAL}
 };
 
 #ifdef HAVE_MMAP
@@ -121,6 +121,7 @@ extern uint connection_count;
 extern my_bool opt_safe_user_create;
 extern my_bool opt_safe_show_db, opt_local_infile, opt_myisam_use_mmap;
 extern my_bool opt_slave_compressed_protocol, use_temp_pool;
+extern ulong opt_slave_compression_algorithm;
 extern ulong slave_exec_mode_options;
 extern ulonglong slave_type_conversions_options;
 extern my_bool read_only, opt_readonly, super_read_only, opt_super_readonly;
@@ -185,11 +186,26 @@ extern int32 thread_binlog_client;
 
 extern my_bool opt_log_slow_extra;
 extern ulonglong binlog_fsync_count;
+extern ulong opt_binlog_tail_cache_size;
+extern ulonglong binlog_tail_cache_hits, binlog_tail_cache_misses;
+extern ulong opt_binlog_trx_compression_type;
+extern ulonglong binlog_trx_compression_bytes_before;
+extern ulonglong binlog_trx_compression_bytes_after;
+extern ulong opt_slave_prefetch_threads;
+extern ulonglong opt_slave_prefetch_lookahead;
+extern ulonglong slave_prefetch_events, slave_prefetch_skips;
+extern ulong opt_slave_rows_batch_lookup_min_rows;
+extern ulonglong slave_rows_batch_lookups;
+extern ulonglong opt_slave_relay_log_bypass_size;
+extern ulonglong slave_relay_log_bypass_events;
+extern ulonglong slave_relay_log_bypass_overflows;
 
 extern uint net_compression_level;
 
 extern ulong relay_io_connected;
 
+extern my_bool opt_slave_apply_latency_stats;
+
 extern ulong opt_peak_lag_time;
 extern ulong opt_peak_lag_sample_rate;
 
@@ -521,7 +537,7 @@ extern PSI_mutex_key
   key_mutex_slave_parallel_worker,
   key_structure_guard_mutex, key_TABLE_SHARE_LOCK_ha_data,
   key_LOCK_error_messages, key_LOCK_thread_count,
-  key_LOCK_global_table_stats,
+  key_LOCK_global_table_stats, key_LOCK_slave_apply_latency,
   key_LOCK_log_throttle_qni,
   key_gtid_info_run_lock,
   key_gtid_info_data_lock,
@@ -545,7 +561,7 @@ extern PSI_mutex_key key_LOCK_thread_created;
 extern PSI_rwlock_key key_rwlock_LOCK_grant, key_rwlock_LOCK_logger,
   key_rwlock_LOCK_sys_init_connect, key_rwlock_LOCK_sys_init_slave,
   key_rwlock_LOCK_system_variables_hash, key_rwlock_query_cache_query_lock,
-  key_rwlock_global_sid_lock;
+  key_rwlock_global_sid_lock, key_rwlock_binlog_tail_cache;
 
 #ifdef HAVE_MMAP
 extern PSI_cond_key key_PAGE_cond, key_COND_active, key_COND_pool;
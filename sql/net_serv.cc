@@ -113,6 +113,8 @@ my_bool my_net_init(NET *net, Vio* vio)
   net->write_pos=net->read_pos = net->buff;
   net->last_error[0]=0;
   net->compress=0; net->reading_or_writing=0;
+  net->compress_algorithm= NET_COMPRESSION_ZLIB;
+  net->compress_stream= NULL;
   net->where_b = net->remain_in_buf=0;
   net->last_errno=0;
   net->unused= 0;
@@ -138,10 +140,37 @@ void net_end(NET *net)
   DBUG_ENTER("net_end");
   my_free(net->buff);
   net->buff=0;
+#ifdef HAVE_COMPRESS
+  if (net->compress_stream)
+  {
+    my_compress_stream_end(net->compress_stream);
+    net->compress_stream= NULL;
+  }
+#endif
   DBUG_VOID_RETURN;
 }
 
 
+/**
+  Use the compressed protocol, with the algorithm negotiated in the
+  capability flags of the connection.
+
+  @param net           NET handler
+  @param capabilities  Client capability flags
+*/
+
+void my_net_set_compression(NET *net, ulong capabilities)
+{
+  net->compress= 1;
+  if (capabilities & CAN_CLIENT_COMPRESS_ZSTD)
+    net->compress_algorithm= NET_COMPRESSION_ZSTD;
+  else if (capabilities & CAN_CLIENT_COMPRESS_LZ4)
+    net->compress_algorithm= NET_COMPRESSION_LZ4;
+  else
+    net->compress_algorithm= NET_COMPRESSION_ZLIB;
+}
+
+
 /** Realloc the packet buffer. */
 
 my_bool net_realloc(NET *net, size_t length)
@@ -798,6 +827,127 @@ net_write_raw_loop(NET *net, const uchar *buf, size_t count)
 }
 
 
+#ifdef HAVE_COMPRESS
+/**
+  The zstd or lz4 compression stream of a connection, created when it is
+  first used.
+*/
+
+static MY_COMPRESS_STREAM *net_compress_stream(NET *net)
+{
+  if (!net->compress_stream)
+    net->compress_stream= my_compress_stream_init(net->compress_algorithm,
+                                                  net_compression_level);
+  return net->compress_stream;
+}
+
+
+/*
+  Longest packet compressed into one compressed packet by a stream. The
+  compressed length, stored in 3 bytes, may exceed the original length by
+  a small fraction with incompressible data.
+*/
+#define NET_STREAM_CHUNK_LENGTH (MAX_PACKET_LENGTH - MAX_PACKET_LENGTH / 64)
+
+/**
+  Compress a packet with the zstd or lz4 stream of the connection.
+
+  Unlike with zlib, the packet is compressed even if it gets longer, as the
+  peer must uncompress everything the stream has compressed. Packets longer
+  than NET_STREAM_CHUNK_LENGTH are sent as several compressed packets.
+
+  @param          net      NET handler.
+  @param          packet   The packet to compress.
+  @param[in,out]  length   Length of the packet.
+
+  @return Pointer to the (new) compressed packets.
+*/
+
+static uchar *
+compress_packet_stream(NET *net, const uchar *packet, size_t *length)
+{
+  MY_COMPRESS_STREAM *stream;
+  uchar *compr_packet;
+  size_t buff_length= 0, pos= 0, left;
+  const uint header_length= NET_HEADER_SIZE + COMP_HEADER_SIZE;
+
+  if (!(stream= net_compress_stream(net)))
+    return NULL;
+
+  for (left= *length; ; left-= NET_STREAM_CHUNK_LENGTH)
+  {
+    size_t chunk_length= MY_MIN(left, NET_STREAM_CHUNK_LENGTH);
+    buff_length+= header_length +
+                  my_compress_stream_bound(stream, chunk_length);
+    if (left <= NET_STREAM_CHUNK_LENGTH)
+      break;
+  }
+  if (!(compr_packet= (uchar *) my_malloc(buff_length, MYF(MY_WME))))
+    return NULL;
+
+  left= *length;
+  do
+  {
+    uchar *header= compr_packet + pos;
+    size_t chunk_length= MY_MIN(left, NET_STREAM_CHUNK_LENGTH);
+    size_t compr_length= buff_length - pos - header_length;
+
+    if (!chunk_length)
+      compr_length= 0;
+    else if (my_compress_stream(stream, packet, chunk_length,
+                                header + header_length, &compr_length))
+    {
+      my_free(compr_packet);
+      return NULL;
+    }
+
+    /* Length of the original packet. */
+    int3store(&header[NET_HEADER_SIZE], chunk_length);
+    /* Length of this packet. */
+    int3store(header, compr_length);
+    /* Packet number. */
+    header[3]= (uchar) (net->compress_pkt_nr++);
+
+    pos+= header_length + compr_length;
+    packet+= chunk_length;
+    left-= chunk_length;
+  } while (left);
+
+  *length= pos;
+  return compr_packet;
+}
+
+
+/**
+  Uncompress a packet read with the compressed protocol in place.
+
+  @param          net      NET handler.
+  @param          packet   The compressed packet.
+  @param          len      Length of the compressed packet.
+  @param[in,out]  complen  Length of the original packet, 0 if it was not
+                           compressed. Set to the length of the packet.
+
+  @return TRUE on error, FALSE on success.
+*/
+
+static my_bool
+net_uncompress(NET *net, uchar *packet, size_t len, size_t *complen)
+{
+  MY_COMPRESS_STREAM *stream;
+
+  if (net->compress_algorithm == NET_COMPRESSION_ZLIB)
+    return my_uncompress(packet, len, complen);
+  if (!*complen)
+  {
+    *complen= len;
+    return FALSE;
+  }
+  return !(stream= net_compress_stream(net)) ||
+         my_uncompress_stream(stream, packet, len, *complen);
+}
+#endif /* HAVE_COMPRESS */
+
+
 /**
   Compress and encapsulate a packet into a compressed packet.
 
@@ -882,7 +1032,11 @@ net_write_packet(NET *net, const uchar *packet, size_t length)
   const bool do_compress= net->compress;
   if (do_compress)
   {
-    if ((packet= compress_packet(net, packet, &length)) == NULL)
+    if (net->compress_algorithm != NET_COMPRESSION_ZLIB)
+      packet= compress_packet_stream(net, packet, &length);
+    else
+      packet= compress_packet(net, packet, &length);
+    if (packet == NULL)
     {
       net->error= 2;
       net->last_errno= ER_OUT_OF_RESOURCES;
@@ -1495,8 +1649,8 @@ my_net_read(NET *net)
         MYSQL_NET_READ_DONE(1, 0);
         return packet_error;
       }
-      if (my_uncompress(net->buff + net->where_b, packet_len,
-                        &complen))
+      if (net_uncompress(net, net->buff + net->where_b, packet_len,
+                         &complen))
       {
         net->error= 2;			/* caller will close socket */
         net->last_errno= ER_NET_UNCOMPRESS_ERROR;
@@ -331,6 +331,7 @@ class Explain_join : public Explain_table_base
 private:
   bool need_tmp_table; ///< add "Using temporary" to "extra" if true
   bool need_order; ///< add "Using filesort"" to "extra" if true
+  bool need_hash_agg; ///< add "Using hash aggregation" to "extra" if true
   const bool distinct; ///< add "Distinct" string to "extra" column if true
 
   uint tabnum; ///< current tab number in join->join_tab[]
@@ -345,8 +346,9 @@ public:
                bool distinct_arg)
   : Explain_table_base(CTX_JOIN, thd_arg, join_arg),
     need_tmp_table(need_tmp_table_arg),
-    need_order(need_order_arg), distinct(distinct_arg),
-    tabnum(0), select(0), used_tables(0)
+    need_order(need_order_arg),
+    need_hash_agg(join_arg->explain_flags.any(ESP_USING_HASH_AGG)),
+    distinct(distinct_arg), tabnum(0), select(0), used_tables(0)
   {
     /* it is not UNION: */
     DBUG_ASSERT(join_arg->select_lex != join_arg->unit->fake_select_lex);
@@ -1534,6 +1536,11 @@ bool Explain_join::explain_extra()
       return true;
     need_tmp_table= need_order= false;
 
+    if (need_hash_agg && !fmt->is_hierarchical() &&
+        push_extra(ET_USING_HASH_AGGREGATION))
+      return true;
+    need_hash_agg= false;
+
     if (distinct && test_all_bits(used_tables, thd->lex->used_tables) &&
         push_extra(ET_DISTINCT))
       return true;
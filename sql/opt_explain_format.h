@@ -99,6 +99,7 @@ enum Extra_tag
   ET_UNIQUE_ROW_NOT_FOUND,
   ET_IMPOSSIBLE_ON_CONDITION,
   ET_PUSHED_JOIN,
+  ET_USING_HASH_AGGREGATION,
   //------------------------------------
   ET_total
 };
@@ -463,7 +464,8 @@ enum Explain_sort_property
   ESP_USING_FILESORT = 1 << 2, //< Clause causes a filesort
   ESP_USING_TMPTABLE = 1 << 3, //< Clause creates an intermediate table
   ESP_DUPS_REMOVAL   = 1 << 4, //< Duplicate removal for DISTINCT
-  ESP_CHECKED        = 1 << 5  //< Properties were already checked
+  ESP_CHECKED        = 1 << 5, //< Properties were already checked
+  ESP_USING_HASH_AGG = 1 << 6  //< Clause is evaluated by hash aggregation
 };
 
 
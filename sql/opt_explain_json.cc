@@ -53,7 +53,8 @@ static const char *json_extra_tags[ET_total]=
   "const_row_not_found",                // ET_CONST_ROW_NOT_FOUND
   "unique_row_not_found",               // ET_UNIQUE_ROW_NOT_FOUND
   "impossible_on_condition",            // ET_IMPOSSIBLE_ON_CONDITION
-  "pushed_join"                         // ET_PUSHED_JOIN
+  "pushed_join",                        // ET_PUSHED_JOIN
+  "using_hash_aggregation"              // ET_USING_HASH_AGGREGATION
 };
 
 
@@ -92,6 +93,7 @@ static const char K_UPDATE_VALUE_SUBQUERIES[]=      "update_value_subqueries";
 static const char K_USED_KEY_PARTS[]=               "used_key_parts";
 static const char K_USING_FILESORT[]=               "using_filesort";
 static const char K_USING_TMP_TABLE[]=              "using_temporary_table";
+static const char K_USING_HASH_AGG[]=               "using_hash_aggregation";
 
 
 /*
@@ -927,6 +929,7 @@ protected:
 
 private:
   const bool using_tmptable; //< true if the clause creates intermediate table
+  const bool using_hash_agg; //< true if the clause uses hash aggregation
   const bool using_filesort; //< true if the clause uses filesort
 
 public:
@@ -938,6 +941,7 @@ public:
     joinable_ctx(type_arg, name_arg, parent_arg),
     join_tab(NULL),
     using_tmptable(flags->get(clause, ESP_USING_TMPTABLE)),
+    using_hash_agg(flags->get(clause, ESP_USING_HASH_AGG)),
     using_filesort(flags->get(clause, ESP_USING_FILESORT))
   {}
 
@@ -967,6 +971,8 @@ protected:
   {
     if (using_tmptable)
       obj->add(K_USING_TMP_TABLE, true);
+    if (using_hash_agg)
+      obj->add(K_USING_HASH_AGG, true);
     obj->add(K_USING_FILESORT, using_filesort);
     return join_tab->format(json);
   }
@@ -1105,6 +1111,7 @@ TODO
 class sort_ctx : public join_ctx
 {
   const bool using_tmptable; //< the clause creates temporary table
+  const bool using_hash_agg; //< the clause uses hash aggregation
   const bool using_filesort; //< the clause uses filesort
 
 public:
@@ -1115,6 +1122,7 @@ public:
   : context(type_arg, name_arg, parent_arg),
     join_ctx(type_arg, name_arg, parent_arg),
     using_tmptable(flags->get(clause, ESP_USING_TMPTABLE)),
+    using_hash_agg(flags->get(clause, ESP_USING_HASH_AGG)),
     using_filesort(flags->get(clause, ESP_USING_FILESORT))
   {}
 
@@ -1125,6 +1133,8 @@ protected:
 
     if (using_tmptable)
       obj->add(K_USING_TMP_TABLE, true);
+    if (using_hash_agg)
+      obj->add(K_USING_HASH_AGG, true);
     if (type != CTX_BUFFER_RESULT)
       obj->add(K_USING_FILESORT, using_filesort);
 
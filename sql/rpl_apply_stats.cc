@@ -0,0 +1,301 @@
+/* Copyright (c) 2013, Facebook, Inc. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include "rpl_apply_stats.h"
+#include "sql_base.h"
+#include "sql_show.h"
+#include "mysqld.h"
+#include "log_event.h"
+#ifdef HAVE_REPLICATION
+#include "rpl_rli.h"
+#include "rpl_slave.h"                          // MTS_MAX_WORKERS
+#endif
+
+/** Latency histogram of one event type and table */
+struct SLAVE_APPLY_LATENCY
+{
+  /* Event type byte followed by "db\0table" */
+  uchar key[1 + 2 * (NAME_LEN + 1)];
+  uint key_length;
+  Slave_apply_latency_key id;
+  ulonglong events[SLAVE_APPLY_LATENCY_BUCKETS];
+  ulonglong time[SLAVE_APPLY_LATENCY_BUCKETS];
+};
+
+static HASH slave_apply_latency_hash;
+static mysql_mutex_t LOCK_slave_apply_latency;
+
+Slave_worker_stats slave_worker_stats[SLAVE_WORKER_STATS_MAX];
+
+extern "C" uchar *get_key_slave_apply_latency(const uchar *ptr, size_t *length,
+                                              my_bool not_used
+                                              __attribute__((unused)))
+{
+  SLAVE_APPLY_LATENCY *latency= (SLAVE_APPLY_LATENCY *) ptr;
+  *length= latency->key_length;
+  return latency->key;
+}
+
+extern "C" void free_slave_apply_latency(void *p)
+{
+  my_free(p);
+}
+
+void init_slave_apply_stats()
+{
+  mysql_mutex_init(key_LOCK_slave_apply_latency, &LOCK_slave_apply_latency,
+                   MY_MUTEX_INIT_FAST);
+  if (my_hash_init(&slave_apply_latency_hash, &my_charset_bin, 64, 0, 0,
+                   (my_hash_get_key) get_key_slave_apply_latency,
+                   free_slave_apply_latency, 0))
+    sql_print_error("Initializing slave_apply_latency_hash failed.");
+}
+
+void free_slave_apply_stats()
+{
+  my_hash_free(&slave_apply_latency_hash);
+  mysql_mutex_destroy(&LOCK_slave_apply_latency);
+}
+
+void reset_slave_apply_stats()
+{
+  mysql_mutex_lock(&LOCK_slave_apply_latency);
+  my_hash_reset(&slave_apply_latency_hash);
+  mysql_mutex_unlock(&LOCK_slave_apply_latency);
+
+  /* Races with the workers updating their counters are OK */
+  memset(slave_worker_stats, 0, sizeof(slave_worker_stats));
+}
+
+#ifdef HAVE_REPLICATION
+/**
+  Find the event type and table an event is accounted to.
+
+  Must be called before the event is applied: the table of a rows event
+  is looked up in the tables the Table_map events of the statement
+  added to rli->tables_to_lock, which are gone once the last rows event
+  of the statement is applied.
+
+  @param[out] key  Event type, database and table of the event
+  @param      ev   The event
+  @param      rli  The SQL thread or the worker applying the event
+*/
+
+void get_slave_apply_latency_key(Slave_apply_latency_key *key,
+                                 Log_event *ev, Relay_log_info *rli)
+{
+  const char *db= NULL;
+  const char *table_name= NULL;
+
+  key->event_type= ev->get_type_code();
+
+  if (ev->is_row_log_event())
+  {
+    const Table_id &table_id= static_cast<Rows_log_event*>(ev)->get_table_id();
+    for (TABLE_LIST *tl= rli->tables_to_lock; tl; tl= tl->next_global)
+    {
+      if (tl->table_id == table_id)
+      {
+        db= tl->db;
+        table_name= tl->table_name;
+        break;
+      }
+    }
+  }
+  else if (key->event_type == TABLE_MAP_EVENT)
+  {
+    Table_map_log_event *map= static_cast<Table_map_log_event*>(ev);
+    db= map->get_db_name();
+    table_name= map->get_table_name();
+  }
+  else if (key->event_type == QUERY_EVENT)
+    db= static_cast<Query_log_event*>(ev)->db;
+
+  strmake(key->db, db ? db : "", NAME_LEN);
+  strmake(key->table_name, table_name ? table_name : "", NAME_LEN);
+}
+#endif
+
+/**
+  Count an applied event in the latency histogram of its event type and
+  table.
+
+  @param key        Event type and table, see get_slave_apply_latency_key()
+  @param wall_time  Time applying the event took, in my_timer units
+*/
+
+void update_slave_apply_latency(const Slave_apply_latency_key *key,
+                                ulonglong wall_time)
+{
+  uchar hash_key[sizeof(((SLAVE_APPLY_LATENCY *) 0)->key)];
+  uint key_length;
+  ulonglong usecs= (ulonglong) my_timer_to_microseconds(wall_time);
+  uint bucket= 0;
+
+  while (bucket < SLAVE_APPLY_LATENCY_BUCKETS - 1 && (usecs >> bucket))
+    bucket++;
+
+  hash_key[0]= (uchar) key->event_type;
+  key_length= (uint) (strmov(strmov((char *) hash_key + 1, key->db) + 1,
+                             key->table_name) - (char *) hash_key);
+
+  mysql_mutex_lock(&LOCK_slave_apply_latency);
+  SLAVE_APPLY_LATENCY *latency= (SLAVE_APPLY_LATENCY *)
+    my_hash_search(&slave_apply_latency_hash, hash_key, key_length);
+  if (!latency)
+  {
+    if (!(latency= (SLAVE_APPLY_LATENCY *)
+          my_malloc(sizeof(SLAVE_APPLY_LATENCY), MYF(MY_WME | MY_ZEROFILL))))
+    {
+      mysql_mutex_unlock(&LOCK_slave_apply_latency);
+      return;
+    }
+    memcpy(latency->key, hash_key, key_length);
+    latency->key_length= key_length;
+    latency->id= *key;
+    if (my_hash_insert(&slave_apply_latency_hash, (uchar *) latency))
+    {
+      my_free(latency);
+      mysql_mutex_unlock(&LOCK_slave_apply_latency);
+      return;
+    }
+  }
+  latency->events[bucket]++;
+  latency->time[bucket]+= wall_time;
+  mysql_mutex_unlock(&LOCK_slave_apply_latency);
+}
+
+Slave_worker_stats *get_slave_worker_stats(ulong worker_id)
+{
+#ifdef HAVE_REPLICATION
+  compile_time_assert(SLAVE_WORKER_STATS_MAX == MTS_MAX_WORKERS);
+#endif
+  DBUG_ASSERT(worker_id < SLAVE_WORKER_STATS_MAX);
+  return &slave_worker_stats[worker_id];
+}
+
+ST_FIELD_INFO slave_apply_latency_fields_info[]=
+{
+  {"EVENT_TYPE", NAME_LEN, MYSQL_TYPE_STRING, 0, 0, 0, SKIP_OPEN_TABLE},
+  {"TABLE_SCHEMA", NAME_LEN, MYSQL_TYPE_STRING, 0, 0, 0, SKIP_OPEN_TABLE},
+  {"TABLE_NAME", NAME_LEN, MYSQL_TYPE_STRING, 0, 0, 0, SKIP_OPEN_TABLE},
+  {"LATENCY_USECS_LESS_THAN", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0, MY_I_S_MAYBE_NULL, 0, SKIP_OPEN_TABLE},
+  {"EVENTS", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0, 0, 0, SKIP_OPEN_TABLE},
+  {"TOTAL_USECS", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0, 0, 0, SKIP_OPEN_TABLE},
+  {0, 0, MYSQL_TYPE_STRING, 0, 0, 0, SKIP_OPEN_TABLE}
+};
+
+int fill_slave_apply_latency(THD *thd, TABLE_LIST *tables, Item *cond)
+{
+  DBUG_ENTER("fill_slave_apply_latency");
+  TABLE* table= tables->table;
+
+  mysql_mutex_lock(&LOCK_slave_apply_latency);
+
+  for (ulong i= 0; i < slave_apply_latency_hash.records; ++i)
+  {
+    SLAVE_APPLY_LATENCY *latency= (SLAVE_APPLY_LATENCY *)
+      my_hash_element(&slave_apply_latency_hash, i);
+    const char *type=
+      Log_event::get_type_str((Log_event_type) latency->id.event_type);
+
+    for (uint bucket= 0; bucket < SLAVE_APPLY_LATENCY_BUCKETS; ++bucket)
+    {
+      int f= 0;
+
+      if (!latency->events[bucket])
+        continue;
+
+      restore_record(table, s->default_values);
+      table->field[f++]->store(type, strlen(type), system_charset_info);
+      table->field[f++]->store(latency->id.db, strlen(latency->id.db),
+                               system_charset_info);
+      table->field[f++]->store(latency->id.table_name,
+                               strlen(latency->id.table_name),
+                               system_charset_info);
+      if (bucket < SLAVE_APPLY_LATENCY_BUCKETS - 1)
+      {
+        table->field[f]->set_notnull();
+        table->field[f++]->store(1ULL << bucket, TRUE);
+      }
+      else
+        table->field[f++]->set_null();
+      table->field[f++]->store(latency->events[bucket], TRUE);
+      table->field[f++]->store((ulonglong)
+                               my_timer_to_microseconds(latency->time[bucket]),
+                               TRUE);
+
+      if (schema_table_store_record(thd, table))
+      {
+        mysql_mutex_unlock(&LOCK_slave_apply_latency);
+        DBUG_RETURN(-1);
+      }
+    }
+  }
+  mysql_mutex_unlock(&LOCK_slave_apply_latency);
+
+  DBUG_RETURN(0);
+}
+
+ST_FIELD_INFO slave_worker_stats_fields_info[]=
+{
+  {"WORKER_ID", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0, 0, 0, SKIP_OPEN_TABLE},
+  {"EVENTS", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0, 0, 0, SKIP_OPEN_TABLE},
+  {"GROUPS", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0, 0, 0, SKIP_OPEN_TABLE},
+  {"BUSY_USECS", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0, 0, 0, SKIP_OPEN_TABLE},
+  {"IDLE_USECS", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0, 0, 0, SKIP_OPEN_TABLE},
+  {"COMMIT_USECS", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0, 0, 0, SKIP_OPEN_TABLE},
+  {"QUEUE_FULL_WAITS", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0, 0, 0, SKIP_OPEN_TABLE},
+  {"QUEUE_FULL_WAIT_USECS", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0, 0, 0, SKIP_OPEN_TABLE},
+  {0, 0, MYSQL_TYPE_STRING, 0, 0, 0, SKIP_OPEN_TABLE}
+};
+
+int fill_slave_worker_stats(THD *thd, TABLE_LIST *tables, Item *cond)
+{
+  DBUG_ENTER("fill_slave_worker_stats");
+  TABLE* table= tables->table;
+
+  /* These reads race with the workers. That is OK. */
+  for (ulong i= 0; i < SLAVE_WORKER_STATS_MAX; ++i)
+  {
+    Slave_worker_stats *stats= &slave_worker_stats[i];
+    int f= 0;
+
+    if (stats->events == 0 && stats->idle_time == 0 &&
+        stats->queue_full_waits == 0)
+      continue;
+
+    restore_record(table, s->default_values);
+    table->field[f++]->store(i, TRUE);
+    table->field[f++]->store(stats->events, TRUE);
+    table->field[f++]->store(stats->groups, TRUE);
+    table->field[f++]->store((ulonglong)
+                             my_timer_to_microseconds(stats->busy_time), TRUE);
+    table->field[f++]->store((ulonglong)
+                             my_timer_to_microseconds(stats->idle_time), TRUE);
+    table->field[f++]->store((ulonglong)
+                             my_timer_to_microseconds(stats->commit_time),
+                             TRUE);
+    table->field[f++]->store(stats->queue_full_waits, TRUE);
+    table->field[f++]->store((ulonglong)
+                             my_timer_to_microseconds(
+                               stats->queue_full_wait_time), TRUE);
+
+    if (schema_table_store_record(thd, table))
+      DBUG_RETURN(-1);
+  }
+
+  DBUG_RETURN(0);
+}
@@ -0,0 +1,100 @@
+#ifndef RPL_APPLY_STATS_INCLUDED
+#define RPL_APPLY_STATS_INCLUDED
+
+/* Copyright (c) 2013, Facebook, Inc. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/**
+  @file
+
+  @brief
+  Slave apply latency statistics.
+
+  INFORMATION_SCHEMA.SLAVE_APPLY_LATENCY has a latency histogram of the
+  events the slave SQL thread or the MTS workers applied, by event type
+  and by table, collected while slave_apply_latency_stats is ON. Bucket
+  N counts the events that took less than 2^N microseconds to apply and
+  at least 2^(N-1) microseconds; only the buckets that counted events
+  are shown.
+
+  INFORMATION_SCHEMA.SLAVE_WORKER_STATISTICS has for each MTS worker the
+  time it spent applying events, waiting for the coordinator and
+  committing its groups, and how often and for how long the coordinator
+  waited because the queue of the worker was full.
+
+  FLUSH STATISTICS resets both.
+*/
+
+#include "my_global.h"
+#include "mysql_com.h"                          // NAME_LEN
+
+class Log_event;
+class Relay_log_info;
+class THD;
+struct TABLE_LIST;
+class Item;
+typedef struct st_field_info ST_FIELD_INFO;
+
+/** Number of latency buckets, the last one counts all slower events. */
+#define SLAVE_APPLY_LATENCY_BUCKETS 32
+
+/** The event type and table an apply latency is accounted to. */
+struct Slave_apply_latency_key
+{
+  uint event_type;
+  char db[NAME_LEN + 1];
+  char table_name[NAME_LEN + 1];
+};
+
+/** Number of worker statistics slots, MTS_MAX_WORKERS */
+#define SLAVE_WORKER_STATS_MAX 1024
+
+/** Per worker statistics, indexed by the id of the worker. */
+struct Slave_worker_stats
+{
+  /** Events and groups applied */
+  ulonglong events;
+  ulonglong groups;
+  /** Time applying events, commits included, in my_timer units */
+  ulonglong busy_time;
+  /** Time waiting for the coordinator to assign an event */
+  ulonglong idle_time;
+  /** Time applying the events that commit a group */
+  ulonglong commit_time;
+  /** Times and time the coordinator waited for a full worker queue */
+  ulonglong queue_full_waits;
+  ulonglong queue_full_wait_time;
+};
+
+extern Slave_worker_stats slave_worker_stats[];
+
+#ifdef HAVE_REPLICATION
+void get_slave_apply_latency_key(Slave_apply_latency_key *key,
+                                 Log_event *ev, Relay_log_info *rli);
+#endif
+void update_slave_apply_latency(const Slave_apply_latency_key *key,
+                                ulonglong wall_time);
+Slave_worker_stats *get_slave_worker_stats(ulong worker_id);
+
+void init_slave_apply_stats();
+void free_slave_apply_stats();
+void reset_slave_apply_stats();
+
+extern ST_FIELD_INFO slave_apply_latency_fields_info[];
+extern ST_FIELD_INFO slave_worker_stats_fields_info[];
+int fill_slave_apply_latency(THD *thd, TABLE_LIST *tables, Item *cond);
+int fill_slave_worker_stats(THD *thd, TABLE_LIST *tables, Item *cond);
+
+#endif /* RPL_APPLY_STATS_INCLUDED */
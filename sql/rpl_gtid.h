@@ -826,7 +826,9 @@ struct Gtid
   Represents a set of GTIDs.
 
   This is structured as an array, indexed by SIDNO, where each element
-  contains a linked list of intervals.
+  contains a sorted array of disjoint, non-adjacent intervals.  Single
+  intervals are added and removed with a binary search, and the
+  intervals of two sets are combined with a linear merge.
 
   This data structure OPTIONALLY knows of a Sid_map that gives a
   correspondence between SIDNO and SID.  If the Sid_map is NULL, then
@@ -899,9 +901,7 @@ public:
   enum_return_status _add_gtid(rpl_sidno sidno, rpl_gno gno)
   {
     DBUG_ENTER("Gtid_set::_add_gtid(sidno, gno)");
-    Interval_iterator ivit(this, sidno);
-    Free_intervals_lock lock(this);
-    enum_return_status ret= add_gno_interval(&ivit, gno, gno + 1, &lock);
+    enum_return_status ret= add_gno_interval(sidno, gno, gno + 1);
     DBUG_RETURN(ret);
   }
   /**
@@ -926,9 +926,7 @@ public:
     DBUG_ENTER("Gtid_set::_remove_gtid(rpl_sidno, rpl_gno)");
     if (sidno <= get_max_sidno())
     {
-      Interval_iterator ivit(this, sidno);
-      Free_intervals_lock lock(this);
-      enum_return_status ret= remove_gno_interval(&ivit, gno, gno + 1, &lock);
+      enum_return_status ret= remove_gno_interval(sidno, gno, gno + 1);
       DBUG_RETURN(ret);
     }
     RETURN_OK;
@@ -1064,8 +1062,7 @@ public:
     DBUG_ASSERT(sidno >= 1);
     if (sidno > get_max_sidno())
       return false;
-    Const_interval_iterator ivit(this, sidno);
-    return ivit.get() != NULL;
+    return get_sidno_intervals(sidno)->count != 0;
   }
   /**
     Returns true if the given string is a valid specification of a
@@ -1185,8 +1182,8 @@ public:
   Sid_map *get_sid_map() const { return sid_map; }
 
   /**
-    Represents one element in the linked list of intervals associated
-    with a SIDNO.
+    Represents one element in the array of intervals associated with a
+    SIDNO.
   */
   struct Interval
   {
@@ -1200,129 +1197,50 @@ public:
     {
       return start == other.start && end == other.end;
     }
-    /// Pointer to next interval in list.
-    Interval *next;
   };
 
   /**
-    Provides an array of Intervals that this Gtid_set can use when
-    groups are subsequently added.  This can be used as an
-    optimization, to reduce allocation for sets that have a known
-    number of intervals.
+    Iterator over the intervals of a const Gtid_set for a given SIDNO.
 
-    @param n_intervals The number of intervals to add.
-    @param intervals Array of n_intervals intervals.
+    The iterator points into the array of intervals, so it is
+    invalidated when intervals are added to or removed from the SIDNO.
   */
-  void add_interval_memory(int n_intervals, Interval *intervals_param)
-  {
-    if (sid_lock != NULL)
-      mysql_mutex_lock(&free_intervals_mutex);
-    add_interval_memory_lock_taken(n_intervals, intervals_param);
-    if (sid_lock != NULL)
-      mysql_mutex_unlock(&free_intervals_mutex);
-  }
-
-
-  /**
-    Iterator over intervals for a given SIDNO.
-
-    This is an abstract template class, used as a common base class
-    for Const_interval_iterator and Interval_iterator.
-
-    The iterator always points to an interval pointer.  The interval
-    pointer is either the initial pointer into the list, or the next
-    pointer of one of the intervals in the list.
-  */
-  template<typename Gtid_set_p, typename Interval_p> class Interval_iterator_base
+  class Const_interval_iterator
   {
   public:
+    /// Create an iterator that is past the last interval.
+    Const_interval_iterator() : p(NULL), end(NULL) {}
     /**
       Construct a new iterator over the GNO intervals for a given Gtid_set.
 
       @param gtid_set The Gtid_set.
       @param sidno The SIDNO.
     */
-    Interval_iterator_base(Gtid_set_p gtid_set, rpl_sidno sidno)
+    Const_interval_iterator(const Gtid_set *gtid_set, rpl_sidno sidno)
     {
       DBUG_ASSERT(sidno >= 1 && sidno <= gtid_set->get_max_sidno());
       init(gtid_set, sidno);
     }
-    /// Construct a new iterator over the free intervals of a Gtid_set.
-    Interval_iterator_base(Gtid_set_p gtid_set)
-    { p= const_cast<Interval_p *>(&gtid_set->free_intervals); }
     /// Reset this iterator.
-    inline void init(Gtid_set_p gtid_set, rpl_sidno sidno)
-    { p= dynamic_element(&gtid_set->intervals, sidno - 1, Interval_p *); }
+    inline void init(const Gtid_set *gtid_set, rpl_sidno sidno)
+    {
+      const Sidno_intervals *si= gtid_set->get_sidno_intervals(sidno);
+      p= si->ivs;
+      end= si->ivs + si->count;
+    }
     /// Advance current_elem one step.
     inline void next()
     {
-      DBUG_ASSERT(*p != NULL);
-      p= const_cast<Interval_p *>(&(*p)->next);
+      DBUG_ASSERT(p < end);
+      p++;
     }
-    /// Return current_elem.
-    inline Interval_p get() const { return *p; }
-  protected:
-    /**
-      Holds the address of the 'next' pointer of the previous element,
-      or the address of the initial pointer into the list, if the
-      current element is the first element.
-    */
-    Interval_p *p;
-  };
-
-  /**
-    Iterator over intervals of a const Gtid_set.
-  */
-  class Const_interval_iterator
-    : public Interval_iterator_base<const Gtid_set *, const Interval *>
-  {
-  public:
-    /// Create this Const_interval_iterator.
-    Const_interval_iterator(const Gtid_set *gtid_set, rpl_sidno sidno)
-      : Interval_iterator_base<const Gtid_set *, const Interval *>(gtid_set, sidno) {}
-    /// Create this Const_interval_iterator.
-    Const_interval_iterator(const Gtid_set *gtid_set)
-      : Interval_iterator_base<const Gtid_set *, const Interval *>(gtid_set) {}
-  };
-
-  /**
-    Iterator over intervals of a non-const Gtid_set, with additional
-    methods to modify the Gtid_set.
-  */
-  class Interval_iterator
-    : public Interval_iterator_base<Gtid_set *, Interval *>
-  {
-  public:
-    /// Create this Interval_iterator.
-    Interval_iterator(Gtid_set *gtid_set, rpl_sidno sidno)
-      : Interval_iterator_base<Gtid_set *, Interval *>(gtid_set, sidno) {}
-    /// Destroy this Interval_iterator.
-    Interval_iterator(Gtid_set *gtid_set)
-      : Interval_iterator_base<Gtid_set *, Interval *>(gtid_set) {}
+    /// Return current_elem, or NULL if the iterator is past the end.
+    inline const Interval *get() const { return p < end ? p : NULL; }
   private:
-    /**
-      Set current_elem to the given Interval but do not touch the
-      next pointer of the given Interval.
-    */
-    inline void set(Interval *iv) { *p= iv; }
-    /// Insert the given element before current_elem.
-    inline void insert(Interval *iv) { iv->next= *p; set(iv); }
-    /// Remove current_elem.
-    inline void remove(Gtid_set *gtid_set)
-    {
-      DBUG_ASSERT(get() != NULL);
-      Interval *next= (*p)->next;
-      gtid_set->put_free_interval(*p);
-      set(next);
-    }
-    /**
-      Only Gtid_set is allowed to use set/insert/remove.
-
-      They are not safe to use from other code because: (1) very easy
-      to make a mistakes (2) they don't clear cached_string_format or
-      cached_string_length.
-    */
-    friend class Gtid_set;
+    /// The current interval.
+    const Interval *p;
+    /// The position after the last interval.
+    const Interval *end;
   };
 
 
@@ -1334,7 +1252,7 @@ public:
   {
   public:
     Gtid_iterator(const Gtid_set *gs)
-      : gtid_set(gs), sidno(0), ivit(gs)
+      : gtid_set(gs), sidno(0)
     {
       if (gs->sid_lock != NULL)
         gs->sid_lock->assert_some_wrlock();
@@ -1421,20 +1339,59 @@ public:
   */
   size_t get_encoded_length() const;
 
+  /**
+    Returns the length of this Gtid_set when encoded using the
+    encode_compact() function.
+  */
+  size_t get_compact_encoded_length() const;
+  /**
+    Encodes this Gtid_set in the compact binary format.
+
+    Unlike encode(), the numbers are stored as packed integers, see
+    net_store_length(), and each interval as the distance from the end
+    of the previous interval and its length.  So the usual sets, with
+    one or a few intervals per SID, take a little more than 16 bytes
+    per SID.
+  */
+  void encode_compact(uchar *buf) const;
+  /**
+    Decodes a Gtid_set from the compact binary format of
+    encode_compact().
+
+    @param encoded The encoded string.
+    @param length The number of bytes.
+    @param actual_length If this is not NULL, it is set to the number
+    of bytes used by the encoding (which may be less than 'length').
+    If this is NULL, an error is generated if the encoding is shorter
+    than the given 'length'.
+    @return RETURN_STATUS_OK or RETURN_STATUS_REPORTED_ERROR.
+  */
+  enum_return_status add_gtid_compact_encoding(const uchar *encoded,
+                                               size_t length,
+                                               size_t *actual_length= NULL);
+
 private:
   /**
-    Contains a list of intervals allocated by this Gtid_set.  When a
-    method of this class needs a new interval and there are no more
-    free intervals, a new Interval_chunk is allocated and the
-    intervals of it are added to the list of free intervals.
+    The intervals of one SIDNO: an array of disjoint, non-adjacent
+    intervals, sorted by GNO.
   */
-  struct Interval_chunk
+  struct Sidno_intervals
   {
-    Interval_chunk *next;
-    Interval intervals[1];
+    /// The intervals.
+    Interval *ivs;
+    /// The number of intervals.
+    int count;
+    /// The number of intervals that ivs has space for.
+    int capacity;
   };
-  /// The default number of intervals in an Interval_chunk.
-  static const int CHUNK_GROW_SIZE= 8;
+  /// The smallest number of intervals allocated for a SIDNO.
+  static const int MIN_CAPACITY= 4;
+
+  /// Return the intervals of the given sidno.
+  Sidno_intervals *get_sidno_intervals(rpl_sidno sidno)
+  { return dynamic_element(&intervals, sidno - 1, Sidno_intervals *); }
+  const Sidno_intervals *get_sidno_intervals(rpl_sidno sidno) const
+  { return dynamic_element(&intervals, sidno - 1, const Sidno_intervals *); }
 
 /*
   Functions sidno_equals() and equals() are only used by unitests
@@ -1457,16 +1414,7 @@ private:
 
   /// Return the number of intervals for the given sidno.
   int get_n_intervals(rpl_sidno sidno) const
-  {
-    Const_interval_iterator ivit(this, sidno);
-    int ret= 0;
-    while (ivit.get() != NULL)
-    {
-      ret++;
-      ivit.next();
-    }
-    return ret;
-  }
+  { return get_sidno_intervals(sidno)->count; }
   /// Return the number of intervals in this Gtid_set.
   int get_n_intervals() const
   {
@@ -1479,180 +1427,75 @@ private:
     return ret;
   }
   /**
-    Allocates a new chunk of Intervals and adds them to the list of
-    unused intervals.
+    Makes sure that the given Sidno_intervals has space for at least
+    n intervals.  The array grows by at least half of its size, so
+    adding intervals one by one is amortized constant time.
 
-    @param size The number of intervals in this chunk
     @return RETURN_STATUS_OK or RETURN_STATUS_REPORTED_ERROR.
   */
-  enum_return_status create_new_chunk(int size);
-  /**
-    Returns a fresh new Interval object.
-
-    This usually does not require any real allocation, it only pops
-    the first interval from the list of free intervals.  If there are
-    no free intervals, it calls create_new_chunk.
-
-    @param out The resulting Interval* will be stored here.
-    @return RETURN_STATUS_OK or RETURN_STATUS_REPORTED_ERROR.
-  */
-  enum_return_status get_free_interval(Interval **out);
-  /**
-    Puts the given interval in the list of free intervals.  Does not
-    unlink it from its place in any other list.
-  */
-  void put_free_interval(Interval *iv);
-  /**
-    Like add_interval_memory, but does not acquire
-    free_intervals_mutex.
-    @see Gtid_set::add_interval_memory
-  */
-  void add_interval_memory_lock_taken(int n_ivs, Interval *ivs);
+  enum_return_status reserve(Sidno_intervals *si, int n);
 
   /// Read-write lock that protects updates to the number of SIDs.
   mutable Checkable_rwlock *sid_lock;
-  /**
-    Lock protecting the list of free intervals.  This lock is only
-    used if sid_lock is not NULL.
-  */
-  mysql_mutex_t free_intervals_mutex;
-  /**
-    Class representing a lock on free_intervals_mutex.
-
-    This is used by the add_* and remove_* functions.  The lock is
-    declared by the top-level function and a pointer to the lock is
-    passed down to low-level functions. If the low-level function
-    decides to access the free intervals list, then it acquires the
-    lock.  The lock is then automatically released by the destructor
-    when the top-level function returns.
-
-    The lock is not taken if Gtid_set->sid_lock == NULL; such
-    Gtid_sets are assumed to be thread-local.
-  */
-  class Free_intervals_lock
-  {
-  public:
-    /// Create a new lock, but do not acquire it.
-    Free_intervals_lock(Gtid_set *_gtid_set)
-      : gtid_set(_gtid_set), locked(false) {}
-    /// Lock the lock if it is not already locked.
-    void lock_if_not_locked()
-    {
-      if (gtid_set->sid_lock && !locked)
-      {
-        mysql_mutex_lock(&gtid_set->free_intervals_mutex);
-        locked= true;
-      }
-    }
-    /// Lock the lock if it is locked.
-    void unlock_if_locked()
-    {
-      if (gtid_set->sid_lock && locked)
-      {
-        mysql_mutex_unlock(&gtid_set->free_intervals_mutex);
-        locked= false;
-      }
-    }
-    /// Destroy this object and unlock the lock if it is locked.
-    ~Free_intervals_lock()
-    {
-      unlock_if_locked();
-    }
-  private:
-    Gtid_set *gtid_set;
-    bool locked;
-  };
-  void assert_free_intervals_locked()
-  {
-    if (sid_lock != NULL)
-      mysql_mutex_assert_owner(&free_intervals_mutex);
-  }
 
   /**
-    Adds the interval (start, end) to the given Interval_iterator.
+    Adds the interval (start, end) to the given SIDNO.
 
     This is the lowest-level function that adds groups; this is where
-    Interval objects are added, grown, or merged.
+    intervals are added, grown, or merged.  The position of the
+    interval is found with a binary search; the common case of an
+    interval that follows the last interval is handled without it.
 
-    @param ivitp Pointer to iterator.  After this function returns,
-    the current_element of the iterator will be the interval that
-    contains start and end.
+    @param sidno The SIDNO, which must exist in the Gtid_set.
     @param start The first GNO in the interval.
     @param end The first GNO after the interval.
-    @param lock If this function has to add or remove an interval,
-    then this lock will be taken unless it is already taken.  This
-    mechanism means that the lock will be taken lazily by
-    e.g. add_gtid_set() the first time that the list of free intervals
-    is accessed, and automatically released when add_gtid_set()
-    returns.
     @return RETURN_STATUS_OK or RETURN_STATUS_REPORTED_ERROR.
   */
-  enum_return_status add_gno_interval(Interval_iterator *ivitp,
-                                      rpl_gno start, rpl_gno end,
-                                      Free_intervals_lock *lock);
+  enum_return_status add_gno_interval(rpl_sidno sidno,
+                                      rpl_gno start, rpl_gno end);
   /**
-    Removes the interval (start, end) from the given
-    Interval_iterator. This is the lowest-level function that removes
-    groups; this is where Interval objects are removed, truncated, or
-    split.
+    Removes the interval (start, end) from the given SIDNO. This is the
+    lowest-level function that removes groups; this is where intervals
+    are removed, truncated, or split.
 
     It is not required that the groups in the interval exist in this
     Gtid_set.
 
-    @param ivitp Pointer to iterator.  After this function returns,
-    the current_element of the iterator will be the next interval
-    after end.
+    @param sidno The SIDNO, which must exist in the Gtid_set.
     @param start The first GNO in the interval.
     @param end The first GNO after the interval.
-    @param lock If this function has to add or remove an interval,
-    then this lock will be taken unless it is already taken.  This
-    mechanism means that the lock will be taken lazily by
-    e.g. add_gtid_set() the first time that the list of free intervals
-    is accessed, and automatically released when add_gtid_set()
-    returns.
     @return RETURN_STATUS_OK or RETURN_STATUS_REPORTED_ERROR.
   */
-  enum_return_status remove_gno_interval(Interval_iterator *ivitp,
-                                         rpl_gno start, rpl_gno end,
-                                         Free_intervals_lock *lock);
+  enum_return_status remove_gno_interval(rpl_sidno sidno,
+                                         rpl_gno start, rpl_gno end);
   /**
-    Adds a list of intervals to the given SIDNO.
+    Adds a sorted array of disjoint intervals to the given SIDNO, with
+    a linear merge.
 
     The SIDNO must exist in the Gtid_set before this function is called.
 
     @param sidno The SIDNO to which intervals will be added.
-    @param ivit Iterator over the intervals to add. This is typically
-    an iterator over some other Gtid_set.
-    @param lock If this function has to add or remove an interval,
-    then this lock will be taken unless it is already taken.  This
-    mechanism means that the lock will be taken lazily by
-    e.g. add_gtid_set() the first time that the list of free intervals
-    is accessed, and automatically released when add_gtid_set()
-    returns.
+    @param ivs The intervals to add, typically those of some other
+    Gtid_set.  They must not belong to this Gtid_set.
+    @param n_ivs The number of intervals.
     @return RETURN_STATUS_OK or RETURN_STATUS_REPORTED_ERROR.
   */
   enum_return_status add_gno_intervals(rpl_sidno sidno,
-                                       Const_interval_iterator ivit,
-                                       Free_intervals_lock *lock);
+                                       const Interval *ivs, int n_ivs);
   /**
-    Removes a list of intervals from the given SIDNO.
+    Removes a sorted array of disjoint intervals from the given SIDNO,
+    with a linear merge.
 
     It is not required that the intervals exist in this Gtid_set.
 
     @param sidno The SIDNO from which intervals will be removed.
-    @param ivit Iterator over the intervals to remove. This is typically
-    an iterator over some other Gtid_set.
-    @param lock If this function has to add or remove an interval,
-    then this lock will be taken unless it is already taken.  This
-    mechanism means that the lock will be taken lazily by
-    e.g. add_gtid_set() the first time that the list of free intervals
-    is accessed, and automatically released when add_gtid_set()
-    returns.
+    @param ivs The intervals to remove, typically those of some other
+    Gtid_set.  They must not belong to this Gtid_set.
+    @param n_ivs The number of intervals.
     @return RETURN_STATUS_OK or RETURN_STATUS_REPORTED_ERROR.
   */
   enum_return_status remove_gno_intervals(rpl_sidno sidno,
-                                          Const_interval_iterator ivit,
-                                          Free_intervals_lock *lock);
+                                          const Interval *ivs, int n_ivs);
 
   /// Returns true if every interval of sub is a subset of some
   /// interval of super.
@@ -1665,32 +1508,22 @@ private:
   /// Sid_map associated with this Gtid_set.
   Sid_map *sid_map;
   /**
-    Array where the N'th element contains the head pointer to the
-    intervals of SIDNO N+1.
+    Array where the N'th element is the Sidno_intervals of SIDNO N+1.
+
+    The array only grows while sid_lock is held for writing.  The
+    intervals of different SIDNOs are allocated separately, so they can
+    be updated concurrently while sid_lock is held for reading.
   */
   DYNAMIC_ARRAY intervals;
-  /// Linked list of free intervals.
-  Interval *free_intervals;
-  /// Linked list of chunks.
-  Interval_chunk *chunks;
   /// The string length.
   mutable int cached_string_length;
   /// The String_format that was used when cached_string_length was computed.
   mutable const String_format *cached_string_format;
-#ifndef DBUG_OFF
-  /**
-    The number of chunks.  Used only to check some invariants when
-    DBUG is on.
-  */
-  int n_chunks;
-#endif
 
   /// Used by unit tests that need to access private members.
 #ifdef FRIEND_OF_GTID_SET
   friend FRIEND_OF_GTID_SET;
 #endif
-  /// Only Free_intervals_lock is allowed to access free_intervals_mutex.
-  friend class Gtid_set::Free_intervals_lock;
 };
 
 
@@ -69,14 +69,7 @@ void Gtid_set::init()
   DBUG_ENTER("Gtid_set::init");
   cached_string_length= -1;
   cached_string_format= NULL;
-  chunks= NULL;
-  free_intervals= NULL;
-  my_init_dynamic_array(&intervals, sizeof(Interval *), 0, 8);
-  if (sid_lock)
-    mysql_mutex_init(0, &free_intervals_mutex, NULL);
-#ifndef DBUG_OFF
-  n_chunks= 0;
-#endif
+  my_init_dynamic_array(&intervals, sizeof(Sidno_intervals), 0, 8);
   DBUG_VOID_RETURN;
 }
 
@@ -84,20 +77,9 @@ void Gtid_set::init()
 Gtid_set::~Gtid_set()
 {
   DBUG_ENTER("Gtid_set::~Gtid_set");
-  Interval_chunk *chunk= chunks;
-  while (chunk != NULL)
-  {
-    Interval_chunk *next_chunk= chunk->next;
-    free(chunk);
-    chunk= next_chunk;
-#ifndef DBUG_OFF
-    n_chunks--;
-#endif
-  }
-  DBUG_ASSERT(n_chunks == 0);
+  for (uint i= 0; i < intervals.elements; i++)
+    my_free(dynamic_element(&intervals, i, Sidno_intervals *)->ivs);
   delete_dynamic(&intervals);
-  if (sid_lock)
-    mysql_mutex_destroy(&free_intervals_mutex);
   DBUG_VOID_RETURN;
 }
 
@@ -143,9 +125,9 @@ enum_return_status Gtid_set::ensure_sidno(rpl_sidno sidno)
     if (allocate_dynamic(&intervals,
                          sid_map == NULL ? sidno : sid_map->get_max_sidno()))
       goto error;
-    Interval *null_p= NULL;
+    Sidno_intervals empty= { NULL, 0, 0 };
     for (rpl_sidno i= max_sidno; i < sidno; i++)
-      if (insert_dynamic(&intervals, &null_p))
+      if (insert_dynamic(&intervals, &empty))
         goto error;
     if (sid_lock != NULL)
     {
@@ -163,227 +145,163 @@ error:
 }
 
 
-void Gtid_set::add_interval_memory_lock_taken(int n_ivs, Interval *ivs)
+enum_return_status Gtid_set::reserve(Sidno_intervals *si, int n)
 {
-  DBUG_ENTER("Gtid_set::add_interval_memory");
-  assert_free_intervals_locked();
-  // make ivs a linked list
-  for (int i= 0; i < n_ivs - 1; i++)
-    ivs[i].next= &(ivs[i + 1]);
-  Interval_iterator ivit(this);
-  ivs[n_ivs - 1].next= ivit.get();
-  // add intervals to list of free intervals
-  ivit.set(&(ivs[0]));
-  DBUG_VOID_RETURN;
-}
-
-
-enum_return_status Gtid_set::create_new_chunk(int size)
-{
-  DBUG_ENTER("Gtid_set::create_new_chunk");
-  // allocate the new chunk. one element is already pre-allocated, so
-  // we only add size-1 elements to the size of the struct.
-  assert_free_intervals_locked();
-  Interval_chunk *new_chunk=
-    (Interval_chunk *)my_malloc(sizeof(Interval_chunk) +
-                                sizeof(Interval) * (size - 1),
-                                MYF(MY_WME));
-  if (new_chunk == NULL)
-    RETURN_REPORTED_ERROR;
-  // store the chunk in the list of chunks
-  new_chunk->next= chunks;
-  chunks= new_chunk;
-#ifndef DBUG_OFF
-  n_chunks++;
-#endif
-  // add the intervals in the chunk to the list of free intervals
-  add_interval_memory_lock_taken(size, new_chunk->intervals);
+  DBUG_ENTER("Gtid_set::reserve");
+  if (n > si->capacity)
+  {
+    int capacity= max(max(n, si->capacity + si->capacity / 2), MIN_CAPACITY);
+    Interval *ivs= (Interval *)my_realloc(si->ivs, capacity * sizeof(Interval),
+                                          MYF(MY_WME | MY_ALLOW_ZERO_PTR));
+    if (ivs == NULL)
+    {
+      BINLOG_ERROR(("Out of memory."), (ER_OUT_OF_RESOURCES, MYF(0)));
+      RETURN_REPORTED_ERROR;
+    }
+    si->ivs= ivs;
+    si->capacity= capacity;
+  }
   RETURN_OK;
 }
 
 
-enum_return_status Gtid_set::get_free_interval(Interval **out)
+void Gtid_set::clear()
 {
-  DBUG_ENTER("Gtid_set::get_free_interval");
-  assert_free_intervals_locked();
-  Interval_iterator ivit(this);
-  if (ivit.get() == NULL)
-    PROPAGATE_REPORTED_ERROR(create_new_chunk(CHUNK_GROW_SIZE));
-  *out= ivit.get();
-  ivit.set((*out)->next);
-  RETURN_OK;
+  DBUG_ENTER("Gtid_set::clear");
+  cached_string_length= -1;
+  rpl_sidno max_sidno= get_max_sidno();
+  for (rpl_sidno sidno= 1; sidno <= max_sidno; sidno++)
+    get_sidno_intervals(sidno)->count= 0;
+  DBUG_VOID_RETURN;
 }
 
 
-void Gtid_set::put_free_interval(Interval *iv)
+/**
+  Return the index of the first interval that ends after gno, or n_ivs
+  if there is none.
+*/
+static int first_interval_ending_after(const Gtid_set::Interval *ivs,
+                                       int n_ivs, rpl_gno gno)
 {
-  DBUG_ENTER("Gtid_set::put_free_interval");
-  assert_free_intervals_locked();
-  Interval_iterator ivit(this);
-  iv->next= ivit.get();
-  ivit.set(iv);
-  DBUG_VOID_RETURN;
+  int lo= 0, hi= n_ivs;
+  while (lo < hi)
+  {
+    int mid= lo + (hi - lo) / 2;
+    if (ivs[mid].end <= gno)
+      lo= mid + 1;
+    else
+      hi= mid;
+  }
+  return lo;
 }
 
 
-void Gtid_set::clear()
+/**
+  Return the index of the first interval that starts at or after gno,
+  or n_ivs if there is none.
+*/
+static int first_interval_starting_from(const Gtid_set::Interval *ivs,
+                                        int n_ivs, rpl_gno gno)
 {
-  DBUG_ENTER("Gtid_set::clear");
-  rpl_sidno max_sidno= get_max_sidno();
-  if (max_sidno == 0)
-    DBUG_VOID_RETURN;
-  Interval_iterator free_ivit(this);
-  for (rpl_sidno sidno= 1; sidno <= max_sidno; sidno++)
+  int lo= 0, hi= n_ivs;
+  while (lo < hi)
   {
-    /*
-      Link in this list of intervals at the end of the list of
-      free intervals.
-    */
-    Interval_iterator ivit(this, sidno);
-    Interval *iv= ivit.get();
-    if (iv != NULL)
-    {
-      // find the end of the list of free intervals
-      while (free_ivit.get() != NULL)
-        free_ivit.next();
-      // append the present list
-      free_ivit.set(iv);
-      // clear the pointer to the head of this list
-      ivit.set(NULL);
-    }
+    int mid= lo + (hi - lo) / 2;
+    if (ivs[mid].start < gno)
+      lo= mid + 1;
+    else
+      hi= mid;
   }
-  DBUG_VOID_RETURN;
+  return lo;
 }
 
 
 enum_return_status
-Gtid_set::add_gno_interval(Interval_iterator *ivitp,
-                           rpl_gno start, rpl_gno end,
-                           Free_intervals_lock *lock)
+Gtid_set::add_gno_interval(rpl_sidno sidno, rpl_gno start, rpl_gno end)
 {
-  DBUG_ENTER("Gtid_set::add_gno_interval(Interval_iterator*, rpl_gno, rpl_gno)");
+  DBUG_ENTER("Gtid_set::add_gno_interval(rpl_sidno, rpl_gno, rpl_gno)");
   DBUG_ASSERT(start > 0);
   DBUG_ASSERT(start < end);
   DBUG_PRINT("info", ("start=%lld end=%lld", start, end));
-  Interval *iv;
-  Interval_iterator ivit= *ivitp;
+  Sidno_intervals *si= get_sidno_intervals(sidno);
+  Interval *last= si->count > 0 ? &si->ivs[si->count - 1] : NULL;
   cached_string_length= -1;
 
-  while ((iv= ivit.get()) != NULL)
+  // Fast path: GTIDs are mostly added in increasing order.
+  if (last != NULL && last->end == start)
   {
-    if (iv->end >= start)
-    {
-      if (iv->start > end)
-        // (start, end) is strictly before the current interval
-        break;
-      // (start, end) and (iv->start, iv->end) touch or intersect.
-      // Save the start of the merged interval.
-      if (iv->start < start)
-        start= iv->start;
-      // Remove the current interval as long as the new interval
-      // intersects with the next interval.
-      while (iv->next && end >= iv->next->start)
-      {
-        lock->lock_if_not_locked();
-        ivit.remove(this);
-        iv= ivit.get();
-      }
-      // Store the interval in the current interval.
-      iv->start= start;
-      if (iv->end < end)
-        iv->end= end;
-      *ivitp= ivit;
-      RETURN_OK;
-    }
-    ivit.next();
+    last->end= end;
+    RETURN_OK;
   }
-  /*
-    We come here if the interval cannot be combined with any existing
-    interval: it is after the previous interval (if any) and before
-    the current interval (if any). So we allocate a new interval and
-    insert it at the current position.
-  */
-  Interval *new_iv;
-  lock->lock_if_not_locked();
-  PROPAGATE_REPORTED_ERROR(get_free_interval(&new_iv));
-  new_iv->start= start;
-  new_iv->end= end;
-  ivit.insert(new_iv);
-  *ivitp= ivit;
+
+  // Intervals [i, j) touch or intersect (start, end).
+  int i= (last == NULL || last->end < start) ? si->count :
+    first_interval_ending_after(si->ivs, si->count, start - 1);
+  int j= first_interval_starting_from(si->ivs + i, si->count - i, end + 1) + i;
+
+  if (i == j)
+  {
+    // (start, end) cannot be combined with any existing interval.
+    PROPAGATE_REPORTED_ERROR(reserve(si, si->count + 1));
+    memmove(si->ivs + i + 1, si->ivs + i, (si->count - i) * sizeof(Interval));
+    si->ivs[i].start= start;
+    si->ivs[i].end= end;
+    si->count++;
+    RETURN_OK;
+  }
+
+  // Merge intervals [i, j) and (start, end) into interval i.
+  Interval *iv= &si->ivs[i];
+  iv->start= min(iv->start, start);
+  iv->end= max(si->ivs[j - 1].end, end);
+  memmove(si->ivs + i + 1, si->ivs + j, (si->count - j) * sizeof(Interval));
+  si->count-= j - i - 1;
   RETURN_OK;
 }
 
 
-enum_return_status Gtid_set::remove_gno_interval(Interval_iterator *ivitp,
-                                                 rpl_gno start, rpl_gno end,
-                                                 Free_intervals_lock *lock)
+enum_return_status
+Gtid_set::remove_gno_interval(rpl_sidno sidno, rpl_gno start, rpl_gno end)
 {
-  DBUG_ENTER("Gtid_set::remove_gno_interval(Interval_iterator *ivitp, rpl_gno start, rpl_gno end)");
+  DBUG_ENTER("Gtid_set::remove_gno_interval(rpl_sidno, rpl_gno, rpl_gno)");
   DBUG_ASSERT(start < end);
-  Interval_iterator ivit= *ivitp;
-  Interval *iv;
+  Sidno_intervals *si= get_sidno_intervals(sidno);
   cached_string_length= -1;
 
-  // Skip intervals of 'this' that are completely before the removed interval.
-  while (1)
-  {
-    iv= ivit.get();
-    if (iv == NULL)
-      goto ok;
-    if (iv->end > start)
-      break;
-    ivit.next();
-  }
+  // Intervals [i, j) intersect (start, end).
+  int i= first_interval_ending_after(si->ivs, si->count, start);
+  int j= first_interval_starting_from(si->ivs + i, si->count - i, end) + i;
+  if (i == j)
+    RETURN_OK;
 
-  // Now iv ends after the beginning of the removed interval.
-  DBUG_ASSERT(iv != NULL && iv->end > start);
-  if (iv->start < start)
+  Interval *iv= &si->ivs[i];
+  if (j == i + 1 && iv->start < start && iv->end > end)
   {
-    if (iv->end > end)
-    {
-      // iv cuts also the end of the removed interval: split iv in two
-      Interval *new_iv;
-      lock->lock_if_not_locked();
-      PROPAGATE_REPORTED_ERROR(get_free_interval(&new_iv));
-      new_iv->start= end;
-      new_iv->end= iv->end;
-      iv->end= start;
-      ivit.next();
-      ivit.insert(new_iv);
-      goto ok;
-    }
-    // iv cuts the beginning but not the end of the removed interval:
-    // truncate iv, and iterate one step to next interval
+    // iv covers the removed interval with some GNOs left on both sides:
+    // split iv in two
+    PROPAGATE_REPORTED_ERROR(reserve(si, si->count + 1));
+    iv= &si->ivs[i];
+    memmove(iv + 1, iv, (si->count - i) * sizeof(Interval));
     iv->end= start;
-    ivit.next();
-    iv= ivit.get();
-    if (iv == NULL)
-      goto ok;
+    (iv + 1)->start= end;
+    si->count++;
+    RETURN_OK;
   }
 
-  // Now iv starts after the beginning of the removed interval.
-  DBUG_ASSERT(iv != NULL && iv->start >= start);
-  while (iv->end <= end)
+  // Truncate the first and last intervals if they have GNOs outside the
+  // removed interval, and remove the rest.
+  if (iv->start < start)
   {
-    // iv ends before the end of the removed interval, so it is
-    // completely covered: remove iv.
-    lock->lock_if_not_locked();
-    ivit.remove(this);
-    iv= ivit.get();
-    if (iv == NULL)
-      goto ok;
+    iv->end= start;
+    i++;
   }
-
-  // Now iv ends after the removed interval.
-  DBUG_ASSERT(iv != NULL && iv->end > end);
-  if (iv->start < end)
+  if (si->ivs[j - 1].end > end)
   {
-    // iv begins before the end of the removed interval: truncate iv
-    iv->start= end;
+    si->ivs[j - 1].start= end;
+    j--;
   }
-
-ok:
-  *ivitp= ivit;
+  memmove(si->ivs + i, si->ivs + j, (si->count - j) * sizeof(Interval));
+  si->count-= j - i;
   RETURN_OK;
 }
 
@@ -425,25 +343,7 @@ enum_return_status Gtid_set::add_gtid_text(const char *text, bool *anonymous)
     RETURN_OK;
   }
 
-  Free_intervals_lock lock(this);
-
   DBUG_PRINT("info", ("'%s' not only whitespace", text));
-  // Allocate space for all intervals at once, if nothing is allocated.
-  if (chunks == NULL)
-  {
-    // compute number of intervals in text: it is equal to the number of
-    // colons
-    int n_intervals= 0;
-    text= s;
-    for (; *s; s++)
-      if (*s == ':')
-        n_intervals++;
-    // allocate all intervals in one chunk
-    lock.lock_if_not_locked();
-    create_new_chunk(n_intervals);
-    lock.unlock_if_locked();
-    s= text;
-  }
 
   while (1)
   {
@@ -485,7 +385,6 @@ enum_return_status Gtid_set::add_gtid_text(const char *text, bool *anonymous)
       SKIP_WHITESPACE();
 
       // Iterate over intervals.
-      Interval_iterator ivit(this, sidno);
       while (*s == ':')
       {
         // Skip ':'.
@@ -523,13 +422,8 @@ enum_return_status Gtid_set::add_gtid_text(const char *text, bool *anonymous)
 
         if (end > start)
         {
-          // Add interval.  Use the existing iterator position if the
-          // current interval does not begin before it.  Otherwise iterate
-          // from the beginning.
-          Interval *current= ivit.get();
-          if (current == NULL || start < current->start)
-            ivit.init(this, sidno);
-          if (add_gno_interval(&ivit, start, end, &lock) != RETURN_STATUS_OK)
+          // Add interval.
+          if (add_gno_interval(sidno, start, end) != RETURN_STATUS_OK)
           {
             RETURN_REPORTED_ERROR;
           }
@@ -606,41 +500,113 @@ bool Gtid_set::is_valid(const char *text)
 
 
 enum_return_status
-Gtid_set::add_gno_intervals(rpl_sidno sidno,
-                            Const_interval_iterator other_ivit,
-                            Free_intervals_lock *lock)
+Gtid_set::add_gno_intervals(rpl_sidno sidno, const Interval *other_ivs,
+                            int n_other_ivs)
 {
-  DBUG_ENTER("Gtid_set::add_gno_intervals(rpl_sidno, Const_interval_iterator, bool *)");
+  DBUG_ENTER("Gtid_set::add_gno_intervals(rpl_sidno, const Interval *, int)");
   DBUG_ASSERT(sidno >= 1 && sidno <= get_max_sidno());
-  const Interval *other_iv;
-  Interval_iterator ivit(this, sidno);
-  while ((other_iv= other_ivit.get()) != NULL)
+  Sidno_intervals *si= get_sidno_intervals(sidno);
+  DBUG_ASSERT(n_other_ivs == 0 || other_ivs < si->ivs ||
+              other_ivs >= si->ivs + si->capacity);
+  if (n_other_ivs == 0)
+    RETURN_OK;
+  if (n_other_ivs == 1)
   {
-    PROPAGATE_REPORTED_ERROR(add_gno_interval(&ivit,
-                                              other_iv->start, other_iv->end,
-                                              lock));
-    other_ivit.next();
+    enum_return_status ret= add_gno_interval(sidno, other_ivs->start,
+                                             other_ivs->end);
+    DBUG_RETURN(ret);
   }
+  cached_string_length= -1;
+  int n= si->count;
+  PROPAGATE_REPORTED_ERROR(reserve(si, n + n_other_ivs));
+  Interval *ivs= si->ivs;
+
+  /*
+    Merge the two arrays by start from the back, so that no interval of
+    this set is overwritten before it is moved, and then coalesce the
+    intervals that touch or intersect from the front.
+  */
+  int i= n - 1, j= n_other_ivs - 1, w= n + n_other_ivs - 1;
+  while (j >= 0)
+  {
+    if (i >= 0 && ivs[i].start > other_ivs[j].start)
+      ivs[w--]= ivs[i--];
+    else
+      ivs[w--]= other_ivs[j--];
+  }
+  int last= 0;
+  for (int r= 1; r < n + n_other_ivs; r++)
+  {
+    if (ivs[r].start <= ivs[last].end)
+    {
+      if (ivs[r].end > ivs[last].end)
+        ivs[last].end= ivs[r].end;
+    }
+    else
+      ivs[++last]= ivs[r];
+  }
+  si->count= last + 1;
   RETURN_OK;
 }
 
 
 enum_return_status
-Gtid_set::remove_gno_intervals(rpl_sidno sidno,
-                               Const_interval_iterator other_ivit,
-                               Free_intervals_lock *lock)
+Gtid_set::remove_gno_intervals(rpl_sidno sidno, const Interval *other_ivs,
+                               int n_other_ivs)
 {
-  DBUG_ENTER("Gtid_set::remove_gno_intervals(rpl_sidno, Interval_iterator, bool *)");
+  DBUG_ENTER("Gtid_set::remove_gno_intervals(rpl_sidno, const Interval *, int)");
   DBUG_ASSERT(sidno >= 1 && sidno <= get_max_sidno());
-  const Interval *other_iv;
-  Interval_iterator ivit(this, sidno);
-  while ((other_iv= other_ivit.get()) != NULL)
+  Sidno_intervals *si= get_sidno_intervals(sidno);
+  DBUG_ASSERT(n_other_ivs == 0 || other_ivs < si->ivs ||
+              other_ivs >= si->ivs + si->capacity);
+  if (si->count == 0 || n_other_ivs == 0)
+    RETURN_OK;
+  if (n_other_ivs == 1)
   {
-    PROPAGATE_REPORTED_ERROR(remove_gno_interval(&ivit,
-                                                 other_iv->start, other_iv->end,
-                                                 lock));
-    other_ivit.next();
+    enum_return_status ret= remove_gno_interval(sidno, other_ivs->start,
+                                                other_ivs->end);
+    DBUG_RETURN(ret);
   }
+  cached_string_length= -1;
+
+  /*
+    Every removed interval splits at most one interval of this set, so
+    the result has at most count + n_other_ivs intervals.  It is written
+    to a new array since splits make it longer than what was read.
+  */
+  Sidno_intervals result= { NULL, 0, 0 };
+  PROPAGATE_REPORTED_ERROR(reserve(&result, si->count + n_other_ivs));
+  int j= 0;
+  for (int i= 0; i < si->count; i++)
+  {
+    Interval iv= si->ivs[i];
+    // Skip removed intervals that end before iv.
+    while (j < n_other_ivs && other_ivs[j].end <= iv.start)
+      j++;
+    // Cut the removed intervals that intersect iv out of it.
+    while (j < n_other_ivs && other_ivs[j].start < iv.end)
+    {
+      if (other_ivs[j].start > iv.start)
+      {
+        result.ivs[result.count].start= iv.start;
+        result.ivs[result.count].end= other_ivs[j].start;
+        result.count++;
+      }
+      if (other_ivs[j].end >= iv.end)
+      {
+        // The rest of iv is removed; other_ivs[j] may cover the next
+        // interval too.
+        iv.start= iv.end;
+        break;
+      }
+      iv.start= other_ivs[j].end;
+      j++;
+    }
+    if (iv.start < iv.end)
+      result.ivs[result.count++]= iv;
+  }
+  my_free(si->ivs);
+  *si= result;
   RETURN_OK;
 }
 
@@ -650,15 +616,18 @@ enum_return_status Gtid_set::add_gtid_set(const Gtid_set *other)
   DBUG_ENTER("Gtid_set::add_gtid_set(const Gtid_set *)");
   if (sid_lock != NULL)
     sid_lock->assert_some_wrlock();
+  if (other == this)
+    RETURN_OK;
   rpl_sidno max_other_sidno= other->get_max_sidno();
-  Free_intervals_lock lock(this);
   if (other->sid_map == sid_map || other->sid_map == NULL || sid_map == NULL)
   {
     PROPAGATE_REPORTED_ERROR(ensure_sidno(max_other_sidno));
     for (rpl_sidno sidno= 1; sidno <= max_other_sidno; sidno++)
-      PROPAGATE_REPORTED_ERROR(
-        add_gno_intervals(sidno, Const_interval_iterator(other, sidno),
-                          &lock));
+    {
+      const Sidno_intervals *other_si= other->get_sidno_intervals(sidno);
+      PROPAGATE_REPORTED_ERROR(add_gno_intervals(sidno, other_si->ivs,
+                                                 other_si->count));
+    }
   }
   else
   {
@@ -672,16 +641,16 @@ enum_return_status Gtid_set::add_gtid_set(const Gtid_set *other)
     for (rpl_sidno other_sidno= 1; other_sidno <= max_other_sidno;
          other_sidno++)
     {
-      Const_interval_iterator other_ivit(other, other_sidno);
-      if (other_ivit.get() != NULL)
+      const Sidno_intervals *other_si= other->get_sidno_intervals(other_sidno);
+      if (other_si->count != 0)
       {
         const rpl_sid &sid= other_sid_map->sidno_to_sid(other_sidno);
         rpl_sidno this_sidno= sid_map->add_sid(sid);
         if (this_sidno <= 0)
           RETURN_REPORTED_ERROR;
         PROPAGATE_REPORTED_ERROR(ensure_sidno(this_sidno));
-        PROPAGATE_REPORTED_ERROR(add_gno_intervals(this_sidno, other_ivit,
-                                                   &lock));
+        PROPAGATE_REPORTED_ERROR(add_gno_intervals(this_sidno, other_si->ivs,
+                                                   other_si->count));
       }
     }
   }
@@ -694,15 +663,21 @@ enum_return_status Gtid_set::remove_gtid_set(const Gtid_set *other)
   DBUG_ENTER("Gtid_set::remove_gtid_set(Gtid_set *)");
   if (sid_lock != NULL)
     sid_lock->assert_some_wrlock();
+  if (other == this)
+  {
+    clear();
+    RETURN_OK;
+  }
   rpl_sidno max_other_sidno= other->get_max_sidno();
-  Free_intervals_lock lock(this);
   if (other->sid_map == sid_map || other->sid_map == NULL || sid_map == NULL)
   {
     rpl_sidno max_sidno= min(max_other_sidno, get_max_sidno());
     for (rpl_sidno sidno= 1; sidno <= max_sidno; sidno++)
-      PROPAGATE_REPORTED_ERROR(
-        remove_gno_intervals(sidno, Const_interval_iterator(other, sidno),
-                             &lock));
+    {
+      const Sidno_intervals *other_si= other->get_sidno_intervals(sidno);
+      PROPAGATE_REPORTED_ERROR(remove_gno_intervals(sidno, other_si->ivs,
+                                                    other_si->count));
+    }
   }
   else
   {
@@ -718,14 +693,14 @@ enum_return_status Gtid_set::remove_gtid_set(const Gtid_set *other)
     for (rpl_sidno other_sidno= 1; other_sidno <= max_other_sidno;
          other_sidno++)
     {
-      Const_interval_iterator other_ivit(other, other_sidno);
-      if (other_ivit.get() != NULL)
+      const Sidno_intervals *other_si= other->get_sidno_intervals(other_sidno);
+      if (other_si->count != 0)
       {
         const rpl_sid &sid= other_sid_map->sidno_to_sid(other_sidno);
         rpl_sidno this_sidno= sid_map->sid_to_sidno(sid);
         if (this_sidno != 0)
           PROPAGATE_REPORTED_ERROR(
-            remove_gno_intervals(this_sidno, other_ivit, &lock));
+            remove_gno_intervals(this_sidno, other_si->ivs, other_si->count));
       }
     }
 #endif
@@ -742,17 +717,9 @@ bool Gtid_set::contains_gtid(rpl_sidno sidno, rpl_gno gno) const
     sid_lock->assert_some_lock();
   if (sidno > get_max_sidno())
     DBUG_RETURN(false);
-  Const_interval_iterator ivit(this, sidno);
-  const Interval *iv;
-  while ((iv= ivit.get()) != NULL)
-  {
-    if (gno < iv->start)
-      DBUG_RETURN(false);
-    else if (gno < iv->end)
-      DBUG_RETURN(true);
-    ivit.next();
-  }
-  DBUG_RETURN(false);
+  const Sidno_intervals *si= get_sidno_intervals(sidno);
+  int i= first_interval_ending_after(si->ivs, si->count, gno);
+  DBUG_RETURN(i < si->count && si->ivs[i].start <= gno);
 }
 
 int Gtid_set::to_string(char **buf_arg, const Gtid_set::String_format *sf_arg) const
@@ -1241,19 +1208,56 @@ Gtid_set::intersection(const Gtid_set *other, Gtid_set *result)
   DBUG_ASSERT(result != this);
   DBUG_ASSERT(result != other);
   DBUG_ASSERT(other != this);
-  /**
-    @todo: This algorithm is simple, a little bit slower than
-    necessary.  It would be more efficient to iterate over intervals
-    of 'this' and 'other' similar to add_gno_interval(). At the moment
-    the performance of this is not super-important. /Sven
-  */
-  Gtid_set this_minus_other(sid_map);
+  Sid_map *other_sid_map= other->sid_map;
+  rpl_sidno max_sidno= get_max_sidno();
+  rpl_sidno other_max_sidno= other->get_max_sidno();
   Gtid_set intersection(sid_map);
-  // In set theory, intersection(A, B) == A - (A - B)
-  PROPAGATE_REPORTED_ERROR(this_minus_other.add_gtid_set(this));
-  PROPAGATE_REPORTED_ERROR(this_minus_other.remove_gtid_set(other));
-  PROPAGATE_REPORTED_ERROR(intersection.add_gtid_set(this));
-  PROPAGATE_REPORTED_ERROR(intersection.remove_gtid_set(&this_minus_other));
+  Sidno_intervals common= { NULL, 0, 0 };
+  enum_return_status ret= RETURN_STATUS_OK;
+
+  // Intersect the intervals of each sidno with a linear merge.
+  for (rpl_sidno sidno= 1; sidno <= max_sidno && ret == RETURN_STATUS_OK;
+       sidno++)
+  {
+    const Sidno_intervals *si= get_sidno_intervals(sidno);
+    if (si->count == 0)
+      continue;
+    rpl_sidno other_sidno= sidno;
+    if (other_sid_map != sid_map && other_sid_map != NULL && sid_map != NULL)
+      other_sidno= other_sid_map->sid_to_sidno(sid_map->sidno_to_sid(sidno));
+    if (other_sidno == 0 || other_sidno > other_max_sidno)
+      continue;
+    const Sidno_intervals *other_si= other->get_sidno_intervals(other_sidno);
+    if ((ret= reserve(&common, si->count + other_si->count)) !=
+        RETURN_STATUS_OK)
+      break;
+    common.count= 0;
+    int i= 0, j= 0;
+    while (i < si->count && j < other_si->count)
+    {
+      rpl_gno start= max(si->ivs[i].start, other_si->ivs[j].start);
+      rpl_gno end= min(si->ivs[i].end, other_si->ivs[j].end);
+      if (start < end)
+      {
+        common.ivs[common.count].start= start;
+        common.ivs[common.count].end= end;
+        common.count++;
+      }
+      // Advance the interval that ends first.
+      if (si->ivs[i].end < other_si->ivs[j].end)
+        i++;
+      else
+        j++;
+    }
+    if (common.count != 0 &&
+        ((ret= intersection.ensure_sidno(sidno)) != RETURN_STATUS_OK ||
+         (ret= intersection.add_gno_intervals(sidno, common.ivs,
+                                              common.count)) !=
+         RETURN_STATUS_OK))
+      break;
+  }
+  my_free(common.ivs);
+  PROPAGATE_REPORTED_ERROR(ret);
   PROPAGATE_REPORTED_ERROR(result->add_gtid_set(&intersection));
   RETURN_OK;
 }
@@ -1344,7 +1348,6 @@ enum_return_status Gtid_set::add_gtid_encoding(const uchar *encoded,
     sid_lock->assert_some_wrlock();
   size_t pos= 0;
   uint64 n_sids;
-  Free_intervals_lock lock(this);
   // read number of SIDs
   if (length < 8)
   {
@@ -1383,7 +1386,6 @@ enum_return_status Gtid_set::add_gtid_encoding(const uchar *encoded,
                            (ulong) length, (ulong) pos, n_intervals));
       goto report_error;
     }
-    Interval_iterator ivit(this, sidno);
     rpl_gno last= 0;
     for (uint i= 0; i < n_intervals; i++)
     {
@@ -1399,14 +1401,8 @@ enum_return_status Gtid_set::add_gtid_encoding(const uchar *encoded,
         goto report_error;
       }
       last= end;
-      // Add interval.  Use the existing iterator position if the
-      // current interval does not begin before it.  Otherwise iterate
-      // from the beginning.
-      Interval *current= ivit.get();
-      if (current == NULL || start < current->start)
-        ivit.init(this, sidno);
       DBUG_PRINT("info", ("adding %d:%lld-%lld", sidno, start, end - 1));
-      PROPAGATE_REPORTED_ERROR(add_gno_interval(&ivit, start, end, &lock));
+      PROPAGATE_REPORTED_ERROR(add_gno_interval(sidno, start, end));
     }
   }
   DBUG_ASSERT(pos <= length);
@@ -1442,3 +1438,165 @@ size_t Gtid_set::get_encoded_length() const
       ret+= 16 + 8 + 2 * 8 * get_n_intervals(sidno);
   return ret;
 }
+
+
+/// Return the number of bytes that net_store_length() uses for n.
+static uint packed_length_size(uint64 n)
+{
+  return n < 251ULL ? 1 : n < 65536ULL ? 3 : n < 16777216ULL ? 4 : 9;
+}
+
+
+size_t Gtid_set::get_compact_encoded_length() const
+{
+  if (sid_lock != NULL)
+    sid_lock->assert_some_wrlock();
+  uint64 n_sids= 0;
+  size_t ret= 0;
+  rpl_sidno max_sidno= get_max_sidno();
+  for (rpl_sidno sidno= 1; sidno <= max_sidno; sidno++)
+  {
+    const Sidno_intervals *si= get_sidno_intervals(sidno);
+    if (si->count == 0)
+      continue;
+    n_sids++;
+    ret+= rpl_sid::BYTE_LENGTH + packed_length_size(si->count);
+    rpl_gno last= 0;
+    for (int i= 0; i < si->count; i++)
+    {
+      ret+= packed_length_size(si->ivs[i].start - last) +
+        packed_length_size(si->ivs[i].end - si->ivs[i].start);
+      last= si->ivs[i].end;
+    }
+  }
+  return ret + packed_length_size(n_sids);
+}
+
+
+void Gtid_set::encode_compact(uchar *buf) const
+{
+  DBUG_ENTER("Gtid_set::encode_compact(uchar *)");
+  if (sid_lock != NULL)
+    sid_lock->assert_some_wrlock();
+  uchar *start= buf;
+  uint64 n_sids= 0;
+  rpl_sidno sidmap_max_sidno= sid_map->get_max_sidno();
+  rpl_sidno max_sidno= get_max_sidno();
+  for (rpl_sidno sidno= 1; sidno <= max_sidno; sidno++)
+    if (contains_sidno(sidno))
+      n_sids++;
+  buf= net_store_length(buf, n_sids);
+  // iterate over sidnos in the order of the SIDs, like encode()
+  for (rpl_sidno sid_i= 0; sid_i < sidmap_max_sidno; sid_i++)
+  {
+    rpl_sidno sidno= sid_map->get_sorted_sidno(sid_i);
+    if (sidno > max_sidno)
+      continue;
+    const Sidno_intervals *si= get_sidno_intervals(sidno);
+    if (si->count == 0)
+      continue;
+    sid_map->sidno_to_sid(sidno).copy_to(buf);
+    buf+= rpl_sid::BYTE_LENGTH;
+    buf= net_store_length(buf, si->count);
+    // store each interval as the gap after the previous one and its length
+    rpl_gno last= 0;
+    for (int i= 0; i < si->count; i++)
+    {
+      buf= net_store_length(buf, si->ivs[i].start - last);
+      buf= net_store_length(buf, si->ivs[i].end - si->ivs[i].start);
+      last= si->ivs[i].end;
+    }
+  }
+  DBUG_ASSERT((size_t) (buf - start) == get_compact_encoded_length());
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  Read a packed integer stored by net_store_length().
+
+  @param[in,out] pos Position in the encoded string, advanced past the
+  integer.
+  @param end End of the encoded string.
+  @param[out] value The integer.
+  @return false on success, true if the integer is truncated or NULL.
+*/
+static bool read_packed_length(const uchar **pos, const uchar *end,
+                               uint64 *value)
+{
+  if (*pos >= end || **pos == 251)
+    return true;
+  uint size= **pos < 251 ? 1 : **pos == 252 ? 3 : **pos == 253 ? 4 : 9;
+  if ((size_t) (end - *pos) < size)
+    return true;
+  *value= net_field_length_ll((uchar **) pos);
+  return false;
+}
+
+
+enum_return_status
+Gtid_set::add_gtid_compact_encoding(const uchar *encoded, size_t length,
+                                    size_t *actual_length)
+{
+  DBUG_ENTER("Gtid_set::add_gtid_compact_encoding(const uchar *, size_t)");
+  if (sid_lock != NULL)
+    sid_lock->assert_some_wrlock();
+  const uchar *pos= encoded;
+  const uchar *end= encoded + length;
+  uint64 n_sids;
+  if (read_packed_length(&pos, end, &n_sids))
+    goto report_error;
+  for (uint64 i= 0; i < n_sids; i++)
+  {
+    uint64 n_intervals;
+    if ((size_t) (end - pos) < rpl_sid::BYTE_LENGTH)
+      goto report_error;
+    rpl_sid sid;
+    sid.copy_from(pos);
+    pos+= rpl_sid::BYTE_LENGTH;
+    if (read_packed_length(&pos, end, &n_intervals))
+      goto report_error;
+    rpl_sidno sidno= sid_map->add_sid(sid);
+    if (sidno <= 0)
+      RETURN_REPORTED_ERROR;
+    PROPAGATE_REPORTED_ERROR(ensure_sidno(sidno));
+    rpl_gno last= 0;
+    for (uint64 j= 0; j < n_intervals; j++)
+    {
+      uint64 gap, n_gnos;
+      if (read_packed_length(&pos, end, &gap) ||
+          read_packed_length(&pos, end, &n_gnos))
+        goto report_error;
+      // intervals are disjoint and non-adjacent, and not empty
+      if (gap == 0 || n_gnos == 0 ||
+          gap >= (uint64) (MAX_GNO - last) ||
+          n_gnos > (uint64) (MAX_GNO - last - gap))
+      {
+        DBUG_PRINT("error", ("last=%lld gap=%llu n_gnos=%llu",
+                             last, gap, n_gnos));
+        goto report_error;
+      }
+      rpl_gno start= last + (rpl_gno) gap;
+      last= start + (rpl_gno) n_gnos;
+      PROPAGATE_REPORTED_ERROR(add_gno_interval(sidno, start, last));
+    }
+  }
+  if (actual_length == NULL)
+  {
+    if (pos != end)
+    {
+      DBUG_PRINT("error", ("(pos=%lu) != (length=%lu)",
+                           (ulong) (pos - encoded), (ulong) length));
+      goto report_error;
+    }
+  }
+  else
+    *actual_length= pos - encoded;
+
+  RETURN_OK;
+
+report_error:
+  BINLOG_ERROR(("Malformed GTID_set encoding."),
+               (ER_MALFORMED_GTID_SET_ENCODING, MYF(0)));
+  RETURN_REPORTED_ERROR;
+}
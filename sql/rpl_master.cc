@@ -28,6 +28,7 @@
 #include "rpl_master.h"
 #include "debug_sync.h"
 #include "binlog.h"
+#include "binlog_tail_cache.h"
 #include <errno.h>
 #include <sys/socket.h>
 
@@ -557,6 +558,36 @@ Increase max_allowed_packet on master";
 }
 
 
+/**
+  Read the next event of a binary log for a dump thread: from the binlog
+  tail cache if it has the event, from the binary log file otherwise.
+  The arguments and return value are the same as for
+  Log_event::read_log_event().
+*/
+
+static int read_binlog_event(IO_CACHE *log, String *packet,
+                             uint8 checksum_alg, const char *log_file_name,
+                             bool *is_binlog_active= NULL)
+{
+  my_off_t pos= my_b_tell(log);
+  ulong length;
+  int error;
+
+  if (binlog_tail_cache.read_event(log_file_name, pos, packet, &length))
+  {
+    if (is_binlog_active)
+      *is_binlog_active= mysql_bin_log.is_active(log_file_name);
+    my_b_seek(log, pos + length);
+    return 0;
+  }
+  error= Log_event::read_log_event(log, packet, checksum_alg, log_file_name,
+                                   is_binlog_active);
+  if (!error && binlog_tail_cache.is_enabled())
+    my_atomic_add64((longlong*) &binlog_tail_cache_misses, 1);
+  return error;
+}
+
+
 /**
   An auxiliary function for calling in mysql_binlog_send
   to initialize the heartbeat timeout in waiting for a binlogged event.
@@ -1293,10 +1324,8 @@ void mysql_binlog_send(THD* thd, char* log_ident, my_off_t pos,
                               semi_sync_slave))
       GOTO_ERR;
     bool is_active_binlog= false;
-    while (!(error= Log_event::read_log_event(&log, packet,
-                                              current_checksum_alg,
-                                              log_file_name,
-                                              &is_active_binlog)))
+    while (!(error= read_binlog_event(&log, packet, current_checksum_alg,
+                                      log_file_name, &is_active_binlog)))
     {
       DBUG_PRINT("info", ("read_log_event returned 0 on line %d", __LINE__));
 #ifndef DBUG_OFF
@@ -1620,9 +1649,8 @@ void mysql_binlog_send(THD* thd, char* log_ident, my_off_t pos,
           has not been updated since last read.
 	*/
 
-        switch (error= Log_event::read_log_event(&log, packet,
-                                                 current_checksum_alg,
-                                                 log_file_name)) {
+        switch (error= read_binlog_event(&log, packet, current_checksum_alg,
+                                         log_file_name)) {
 	case 0:
           DBUG_PRINT("info", ("read_log_event returned 0 on line %d",
                               __LINE__));
@@ -2365,6 +2393,12 @@ err:
   DBUG_RETURN(TRUE);
 }
 
+static bool previous_gtid_set_lacks_gtid(const Gtid_set *previous_gtid_set,
+                                         const void *gtid)
+{
+  return !previous_gtid_set->contains_gtid(*(const Gtid*) gtid);
+}
+
 /*
   Finds the binlog file name and starting position of corresponding
   Gtid_log_event of gtid_string and store in parameters log_name
@@ -2386,50 +2420,43 @@ uint find_gtid_position_helper(const char* gtid_string,
   Sid_map sid_map(NULL);
   uint error = ER_UNKNOWN_ERROR;
   int dir_len;
+  int index;
+  std::string binlog_file_name;
 
   Gtid_set previous_gtid_set(&sid_map);
 
-  std::map<std::string, std::string>::reverse_iterator rit;
-  std::map<std::string, std::string> *previous_gtid_set_map;
-
   if (gtid.parse(&sid_map, gtid_string) != RETURN_STATUS_OK)
   {
     goto err;
   }
 
+  /*
+    The gtid is in the last binary log whose previous gtid set does not
+    contain it, if any.
+  */
   mysql_bin_log.lock_index();
-  previous_gtid_set_map = mysql_bin_log.get_previous_gtid_set_map();
-
-  for (rit = previous_gtid_set_map->rbegin();
-       rit != previous_gtid_set_map->rend(); ++rit)
+  index = mysql_bin_log.find_last_previous_gtid_set(
+    &previous_gtid_set, previous_gtid_set_lacks_gtid, &gtid);
+  if (index < 0)
   {
+    mysql_bin_log.unlock_index();
+    error = ER_REQUESTED_PURGED_GTID;
+    goto err;
+  }
+  binlog_file_name = (*mysql_bin_log.get_previous_gtid_sets())[index].first;
+  mysql_bin_log.unlock_index();
 
-    previous_gtid_set.add_gtid_encoding((const uchar*)rit->second.c_str(),
-                                        rit->second.length());
-
-    if (!previous_gtid_set.contains_gtid(gtid))
-    {
-      /*
-        Unlock index here since we don't iterate over the
-        previous_gtid_set_map anymore.
-      */
-      mysql_bin_log.unlock_index();
-      gtid_pos = find_gtid_pos_in_log(rit->first.c_str(), gtid, &sid_map);
-      if (!gtid_pos)
-      {
-        error = ER_REQUESTED_GTID_NOT_IN_EXECUTED_SET;
-        goto err;
-      }
+  gtid_pos = find_gtid_pos_in_log(binlog_file_name.c_str(), gtid, &sid_map);
+  if (!gtid_pos)
+  {
+    error = ER_REQUESTED_GTID_NOT_IN_EXECUTED_SET;
+    goto err;
+  }
 
-      dir_len = dirname_length(rit->first.c_str());
-      strcpy(log_name, rit->first.c_str() + dir_len);
+  dir_len = dirname_length(binlog_file_name.c_str());
+  strcpy(log_name, binlog_file_name.c_str() + dir_len);
 
-      DBUG_RETURN(0);
-    }
-    previous_gtid_set.clear();
-  }
-  mysql_bin_log.unlock_index();
-  error = ER_REQUESTED_PURGED_GTID;
+  DBUG_RETURN(0);
 
 err:
   DBUG_RETURN(error);
@@ -99,7 +99,9 @@ Relay_log_info::Relay_log_info(bool is_slave_recovery
    part_event(false),
    ends_group(false),
    save_temporary_tables(0),
-   cur_log_old_open_count(0), group_relay_log_pos(0), event_relay_log_pos(0),
+   cur_log_old_open_count(0), trx_payload(NULL),
+   prefetchers(NULL), n_prefetchers(0), mute_reports(false),
+   group_relay_log_pos(0), event_relay_log_pos(0),
    group_master_log_pos(0),
    gtid_set(global_sid_map, global_sid_lock),
    log_space_total(0), ignore_log_space_limit(0),
@@ -232,11 +234,89 @@ Relay_log_info::~Relay_log_info()
   my_atomic_rwlock_destroy(&slave_open_temp_tables_lock);
   relay_log.cleanup();
   set_rli_description_event(NULL);
+  delete trx_payload;
   deinit_gtid_infos();
 
   DBUG_VOID_RETURN;
 }
 
+bool Relay_log_event_queue::push(const char *buf, ulong len, my_off_t pos,
+                                 uint32 open_count, ulonglong max_bytes)
+{
+  bool overflow= false;
+  Entry *entry;
+
+  if (m_bytes + len > max_bytes)
+  {
+    clear();
+    overflow= true;
+    if (len > max_bytes)
+      return true;
+  }
+
+  if (!(entry= (Entry *) my_malloc(sizeof(Entry), MYF(0))))
+    return true;
+  /* Some events use the extra byte to null-terminate strings */
+  if (!(entry->buf= (char *) my_malloc(len + 1, MYF(0))))
+  {
+    my_free(entry);
+    return true;
+  }
+  memcpy(entry->buf, buf, len);
+  entry->next= NULL;
+  entry->len= len;
+  entry->pos= pos;
+  entry->open_count= open_count;
+
+  if (m_tail)
+    m_tail->next= entry;
+  else
+    m_head= entry;
+  m_tail= entry;
+  m_bytes+= len;
+  return overflow;
+}
+
+char *Relay_log_event_queue::pop(my_off_t pos, uint32 open_count, ulong *len)
+{
+  while (m_head &&
+         (m_head->open_count != open_count || m_head->pos < pos))
+  {
+    Entry *entry= m_head;
+    m_head= entry->next;
+    m_bytes-= entry->len;
+    my_free(entry->buf);
+    my_free(entry);
+  }
+  if (!m_head)
+    m_tail= NULL;
+
+  if (!m_head || m_head->pos != pos)
+    return NULL;
+
+  Entry *entry= m_head;
+  char *buf= entry->buf;
+  *len= entry->len;
+  if (!(m_head= entry->next))
+    m_tail= NULL;
+  m_bytes-= entry->len;
+  my_free(entry);
+  return buf;
+}
+
+void Relay_log_event_queue::clear()
+{
+  while (m_head)
+  {
+    Entry *entry= m_head;
+    m_head= entry->next;
+    my_free(entry->buf);
+    my_free(entry);
+  }
+  m_tail= NULL;
+  m_bytes= 0;
+}
+
 /**
    Method is called when MTS coordinator senses the relay-log name
    has been changed.
@@ -545,8 +625,14 @@ int Relay_log_info::init_relay_log_pos(const char* log,
   */
   set_rli_description_event(new Format_description_log_event(3));
 
+  /* The rest of a compressed transaction is read again from the relay log */
+  delete trx_payload;
+  trx_payload= NULL;
+
   mysql_mutex_lock(log_lock);
 
+  relay_log_queue.clear();
+
   /* Close log file and free buffers if it's already open */
   if (cur_log_fd >= 0)
   {
@@ -28,8 +28,62 @@
 
 struct RPL_TABLE_LIST;
 class Master_info;
+class Transaction_payload_log_event;
+class Slave_prefetcher;
 extern uint sql_slave_skip_counter;
 
+/**
+  Events the slave I/O thread has just written to the relay log, kept in
+  memory so that the SQL thread can take them from here instead of
+  reading them back from the hot relay log. The relay log is still
+  written for crash safety, and the SQL thread reads it whenever the
+  event at its position is not queued: after a restart, when it lags
+  behind the hot log, or after the queue overflowed and was emptied.
+
+  Every entry is the event at position pos of the relay log file opened
+  for the open_count'th time. The queue is protected by the LOCK_log of
+  the relay log.
+*/
+class Relay_log_event_queue
+{
+public:
+  Relay_log_event_queue() : m_head(NULL), m_tail(NULL), m_bytes(0) {}
+  ~Relay_log_event_queue() { clear(); }
+
+  /**
+    Queue a copy of the event the I/O thread wrote at pos. If the queue
+    would grow above max_bytes, it is emptied first.
+
+    @retval false  the queue held the event without dropping any
+    @retval true   the queue overflowed, or the event could not be queued
+  */
+  bool push(const char *buf, ulong len, my_off_t pos, uint32 open_count,
+            ulonglong max_bytes);
+
+  /**
+    Take the event at pos, dropping the events before it.
+
+    @return the event, to be freed by the caller with my_free(), or NULL
+            if it is not queued
+  */
+  char *pop(my_off_t pos, uint32 open_count, ulong *len);
+
+  void clear();
+
+private:
+  struct Entry
+  {
+    Entry *next;
+    char *buf;
+    ulong len;
+    my_off_t pos;
+    uint32 open_count;
+  };
+
+  Entry *m_head, *m_tail;
+  ulonglong m_bytes;
+};
+
 /*******************************************************************************
 Replication SQL Thread
 
@@ -201,6 +255,33 @@ public:
   */
   uint32 cur_log_old_open_count;
 
+  /*
+    The compressed transaction whose events the SQL thread is reading, see
+    next_event(). The relay log positions are after it while its events
+    are applied.
+  */
+  Transaction_payload_log_event *trx_payload;
+
+  /*
+    The prefetch threads started with the SQL thread, see
+    rpl_slave_prefetch.cc.
+  */
+  Slave_prefetcher **prefetchers;
+  uint n_prefetchers;
+
+  /*
+    Set for the Relay_log_info of a prefetch thread, which applies
+    events ahead of the SQL thread and expects some of them to fail.
+    Its errors are not reported in the error log.
+  */
+  bool mute_reports;
+
+  /*
+    The events the I/O thread hands to the SQL thread, see
+    slave_relay_log_bypass_size.
+  */
+  Relay_log_event_queue relay_log_queue;
+
   /*
     Let's call a group (of events) :
       - a transaction
@@ -944,6 +1025,13 @@ public:
 protected:
   Format_description_log_event *rli_description_event;
 
+  virtual void do_report(loglevel level, int err_code,
+                         const char *msg, va_list v_args) const
+  {
+    if (!mute_reports)
+      va_report(level, err_code, msg, v_args);
+  }
+
 private:
 
   /**
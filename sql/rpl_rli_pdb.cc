@@ -3,6 +3,7 @@
 #include "unireg.h"
 #include "rpl_rli_pdb.h"
 #include "rpl_slave.h"
+#include "rpl_apply_stats.h"
 #include "sql_string.h"
 #include "sql_base.h"
 #include "debug_sync.h"
@@ -1820,13 +1821,18 @@ bool append_item_to_jobs(slave_job_item *job_item,
   while (worker->running_status == Slave_worker::RUNNING && !thd->killed &&
          (ret= en_queue(&worker->jobs, job_item)) == -1)
   {
+    Slave_worker_stats *stats= get_slave_worker_stats(worker->id);
+    ulonglong wait_start= my_timer_now();
+
     thd->ENTER_COND(&worker->jobs_cond, &worker->jobs_lock,
                     &stage_slave_waiting_worker_queue, &old_stage);
     worker->jobs.overfill= TRUE;
     worker->jobs.waited_overfill++;
     rli->mts_wq_overfill_cnt++;
+    stats->queue_full_waits++;
     mysql_cond_wait(&worker->jobs_cond, &worker->jobs_lock);
     thd->EXIT_COND(&old_stage);
+    stats->queue_full_wait_time+= my_timer_since(wait_start);
 
     mysql_mutex_lock(&worker->jobs_lock);
   }
@@ -2029,12 +2035,15 @@ struct slave_job_item* pop_jobs_item(Slave_worker *worker,
         // Resets worker->current_event_index to 0.
         clear_current_group_events(worker, worker->c_rli, true);
       }
+      ulonglong wait_start= my_timer_now();
       worker->wq_empty_waits++;
       thd->ENTER_COND(&worker->jobs_cond, &worker->jobs_lock,
                                &stage_slave_waiting_event_from_coordinator,
                                &old_stage);
       mysql_cond_wait(&worker->jobs_cond, &worker->jobs_lock);
       thd->EXIT_COND(&old_stage);
+      get_slave_worker_stats(worker->id)->idle_time+=
+        my_timer_since(wait_start);
       mysql_mutex_lock(&worker->jobs_lock);
     }
   }
@@ -2141,6 +2150,12 @@ int slave_worker_exec_job(Slave_worker *worker, Relay_log_info *rli)
   my_io_perf_t start_perf_read_primary, start_perf_read_secondary;
   ulonglong init_timer, wall_time;
   bool is_other, is_xid, update_slave_stats;
+  Slave_worker_stats *worker_stats;
+  Slave_apply_latency_key latency_key;
+  bool apply_latency_stats;
+  worker_stats= get_slave_worker_stats(worker->id);
+  if ((apply_latency_stats= opt_slave_apply_latency_stats))
+    get_slave_apply_latency_key(&latency_key, ev, worker);
   /* Initialize for user_statistics, see dispatch_command */
   thd->reset_user_stats_counters();
   start_perf_read = thd->io_perf_read;
@@ -2243,6 +2258,15 @@ int slave_worker_exec_job(Slave_worker *worker, Relay_log_info *rli)
 #endif
   }
   wall_time = my_timer_since(init_timer);
+  worker_stats->events++;
+  worker_stats->busy_time+= wall_time;
+  if (end_event)
+  {
+    worker_stats->groups++;
+    worker_stats->commit_time+= wall_time;
+  }
+  if (apply_latency_stats)
+    update_slave_apply_latency(&latency_key, wall_time);
   /* Update counters for USER_STATS */
   is_other= FALSE;
   is_xid= FALSE;
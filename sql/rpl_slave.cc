@@ -53,6 +53,8 @@
                                                 // Format_description_log_event
 #include "dynamic_ids.h"
 #include "rpl_rli_pdb.h"
+#include "rpl_slave_prefetch.h"
+#include "rpl_apply_stats.h"
 #include "global_threads.h"
 
 #ifdef HAVE_REPLICATION
@@ -341,6 +343,8 @@ static void init_slave_psi_keys(void)
 
   count= array_elements(all_slave_threads);
   mysql_thread_register(category, all_slave_threads, count);
+
+  init_slave_prefetch_psi_keys();
 }
 #endif /* HAVE_PSI_INTERFACE */
 
@@ -3477,6 +3481,11 @@ apply_event_and_update_pos(Log_event** ptr_ev, THD* thd, Relay_log_info* rli)
     if (sql_delay_event(ev, thd, rli))
       DBUG_RETURN(SLAVE_APPLY_EVENT_AND_UPDATE_POS_OK);
 
+    Slave_apply_latency_key latency_key;
+    bool apply_latency_stats= opt_slave_apply_latency_stats;
+    if (apply_latency_stats)
+      get_slave_apply_latency_key(&latency_key, ev, rli);
+
     init_timer = my_timer_now();
 
     exec_res= ev->apply_event(rli);
@@ -3588,6 +3597,8 @@ apply_event_and_update_pos(Log_event** ptr_ev, THD* thd, Relay_log_info* rli)
     }
     else {
       ulonglong wall_time = my_timer_since(init_timer);
+      if (apply_latency_stats)
+        update_slave_apply_latency(&latency_key, wall_time);
       /* Update counters for USER_STATS */
       bool is_other= FALSE;
       bool is_xid= FALSE;
@@ -5651,6 +5662,9 @@ pthread_handler_t handle_slave_sql(void *arg)
                 "Error initializing relay log position: %s", errmsg);
     goto err;
   }
+  if (start_slave_prefetch_threads(rli))
+    sql_print_warning("Slave SQL thread: failed to start the slave prefetch "
+                      "threads, continuing without prefetching");
   THD_CHECK_SENTRY(thd);
 #ifndef DBUG_OFF
   {
@@ -5843,6 +5857,10 @@ llstr(rli->get_group_master_log_pos(), llbuff));
 
  err:
 
+  stop_slave_prefetch_threads(rli);
+  mysql_mutex_lock(rli->relay_log.get_log_lock());
+  rli->relay_log_queue.clear();
+  mysql_mutex_unlock(rli->relay_log.get_log_lock());
   mysql_mutex_lock(&rli->run_lock);
   slave_stop_workers(rli, &mts_inited); // stopping worker pool
   if (rli->recovery_groups_inited)
@@ -6772,8 +6790,15 @@ static int queue_event(Master_info* mi,const char* buf, ulong event_len)
   else
   {
     /* write the event to the relay log */
+    my_off_t event_pos= my_b_append_tell(rli->relay_log.get_log_file());
+    uint32 open_count= rli->relay_log.get_open_count();
     if (likely(rli->relay_log.append_buffer(buf, event_len, mi) == 0))
     {
+      /* Hand the event to the SQL thread, see next_event() */
+      if (opt_slave_relay_log_bypass_size && rli->slave_running &&
+          rli->relay_log_queue.push(buf, event_len, event_pos, open_count,
+                                    opt_slave_relay_log_bypass_size))
+        slave_relay_log_bypass_overflows++;
       mi->set_master_log_pos(mi->get_master_log_pos() + inc_pos);
       DBUG_PRINT("info", ("master_log_pos: %lu", (ulong) mi->get_master_log_pos()));
       rli->relay_log.harvest_bytes_written(&rli->log_space_total);
@@ -6884,7 +6909,12 @@ static int connect_to_master(THD* thd, MYSQL* mysql, Master_info* mi,
 #endif
   ulong client_flag= CLIENT_REMEMBER_OPTIONS;
   if (opt_slave_compressed_protocol)
+  {
     client_flag |= CLIENT_COMPRESS;             /* We will use compression */
+    mysql_options(mysql, MYSQL_OPT_COMPRESSION_ALGORITHM,
+                  net_compression_algorithm_typelib.type_names[
+                    opt_slave_compression_algorithm]);
+  }
 
   mysql_options(mysql, MYSQL_OPT_CONNECT_TIMEOUT, (char *) &slave_net_timeout);
   mysql_options(mysql, MYSQL_OPT_READ_TIMEOUT, (char *) &slave_net_timeout);
@@ -7173,6 +7203,40 @@ static IO_CACHE *reopen_relay_log(Relay_log_info *rli, const char **errmsg)
   error is reported through the sql_print_information() or
   sql_print_error() functions.
 */
+/**
+  Take the event at the read position of the hot relay log from the
+  events the I/O thread queued, and move the read position after it.
+
+  @return the event, or NULL if it is not queued or cannot be parsed, in
+          which case it is read from the relay log
+*/
+static Log_event* read_queued_event(Relay_log_info* rli, IO_CACHE* cur_log,
+                                    int* read_length)
+{
+  const char *errmsg= 0;
+  ulong len;
+  char *buf;
+  Log_event *ev;
+
+  mysql_mutex_assert_owner(rli->relay_log.get_log_lock());
+  if (!(buf= rli->relay_log_queue.pop(my_b_tell(cur_log),
+                                      rli->cur_log_old_open_count, &len)))
+    return NULL;
+
+  if (!(ev= Log_event::read_log_event(buf, len, &errmsg,
+                                      rli->get_rli_description_event(),
+                                      opt_slave_sql_verify_checksum)))
+  {
+    my_free(buf);
+    return NULL;
+  }
+  ev->register_temp_buf(buf);
+  my_b_seek(cur_log, my_b_tell(cur_log) + len);
+  *read_length= len;
+  slave_relay_log_bypass_events++;
+  return ev;
+}
+
 static Log_event* next_event(Relay_log_info* rli)
 {
   Log_event* ev;
@@ -7200,6 +7264,24 @@ static Log_event* next_event(Relay_log_info* rli)
   */
   mysql_mutex_assert_owner(&rli->data_lock);
 
+  /*
+    The events of a compressed transaction are returned one by one, the
+    relay log positions stay after the Transaction_payload_log_event.
+  */
+  if (rli->trx_payload)
+  {
+    if ((ev= rli->trx_payload->next_event(rli->get_rli_description_event(),
+                                          &errmsg)))
+    {
+      ev->future_event_relay_log_pos= rli->get_future_event_relay_log_pos();
+      DBUG_RETURN(ev);
+    }
+    delete rli->trx_payload;
+    rli->trx_payload= NULL;
+    if (errmsg)
+      goto err;
+  }
+
   while (!sql_slave_killed(thd,rli))
   {
     /*
@@ -7277,7 +7359,8 @@ static Log_event* next_event(Relay_log_info* rli)
       But if the relay log is created by new_file(): then the solution is:
       MYSQL_BIN_LOG::open() will write the buffered description event.
     */
-    if ((ev= Log_event::read_log_event(cur_log, 0,
+    if ((hot_log && (ev= read_queued_event(rli, cur_log, &read_length))) ||
+        (ev= Log_event::read_log_event(cur_log, 0,
                                        rli->get_rli_description_event(),
                                        opt_slave_sql_verify_checksum,
                                        &read_length)))
@@ -7294,6 +7377,25 @@ static Log_event* next_event(Relay_log_info* rli)
         mysql_mutex_unlock(log_lock);
       relay_sql_events++;
       relay_sql_bytes += read_length;
+
+      if (ev->get_type_code() == TRANSACTION_PAYLOAD_EVENT)
+      {
+        rli->trx_payload= static_cast<Transaction_payload_log_event *>(ev);
+        if (rli->trx_payload->uncompress())
+          errmsg= "failed to uncompress a Transaction_payload event";
+        else if ((ev= rli->trx_payload->next_event(
+                        rli->get_rli_description_event(), &errmsg)))
+          ev->future_event_relay_log_pos=
+            rli->get_future_event_relay_log_pos();
+        else if (!errmsg)
+          errmsg= "empty Transaction_payload event";
+        if (errmsg)
+        {
+          delete rli->trx_payload;
+          rli->trx_payload= NULL;
+          goto err;
+        }
+      }
       /* 
          MTS checkpoint in the successful read branch 
       */
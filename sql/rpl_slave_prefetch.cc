@@ -0,0 +1,670 @@
+/* Copyright (c) 2013, Facebook, Inc. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include "sql_priv.h"
+#include "my_global.h"
+#include "rpl_slave_prefetch.h"
+
+#ifdef HAVE_REPLICATION
+
+#include "rpl_rli.h"
+#include "rpl_info_factory.h"
+#include "log_event.h"
+#include "binlog.h"
+#include "set_var.h"                            // find_sys_var
+#include "transaction.h"                        // trans_begin
+#include "global_threads.h"
+#include "mysqld.h"
+#include "my_atomic.h"
+
+#include <algorithm>
+
+/* How long a prefetch thread sleeps when it has nothing to do */
+static const ulonglong PREFETCH_WAIT_USECS= 10000;
+
+#ifdef HAVE_PSI_INTERFACE
+static PSI_thread_key key_thread_slave_prefetch;
+static PSI_mutex_key key_LOCK_slave_prefetch;
+static PSI_cond_key key_COND_slave_prefetch;
+
+static PSI_thread_info all_slave_prefetch_threads[]=
+{
+  { &key_thread_slave_prefetch, "slave_prefetch", 0}
+};
+
+static PSI_mutex_info all_slave_prefetch_mutexes[]=
+{
+  { &key_LOCK_slave_prefetch, "Slave_prefetcher::m_lock", 0}
+};
+
+static PSI_cond_info all_slave_prefetch_conds[]=
+{
+  { &key_COND_slave_prefetch, "Slave_prefetcher::m_cond", 0}
+};
+
+void init_slave_prefetch_psi_keys()
+{
+  const char* category= "sql";
+
+  mysql_thread_register(category, all_slave_prefetch_threads,
+                        array_elements(all_slave_prefetch_threads));
+  mysql_mutex_register(category, all_slave_prefetch_mutexes,
+                       array_elements(all_slave_prefetch_mutexes));
+  mysql_cond_register(category, all_slave_prefetch_conds,
+                      array_elements(all_slave_prefetch_conds));
+}
+#endif /* HAVE_PSI_INTERFACE */
+
+
+/**
+  One prefetch thread. It reads the relay log through its own IO_CACHE
+  and applies the row events of its transactions through its own
+  Relay_log_info, like a client executing BINLOG statements.
+*/
+class Slave_prefetcher
+{
+public:
+  Slave_prefetcher(Relay_log_info *sql_rli, uint id, uint n_threads);
+  ~Slave_prefetcher();
+
+  bool start();
+  void stop();
+  void run();
+
+private:
+  bool init_thd(THD *thd);
+  void deinit_thd();
+  bool set_session_var(const char *name, longlong value);
+  bool is_stopping();
+  void wait(ulonglong usecs);
+
+  bool sync_with_sql_thread();
+  bool open_log(const char *log_name, my_off_t pos);
+  void close_log();
+  int check_readable();
+
+  void handle_event(Log_event *ev, my_off_t pos);
+  void begin_trx(my_off_t pos);
+  void end_trx();
+
+  /** Relay_log_info of the SQL thread, the relay log to prefetch */
+  Relay_log_info *m_sql_rli;
+  /** Relay_log_info used to apply the events, owned by m_thd */
+  Relay_log_info *m_rli;
+  uint m_id;
+  uint m_n_threads;
+
+  pthread_t m_thread;
+  bool m_started;
+  /** m_lock protects m_thd and m_stop */
+  mysql_mutex_t m_lock;
+  mysql_cond_t m_cond;
+  THD *m_thd;
+  bool m_stop;
+
+  IO_CACHE m_log;
+  File m_log_fd;
+  char m_log_name[FN_REFLEN];
+  /** The events before this position of m_log are complete */
+  my_off_t m_readable_end;
+  /** m_log was the active relay log when m_readable_end was updated */
+  bool m_log_is_hot;
+
+  /** relay_sql_bytes when the thread synced with the SQL thread */
+  ulonglong m_sync_sql_bytes;
+  /** Bytes of events read since the thread synced with the SQL thread */
+  ulonglong m_read_bytes;
+
+  bool m_in_trx;
+  /** The current transaction is applied by this thread */
+  bool m_trx_mine;
+  bool m_trx_begin_seen;
+};
+
+
+Slave_prefetcher::Slave_prefetcher(Relay_log_info *sql_rli, uint id,
+                                   uint n_threads)
+  : m_sql_rli(sql_rli), m_rli(NULL), m_id(id), m_n_threads(n_threads),
+    m_started(false), m_thd(NULL), m_stop(false), m_log_fd(-1),
+    m_readable_end(0), m_log_is_hot(true), m_sync_sql_bytes(0),
+    m_read_bytes(0), m_in_trx(false), m_trx_mine(false),
+    m_trx_begin_seen(false)
+{
+  m_log_name[0]= 0;
+  mysql_mutex_init(key_LOCK_slave_prefetch, &m_lock, MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_COND_slave_prefetch, &m_cond, NULL);
+}
+
+
+Slave_prefetcher::~Slave_prefetcher()
+{
+  DBUG_ASSERT(!m_started);
+  mysql_cond_destroy(&m_cond);
+  mysql_mutex_destroy(&m_lock);
+}
+
+
+pthread_handler_t handle_slave_prefetch(void *arg)
+{
+  static_cast<Slave_prefetcher *>(arg)->run();
+  return 0;
+}
+
+
+bool Slave_prefetcher::start()
+{
+  pthread_attr_t attr;
+
+  if (pthread_attr_init(&attr))
+    return true;
+  if (pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE) ||
+      mysql_thread_create(key_thread_slave_prefetch, &m_thread, &attr,
+                          handle_slave_prefetch, this))
+  {
+    pthread_attr_destroy(&attr);
+    return true;
+  }
+  pthread_attr_destroy(&attr);
+  m_started= true;
+  return false;
+}
+
+
+void Slave_prefetcher::stop()
+{
+  if (!m_started)
+    return;
+
+  mysql_mutex_lock(&m_lock);
+  m_stop= true;
+  mysql_cond_signal(&m_cond);
+  /* Interrupt a wait for a row lock or a metadata lock */
+  if (m_thd)
+  {
+    mysql_mutex_lock(&m_thd->LOCK_thd_data);
+    m_thd->awake(THD::KILL_QUERY);
+    mysql_mutex_unlock(&m_thd->LOCK_thd_data);
+  }
+  mysql_mutex_unlock(&m_lock);
+
+  pthread_join(m_thread, NULL);
+  m_started= false;
+}
+
+
+bool Slave_prefetcher::is_stopping()
+{
+  return m_stop || m_thd->killed == THD::KILL_CONNECTION ||
+         abort_loop;
+}
+
+
+void Slave_prefetcher::wait(ulonglong usecs)
+{
+  struct timespec abstime;
+
+  set_timespec_nsec(abstime, usecs * 1000);
+  mysql_mutex_lock(&m_lock);
+  if (!m_stop)
+    mysql_cond_timedwait(&m_cond, &m_lock, &abstime);
+  mysql_mutex_unlock(&m_lock);
+}
+
+
+/**
+  Set a session variable of m_thd, as SET SESSION would.
+
+  @retval false  OK
+  @retval true   the variable does not exist or the value is invalid
+*/
+bool Slave_prefetcher::set_session_var(const char *name, longlong value)
+{
+  sys_var *var= find_sys_var(m_thd, name);
+  Item *item;
+  bool error= true;
+
+  if (var && (item= new (m_thd->mem_root) Item_int(value)))
+  {
+    set_var set(OPT_SESSION, var, &null_lex_str, item);
+    error= set.check(m_thd) || set.update(m_thd);
+  }
+  m_thd->free_items();
+  m_thd->clear_error();
+  return error;
+}
+
+
+bool Slave_prefetcher::init_thd(THD *thd)
+{
+  thd->store_globals();
+  thd->security_ctx->skip_grants();
+  my_net_init(&thd->net, 0);
+  thd->init_for_queries();
+  thd->set_command(COM_DAEMON);
+  /* The fake changes are rolled back, and never binlogged */
+  thd->variables.option_bits&= ~OPTION_BIN_LOG;
+  /* Do not hold up the SQL thread or DDL for long */
+  thd->variables.lock_wait_timeout= 1;
+
+  mysql_mutex_lock(&LOCK_thread_count);
+  add_global_thread(thd);
+  mysql_mutex_unlock(&LOCK_thread_count);
+
+  mysql_mutex_lock(&m_lock);
+  m_thd= thd;
+  mysql_mutex_unlock(&m_lock);
+
+  if (set_session_var("innodb_fake_changes", 1))
+  {
+    sql_print_warning("Slave prefetch thread %u: innodb_fake_changes is "
+                      "not available, prefetching is disabled", m_id);
+    return true;
+  }
+  set_session_var("innodb_lock_wait_timeout", 1);
+
+  if (!(m_rli= Rpl_info_factory::create_rli(INFO_REPOSITORY_DUMMY, FALSE)))
+    return true;
+  m_rli->info_thd= thd;
+  m_rli->mute_reports= true;
+  thd->rli_fake= m_rli;
+  return false;
+}
+
+
+void Slave_prefetcher::deinit_thd()
+{
+  THD *thd= m_thd;
+
+  close_log();
+
+  mysql_mutex_lock(&m_lock);
+  m_thd= NULL;
+  mysql_mutex_unlock(&m_lock);
+
+  net_end(&thd->net);
+  thd->release_resources();
+  mysql_mutex_lock(&LOCK_thread_count);
+  remove_global_thread(thd);
+  mysql_mutex_unlock(&LOCK_thread_count);
+  /* Frees m_rli */
+  delete thd;
+  m_rli= NULL;
+}
+
+
+void Slave_prefetcher::run()
+{
+  THD *thd;                     /* needs to be first for thread_stack */
+
+  my_thread_init();
+  DBUG_ENTER("Slave_prefetcher::run");
+
+  thd= new THD;
+  thd->thread_stack= (char*) &thd;
+
+  if (!init_thd(thd))
+  {
+    while (!is_stopping())
+    {
+      if (m_log_fd < 0 && sync_with_sql_thread())
+      {
+        wait(PREFETCH_WAIT_USECS);
+        continue;
+      }
+
+      /*
+        The SQL thread reads the same events as this thread, so comparing
+        the bytes both read since the sync tells how far ahead this thread
+        is.
+      */
+      ulonglong sql_bytes= relay_sql_bytes - m_sync_sql_bytes;
+      if (m_read_bytes < sql_bytes)
+      {
+        /* Behind the SQL thread: skip to its position */
+        end_trx();
+        close_log();
+        my_atomic_add64((int64 *) &slave_prefetch_skips, 1);
+        continue;
+      }
+      if (m_read_bytes - sql_bytes > opt_slave_prefetch_lookahead)
+      {
+        wait(PREFETCH_WAIT_USECS);
+        continue;
+      }
+
+      int readable= check_readable();
+      if (readable < 0)
+      {
+        end_trx();
+        close_log();
+        continue;
+      }
+      if (readable > 0)
+      {
+        wait(PREFETCH_WAIT_USECS);
+        continue;
+      }
+
+      int read_length= 0;
+      my_off_t pos= my_b_tell(&m_log);
+      Log_event *ev=
+        Log_event::read_log_event(&m_log, NULL,
+                                  m_rli->get_rli_description_event(),
+                                  opt_slave_sql_verify_checksum,
+                                  &read_length);
+      if (!ev)
+      {
+        end_trx();
+        close_log();
+        wait(PREFETCH_WAIT_USECS);
+        continue;
+      }
+      m_read_bytes+= read_length;
+      handle_event(ev, pos);
+
+      if (m_thd->killed == THD::KILL_QUERY)
+      {
+        /* A KILL QUERY only aborts the current transaction */
+        end_trx();
+        m_thd->killed= THD::NOT_KILLED;
+      }
+    }
+    end_trx();
+  }
+  deinit_thd();
+
+  my_thread_end();
+  DBUG_LEAVE;
+  pthread_exit(0);
+}
+
+
+/**
+  Open the relay log at the position of the SQL thread.
+
+  @retval false  OK
+  @retval true   the SQL thread has no position yet, or the relay log
+                 could not be opened
+*/
+bool Slave_prefetcher::sync_with_sql_thread()
+{
+  char log_name[FN_REFLEN];
+  my_off_t pos;
+
+  mysql_mutex_lock(&m_sql_rli->data_lock);
+  strmake(log_name, m_sql_rli->get_event_relay_log_name(), FN_REFLEN - 1);
+  pos= m_sql_rli->get_event_relay_log_pos();
+  m_sync_sql_bytes= relay_sql_bytes;
+  mysql_mutex_unlock(&m_sql_rli->data_lock);
+  m_read_bytes= 0;
+
+  if (!log_name[0])
+    return true;
+  return open_log(log_name, std::max<my_off_t>(pos, BIN_LOG_HEADER_SIZE));
+}
+
+
+/**
+  Open a relay log and position it at pos. Like the SQL thread, read the
+  Format_description events at the start of the log to know how to read
+  the events at pos.
+*/
+bool Slave_prefetcher::open_log(const char *log_name, my_off_t pos)
+{
+  const char *errmsg;
+
+  close_log();
+  if ((m_log_fd= open_binlog_file(&m_log, log_name, &errmsg)) < 0)
+    return true;
+  strmake(m_log_name, log_name, FN_REFLEN - 1);
+  m_readable_end= BIN_LOG_HEADER_SIZE;
+  m_log_is_hot= true;
+
+  m_rli->set_rli_description_event(new Format_description_log_event(3));
+  while (my_b_tell(&m_log) < pos && check_readable() == 0)
+  {
+    Log_event *ev=
+      Log_event::read_log_event(&m_log, NULL,
+                                m_rli->get_rli_description_event(),
+                                opt_slave_sql_verify_checksum, NULL);
+    if (!ev)
+    {
+      close_log();
+      return true;
+    }
+    Log_event_type type= ev->get_type_code();
+    if (type == FORMAT_DESCRIPTION_EVENT)
+    {
+      m_rli->set_rli_description_event(
+        static_cast<Format_description_log_event *>(ev));
+      continue;
+    }
+    delete ev;
+    if (type != ROTATE_EVENT && type != PREVIOUS_GTIDS_LOG_EVENT)
+      break;
+  }
+  my_b_seek(&m_log, pos);
+  return false;
+}
+
+
+void Slave_prefetcher::close_log()
+{
+  if (m_log_fd < 0)
+    return;
+  end_io_cache(&m_log);
+  mysql_file_close(m_log_fd, MYF(MY_WME));
+  m_log_fd= -1;
+}
+
+
+/**
+  Check if a complete event can be read at the position of m_log, and
+  switch to the next relay log at the end of a log that is not active.
+  The I/O thread appends to the active relay log and flushes it while
+  holding LOCK_log, so with LOCK_log held the file holds whole events.
+
+  @retval 0   an event can be read
+  @retval 1   the relay log has no new events yet
+  @retval -1  the next relay log could not be opened
+*/
+int Slave_prefetcher::check_readable()
+{
+  MYSQL_BIN_LOG *relay_log= &m_sql_rli->relay_log;
+
+  while (my_b_tell(&m_log) >= m_readable_end)
+  {
+    if (!m_log_is_hot)
+    {
+      LOG_INFO linfo;
+      char log_name[FN_REFLEN];
+
+      strmake(log_name, m_log_name, FN_REFLEN - 1);
+      if (relay_log->find_log_pos(&linfo, log_name, true) ||
+          relay_log->find_next_log(&linfo, true))
+        return -1;
+      if (open_log(linfo.log_file_name, BIN_LOG_HEADER_SIZE))
+        return -1;
+      continue;
+    }
+
+    mysql_mutex_lock(relay_log->get_log_lock());
+    m_log_is_hot= relay_log->is_active(m_log_name);
+    m_readable_end= my_b_filelength(&m_log);
+    mysql_mutex_unlock(relay_log->get_log_lock());
+
+    if (m_log_is_hot && my_b_tell(&m_log) >= m_readable_end)
+      return 1;
+  }
+  return 0;
+}
+
+
+void Slave_prefetcher::begin_trx(my_off_t pos)
+{
+  m_in_trx= true;
+  m_trx_begin_seen= false;
+  /* Spread the transactions over the threads by their position */
+  m_trx_mine= ((pos * 0x9E3779B97F4A7C15ULL) >> 32) % m_n_threads == m_id;
+  if (m_trx_mine && trans_begin(m_thd))
+  {
+    m_thd->clear_error();
+    m_trx_mine= false;
+  }
+}
+
+
+void Slave_prefetcher::end_trx()
+{
+  if (m_in_trx && m_trx_mine)
+  {
+    m_thd->clear_error();
+    m_rli->cleanup_context(m_thd, 1);
+  }
+  m_in_trx= false;
+  m_trx_mine= false;
+}
+
+
+/**
+  Apply an event of a transaction of this thread, if it is a row event,
+  and track the transaction boundaries. Takes ownership of ev.
+*/
+void Slave_prefetcher::handle_event(Log_event *ev, my_off_t pos)
+{
+  switch (ev->get_type_code())
+  {
+  case FORMAT_DESCRIPTION_EVENT:
+    end_trx();
+    m_rli->set_rli_description_event(
+      static_cast<Format_description_log_event *>(ev));
+    return;
+
+  case GTID_LOG_EVENT:
+  case ANONYMOUS_GTID_LOG_EVENT:
+    end_trx();
+    begin_trx(pos);
+    break;
+
+  case QUERY_EVENT:
+    if (static_cast<Query_log_event *>(ev)->starts_group())
+    {
+      if (!m_in_trx || m_trx_begin_seen)
+      {
+        end_trx();
+        begin_trx(pos);
+      }
+      m_trx_begin_seen= true;
+    }
+    else
+      end_trx();
+    break;
+
+  case XID_EVENT:
+    end_trx();
+    break;
+
+  case TABLE_MAP_EVENT:
+  case WRITE_ROWS_EVENT:
+  case UPDATE_ROWS_EVENT:
+  case DELETE_ROWS_EVENT:
+  case WRITE_ROWS_EVENT_V1:
+  case UPDATE_ROWS_EVENT_V1:
+  case DELETE_ROWS_EVENT_V1:
+    if (m_in_trx && m_trx_mine)
+    {
+      m_thd->set_query_id(next_query_id());
+      ev->thd= m_thd;
+      if (ev->apply_event(m_rli))
+      {
+        /*
+          The rows of a transaction ahead of the SQL thread may not be
+          there yet: give up on the rest of the transaction.
+        */
+        end_trx();
+        m_in_trx= true;
+      }
+      else if (ev->get_type_code() != TABLE_MAP_EVENT)
+        my_atomic_add64((int64 *) &slave_prefetch_events, 1);
+    }
+    break;
+
+  case TRANSACTION_PAYLOAD_EVENT:
+  {
+    Transaction_payload_log_event *payload=
+      static_cast<Transaction_payload_log_event *>(ev);
+    const char *errmsg= NULL;
+    Log_event *inner;
+
+    if (payload->uncompress())
+      break;
+    while (!is_stopping() &&
+           (inner= payload->next_event(m_rli->get_rli_description_event(),
+                                       &errmsg)))
+      handle_event(inner, pos);
+    break;
+  }
+
+  default:
+    break;
+  }
+  delete ev;
+}
+
+
+bool start_slave_prefetch_threads(Relay_log_info *rli)
+{
+  uint n= opt_slave_prefetch_threads;
+  DBUG_ENTER("start_slave_prefetch_threads");
+
+  DBUG_ASSERT(!rli->prefetchers && !rli->n_prefetchers);
+  if (!n)
+    DBUG_RETURN(false);
+
+  if (!(rli->prefetchers= (Slave_prefetcher **)
+        my_malloc(n * sizeof(Slave_prefetcher *), MYF(MY_WME))))
+    DBUG_RETURN(true);
+
+  for (uint i= 0; i < n; i++)
+  {
+    Slave_prefetcher *prefetcher= new Slave_prefetcher(rli, i, n);
+    if (prefetcher->start())
+    {
+      delete prefetcher;
+      stop_slave_prefetch_threads(rli);
+      DBUG_RETURN(true);
+    }
+    rli->prefetchers[rli->n_prefetchers++]= prefetcher;
+  }
+  DBUG_RETURN(false);
+}
+
+
+void stop_slave_prefetch_threads(Relay_log_info *rli)
+{
+  DBUG_ENTER("stop_slave_prefetch_threads");
+
+  for (uint i= 0; i < rli->n_prefetchers; i++)
+  {
+    rli->prefetchers[i]->stop();
+    delete rli->prefetchers[i];
+  }
+  my_free(rli->prefetchers);
+  rli->prefetchers= NULL;
+  rli->n_prefetchers= 0;
+  DBUG_VOID_RETURN;
+}
+
+#endif /* HAVE_REPLICATION */
@@ -0,0 +1,71 @@
+#ifndef RPL_SLAVE_PREFETCH_INCLUDED
+#define RPL_SLAVE_PREFETCH_INCLUDED
+
+/* Copyright (c) 2013, Facebook, Inc. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/**
+  @file
+
+  @brief
+  Slave prefetch threads.
+
+  A slave whose data does not fit in the buffer pool spends most of the
+  time of the SQL thread waiting for the index pages that the row events
+  touch to be read from disk, one at a time. The prefetch threads read
+  the relay log ahead of the SQL thread (or of the MTS coordinator) and
+  apply the row events with innodb_fake_changes, so the primary and
+  secondary index pages are read into the buffer pool, and then roll the
+  transaction back. By the time the SQL thread applies the same events,
+  the pages are usually in memory.
+
+  Each of the slave_prefetch_threads threads reads the relay log on its
+  own and applies the transactions whose start position hashes to it.
+  A thread stays at most slave_prefetch_lookahead bytes ahead of the SQL
+  thread, and when it falls behind the SQL thread it skips to the SQL
+  thread's position, since the pages it would read are not needed any
+  more.
+
+  Slave_prefetch_events and Slave_prefetch_skips count the row events
+  applied and the skips; InnoDB counts the pages the prefetchers read in
+  Innodb_buffer_pool_fake_changes_reads, and the pages later used by the
+  SQL thread or the workers in Innodb_buffer_pool_fake_changes_hits.
+*/
+
+#ifdef HAVE_REPLICATION
+
+class Relay_log_info;
+
+#ifdef HAVE_PSI_INTERFACE
+void init_slave_prefetch_psi_keys();
+#endif
+
+/**
+  Start slave_prefetch_threads prefetch threads for the relay log of rli.
+  Called by the SQL thread once the relay log position is initialized.
+
+  @retval false  OK, or prefetching is disabled
+  @retval true   a thread could not be started
+*/
+bool start_slave_prefetch_threads(Relay_log_info *rli);
+
+/**
+  Stop and free the prefetch threads of rli. Called by the SQL thread
+  when it stops.
+*/
+void stop_slave_prefetch_threads(Relay_log_info *rli);
+
+#endif /* HAVE_REPLICATION */
+#endif /* RPL_SLAVE_PREFETCH_INCLUDED */
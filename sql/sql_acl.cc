@@ -9442,6 +9442,8 @@ static bool send_server_handshake_packet(MPVIO_EXT *mpvio,
     mpvio->client_capabilities|= CLIENT_TRANSACTIONS;
 
   mpvio->client_capabilities|= CAN_CLIENT_COMPRESS;
+  mpvio->client_capabilities|= CAN_CLIENT_COMPRESS_ZSTD;
+  mpvio->client_capabilities|= CAN_CLIENT_COMPRESS_LZ4;
 
   if (ssl_acceptor_fd)
   {
@@ -16,6 +16,8 @@
 #ifndef SQL_TABLE_MAINTENANCE_H
 #define SQL_TABLE_MAINTENANCE_H
 
+#include "histogram.h"                          // enum_histogram_command
+
 /* Must be able to hold ALTER TABLE t PARTITION BY ... KEY ALGORITHM = 1 ... */
 #define SQL_ADMIN_MSG_TEXT_SIZE 128 * 1024
 
@@ -35,6 +37,8 @@ public:
     Constructor, used to represent a ANALYZE TABLE statement.
   */
   Sql_cmd_analyze_table()
+    : m_histogram_command(HISTOGRAM_NONE), m_histogram_columns(NULL),
+      m_histogram_buckets(HISTOGRAM_DEFAULT_BUCKETS)
   {}
 
   ~Sql_cmd_analyze_table()
@@ -46,6 +50,22 @@ public:
   {
     return SQLCOM_ANALYZE;
   }
+
+  /**
+    Make the statement ANALYZE TABLE ... UPDATE | DROP HISTOGRAM.
+  */
+  void set_histogram_command(enum_histogram_command command,
+                             List<String> *columns, uint buckets)
+  {
+    m_histogram_command= command;
+    m_histogram_columns= columns;
+    m_histogram_buckets= buckets;
+  }
+
+private:
+  enum_histogram_command m_histogram_command;
+  List<String> *m_histogram_columns;
+  uint m_histogram_buckets;
 };
 
 
@@ -6470,7 +6470,7 @@ find_field_in_view(THD *thd, TABLE_LIST *table_list,
   field_it.set(table_list);
 
   DBUG_ASSERT(table_list->schema_table_reformed ||
-              (ref != 0 && table_list->view != 0));
+              (ref != 0 && table_list->is_merged()));
   for (; !field_it.end_of_fields(); field_it.next())
   {
     if (!my_strcasecmp(system_charset_info, field_it.name(), name))
@@ -8314,8 +8314,7 @@ TABLE_LIST **make_leaves_list(TABLE_LIST **list, TABLE_LIST *tables)
   {
     if (table->merge_underlying_list)
     {
-      DBUG_ASSERT(table->view &&
-                  table->effective_algorithm == VIEW_ALGORITHM_MERGE);
+      DBUG_ASSERT(table->is_merged());
       list= make_leaves_list(list, table->merge_underlying_list);
     }
     else
@@ -8403,8 +8402,7 @@ bool setup_tables(THD *thd, Name_resolution_context *context,
   {
     if (table_list->merge_underlying_list)
     {
-      DBUG_ASSERT(table_list->view &&
-                  table_list->effective_algorithm == VIEW_ALGORITHM_MERGE);
+      DBUG_ASSERT(table_list->is_merged());
 
       Prepared_stmt_arena_holder ps_arena_holder(thd);
       if (table_list->setup_underlying(thd))
@@ -446,6 +446,7 @@ typedef struct system_variables
   ulong auto_increment_increment, auto_increment_offset;
   ulong bulk_insert_buff_size;
   uint  eq_range_index_dive_limit;
+  ulong histogram_sample_rows;
   uint  part_scan_max;
   ulong join_buff_size;
   ulong lock_wait_timeout;
@@ -544,6 +545,7 @@ typedef struct system_variables
 
   my_bool sysdate_is_now;
   my_bool binlog_rows_query_log_events;
+  my_bool binlog_trx_compression;
 
   double long_query_time_double;
 
@@ -555,6 +557,8 @@ typedef struct system_variables
   ulong allow_noncurrent_db_rw;
 
   my_bool expand_fast_index_creation;
+
+  my_bool select_point_fast_path;
 } SV;
 
 
@@ -601,11 +605,13 @@ typedef struct system_status_var
   ulonglong select_range_count;
   ulonglong select_range_check_count;
   ulonglong select_scan_count;
+  ulonglong select_point_fast_path_count;
   ulonglong long_query_count;
   ulonglong filesort_merge_passes;
   ulonglong filesort_range_count;
   ulonglong filesort_rows;
   ulonglong filesort_scan_count;
+  ulonglong hash_aggregation_spills;
   /* Prepared statements and binary protocol */
   ulonglong com_stmt_prepare;
   ulonglong com_stmt_reprepare;
@@ -831,7 +831,7 @@ void prepare_new_connection_state(THD* thd)
   Security_context *sctx= thd->security_ctx;
 
   if (thd->client_capabilities & CLIENT_COMPRESS)
-    thd->net.compress=1;        // Use compression
+    my_net_set_compression(&thd->net, thd->client_capabilities);
 
   /*
     Much of this is duplicated in create_embedded_thd() for the
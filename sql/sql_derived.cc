@@ -29,6 +29,8 @@
 #include "sql_view.h"                         // check_duplicate_names
 #include "sql_acl.h"                          // SELECT_ACL
 #include "sql_tmp_table.h"                    // Tmp tables
+#include "sql_base.h"                         // setup_tables, setup_wild
+#include "opt_trace.h"
 
 
 /**
@@ -115,6 +117,214 @@ mysql_handle_single_derived(LEX *lex, TABLE_LIST *derived,
           (*processor)(lex->thd, lex, derived));
 }
 
+/**
+  Check whether a join list contains a NATURAL or USING join.
+
+  @param join_list  list of tables and join nests
+
+  @return true if any nest of the list is a NATURAL/USING join.
+*/
+
+static bool has_natural_join(List<TABLE_LIST> *join_list)
+{
+  List_iterator_fast<TABLE_LIST> it(*join_list);
+  TABLE_LIST *tl;
+  while ((tl= it++))
+  {
+    if (tl->is_natural_join ||
+        (tl->nested_join && has_natural_join(&tl->nested_join->join_list)))
+      return true;
+  }
+  return false;
+}
+
+
+/**
+  @brief
+  Check whether a derived table can be merged into the outer query.
+
+  @param thd     Thread handle
+  @param lex     LEX for this thread
+  @param derived TABLE_LIST of the derived table in the upper SELECT
+
+  @details
+  Besides the restrictions on the query expression itself (see
+  st_select_lex_unit::is_mergeable()), merging is not done
+
+  - for views, which are merged by mysql_make_view(),
+  - for statements other than SELECT, so that the derived table never
+    becomes a target of a data change statement,
+  - for derived tables on the inner side of an outer join, where
+    constant columns of the derived table would not be NULL-complemented,
+  - for NATURAL/USING joins inside or around the derived table, whose
+    coalesced columns are computed for one SELECT only,
+  - when the outer query would end up with too many tables.
+
+  A wildcard in the select list of the derived table is expanded before
+  merging. This needs the underlying tables set up, so it is only done
+  when all of them are base tables or materialized derived tables.
+
+  @return true if the derived table is to be merged.
+*/
+
+static bool derived_is_mergeable(THD *thd, LEX *lex, TABLE_LIST *derived)
+{
+  SELECT_LEX_UNIT *const unit= derived->get_unit();
+  SELECT_LEX *const select= unit->first_select();
+
+  if (derived->effective_algorithm != DERIVED_ALGORITHM_TMPTABLE ||
+      !thd->optimizer_switch_flag(OPTIMIZER_SWITCH_DERIVED_MERGE) ||
+      lex->sql_command != SQLCOM_SELECT ||
+      !unit->is_mergeable())
+    return false;
+
+  for (TABLE_LIST *tl= derived; tl; tl= tl->embedding)
+  {
+    if (tl->outer_join || tl->natural_join || tl->is_natural_join)
+      return false;
+  }
+  if (has_natural_join(&select->top_join_list))
+    return false;
+
+  if (derived->select_lex->table_list.elements +
+      select->table_list.elements > MAX_TABLES)
+    return false;
+
+  if (select->with_wild)
+  {
+    for (TABLE_LIST *tl= select->table_list.first; tl; tl= tl->next_local)
+    {
+      if (tl->is_merged())
+        return false;
+    }
+  }
+  return true;
+}
+
+
+/**
+  @brief
+  Merge a derived table into the outer query.
+
+  @param thd     Thread handle
+  @param lex     LEX for this thread
+  @param derived TABLE_LIST of the derived table in the upper SELECT
+
+  @details
+  The derived table is turned into the same structure as a view with the
+  MERGE algorithm (see mysql_make_view()): its TABLE_LIST becomes a join
+  nest over the tables of the derived SELECT, the select list becomes the
+  field translation table of the nest and the WHERE clause is added to the
+  outer query by TABLE_LIST::prep_where(). The unit of the derived table
+  is removed from the tree of SELECTs, while its subqueries are moved to
+  the outer SELECT.
+
+  The changes are permanent, so a prepared statement merges its derived
+  tables only once.
+
+  @return
+    false  OK
+    true   Error
+*/
+
+bool mysql_derived_merge(THD *thd, LEX *lex, TABLE_LIST *derived)
+{
+  SELECT_LEX_UNIT *const unit= derived->get_unit();
+  SELECT_LEX *const select= unit->first_select();
+  SELECT_LEX *const parent= derived->select_lex;
+  TABLE_LIST *tl;
+  DBUG_ENTER("mysql_derived_merge");
+
+  Prepared_stmt_arena_holder ps_arena_holder(thd);
+
+  /* prevent name resolving out of derived table */
+  select->context.outer_context= 0;
+
+  if (select->with_wild)
+  {
+    SELECT_LEX *const save_current_select= lex->current_select;
+    lex->current_select= select;
+    bool res= (setup_tables(thd, &select->context, &select->top_join_list,
+                            select->table_list.first, &select->leaf_tables,
+                            false) ||
+               setup_wild(thd, select->table_list.first, select->item_list,
+                          NULL, select->with_wild));
+    lex->current_select= save_current_select;
+    if (res)
+      DBUG_RETURN(true);
+    select->with_wild= 0;
+  }
+
+  if (check_duplicate_names(select->item_list, 0))
+    DBUG_RETURN(true);
+
+  NESTED_JOIN *nested_join;
+  if (!(nested_join= (NESTED_JOIN *) thd->calloc(sizeof(NESTED_JOIN))))
+    DBUG_RETURN(true);
+
+  derived->effective_algorithm= VIEW_ALGORITHM_MERGE;
+  derived->merge_underlying_list= select->table_list.first;
+  derived->multitable_view= (select->table_list.elements > 1);
+  derived->updatable= false;
+  derived->table_name= derived->alias;
+  derived->table_name_length= strlen(derived->alias);
+  derived->db= (char *)"";
+  derived->db_length= 0;
+#ifndef NO_EMBEDDED_ACCESS_CHECKS
+  derived->grant.privilege= SELECT_ACL;
+#endif
+
+  /* make nested join structure for the tables of the derived table */
+  nested_join->join_list= select->top_join_list;
+  derived->nested_join= nested_join;
+  List_iterator_fast<TABLE_LIST> ti(nested_join->join_list);
+  while ((tl= ti++))
+  {
+    tl->join_list= &nested_join->join_list;
+    tl->embedding= derived;
+  }
+
+  /* Store WHERE clause for post-processing in TABLE_LIST::prep_where() */
+  derived->where= select->where;
+
+  /*
+    Resolve names of the derived table in its own tables only, and make its
+    name resolution contexts point to the SELECT it is merged into.
+  */
+  select->context.resolve_in_table_list_only(select->table_list.first);
+  select->context.select_lex= parent;
+  repoint_contexts_of_join_nests(select->top_join_list, select, parent);
+  for (tl= select->table_list.first; tl; tl= tl->next_local)
+    tl->select_lex= parent;
+
+  parent->select_n_having_items+= select->select_n_having_items;
+  parent->select_n_where_fields+= select->select_n_where_fields;
+
+  /* Remove the unit from the tree of SELECTs */
+  if ((*unit->prev= unit->next))
+    unit->next->prev= unit->prev;
+
+  /*
+    Move the subqueries and derived tables of the merged SELECT to the
+    outer SELECT. The merged SELECT stays in the global list of SELECTs
+    so that the derived tables it contains are still prepared by
+    mysql_handle_derived().
+  */
+  SELECT_LEX_UNIT *next_unit;
+  for (SELECT_LEX_UNIT *inner= select->first_inner_unit();
+       inner;
+       inner= next_unit)
+  {
+    SELECT_LEX_NODE *save_slave= inner->slave;
+    next_unit= inner->next_unit();
+    inner->include_down(parent);
+    inner->slave= save_slave; // fix include_down initialisation
+  }
+
+  DBUG_RETURN(false);
+}
+
+
 /**
   @brief Create temporary table structure (but do not fill it).
 
@@ -177,6 +387,18 @@ bool mysql_derived_prepare(THD *thd, LEX *lex, TABLE_LIST *derived)
   DBUG_ENTER("mysql_derived_prepare");
   bool res= FALSE;
   DBUG_ASSERT(unit);
+
+  if (derived_is_mergeable(thd, lex, derived))
+  {
+    Opt_trace_object trace_wrapper(&thd->opt_trace);
+    Opt_trace_object trace_derived(&thd->opt_trace, "derived");
+    trace_derived.add_utf8("table", derived->alias).
+      add("select#", unit->first_select()->select_number).
+      add("merged", true);
+    if (mysql_derived_merge(thd, lex, derived))
+      DBUG_RETURN(true);
+  }
+
   if (derived->uses_materialization())
   {
     SELECT_LEX *first_select= unit->first_select();
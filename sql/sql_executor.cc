@@ -38,6 +38,7 @@
 #include "sql_tmp_table.h"
 #include "records.h"          // rr_sequential
 #include "opt_explain_format.h" // Explain_format_flags
+#include "sql_hash_agg.h"       // Hash_aggregator
 
 #include <algorithm>
 using std::max;
@@ -60,6 +61,10 @@ static enum_nested_loop_state
 end_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
 static enum_nested_loop_state
 end_unique_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
+static enum_nested_loop_state
+end_hash_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
+static enum_nested_loop_state
+update_tmptable_group(JOIN *join, JOIN_TAB *join_tab);
 static void copy_sum_funcs(Item_sum **func_ptr, Item_sum **end_ptr);
 
 static int join_read_system(JOIN_TAB *tab);
@@ -749,6 +754,34 @@ return_zero_rows(JOIN *join, List<Item> &fields)
 }
 
 
+/**
+  Aggregate the groups of a tmp table in memory with a Hash_aggregator if
+  optimizer_switch hash_aggregation is on and the write function set up
+  for the table permits it: end_update(), or end_write() for GROUP BY
+  without aggregate functions when there is no HAVING or LIMIT to check
+  for every row.
+
+  @param tab  JOIN_TAB of a tmp table
+*/
+
+static void setup_hash_aggregation(JOIN_TAB *tab)
+{
+  THD *thd= tab->join->thd;
+  TMP_TABLE_PARAM *tmp_tbl= tab->tmp_table_param;
+  Hash_aggregator *hash_agg;
+
+  if (!thd->optimizer_switch_flag(OPTIMIZER_SWITCH_HASH_AGGREGATION) ||
+      tmp_tbl->precomputed_group_by || tab->having ||
+      tmp_tbl->end_write_records != HA_POS_ERROR ||
+      !Hash_aggregator::is_applicable(tab->table))
+    return;
+  if (!(hash_agg= new (thd->mem_root) Hash_aggregator(tab->table, tmp_tbl)))
+    return;                                     // Use the tmp table only
+  DBUG_PRINT("info",("Using end_hash_update"));
+  ((QEP_tmp_table *) tab->op)->set_hash_aggregator(hash_agg, end_hash_update);
+}
+
+
 /**
   @brief Setup write_func of QEP_tmp_table object
 
@@ -779,6 +812,7 @@ void setup_tmptable_write_func(JOIN_TAB *tab)
     {
       DBUG_PRINT("info",("Using end_update"));
       op->set_write_func(end_update);
+      setup_hash_aggregation(tab);
     }
     else
     {
@@ -795,6 +829,8 @@ void setup_tmptable_write_func(JOIN_TAB *tab)
   {
     DBUG_PRINT("info",("Using end_write"));
     op->set_write_func(end_write);
+    if (table->group)
+      setup_hash_aggregation(tab);
     if (tmp_tbl->precomputed_group_by)
     {
       /*
@@ -3027,7 +3063,6 @@ end_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records)
 {
   TABLE *const table= join_tab->table;
   ORDER   *group;
-  int	  error;
   DBUG_ENTER("end_update");
 
   if (end_of_records)
@@ -3049,6 +3084,23 @@ end_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records)
     if (item->maybe_null)
       group->buff[-1]= (char) group->field->is_null();
   }
+  DBUG_RETURN(update_tmptable_group(join, join_tab));
+}
+
+
+/**
+  Update the group with the key in TMP_TABLE_PARAM::group_buff in the tmp
+  table, or write it as a new group, for end_update().
+*/
+
+static enum_nested_loop_state
+update_tmptable_group(JOIN *join, JOIN_TAB *join_tab)
+{
+  TABLE *const table= join_tab->table;
+  ORDER   *group;
+  int	  error;
+  DBUG_ENTER("update_tmptable_group");
+
   if (!table->file->ha_index_read_map(table->record[1],
                                       join_tab->tmp_table_param->group_buff,
                                       HA_WHOLE_KEY,
@@ -3094,7 +3146,11 @@ end_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records)
       table->file->print_error(error, MYF(0));
       DBUG_RETURN(NESTED_LOOP_ERROR);
     }
-    ((QEP_tmp_table*)join_tab->op)->set_write_func(end_unique_update);
+    QEP_tmp_table *op= (QEP_tmp_table*) join_tab->op;
+    if (op->hash_aggregator())
+      op->set_spill_func(end_unique_update);
+    else
+      op->set_write_func(end_unique_update);
   }
   join_tab->send_records++;
   DBUG_RETURN(NESTED_LOOP_OK);
@@ -3150,6 +3206,177 @@ end_unique_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records)
 }
 
 
+/**
+  Write the record of a hash aggregation group to the tmp table,
+  converting the table to MyISAM if it gets full as the spill function
+  would.
+
+  @param ignore_dup  true if the group may already be in the table
+
+  @retval 0   OK
+  @retval -1  The group is already in the table
+  @retval 1   Error
+*/
+
+static int write_hash_group(JOIN *join, JOIN_TAB *join_tab, bool ignore_dup)
+{
+  TABLE *const table= join_tab->table;
+  TMP_TABLE_PARAM *const param= join_tab->tmp_table_param;
+  QEP_tmp_table *const op= (QEP_tmp_table*) join_tab->op;
+  bool is_duplicate= false;
+  int error;
+
+  if (!(error= table->file->ha_write_row(table->record[0])))
+    return 0;
+  if (ignore_dup && !table->file->is_fatal_error(error, HA_CHECK_DUP))
+    return -1;
+  if (create_myisam_from_heap(join->thd, table, param->start_recinfo,
+                              &param->recinfo, error, ignore_dup,
+                              &is_duplicate))
+    return 1;                                   // Not a table_is_full error
+  if (op->get_spill_func() == end_update)
+  {
+    /* As in end_update() */
+    if ((error= table->file->ha_index_init(0, 0)))
+    {
+      table->file->print_error(error, MYF(0));
+      return 1;
+    }
+    op->set_spill_func(end_unique_update);
+  }
+  else
+    table->s->uniques= 0;                       // As in end_write()
+  return is_duplicate ? -1 : 0;
+}
+
+
+/**
+  Group by looking up the group in the in-memory hash table of the
+  Hash_aggregator and updating it there.
+
+  With aggregate functions the group key is made and the group updated as
+  in end_update(), without them the group is the record as in end_write().
+  Rows of spilled partitions are aggregated in the tmp table. At the end
+  of the records the groups still in memory are written to the tmp table
+  in the order they were first seen.
+*/
+
+static enum_nested_loop_state
+end_hash_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records)
+{
+  TABLE *const table= join_tab->table;
+  TMP_TABLE_PARAM *const param= join_tab->tmp_table_param;
+  QEP_tmp_table *const op= (QEP_tmp_table*) join_tab->op;
+  Hash_aggregator *const hash_agg= op->hash_aggregator();
+  const bool update= param->sum_func_count != 0;
+  ORDER *group;
+  uchar *group_rec;
+  int error;
+  DBUG_ENTER("end_hash_update");
+
+  if (end_of_records)
+  {
+    for (group_rec= hash_agg->next_group(NULL); group_rec;
+         group_rec= hash_agg->next_group(group_rec))
+    {
+      memcpy(table->record[0], group_rec, table->s->reclength);
+      if (write_hash_group(join, join_tab, false))
+        DBUG_RETURN(NESTED_LOOP_ERROR);
+    }
+    hash_agg->reset();
+    DBUG_RETURN(NESTED_LOOP_OK);
+  }
+  if (join->thd->killed)			// Aborted by user
+  {
+    join->thd->send_kill_message();
+    DBUG_RETURN(NESTED_LOOP_KILLED);             /* purecov: inspected */
+  }
+
+  join->found_records++;
+  copy_fields(param);
+  if (update)
+  {
+    /* Make a key of group index */
+    for (group=table->group ; group ; group=group->next)
+    {
+      Item *item= *group->item;
+      item->save_org_in_field(group->field);
+      /* Store in the used key if the field was 0 */
+      if (item->maybe_null)
+        group->buff[-1]= (char) group->field->is_null();
+    }
+  }
+  else
+  {
+    if (copy_funcs(param->items_to_copy, join->thd))
+      DBUG_RETURN(NESTED_LOOP_ERROR);         /* purecov: inspected */
+    key_copy(param->group_buff, table->record[0], table->key_info, 0);
+  }
+
+  const ulonglong hash= hash_agg->hash_group_key();
+  if (hash_agg->is_spilled(Hash_aggregator::partition_of(hash)))
+  {
+    if (update)
+      DBUG_RETURN(op->get_spill_func() == end_update ?
+                  update_tmptable_group(join, join_tab) :
+                  end_unique_update(join, join_tab, false));
+    if ((error= write_hash_group(join, join_tab, true)) > 0)
+      DBUG_RETURN(NESTED_LOOP_ERROR);
+    if (!error)
+      join_tab->send_records++;
+    DBUG_RETURN(NESTED_LOOP_OK);
+  }
+
+  if ((group_rec= hash_agg->find_group(hash)))
+  {
+    if (update)
+    {
+      memcpy(table->record[0], group_rec, table->s->reclength);
+      update_tmptable_sum_func(join->sum_funcs, table);
+      memcpy(group_rec, table->record[0], table->s->reclength);
+    }
+    DBUG_RETURN(NESTED_LOOP_OK);
+  }
+
+  if (update)
+  {
+    /* A new group, made as in end_update() */
+    KEY_PART_INFO *key_part;
+    for (group=table->group,key_part=table->key_info[0].key_part;
+         group ;
+         group=group->next,key_part++)
+    {
+      if (key_part->null_bit)
+        memcpy(table->record[0]+key_part->offset, group->buff, 1);
+    }
+    init_tmptable_sum_functions(join->sum_funcs);
+    if (copy_funcs(param->items_to_copy, join->thd))
+      DBUG_RETURN(NESTED_LOOP_ERROR);         /* purecov: inspected */
+  }
+  if (!hash_agg->add_group(hash))
+    DBUG_RETURN(NESTED_LOOP_ERROR);
+  join_tab->send_records++;
+
+  /* Spill the largest partitions until the rest fits in memory */
+  while (hash_agg->is_full())
+  {
+    uint part= hash_agg->spill_candidate();
+    ulong pos= 0;
+    if (part == Hash_aggregator::PARTITIONS)
+      break;
+    while ((group_rec= hash_agg->next_group(part, &pos)))
+    {
+      memcpy(table->record[0], group_rec, table->s->reclength);
+      if (write_hash_group(join, join_tab, false))
+        DBUG_RETURN(NESTED_LOOP_ERROR);
+    }
+    hash_agg->spill(part);
+    status_var_increment(join->thd->status_var.hash_aggregation_spills);
+  }
+  DBUG_RETURN(NESTED_LOOP_OK);
+}
+
+
 	/* ARGSUSED */
 enum_nested_loop_state
 end_write_group(JOIN *join, JOIN_TAB *join_tab, bool end_of_records)
@@ -4300,6 +4527,18 @@ QEP_tmp_table::put_record(bool end_of_records)
 }
 
 
+/**
+  @brief Free the groups of an unfinished hash aggregation.
+*/
+
+void
+QEP_tmp_table::free()
+{
+  if (hash_agg)
+    hash_agg->reset();
+}
+
+
 /**
   @brief Finish rnd/index scan after accumulating records, switch ref_array,
          and send accumulated records further.
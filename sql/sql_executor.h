@@ -21,6 +21,7 @@
 #include "records.h"                          /* READ_RECORD */
 
 class JOIN;
+class Hash_aggregator;
 typedef struct st_join_table JOIN_TAB;
 typedef struct st_table_ref TABLE_REF;
 typedef struct st_position POSITION;
@@ -235,7 +236,7 @@ class QEP_tmp_table :public QEP_operation
 {
 public:
   QEP_tmp_table(JOIN_TAB *tab) : QEP_operation(tab),
-    write_func(NULL)
+    write_func(NULL), hash_agg(NULL), spill_func(NULL)
   {};
   enum_op_type type() { return OT_TMP_TABLE; }
   enum_nested_loop_state put_record() { return put_record(false); };
@@ -247,15 +248,37 @@ public:
     @return return one of enum_nested_loop_state values.
   */
   enum_nested_loop_state end_send();
+  void free();
   /** write_func setter */
   void set_write_func(Next_select_func new_write_func)
   {
     write_func= new_write_func;
   }
+  /**
+    Aggregate the groups in memory with hash_agg_arg. write_func is then
+    only used for the groups of spilled partitions.
+  */
+  void set_hash_aggregator(Hash_aggregator *hash_agg_arg,
+                           Next_select_func hash_write_func)
+  {
+    hash_agg= hash_agg_arg;
+    spill_func= write_func;
+    write_func= hash_write_func;
+  }
+  Hash_aggregator *hash_aggregator() const { return hash_agg; }
+  Next_select_func get_spill_func() const { return spill_func; }
+  void set_spill_func(Next_select_func new_spill_func)
+  {
+    spill_func= new_spill_func;
+  }
 
 private:
   /** Write function that would be used for saving records in tmp table. */
   Next_select_func write_func;
+  /** In-memory group aggregation, see end_hash_update(). */
+  Hash_aggregator *hash_agg;
+  /** Write function for the groups of spilled hash partitions. */
+  Next_select_func spill_func;
   enum_nested_loop_state put_record(bool end_of_records);
   bool prepare_tmp_table();
 };
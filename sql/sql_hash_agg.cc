@@ -0,0 +1,313 @@
+/* Copyright (c) 2013, Facebook, Inc. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include "sql_priv.h"
+#include "sql_class.h"
+#include "sql_hash_agg.h"
+#include "table.h"
+#include "field.h"
+
+#include <algorithm>
+
+using std::min;
+
+/** Initial number of slots of a partition's hash table. */
+static const ulong INITIAL_SLOTS= 64;
+/** Allocation block size of the partition MEM_ROOTs. */
+static const uint BLOCK_SIZE= 8192;
+
+
+Hash_aggregator::Hash_aggregator(TABLE *table, TMP_TABLE_PARAM *param)
+  : m_table(table), m_param(param), m_key_length(0), m_memory_used(0),
+    m_first_group(NULL), m_last_group(NULL)
+{
+  THD *thd= table->in_use;
+
+  for (ORDER *group= table->group; group; group= group->next)
+  {
+    uint end= (uint) ((uchar*) group->buff - param->group_buff) +
+      group->field->pack_length();
+    set_if_bigger(m_key_length, end);
+  }
+  m_record_offset= ALIGN_SIZE(sizeof(Group) + m_key_length);
+  m_entry_length= m_record_offset + ALIGN_SIZE(table->s->reclength);
+  /* The groups get as much memory as an in-memory temporary table */
+  m_max_memory= min(thd->variables.tmp_table_size,
+                    thd->variables.max_heap_table_size);
+
+  for (uint i= 0; i < PARTITIONS; i++)
+  {
+    Partition *part= &m_partitions[i];
+    init_sql_alloc(&part->mem_root, BLOCK_SIZE, 0);
+    part->slots= NULL;
+    part->slot_count= 0;
+    part->group_count= 0;
+    part->memory_used= 0;
+    part->spilled= false;
+  }
+}
+
+
+/**
+  Check if the groups of a grouping temporary table can be aggregated in
+  memory: the table must have a group key and no BLOB columns, whose
+  values are not stored in the record.
+*/
+
+bool Hash_aggregator::is_applicable(TABLE *table)
+{
+  if (!table->group || !table->s->keys || table->s->uniques ||
+      table->s->blob_fields)
+    return false;
+  for (ORDER *group= table->group; group; group= group->next)
+  {
+    if (!group->field || !group->buff)
+      return false;
+  }
+  return true;
+}
+
+
+ulonglong Hash_aggregator::hash_group_key() const
+{
+  ulong nr1= 1, nr2= 4;
+
+  for (ORDER *group= m_table->group; group; group= group->next)
+  {
+    Field *field= group->field;
+    if ((*group->item)->maybe_null && group->buff[-1])
+      nr1^= (nr1 << 1) | 1;
+    else if (field->result_type() == REAL_RESULT)
+    {
+      /* -0.0 and 0.0 are the same group */
+      double nr= field->val_real();
+      uchar buff[sizeof(double)];
+      if (nr == 0.0)
+        nr= 0.0;
+      float8store(buff, nr);
+      my_charset_bin.coll->hash_sort(&my_charset_bin, buff, sizeof(buff),
+                                     &nr1, &nr2);
+    }
+    else
+      field->hash(&nr1, &nr2);
+  }
+
+  /*
+    hash_sort() leaves the high bits, which select the partition, poorly
+    mixed for short keys. Finish with the MurmurHash3 finalizer.
+  */
+  ulonglong hash= nr1;
+  hash^= hash >> 33;
+  hash*= ULL(0xff51afd7ed558ccd);
+  hash^= hash >> 33;
+  hash*= ULL(0xc4ceb9fe1a85ec53);
+  hash^= hash >> 33;
+  return hash;
+}
+
+
+/**
+  Compare a group key image with the key in TMP_TABLE_PARAM::group_buff,
+  using the collations of the group columns.
+*/
+
+bool Hash_aggregator::key_equals(const uchar *key) const
+{
+  const uchar *group_buff= m_param->group_buff;
+
+  for (ORDER *group= m_table->group; group; group= group->next)
+  {
+    uint offset= (uint) ((uchar*) group->buff - group_buff);
+    if ((*group->item)->maybe_null)
+    {
+      if (key[offset - 1] != group_buff[offset - 1])
+        return false;
+      if (key[offset - 1])
+        continue;                               // Both are NULL
+    }
+    if (group->field->cmp(key + offset, group_buff + offset))
+      return false;
+  }
+  return true;
+}
+
+
+uchar *Hash_aggregator::find_group(ulonglong hash) const
+{
+  const Partition *part= &m_partitions[partition_of(hash)];
+  DBUG_ASSERT(!part->spilled);
+
+  if (!part->slot_count)
+    return NULL;
+  ulong mask= part->slot_count - 1;
+  for (ulong i= (ulong) hash & mask; part->slots[i]; i= (i + 1) & mask)
+  {
+    Group *group= part->slots[i];
+    if (group->hash == hash && key_equals(group_key(group)))
+      return group_record(group);
+  }
+  return NULL;
+}
+
+
+/**
+  Double the size of the hash table of a partition. The old slots stay in
+  the MEM_ROOT until the partition is freed.
+
+  @retval false  OK
+  @retval true   Out of memory
+*/
+
+bool Hash_aggregator::grow(Partition *part)
+{
+  ulong slot_count= part->slot_count ? part->slot_count * 2 : INITIAL_SLOTS;
+  ulong mask= slot_count - 1;
+  Group **slots;
+
+  if (!(slots= (Group**) alloc_root(&part->mem_root,
+                                    slot_count * sizeof(Group*))))
+    return true;
+  memset(slots, 0, slot_count * sizeof(Group*));
+  for (ulong i= 0; i < part->slot_count; i++)
+  {
+    Group *group= part->slots[i];
+    if (!group)
+      continue;
+    ulong j= (ulong) group->hash & mask;
+    while (slots[j])
+      j= (j + 1) & mask;
+    slots[j]= group;
+  }
+  part->slots= slots;
+  part->slot_count= slot_count;
+  part->memory_used+= slot_count * sizeof(Group*);
+  m_memory_used+= slot_count * sizeof(Group*);
+  return false;
+}
+
+
+uchar *Hash_aggregator::add_group(ulonglong hash)
+{
+  Partition *part= &m_partitions[partition_of(hash)];
+  Group *group;
+  DBUG_ASSERT(!part->spilled);
+
+  /* Keep the load factor at or below 1/2 */
+  if ((part->group_count + 1) * 2 > part->slot_count && grow(part))
+    return NULL;
+  if (!(group= (Group*) alloc_root(&part->mem_root, m_entry_length)))
+    return NULL;
+  group->hash= hash;
+  memcpy(group_key(group), m_param->group_buff, m_key_length);
+  memcpy(group_record(group), m_table->record[0], m_table->s->reclength);
+
+  ulong mask= part->slot_count - 1;
+  ulong i= (ulong) hash & mask;
+  while (part->slots[i])
+    i= (i + 1) & mask;
+  part->slots[i]= group;
+  part->group_count++;
+  part->memory_used+= m_entry_length;
+  m_memory_used+= m_entry_length;
+
+  group->prev= m_last_group;
+  group->next= NULL;
+  if (m_last_group)
+    m_last_group->next= group;
+  else
+    m_first_group= group;
+  m_last_group= group;
+  return group_record(group);
+}
+
+
+uint Hash_aggregator::spill_candidate() const
+{
+  uint candidate= PARTITIONS;
+
+  for (uint i= 0; i < PARTITIONS; i++)
+  {
+    const Partition *part= &m_partitions[i];
+    if (!part->spilled &&
+        (candidate == PARTITIONS ||
+         part->group_count > m_partitions[candidate].group_count))
+      candidate= i;
+  }
+  return candidate;
+}
+
+
+void Hash_aggregator::free_partition(Partition *part)
+{
+  for (ulong i= 0; i < part->slot_count; i++)
+  {
+    Group *group= part->slots[i];
+    if (!group)
+      continue;
+    if (group->prev)
+      group->prev->next= group->next;
+    else
+      m_first_group= group->next;
+    if (group->next)
+      group->next->prev= group->prev;
+    else
+      m_last_group= group->prev;
+  }
+  free_root(&part->mem_root, MYF(0));
+  m_memory_used-= part->memory_used;
+  part->slots= NULL;
+  part->slot_count= 0;
+  part->group_count= 0;
+  part->memory_used= 0;
+}
+
+
+void Hash_aggregator::spill(uint part)
+{
+  free_partition(&m_partitions[part]);
+  m_partitions[part].spilled= true;
+}
+
+
+uchar *Hash_aggregator::next_group(uint part, ulong *pos) const
+{
+  const Partition *partition= &m_partitions[part];
+
+  while (*pos < partition->slot_count)
+  {
+    Group *group= partition->slots[(*pos)++];
+    if (group)
+      return group_record(group);
+  }
+  return NULL;
+}
+
+
+uchar *Hash_aggregator::next_group(uchar *record) const
+{
+  Group *group= record ? record_group(record)->next : m_first_group;
+  return group ? group_record(group) : NULL;
+}
+
+
+void Hash_aggregator::reset()
+{
+  for (uint i= 0; i < PARTITIONS; i++)
+  {
+    free_partition(&m_partitions[i]);
+    m_partitions[i].spilled= false;
+  }
+  DBUG_ASSERT(m_memory_used == 0 && !m_first_group && !m_last_group);
+}
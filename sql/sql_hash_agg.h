@@ -0,0 +1,167 @@
+#ifndef SQL_HASH_AGG_INCLUDED
+#define SQL_HASH_AGG_INCLUDED
+
+/* Copyright (c) 2013, Facebook, Inc. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/**
+  @file
+
+  @brief
+  In-memory hash aggregation for GROUP BY.
+
+  When no index provides the GROUP BY order, the groups are collected in a
+  temporary table with a unique key on the group columns: every row is
+  looked up in the table and either updates the aggregate values of its
+  group or is written as a new group. With optimizer_switch
+  hash_aggregation=on the groups and their Item_sum accumulators are kept
+  in an in-memory open addressing hash table instead, and every group is
+  written to the temporary table once, after all rows were aggregated.
+
+  The hash table is split into partitions by the hash of the group key,
+  each with its own MEM_ROOT. When the groups outgrow
+  min(tmp_table_size, max_heap_table_size), the largest partition is
+  spilled: its groups are written to the temporary table and the rest of
+  its rows are aggregated there, as without hash aggregation. The
+  temporary table is converted to MyISAM as usual when it gets full.
+
+  The groups in memory are written to the temporary table in the order
+  they were first seen, so that without ORDER BY the result comes in the
+  same order as without hash aggregation.
+
+  Hash_aggregator only manages the groups in memory; the temporary table
+  is written by end_hash_update() in sql_executor.cc.
+*/
+
+#include "my_global.h"
+#include "my_sys.h"                             // MEM_ROOT
+#include "sql_alloc.h"
+
+struct TABLE;
+class TMP_TABLE_PARAM;
+
+class Hash_aggregator : public Sql_alloc
+{
+public:
+  /** Number of partitions, must be a power of 2. */
+  static const uint PARTITIONS= 16;
+
+  Hash_aggregator(TABLE *table, TMP_TABLE_PARAM *param);
+
+  static bool is_applicable(TABLE *table);
+
+  /** Hash of the group key in TMP_TABLE_PARAM::group_buff. */
+  ulonglong hash_group_key() const;
+
+  static uint partition_of(ulonglong hash)
+  { return (uint) (hash >> 60) & (PARTITIONS - 1); }
+  bool is_spilled(uint part) const { return m_partitions[part].spilled; }
+
+  /**
+    Find the group with the key in TMP_TABLE_PARAM::group_buff.
+
+    @return the record of the group, NULL if there is none
+  */
+  uchar *find_group(ulonglong hash) const;
+  /**
+    Add a group with the key in TMP_TABLE_PARAM::group_buff and the
+    record in TABLE::record[0].
+
+    @return the record of the new group, NULL if out of memory
+  */
+  uchar *add_group(ulonglong hash);
+
+  /** true if the groups in memory exceed the memory limit */
+  bool is_full() const { return m_memory_used > m_max_memory; }
+  /**
+    The partition to spill next: the one with the most groups in memory.
+
+    @return partition number, PARTITIONS if all partitions are spilled
+  */
+  uint spill_candidate() const;
+  /** Free the groups of the partition and direct its rows to the table. */
+  void spill(uint part);
+
+  /**
+    Iterate over the groups of a partition.
+
+    @param part     partition
+    @param[in,out]  pos  iterator position, 0 to start
+
+    @return the record of the next group, NULL at the end
+  */
+  uchar *next_group(uint part, ulong *pos) const;
+  /**
+    Iterate over all groups in memory in the order they were added.
+
+    @param record  the record of the previous group, NULL to start
+
+    @return the record of the next group, NULL at the end
+  */
+  uchar *next_group(uchar *record) const;
+
+  /** Free all groups and start over with no partitions spilled. */
+  void reset();
+
+private:
+  /**
+    Header of a group entry. It is followed by the group key image and
+    the record of the group, the latter aligned at m_record_offset.
+  */
+  struct Group
+  {
+    ulonglong hash;
+    /** Groups in memory in the order they were added */
+    Group *prev, *next;
+  };
+
+  struct Partition
+  {
+    MEM_ROOT mem_root;
+    /** Open addressing hash table of the groups. */
+    Group **slots;
+    /** Size of slots, 0 or a power of 2. */
+    ulong slot_count;
+    ulong group_count;
+    /** Bytes allocated for slots and group entries. */
+    ulonglong memory_used;
+    bool spilled;
+  };
+
+  uchar *group_key(Group *group) const
+  { return (uchar*) group + sizeof(Group); }
+  uchar *group_record(Group *group) const
+  { return (uchar*) group + m_record_offset; }
+  Group *record_group(uchar *record) const
+  { return (Group*) (record - m_record_offset); }
+
+  bool key_equals(const uchar *key) const;
+  bool grow(Partition *part);
+  void free_partition(Partition *part);
+
+  TABLE *m_table;
+  TMP_TABLE_PARAM *m_param;
+  /** Length of the group key image in TMP_TABLE_PARAM::group_buff. */
+  uint m_key_length;
+  uint m_record_offset;
+  uint m_entry_length;
+  ulonglong m_memory_used;
+  ulonglong m_max_memory;
+  Group *m_first_group;
+  Group *m_last_group;
+  Partition m_partitions[PARTITIONS];
+};
+
+#endif /* SQL_HASH_AGG_INCLUDED */
@@ -2932,6 +2932,49 @@ bool LEX::can_be_merged()
 }
 
 
+/**
+  Check whether the query expression of a derived table can be merged into
+  the outer query.
+
+  @details
+    The same restrictions as in LEX::can_be_merged() apply: the unit must
+    be a single SELECT over at least one table, without grouping, aggregate
+    functions, DISTINCT, HAVING or LIMIT, and with subqueries only in WHERE
+    and ON clauses. Derived tables of the SELECT itself are allowed. ORDER
+    BY is refused too, as it cannot be moved into the outer query.
+
+  @retval true   merge algorithm can be used
+  @retval false  the derived table must be materialized
+*/
+
+bool st_select_lex_unit::is_mergeable()
+{
+  SELECT_LEX *const select= first_select();
+
+  if (select->next_select())
+    return false;
+
+  for (SELECT_LEX_UNIT *unit= select->first_inner_unit();
+       unit;
+       unit= unit->next_unit())
+  {
+    if (unit->item != NULL &&
+        unit->item->place() != IN_WHERE &&
+        unit->item->place() != IN_ON)
+      return false;
+  }
+
+  return (select->group_list.elements == 0 &&
+          select->having == NULL &&
+          select->with_sum_func == 0 &&
+          select->table_list.elements >= 1 &&
+          !(select->options & SELECT_DISTINCT) &&
+          select->select_limit == NULL &&
+          select->offset_limit == NULL &&
+          select->order_list.elements == 0);
+}
+
+
 /*
   check if command can use VIEW with MERGE algorithm (for top VIEWs)
 
@@ -526,6 +526,7 @@ public:
   friend bool mysql_new_select(LEX *lex, bool move_down);
   friend bool mysql_make_view(THD *thd, TABLE_SHARE *share, TABLE_LIST *table,
                               bool open_view_no_parse);
+  friend bool mysql_derived_merge(THD *thd, LEX *lex, TABLE_LIST *derived);
 private:
   void fast_exclude();
 };
@@ -645,6 +646,7 @@ public:
   void set_limit(st_select_lex *values);
   void set_thd(THD *thd_arg) { thd= thd_arg; }
   inline bool is_union (); 
+  bool is_mergeable();
 
   friend void lex_start(THD *thd);
   friend bool subselect_union_engine::exec();
@@ -39,6 +39,7 @@
 #include "lock.h"
 #include "abstract_query_plan.h"
 #include "opt_explain_format.h"  // Explain_format_flags
+#include "histogram.h"            // load_histograms
 
 #include <algorithm>
 using std::max;
@@ -3611,6 +3612,8 @@ const_table_extraction_done:
         s->found_records= s->records= s->read_time=1; s->worst_seeks= 1.0;
         continue;
       }
+      load_histograms(thd, s->table);
+
       /* Approximate found rows and time to read them */
       s->found_records= s->records= s->table->file->stats.records;
       s->read_time= (ha_rows) s->table->file->scan_time();
@@ -3704,6 +3707,28 @@ const_table_extraction_done:
         Opt_trace_object(trace, "table_scan").
           add("rows", s->found_records).
           add("cost", s->read_time);
+
+      /*
+        Reduce the estimate of rows satisfying the WHERE condition with
+        the histograms of non-indexed columns, which the range optimizer
+        cannot estimate. Tables on the inner side of outer joins and
+        semi-joins are filtered by other conditions and left alone.
+      */
+      if (conds && !tl->embedding && s->type != JT_CONST)
+      {
+        const double selectivity= histogram_cond_selectivity(s->table, conds);
+        if (selectivity < 1.0)
+        {
+          const ha_rows rows=
+            max<ha_rows>(1, (ha_rows) (s->table->quick_condition_rows *
+                                       selectivity));
+          s->table->quick_condition_rows=
+            min(s->table->quick_condition_rows, rows);
+          Opt_trace_object(trace, "histogram_filtering").
+            add("selectivity", selectivity).
+            add("rows", s->table->quick_condition_rows);
+        }
+      }
     }
   }
 
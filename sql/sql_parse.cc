@@ -63,6 +63,7 @@
                               // sp_grant_privileges, ...
 #include "sql_test.h"         // mysql_print_status
 #include "sql_select.h"       // handle_select, mysql_select,
+#include "sql_point_select.h" // execute_point_select
 #include "sql_load.h"         // mysql_load
 #include "sql_servers.h"      // create_servers, alter_servers,
                               // drop_servers, servers_reload
@@ -5531,7 +5532,18 @@ static bool execute_sqlcom_select(THD *thd, TABLE_LIST *all_tables,
                new select_analyse(result, lex->proc_analyse)) == NULL)
           return true;
       }
-      res= handle_select(thd, result, 0);
+      switch (execute_point_select(thd, result)) {
+      case POINT_SELECT_NOT_APPLICABLE:
+        res= handle_select(thd, result, 0);
+        break;
+      case POINT_SELECT_DONE:
+        res= thd->is_error();
+        break;
+      case POINT_SELECT_ERROR:
+        res= true;
+        result->abort_result_set();
+        break;
+      }
       delete analyse_result;
       if (save_result != lex->result)
         delete save_result;
@@ -0,0 +1,392 @@
+/* Copyright (c) 2013, Facebook, Inc. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/**
+  @file
+
+  @brief
+  Fast path executor for single-table unique key point SELECTs.
+
+  The recognizer works on the parse tree, before any name resolution is
+  done, so that a statement which turns out not to qualify can still be
+  handed to the normal JOIN executor untouched. Once a statement is
+  accepted, name resolution and privilege checking are done with the same
+  setup_*() functions JOIN::prepare() uses, so that access errors and
+  warnings are identical to the normal path. The WHERE clause is evaluated
+  on the fetched row, so the index lookup only needs to be a superset of
+  the matching rows.
+*/
+
+#include "sql_priv.h"
+#include "sql_class.h"
+#include "sql_point_select.h"
+#include "sql_base.h"                           // setup_tables_and_check_access
+#include "sql_acl.h"                            // SELECT_ACL
+#include "sql_select.h"
+#include "sql_executor.h"                       // report_handler_error
+#include "sql_cache.h"                          // query_cache_store_query
+#include "key.h"                                // key_copy
+
+/** Maximum number of equalities the recognizer looks at. */
+static const uint MAX_POINT_SELECT_EQUALITIES= MAX_REF_PARTS;
+
+struct Point_select_equality
+{
+  Field *field;
+  Item *value;
+};
+
+
+/**
+  Check the statement-level conditions for the fast path: a single
+  non-union SELECT over one base table, without grouping, ordering,
+  subqueries, stored routines or a result redirection.
+*/
+
+static bool is_point_select_statement(THD *thd)
+{
+  LEX *lex= thd->lex;
+  SELECT_LEX *select_lex= &lex->select_lex;
+  TABLE_LIST *tables= lex->query_tables;
+
+  if (lex->sql_command != SQLCOM_SELECT ||
+      lex->describe ||
+      lex->result ||
+      lex->proc_analyse ||
+      lex->uses_stored_routines() ||
+      !thd->stmt_arena->is_conventional() ||
+      thd->in_sub_stmt ||
+      thd->opt_trace.is_started())
+    return false;
+
+  if (lex->unit.is_union() || lex->unit.fake_select_lex ||
+      select_lex->first_inner_unit() ||
+      select_lex->with_sum_func ||
+      select_lex->group_list.elements ||
+      select_lex->order_list.elements ||
+      select_lex->having ||
+      select_lex->olap != UNSPECIFIED_OLAP_TYPE ||
+      select_lex->ftfunc_list->elements ||
+      select_lex->where == NULL)
+    return false;
+
+  /* LIMIT 0 or SQL_SELECT_LIMIT=0 must return an empty result. */
+  if (lex->unit.global_parameters->explicit_limit ||
+      thd->variables.select_limit == 0)
+    return false;
+
+  if (tables == NULL || tables->next_global ||
+      select_lex->table_list.elements != 1 ||
+      tables->is_view_or_derived() ||
+      tables->schema_table ||
+      tables->index_hints ||
+      tables->table == NULL)
+    return false;
+
+#ifdef WITH_PARTITION_STORAGE_ENGINE
+  /* Let the optimizer prune and lock only the needed partitions. */
+  if (tables->table->part_info)
+    return false;
+#endif
+
+  return true;
+}
+
+
+/**
+  Check that a constant can be compared with the column through the
+  index without changing the comparison semantics. Only integer columns
+  compared with integers and character columns compared with strings are
+  accepted; all other combinations are compared as DOUBLE or DECIMAL by
+  Item_func_eq.
+*/
+
+static bool point_select_types_match(Field *field, Item *value)
+{
+  switch (field->real_type()) {
+  case MYSQL_TYPE_TINY:
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_LONGLONG:
+    return value->result_type() == INT_RESULT;
+  case MYSQL_TYPE_VARCHAR:
+  case MYSQL_TYPE_STRING:
+  case MYSQL_TYPE_VAR_STRING:
+    return value->result_type() == STRING_RESULT;
+  default:
+    return false;
+  }
+}
+
+
+/**
+  Record one "column = constant" conjunct of the unresolved WHERE clause.
+
+  @return false if the conjunct has any other form.
+*/
+
+static bool add_point_select_equality(Item *item, TABLE *table,
+                                      Point_select_equality *eqs,
+                                      uint *count)
+{
+  if (item->type() != Item::FUNC_ITEM ||
+      ((Item_func *) item)->functype() != Item_func::EQ_FUNC ||
+      *count == MAX_POINT_SELECT_EQUALITIES)
+    return false;
+
+  Item **args= ((Item_func *) item)->arguments();
+  Item *column= args[0];
+  Item *value= args[1];
+  if (column->type() != Item::FIELD_ITEM)
+    std::swap(column, value);
+  if (column->type() != Item::FIELD_ITEM ||
+      !value->basic_const_item() ||
+      value->type() == Item::NULL_ITEM)
+    return false;
+
+  Field *field= find_field_in_table_sef(table,
+                                        ((Item_field *) column)->field_name);
+  if (field == NULL)
+    return false;
+
+  eqs[*count].field= field;
+  eqs[*count].value= value;
+  (*count)++;
+  return true;
+}
+
+
+/**
+  Split the unresolved WHERE clause into "column = constant" conjuncts.
+
+  @return number of equalities found, or 0 if the condition has any other
+          form.
+*/
+
+static uint collect_point_select_equalities(Item *cond, TABLE *table,
+                                            Point_select_equality *eqs)
+{
+  uint count= 0;
+
+  if (cond->type() == Item::COND_ITEM &&
+      ((Item_cond *) cond)->functype() == Item_func::COND_AND_FUNC)
+  {
+    List_iterator<Item> li(*((Item_cond *) cond)->argument_list());
+    Item *item;
+    while ((item= li++))
+    {
+      if (!add_point_select_equality(item, table, eqs, &count))
+        return 0;
+    }
+  }
+  else if (!add_point_select_equality(cond, table, eqs, &count))
+    return 0;
+
+  return count;
+}
+
+
+/**
+  Find a unique index all of whose parts are bound by the equalities and
+  build the lookup key for it.
+
+  @param      thd      Thread handler
+  @param      table    Table to read from
+  @param      eqs      Equalities found in the WHERE clause
+  @param      n_eqs    Number of equalities
+  @param[out] key_buff Lookup key in index format
+
+  @return index number, or MAX_KEY if no index can be used.
+*/
+
+static uint find_point_select_key(THD *thd, TABLE *table,
+                                  Point_select_equality *eqs, uint n_eqs,
+                                  uchar **key_buff)
+{
+  for (uint keyno= 0; keyno < table->s->keys; keyno++)
+  {
+    KEY *key_info= table->key_info + keyno;
+    Item *values[MAX_REF_PARTS];
+
+    if (!(key_info->flags & HA_NOSAME) ||
+        (key_info->flags & (HA_FULLTEXT | HA_SPATIAL)) ||
+        !table->s->keys_in_use.is_set(keyno))
+      continue;
+
+    bool usable= true;
+    for (uint part= 0; usable && part < key_info->user_defined_key_parts;
+         part++)
+    {
+      KEY_PART_INFO *key_part= key_info->key_part + part;
+      values[part]= NULL;
+      if (key_part->key_part_flag & HA_PART_KEY_SEG)
+      {
+        usable= false;
+        break;
+      }
+      for (uint i= 0; i < n_eqs; i++)
+      {
+        if (eqs[i].field->field_index == key_part->field->field_index &&
+            point_select_types_match(eqs[i].field, eqs[i].value))
+        {
+          values[part]= eqs[i].value;
+          break;
+        }
+      }
+      usable= values[part] != NULL;
+    }
+    if (!usable)
+      continue;
+
+    /*
+      Store the constants into the record buffer. Any truncation or
+      conversion means the constant is not representable in the column
+      and the comparison is left to the normal executor.
+    */
+    for (uint part= 0; part < key_info->user_defined_key_parts; part++)
+    {
+      Field *field= key_info->key_part[part].field;
+      if (values[part]->save_in_field_no_warnings(field, true) != TYPE_OK ||
+          field->is_null())
+        return MAX_KEY;
+    }
+
+    if (!(*key_buff= (uchar *) thd->alloc(key_info->key_length)))
+      return MAX_KEY;
+    key_copy(*key_buff, table->record[0], key_info, key_info->key_length);
+    return keyno;
+  }
+  return MAX_KEY;
+}
+
+
+/**
+  Execute a SELECT through a single unique index lookup if possible.
+
+  Must be called after the tables of the statement are opened and table
+  level privileges are checked, in place of handle_select().
+
+  @param thd    Thread handler
+  @param result Where to send the result row
+
+  @return POINT_SELECT_NOT_APPLICABLE if the statement must go through the
+          normal executor, POINT_SELECT_DONE or POINT_SELECT_ERROR otherwise.
+*/
+
+enum_point_select_status execute_point_select(THD *thd, select_result *result)
+{
+  LEX *lex= thd->lex;
+  SELECT_LEX *select_lex= &lex->select_lex;
+  Point_select_equality eqs[MAX_POINT_SELECT_EQUALITIES];
+  uchar *key_buff= NULL;
+  DBUG_ENTER("execute_point_select");
+
+  if (!thd->variables.select_point_fast_path ||
+      !is_point_select_statement(thd))
+    DBUG_RETURN(POINT_SELECT_NOT_APPLICABLE);
+
+  TABLE_LIST *tables= lex->query_tables;
+  TABLE *table= tables->table;
+  uint n_eqs= collect_point_select_equalities(select_lex->where, table, eqs);
+  if (n_eqs == 0)
+    DBUG_RETURN(POINT_SELECT_NOT_APPLICABLE);
+
+  const uint keyno= find_point_select_key(thd, table, eqs, n_eqs, &key_buff);
+  if (keyno == MAX_KEY)
+    DBUG_RETURN(POINT_SELECT_NOT_APPLICABLE);
+
+  DBUG_PRINT("info", ("point select on key %u", keyno));
+
+  /* From here on the statement is committed to the fast path. */
+  List<Item> &fields= select_lex->item_list;
+  Item *conds= select_lex->where;
+
+  THD_STAGE_INFO(thd, stage_init);
+  lex->current_select= select_lex;
+  lex->used_tables= 0;
+  select_lex->context.resolve_in_select_list= TRUE;
+  select_lex->is_item_list_lookup= 1;
+
+  if (setup_tables_and_check_access(thd, &select_lex->context,
+                                    &select_lex->top_join_list,
+                                    tables, &select_lex->leaf_tables,
+                                    FALSE, SELECT_ACL, SELECT_ACL) ||
+      setup_wild(thd, tables, fields, NULL, select_lex->with_wild) ||
+      setup_fields(thd, Ref_ptr_array(), fields, MARK_COLUMNS_READ,
+                   NULL, false) ||
+      setup_conds(thd, tables, select_lex->leaf_tables, &conds) ||
+      thd->is_error())
+    DBUG_RETURN(POINT_SELECT_ERROR);
+  select_lex->where= conds;
+
+  if (!lex->is_query_tables_locked())
+  {
+    if (lock_tables(thd, lex->query_tables, lex->table_count, 0))
+      DBUG_RETURN(POINT_SELECT_ERROR);
+    query_cache_store_query(thd, lex->query_tables);
+  }
+
+  if (result->prepare(fields, &lex->unit) || result->prepare2())
+    DBUG_RETURN(POINT_SELECT_ERROR);
+
+  THD_STAGE_INFO(thd, stage_executing);
+
+  int error;
+  if ((error= table->file->ha_index_init(keyno, false)))
+  {
+    table->file->print_error(error, MYF(0));
+    DBUG_RETURN(POINT_SELECT_ERROR);
+  }
+
+  bool found= false;
+  ha_rows examined_rows= 0;
+  const key_part_map keypart_map=
+    make_prev_keypart_map(table->key_info[keyno].user_defined_key_parts);
+  error= table->file->ha_index_read_map(table->record[0], key_buff,
+                                        keypart_map, HA_READ_KEY_EXACT);
+  if (error)
+  {
+    if (report_handler_error(table, error) > 0)
+      goto err;
+  }
+  else
+  {
+    table->status= 0;
+    examined_rows= 1;
+    found= conds->val_int() != 0;
+    if (thd->is_error())
+      goto err;
+  }
+
+  THD_STAGE_INFO(thd, stage_sending_data);
+  if (result->send_result_set_metadata(fields, Protocol::SEND_NUM_ROWS |
+                                               Protocol::SEND_EOF) ||
+      (found && result->send_data(fields)) ||
+      result->send_eof())
+    goto err;
+
+  table->file->ha_index_end();
+
+  thd->limit_found_rows= thd->get_sent_row_count();
+  thd->inc_examined_row_count(examined_rows);
+  thd->status_var.rows_examined+= examined_rows;
+  status_var_increment(thd->status_var.select_point_fast_path_count);
+  DBUG_RETURN(POINT_SELECT_DONE);
+
+err:
+  table->file->ha_index_end();
+  DBUG_RETURN(POINT_SELECT_ERROR);
+}
@@ -0,0 +1,49 @@
+#ifndef SQL_POINT_SELECT_INCLUDED
+#define SQL_POINT_SELECT_INCLUDED
+
+/* Copyright (c) 2013, Facebook, Inc. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/**
+  @file
+
+  @brief
+  Fast path executor for single-table unique key point SELECTs.
+
+  A statement of the form
+
+    SELECT <select list> FROM t WHERE key_col1 = const [AND key_col2 = const]
+
+  where the equalities bind every part of a unique index of t is answered
+  with a single handler index lookup, without constructing a JOIN.
+*/
+
+class THD;
+class select_result;
+
+enum enum_point_select_status
+{
+  /** The statement is not a point select, use the normal executor. */
+  POINT_SELECT_NOT_APPLICABLE= 0,
+  /** The statement was executed by the fast path. */
+  POINT_SELECT_DONE,
+  /** The fast path was taken and failed, error is set in the THD. */
+  POINT_SELECT_ERROR
+};
+
+enum_point_select_status execute_point_select(THD *thd,
+                                              select_result *result);
+
+#endif /* SQL_POINT_SELECT_INCLUDED */
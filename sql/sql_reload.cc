@@ -27,6 +27,7 @@
 #include "rpl_slave.h"   // reset_slave
 #include "rpl_rli.h"     // rotate_relay_log
 #include "rpl_mi.h"
+#include "rpl_apply_stats.h" // reset_slave_apply_stats
 #include "debug_sync.h"
 
 
@@ -340,6 +341,7 @@ bool reload_acl_and_cache(THD *thd, unsigned long options,
   {
     reset_global_table_stats();
     reset_global_db_stats();
+    reset_slave_apply_stats();
 #ifndef EMBEDDED_LIBRARY
     reset_global_user_stats();
 #endif
@@ -28,6 +28,7 @@
 #include "sql_base.h"   // tdc_remove_table, lock_table_names,
 #include "sql_handler.h"                        // mysql_ha_rm_tables
 #include "datadict.h"
+#include "histogram.h"                          // rename_table_histograms
 
 static TABLE_LIST *rename_tables(THD *thd, TABLE_LIST *table_list,
 				 bool skip_error);
@@ -294,6 +295,10 @@ do_rename(THD *thd, TABLE_LIST *ren_table, char *new_db, char *new_table_name,
                                       new_db, new_alias,
                                       ren_table->db, old_alias, 0);
           }
+          else
+            rename_table_histograms(thd, ren_table->db,
+                                    ren_table->table_name,
+                                    new_db, new_table_name);
         }
       }
       break;
@@ -787,6 +787,8 @@ void JOIN::reset()
       tmp_table->file->ha_delete_all_rows();
       free_io_cache(tmp_table);
       filesort_free_buffers(tmp_table,0);
+      /* Discard the groups of an unfinished hash aggregation */
+      join_tab[tmp].op->free();
     }
   }
   clear_sj_tmp_tables(this);
@@ -5030,6 +5032,8 @@ bool JOIN::make_tmp_tables_info()
     join_tab[curr_tmp_table].all_fields= &tmp_all_fields1;
     join_tab[curr_tmp_table].fields= &tmp_fields_list1;
     setup_tmptable_write_func(&join_tab[curr_tmp_table]);
+    if (((QEP_tmp_table *) join_tab[curr_tmp_table].op)->hash_aggregator())
+      explain_flags.set(tmp_group.src, ESP_USING_HASH_AGG);
  
     tmp_table_param.func_count= 0;
     tmp_table_param.field_count+= tmp_table_param.func_count;
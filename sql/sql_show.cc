@@ -56,6 +56,7 @@
 #include "sql_tmp_table.h" // Tmp tables
 #include "sql_optimizer.h" // JOIN
 #include "global_threads.h"
+#include "rpl_apply_stats.h" // Slave apply latency and worker statistics
 
 #include <algorithm>
 using std::max;
@@ -8057,6 +8058,10 @@ ST_SCHEMA_TABLE schema_tables[]=
    fill_status, make_old_format, 0, 0, -1, 0, 0},
   {"SESSION_VARIABLES", variables_fields_info, create_schema_table,
    fill_variables, make_old_format, 0, 0, -1, 0, 0},
+  {"SLAVE_APPLY_LATENCY", slave_apply_latency_fields_info,
+   create_schema_table, fill_slave_apply_latency, NULL, NULL, -1, -1, false, 0},
+  {"SLAVE_WORKER_STATISTICS", slave_worker_stats_fields_info,
+   create_schema_table, fill_slave_worker_stats, NULL, NULL, -1, -1, false, 0},
   {"STATISTICS", stat_fields_info, create_schema_table, 
    get_all_tables, make_old_format, get_schema_stat_record, 1, 2, 0,
    OPEN_TABLE_ONLY|OPTIMIZE_I_S_TABLE},
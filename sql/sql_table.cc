@@ -55,6 +55,7 @@
 #include "datadict.h"  // dd_frm_type()
 #include "sql_resolver.h"              // setup_order, fix_inner_refs
 #include "table_cache.h"
+#include "histogram.h"                 // drop_table_histograms
 #include <mysql/psi/mysql_table.h>
 
 #ifdef __WIN__
@@ -2481,6 +2482,7 @@ int mysql_rm_table_no_locks(THD *thd, TABLE_LIST *tables, bool if_exists,
           non_tmp_table_deleted= TRUE;
           new_error= Table_triggers_list::drop_all_triggers(thd, db,
                                                             table->table_name);
+          drop_table_histograms(thd, db, table->table_name);
         }
         error|= new_error;
       }
@@ -6642,6 +6644,8 @@ static bool mysql_inplace_alter_table(THD *thd,
                                 alter_ctx->db, alter_ctx->alias, 0);
       DBUG_RETURN(true);
     }
+    rename_table_histograms(thd, alter_ctx->db, alter_ctx->table_name,
+                            alter_ctx->new_db, alter_ctx->new_name);
   }
 
   DBUG_RETURN(false);
@@ -7627,6 +7631,9 @@ simple_rename_or_index_change(THD *thd, TABLE_LIST *table_list,
                                 alter_ctx->db, alter_ctx->table_name, 0);
       error= -1;
     }
+    else
+      rename_table_histograms(thd, alter_ctx->db, alter_ctx->table_name,
+                              alter_ctx->new_db, alter_ctx->new_name);
   }
 
   if (!error)
@@ -8674,6 +8681,9 @@ bool mysql_alter_table(THD *thd,char *new_db, char *new_name,
                               alter_ctx.db, alter_ctx.alias, FN_FROM_IS_TMP);
     goto err_with_mdl;
   }
+  if (alter_ctx.is_table_renamed())
+    rename_table_histograms(thd, alter_ctx.db, alter_ctx.table_name,
+                            alter_ctx.new_db, alter_ctx.new_name);
 
   // ALTER TABLE succeeded, delete the backup of the old table.
   if (quick_rm_table(thd, old_db_type, alter_ctx.db, backup_name, FN_IS_TMP))
@@ -1097,9 +1097,9 @@ err:
    parent_lex)
    @param  parent_select
  */
-static void repoint_contexts_of_join_nests(List<TABLE_LIST> join_list,
-                                           SELECT_LEX *removed_select,
-                                           SELECT_LEX *parent_select)
+void repoint_contexts_of_join_nests(List<TABLE_LIST> join_list,
+                                    SELECT_LEX *removed_select,
+                                    SELECT_LEX *parent_select)
 {
   List_iterator_fast<TABLE_LIST> ti(join_list);
   TABLE_LIST *tbl;
@@ -1110,6 +1110,13 @@ static void repoint_contexts_of_join_nests(List<TABLE_LIST> join_list,
     if (tbl->context_of_embedding &&
         tbl->context_of_embedding->select_lex == removed_select)
       tbl->context_of_embedding->select_lex= parent_select;
+    if (tbl->derived && tbl->is_merged())
+    {
+      /* Columns of a merged derived table are resolved in its own context */
+      Name_resolution_context *context= &tbl->derived->first_select()->context;
+      if (context->select_lex == removed_select)
+        context->select_lex= parent_select;
+    }
     if (tbl->nested_join)
       repoint_contexts_of_join_nests(tbl->nested_join->join_list,
                                      removed_select, parent_select);
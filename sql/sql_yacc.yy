@@ -1124,6 +1124,7 @@ bool my_yyoverflow(short **a, YYSTYPE **b, ulong *yystacksize);
 %token  BOOL_SYM
 %token  BOTH                          /* SQL-2003-R */
 %token  BTREE_SYM
+%token  BUCKETS_SYM
 %token  BY                            /* SQL-2003-R */
 %token  BYTE_SYM
 %token  CACHE_SYM
@@ -1291,6 +1292,7 @@ bool my_yyoverflow(short **a, YYSTYPE **b, ulong *yystacksize);
 %token  HASH_SYM
 %token  HAVING                        /* SQL-2003-R */
 %token  HELP_SYM
+%token  HISTOGRAM_SYM
 %token  HEX_NUM
 %token  HIGH_PRIORITY
 %token  HOST_SYM
@@ -1779,7 +1781,7 @@ bool my_yyoverflow(short **a, YYSTYPE **b, ulong *yystacksize);
         ws_nweights func_datetime_precision
         ws_level_flag_desc ws_level_flag_reverse ws_level_flags
         opt_ws_levels ws_level_list ws_level_list_item ws_level_number
-        ws_level_range ws_level_list_or_range  
+        ws_level_range ws_level_list_or_range opt_histogram_buckets  
 
 %type <ulonglong_number>
         ulonglong_num real_ulonglong_num size_number
@@ -8433,6 +8435,29 @@ analyze:
             if (lex->m_sql_cmd == NULL)
               MYSQL_YYABORT;
           }
+          opt_histogram
+        ;
+
+opt_histogram:
+          /* empty */ {}
+        | UPDATE_SYM HISTOGRAM_SYM ON using_list opt_histogram_buckets
+          {
+            Sql_cmd_analyze_table *cmd=
+              static_cast<Sql_cmd_analyze_table*>(Lex->m_sql_cmd);
+            cmd->set_histogram_command(HISTOGRAM_UPDATE, $4, $5);
+          }
+        | DROP HISTOGRAM_SYM ON using_list
+          {
+            Sql_cmd_analyze_table *cmd=
+              static_cast<Sql_cmd_analyze_table*>(Lex->m_sql_cmd);
+            cmd->set_histogram_command(HISTOGRAM_DROP, $4,
+                                       HISTOGRAM_DEFAULT_BUCKETS);
+          }
+        ;
+
+opt_histogram_buckets:
+          /* empty */ { $$= HISTOGRAM_DEFAULT_BUCKETS; }
+        | WITH ulong_num BUCKETS_SYM { $$= $2; }
         ;
 
 binlog_base64_event:
@@ -14253,6 +14278,7 @@ keyword_sp:
         | BOOL_SYM                 {}
         | BOOLEAN_SYM              {}
         | BTREE_SYM                {}
+        | BUCKETS_SYM              {}
         | CASCADED                 {}
         | CATALOG_NAME_SYM         {}
         | CHAIN_SYM                {}
@@ -14334,6 +14360,7 @@ keyword_sp:
         | GTID_SYM                 {}
         | GLOBAL_SYM               {}
         | HASH_SYM                 {}
+        | HISTOGRAM_SYM            {}
         | HOSTS_SYM                {}
         | HOUR_SYM                 {}
         | IDENTIFIED_SYM           {}
@@ -63,6 +63,7 @@
 
 #include "log_event.h"
 #include "binlog.h"
+#include "binlog_tail_cache.h"
 
 #ifdef WITH_PERFSCHEMA_STORAGE_ENGINE
 #include "../storage/perfschema/pfs_server.h"
@@ -963,6 +964,38 @@ static Sys_var_mybool Sys_binlog_rows_query(
        SESSION_VAR(binlog_rows_query_log_events),
        CMD_LINE(OPT_ARG), DEFAULT(FALSE));
 
+static Sys_var_mybool Sys_binlog_trx_compression(
+       "binlog_trx_compression",
+       "Compress the events of every transaction together into one "
+       "Transaction_payload event in the binary log, with the algorithm of "
+       "binlog_trx_compression_type. The events are uncompressed by the "
+       "slave SQL thread, and the relay logs of the slaves stay compressed.",
+       SESSION_VAR(binlog_trx_compression),
+       CMD_LINE(OPT_ARG), DEFAULT(FALSE));
+
+static bool check_binlog_trx_compression_type(sys_var *self, THD *thd,
+                                              set_var *var)
+{
+  uint algorithm= (uint) var->save_result.ulonglong_value;
+  if (!my_compress_buffer_bound(algorithm, 1))
+  {
+    my_error(ER_WRONG_VALUE_FOR_VAR, MYF(0), self->name.str,
+             net_compression_algorithm_typelib.type_names[algorithm]);
+    return true;
+  }
+  return false;
+}
+
+static Sys_var_enum Sys_binlog_trx_compression_type(
+       "binlog_trx_compression_type",
+       "Compression algorithm of binlog_trx_compression, one of zlib, zstd "
+       "or lz4. zstd and lz4 can only be used when the server is built with "
+       "them.",
+       GLOBAL_VAR(opt_binlog_trx_compression_type), CMD_LINE(REQUIRED_ARG),
+       net_compression_algorithm_typelib.type_names,
+       DEFAULT(NET_COMPRESSION_ZLIB), NO_MUTEX_GUARD, NOT_IN_BINLOG,
+       ON_CHECK(check_binlog_trx_compression_type));
+
 static Sys_var_mybool Sys_binlog_order_commits(
        "binlog_order_commits",
        "Issue internal commit calls in the same order as transactions are"
@@ -1772,6 +1805,28 @@ static Sys_var_ulong Sys_max_binlog_size(
        BLOCK_SIZE(IO_SIZE), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
        ON_UPDATE(fix_max_binlog_size));
 
+static bool fix_binlog_tail_cache_size(sys_var *self, THD *thd,
+                                       enum_var_type type)
+{
+  if (binlog_tail_cache.resize(opt_binlog_tail_cache_size))
+  {
+    opt_binlog_tail_cache_size= binlog_tail_cache.size();
+    return true;
+  }
+  return false;
+}
+
+static Sys_var_ulong Sys_binlog_tail_cache_size(
+       "binlog_tail_cache_size",
+       "Size of the in-memory copy of the end of the active binary log that "
+       "is shared by the binlog dump threads. Dump threads that are caught "
+       "up with the binary log send the events from it instead of reading "
+       "the binary log file. 0 disables the cache",
+       GLOBAL_VAR(opt_binlog_tail_cache_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 1024*1024L*1024L), DEFAULT(0), BLOCK_SIZE(IO_SIZE),
+       NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
+       ON_UPDATE(fix_binlog_tail_cache_size));
+
 static bool fix_max_connections(sys_var *self, THD *thd, enum_var_type type)
 {
 #ifndef EMBEDDED_LIBRARY
@@ -2115,7 +2170,8 @@ static const char *optimizer_switch_names[]=
   "materialization", "semijoin", "loosescan", "firstmatch",
   "subquery_materialization_cost_based",
 #endif
-  "use_index_extensions", "default", NullS
+  "use_index_extensions", "derived_merge", "hash_aggregation", "default",
+  NullS
 };
 /** propagates changes to @@engine_condition_pushdown */
 static bool fix_optimizer_switch(sys_var *self, THD *thd,
@@ -2137,8 +2193,9 @@ static Sys_var_flagset Sys_optimizer_switch(
        ", materialization, semijoin, loosescan, firstmatch,"
        " subquery_materialization_cost_based"
 #endif
-       ", block_nested_loop, batched_key_access, use_index_extensions"
-       "} and val is one of {on, off, default}",
+       ", block_nested_loop, batched_key_access, use_index_extensions,"
+       " derived_merge, hash_aggregation} and val is one of"
+       " {on, off, default}",
        SESSION_VAR(optimizer_switch), CMD_LINE(REQUIRED_ARG),
        optimizer_switch_names, DEFAULT(OPTIMIZER_SWITCH_DEFAULT),
        NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(NULL),
@@ -2423,6 +2480,14 @@ static Sys_var_uint Sys_eq_range_index_dive_limit(
        SESSION_VAR(eq_range_index_dive_limit), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0, UINT_MAX32), DEFAULT(10), BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_histogram_sample_rows(
+       "histogram_sample_rows",
+       "The number of rows ANALYZE TABLE ... UPDATE HISTOGRAM samples to "
+       "build column histograms. Tables with more rows are sampled at "
+       "random.",
+       SESSION_VAR(histogram_sample_rows), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, ULONG_MAX), DEFAULT(100000), BLOCK_SIZE(1));
+
 static Sys_var_uint Sys_part_scan_max(
        "part_scan_max",
        "The optimizer will scan up to this many partitions for data "
@@ -2722,6 +2787,17 @@ static Sys_var_mybool Sys_slave_compressed_protocol(
        GLOBAL_VAR(opt_slave_compressed_protocol), CMD_LINE(OPT_ARG),
        DEFAULT(FALSE));
 
+static Sys_var_enum Sys_slave_compression_algorithm(
+       "slave_compression_algorithm",
+       "Compression algorithm of the compressed master/slave protocol, one "
+       "of zlib, zstd or lz4. zstd and lz4 compress the replication stream "
+       "with the history of the connection, they are used if both master "
+       "and slave support them, zlib otherwise. Takes effect when the slave "
+       "I/O thread connects to the master",
+       GLOBAL_VAR(opt_slave_compression_algorithm), CMD_LINE(REQUIRED_ARG),
+       net_compression_algorithm_typelib.type_names,
+       DEFAULT(NET_COMPRESSION_ZLIB));
+
 #ifdef HAVE_REPLICATION
 static const char *slave_exec_mode_names[]=
        {"STRICT", "IDEMPOTENT", 0};
@@ -2783,6 +2859,16 @@ static Sys_var_set Slave_rows_search_algorithms(
        slave_rows_search_algorithms_names,
        DEFAULT(SLAVE_ROWS_INDEX_SCAN | SLAVE_ROWS_TABLE_SCAN),  NO_MUTEX_GUARD,
        NOT_IN_BINLOG, ON_CHECK(slave_rows_search_algorithms_check), ON_UPDATE(NULL));
+
+static Sys_var_ulong Sys_slave_rows_batch_lookup_min_rows(
+       "slave_rows_batch_lookup_min_rows",
+       "Update and delete rows events that look up their rows with "
+       "INDEX_SCAN and hold at least this many rows first read all the "
+       "rows in index order with one multi-range read, so the pages are "
+       "read sequentially before the rows are changed. 0 disables it",
+       GLOBAL_VAR(opt_slave_rows_batch_lookup_min_rows),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(0, UINT_MAX), DEFAULT(0),
+       BLOCK_SIZE(1));
 #endif
 
 bool Sys_var_enum_binlog_checksum::global_update(THD *thd, set_var *var)
@@ -3517,6 +3603,14 @@ static Sys_var_ulong Sys_profiling_history_size(
        NOT_IN_BINLOG, ON_CHECK(0), ON_UPDATE(0), DEPRECATED(""));
 #endif
 
+static Sys_var_mybool Sys_select_point_fast_path(
+       "select_point_fast_path",
+       "Execute single-table SELECTs whose WHERE clause binds all parts of "
+       "a unique index to constants with a direct index lookup, bypassing "
+       "the join optimizer",
+       SESSION_VAR(select_point_fast_path), CMD_LINE(OPT_ARG),
+       DEFAULT(FALSE));
+
 static Sys_var_harows Sys_select_limit(
        "sql_select_limit",
        "The maximum number of rows to return from SELECT statements",
@@ -3900,6 +3994,14 @@ static Sys_var_have Sys_have_compress(
        "have_compress", "have_compress",
        READ_ONLY GLOBAL_VAR(have_compress), NO_CMD_LINE);
 
+static Sys_var_have Sys_have_zstd(
+       "have_zstd", "have_zstd",
+       READ_ONLY GLOBAL_VAR(have_zstd), NO_CMD_LINE);
+
+static Sys_var_have Sys_have_lz4(
+       "have_lz4", "have_lz4",
+       READ_ONLY GLOBAL_VAR(have_lz4), NO_CMD_LINE);
+
 static Sys_var_have Sys_have_crypt(
        "have_crypt", "have_crypt",
        READ_ONLY GLOBAL_VAR(have_crypt), NO_CMD_LINE);
@@ -4348,6 +4450,40 @@ static Sys_var_ulonglong Sys_mts_pending_jobs_size_max(
        GLOBAL_VAR(opt_mts_pending_jobs_size_max), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(1024, (ulonglong)~(intptr)0), DEFAULT(16 * 1024*1024),
        BLOCK_SIZE(1024), ON_CHECK(0));
+
+static Sys_var_ulonglong Sys_slave_relay_log_bypass_size(
+       "slave_relay_log_bypass_size",
+       "Maximum size in bytes of the events the slave I/O thread keeps in "
+       "memory for the slave SQL thread, which then does not have to read "
+       "them back from the relay log. The relay log is written as before. "
+       "0 disables the queue",
+       GLOBAL_VAR(opt_slave_relay_log_bypass_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, (ulonglong)~(intptr)0), DEFAULT(0), BLOCK_SIZE(1024));
+
+static Sys_var_mybool Sys_slave_apply_latency_stats(
+       "slave_apply_latency_stats",
+       "Collect the latency histograms of the events the slave applies by "
+       "event type and table, shown in "
+       "INFORMATION_SCHEMA.SLAVE_APPLY_LATENCY",
+       GLOBAL_VAR(opt_slave_apply_latency_stats), CMD_LINE(OPT_ARG),
+       DEFAULT(FALSE));
+
+static Sys_var_ulong Sys_slave_prefetch_threads(
+       "slave_prefetch_threads",
+       "Number of threads that read the relay log ahead of the slave SQL "
+       "thread and apply its row events with innodb_fake_changes, loading "
+       "the index pages they touch into the buffer pool. Takes effect when "
+       "the SQL thread starts. 0 disables prefetching",
+       GLOBAL_VAR(opt_slave_prefetch_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 64), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulonglong Sys_slave_prefetch_lookahead(
+       "slave_prefetch_lookahead",
+       "How many bytes of relay log the slave prefetch threads may read "
+       "ahead of the slave SQL thread",
+       GLOBAL_VAR(opt_slave_prefetch_lookahead), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(4096, (ulonglong)~(intptr)0), DEFAULT(4 * 1024*1024),
+       BLOCK_SIZE(1024));
 #endif
 
 static bool check_locale(sys_var *self, THD *thd, set_var *var)
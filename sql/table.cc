@@ -568,6 +568,9 @@ inline bool is_system_table_name(const char *name, uint length)
              my_tolower(ci, name[2]) == 'o' &&
              my_tolower(ci, name[3]) == 'c') ||
 
+           /* mysql.column_stats table */
+           (length == 12 && my_strcasecmp(ci, name, "column_stats") == 0) ||
+
            (length > 4 &&
              (
                /* one of mysql.help* tables */
@@ -3838,14 +3841,13 @@ void TABLE_LIST::set_underlying_merge()
 
   if ((tbl= merge_underlying_list))
   {
-    /* This is a view. Process all tables of view */
-    DBUG_ASSERT(view && effective_algorithm == VIEW_ALGORITHM_MERGE);
+    /* This is a view or derived table. Process all its tables */
+    DBUG_ASSERT((view || derived) && is_merged());
     do
     {
       if (tbl->merge_underlying_list)          // This is a view
       {
-        DBUG_ASSERT(tbl->view &&
-                    tbl->effective_algorithm == VIEW_ALGORITHM_MERGE);
+        DBUG_ASSERT((tbl->view || tbl->derived) && tbl->is_merged());
         /*
           This is the only case where set_ancestor is called on an object
           that may not be a view (in which case ancestor is 0)
@@ -3893,7 +3895,7 @@ bool TABLE_LIST::setup_underlying(THD *thd)
   if (!field_translation && merge_underlying_list)
   {
     Field_translator *transl;
-    SELECT_LEX *select= &view->select_lex;
+    SELECT_LEX *select= get_unit()->first_select();
     Item *item;
     TABLE_LIST *tbl;
     List_iterator_fast<Item> it(select->item_list);
@@ -3933,12 +3935,12 @@ bool TABLE_LIST::setup_underlying(THD *thd)
     /* TODO: use hash for big number of fields */
 
     /* full text function moving to current select */
-    if (view->select_lex.ftfunc_list->elements)
+    if (select->ftfunc_list->elements)
     {
       Item_func_match *ifm;
       SELECT_LEX *current_select= thd->lex->current_select;
       List_iterator_fast<Item_func_match>
-        li(*(view->select_lex.ftfunc_list));
+        li(*(select->ftfunc_list));
       while ((ifm= li++))
         current_select->ftfunc_list->push_front(ifm);
     }
@@ -3972,7 +3974,7 @@ bool TABLE_LIST::prep_where(THD *thd, Item **conds,
 
   for (TABLE_LIST *tbl= merge_underlying_list; tbl; tbl= tbl->next_local)
   {
-    if (tbl->view && tbl->prep_where(thd, conds, no_where_clause))
+    if (tbl->is_merged() && tbl->prep_where(thd, conds, no_where_clause))
     {
       DBUG_RETURN(TRUE);
     }
@@ -4347,7 +4349,7 @@ bool TABLE_LIST::set_insert_values(MEM_ROOT *mem_root)
   }
   else
   {
-    DBUG_ASSERT(view && merge_underlying_list);
+    DBUG_ASSERT(is_merged() && merge_underlying_list);
     for (TABLE_LIST *tbl= merge_underlying_list; tbl; tbl= tbl->next_local)
       if (tbl->set_insert_values(mem_root))
         return TRUE;
@@ -4365,17 +4367,17 @@ bool TABLE_LIST::set_insert_values(MEM_ROOT *mem_root)
   DESCRIPTION
     A table reference is a leaf with respect to name resolution if
     it is either a leaf node in a nested join tree (table, view,
-    schema table, subquery), or an inner node that represents a
-    NATURAL/USING join, or a nested join with materialized join
-    columns.
+    schema table, subquery), a merged view or subquery, or an inner
+    node that represents a NATURAL/USING join, or a nested join with
+    materialized join columns.
 
   RETURN
     TRUE if a leaf, FALSE otherwise.
 */
 bool TABLE_LIST::is_leaf_for_name_resolution()
 {
-  return (view || is_natural_join || is_join_columns_complete ||
-          !nested_join);
+  return (view || is_merged() || is_natural_join ||
+          is_join_columns_complete || !nested_join);
 }
 
 
@@ -4846,6 +4848,20 @@ static Item *create_view_field(THD *thd, TABLE_LIST *view, Item **field_ref,
     }
     field= *field_ref;
   }
+  else if (view->derived && field->real_item()->type() == Item::FIELD_ITEM &&
+           thd->mark_used_columns != MARK_COLUMNS_NONE)
+  {
+    /*
+      The columns expanded from a wildcard of a merged derived table are
+      fixed before the outer query sets up its tables, which resets the
+      column usage of the underlying tables. Mark them as used again.
+    */
+    Field *fld= ((Item_field*) field->real_item())->field;
+    if (thd->mark_used_columns == MARK_COLUMNS_READ)
+      bitmap_set_bit(fld->table->read_set, fld->field_index);
+    fld->table->covering_keys.intersect(fld->part_of_key);
+    fld->table->merge_keys.merge(fld->part_of_key);
+  }
   thd->lex->current_select->no_wrap_view_item= save_wrapper;
   if (save_wrapper)
   {
@@ -4906,8 +4922,7 @@ void Field_iterator_table_ref::set_field_iterator()
   /* This is a merge view, so use field_translation. */
   else if (table_ref->field_translation)
   {
-    DBUG_ASSERT(table_ref->view &&
-                table_ref->effective_algorithm == VIEW_ALGORITHM_MERGE);
+    DBUG_ASSERT(table_ref->is_merged());
     field_it= &view_field_it;
     DBUG_PRINT("info", ("field_it for '%s' is Field_iterator_view",
                         table_ref->alias));
@@ -4957,6 +4972,8 @@ const char *Field_iterator_table_ref::get_table_name()
 {
   if (table_ref->view)
     return table_ref->view_name.str;
+  else if (table_ref->is_merged())
+    return table_ref->alias;
   else if (table_ref->is_natural_join)
     return natural_join_it.column_ref()->table_name();
 
@@ -4970,6 +4987,8 @@ const char *Field_iterator_table_ref::get_db_name()
 {
   if (table_ref->view)
     return table_ref->view_db.str;
+  else if (table_ref->is_merged())
+    return table_ref->db;
   else if (table_ref->is_natural_join)
     return natural_join_it.column_ref()->db_name();
 
@@ -4989,7 +5008,7 @@ const char *Field_iterator_table_ref::get_db_name()
 
 GRANT_INFO *Field_iterator_table_ref::grant()
 {
-  if (table_ref->view)
+  if (table_ref->view || table_ref->is_merged())
     return &(table_ref->grant);
   else if (table_ref->is_natural_join)
     return natural_join_it.column_ref()->grant();
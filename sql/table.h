@@ -49,6 +49,7 @@ class ACL_internal_table_access;
 class Field;
 class Field_temporal_with_date_and_time;
 class Table_cache_element;
+class Histogram;
 
 /*
   Used to identify NESTED_JOIN structures within a join (applicable to
@@ -702,6 +703,15 @@ struct TABLE_SHARE
   */
   int cached_row_logging_check;
 
+  /*
+    Column histograms indexed by field number, NULL if the table has none.
+    Read from mysql.column_stats by load_histograms() on first use.
+    Protected by LOCK_ha_data until histograms_loaded is set, immutable
+    afterwards.
+  */
+  Histogram **histograms;
+  bool histograms_loaded;
+
   /*
     Storage media to use for this table (unless another storage
     media has been specified on an individual column - in versions
@@ -1102,6 +1112,12 @@ public:
     this table and constants)
   */
   ha_rows       quick_condition_rows;
+  /*
+    TABLE_SHARE::histograms, copied by load_histograms() once the share
+    has loaded them so that later statements need not lock the share.
+  */
+  Histogram     **histograms;
+  bool          histograms_checked;
   table_map	map;                    /* ID bit of table (1,2,4,8,16...) */
 
   uint          lock_position;          /* Position in MYSQL_LOCK.table */
@@ -1746,11 +1762,13 @@ public:
   */
   uint8         effective_with_check;
   /** 
-      @brief The view algorithm that is actually used, if this is a view.
+      @brief The algorithm that is actually used, if this is a view or a
+      derived table.
       @details One of
       - VIEW_ALGORITHM_UNDEFINED
       - VIEW_ALGORITHM_TMPTABLE
-      - VIEW_ALGORITHM_MERGE
+      - VIEW_ALGORITHM_MERGE (also used for merged derived tables)
+      - DERIVED_ALGORITHM_TMPTABLE
       @to do Replace with an enum 
   */
   enum_derived_type effective_algorithm;
@@ -1923,6 +1941,15 @@ public:
   {
     return (effective_algorithm != VIEW_ALGORITHM_UNDEFINED);
   }
+  /**
+    @returns
+      TRUE  this is a view or derived table merged into the outer query.
+      FALSE otherwise.
+  */
+  inline bool is_merged() const
+  {
+    return (effective_algorithm == VIEW_ALGORITHM_MERGE);
+  }
   /**
     @returns true if materializable table contains one or zero rows.
 
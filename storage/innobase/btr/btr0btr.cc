@@ -717,15 +717,15 @@ btr_root_fseg_validate(
 #endif /* UNIV_BTR_DEBUG */
 
 /**************************************************************//**
-Gets the root node of a tree and x- or s-latches it.
-@return	root page, x- or s-latched */
+Gets the root node of a tree and x- or s-latches or buffer-fixes it.
+@return	root page, x- or s-latched or buffer-fixed */
 UNIV_INTERN
 buf_block_t*
 btr_root_block_get(
 /*===============*/
 	const dict_index_t*	index,	/*!< in: index tree */
-	ulint			mode,	/*!< in: either RW_S_LATCH
-					or RW_X_LATCH */
+	ulint			mode,	/*!< in: RW_S_LATCH, RW_X_LATCH
+					or RW_NO_LATCH */
 	mtr_t*			mtr)	/*!< in: mtr */
 {
 	ulint		space;
@@ -769,7 +769,7 @@ btr_root_get(
 
 /**************************************************************//**
 Gets the height of the B-tree (the level of the root, when the leaf
-level is assumed to be 0). The caller must hold an S or X latch on
+level is assumed to be 0). The caller must hold an S, SX or X latch on
 the index.
 @return	tree height (level of the root) */
 UNIV_INTERN
@@ -784,6 +784,8 @@ btr_height_get(
 
 	ut_ad(mtr_memo_contains(mtr, dict_index_get_lock(index),
 				MTR_MEMO_S_LOCK)
+	      || mtr_memo_contains(mtr, dict_index_get_lock(index),
+				MTR_MEMO_SX_LOCK)
 	      || mtr_memo_contains(mtr, dict_index_get_lock(index),
 				MTR_MEMO_X_LOCK));
 
@@ -1035,7 +1037,7 @@ btr_get_next_user_rec(
 /**************************************************************//**
 Creates a new index page (not the root, and also not
 used in page reorganization).  @see btr_page_empty(). */
-static
+UNIV_INTERN
 void
 btr_page_create(
 /*============*/
@@ -1129,7 +1131,19 @@ btr_page_alloc_low(
 	fseg_header_t*	seg_header;
 	page_t*		root;
 
-	root = btr_root_get(index, mtr);
+	if (rw_lock_get_sx_lock_count(dict_index_get_lock(index))) {
+		/* Pages are only allocated under an x- or sx-latch on
+		the index tree, so this thread is splitting pages under
+		the sx-latch. It may have released the root page while
+		other threads s-latched it, and it must not latch the
+		root page after its descendants. As the file segment
+		headers on the root page never change, it is enough to
+		buffer-fix the root page. */
+		root = buf_block_get_frame(
+			btr_root_block_get(index, RW_NO_LATCH, mtr));
+	} else {
+		root = btr_root_get(index, mtr);
+	}
 
 	if (level == 0) {
 		seg_header = root + PAGE_HEADER + PAGE_BTR_SEG_LEAF;
@@ -1413,7 +1427,9 @@ btr_page_get_father_node_ptr_func(
 	index = btr_cur_get_index(cursor);
 
 	ut_ad(mtr_memo_contains(mtr, dict_index_get_lock(index),
-				MTR_MEMO_X_LOCK));
+				MTR_MEMO_X_LOCK)
+	      || mtr_memo_contains(mtr, dict_index_get_lock(index),
+				   MTR_MEMO_SX_LOCK));
 
 	ut_ad(dict_index_get_page(index) != page_no);
 
@@ -2072,7 +2088,7 @@ btr_parse_page_reorganize(
 #ifndef UNIV_HOTBACKUP
 /*************************************************************//**
 Empties an index page.  @see btr_page_create(). */
-static
+UNIV_INTERN
 void
 btr_page_empty(
 /*===========*/
@@ -2167,7 +2183,9 @@ btr_root_raise_and_insert(
 	ut_a(dict_index_get_page(index) == page_get_page_no(root));
 #endif /* UNIV_BTR_DEBUG */
 	ut_ad(mtr_memo_contains(mtr, dict_index_get_lock(index),
-				MTR_MEMO_X_LOCK));
+				MTR_MEMO_X_LOCK)
+	      || mtr_memo_contains(mtr, dict_index_get_lock(index),
+				   MTR_MEMO_SX_LOCK));
 	ut_ad(mtr_memo_contains(mtr, root_block, MTR_MEMO_PAGE_X_FIX));
 
 	/* Allocate a new page to the tree. Root splitting is done by first
@@ -2872,12 +2890,15 @@ func_start:
 	*offsets = NULL;
 
 	ut_ad(mtr_memo_contains(mtr, dict_index_get_lock(cursor->index),
-				MTR_MEMO_X_LOCK));
+				MTR_MEMO_X_LOCK)
+	      || mtr_memo_contains(mtr, dict_index_get_lock(cursor->index),
+				   MTR_MEMO_SX_LOCK));
 	ut_ad(!dict_index_is_online_ddl(cursor->index)
 	      || (flags & BTR_CREATE_FLAG)
 	      || dict_index_is_clust(cursor->index));
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(rw_lock_own(dict_index_get_lock(cursor->index), RW_LOCK_EX));
+	ut_ad(rw_lock_own(dict_index_get_lock(cursor->index), RW_LOCK_EX)
+	      || rw_lock_own(dict_index_get_lock(cursor->index), RW_LOCK_SX));
 #endif /* UNIV_SYNC_DEBUG */
 
 	block = btr_cur_get_block(cursor);
@@ -3001,10 +3022,12 @@ insert_empty:
 	}
 
 	if (insert_will_fit && page_is_leaf(page)
-	    && !dict_index_is_online_ddl(cursor->index)) {
+	    && !dict_index_is_online_ddl(cursor->index)
+	    && !mtr_memo_release(mtr, dict_index_get_lock(cursor->index),
+				 MTR_MEMO_X_LOCK)) {
 
 		mtr_memo_release(mtr, dict_index_get_lock(cursor->index),
-				 MTR_MEMO_X_LOCK);
+				 MTR_MEMO_SX_LOCK);
 	}
 
 	/* 5. Move then the records to the new page */
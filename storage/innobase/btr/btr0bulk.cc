@@ -0,0 +1,588 @@
+/*****************************************************************************
+
+Copyright (c) 2013, Facebook Inc.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file btr/btr0bulk.cc
+Bottom-up building of an index tree from sorted records
+*******************************************************/
+
+#include "btr0bulk.h"
+
+#include "btr0btr.h"
+#include "dict0dict.h"
+#include "fsp0fsp.h"
+#include "ibuf0ibuf.h"
+#include "log0log.h"
+#include "mtr0log.h"
+#include "page0cur.h"
+#include "page0page.h"
+#include "rem0cmp.h"
+
+/** Space left free on the built pages for later updates and inserts */
+#define BTR_BULK_PAGE_RESERVE	(UNIV_PAGE_SIZE / 16)
+
+/** A level of the tree being built */
+struct btr_bulk_level_t {
+	ulint		page_no;	/*!< rightmost page of the level,
+					or FIL_NULL if the level is empty */
+	ulint		n_pages;	/*!< number of pages on the level */
+	dtuple_t*	first_node_ptr;	/*!< node pointer to the only page
+					of the child level; it is inserted
+					when the child level gets its second
+					page, because a single page at the
+					top becomes the root */
+};
+
+/** Bottom-up index tree builder */
+struct btr_bulk_t {
+	dict_index_t*	index;		/*!< the index */
+	trx_id_t	trx_id;		/*!< PAGE_MAX_TRX_ID of the secondary
+					index leaf pages */
+	mem_heap_t*	heap;		/*!< memory heap for this struct and
+					the deferred node pointers */
+	mem_heap_t*	tuple_heap;	/*!< memory heap for tuples[] */
+	mem_heap_t*	last_heap;	/*!< memory heap for the last record
+					of the previous leaf page */
+	const dtuple_t** tuples;	/*!< records of the leaf page being
+					filled */
+	ulint		n_tuples;	/*!< number of records in tuples[] */
+	ulint		max_tuples;	/*!< capacity of tuples[] */
+	ulint		data_size;	/*!< size of tuples[] as records */
+	ulint		space_limit;	/*!< maximum size of the records and
+					the page directory on a leaf page */
+	const dtuple_t*	last;		/*!< last appended record, or NULL */
+	ulint		n_levels;	/*!< number of non-empty levels */
+	btr_bulk_level_t levels[BTR_MAX_LEVELS];
+					/*!< levels of the tree, leaf first */
+};
+
+/**************************************************************//**
+Creates a builder of the tree of an empty index.
+@return	own: tree builder */
+UNIV_INTERN
+btr_bulk_t*
+btr_bulk_create(
+/*============*/
+	dict_index_t*	index,	/*!< in: uncompressed index whose
+				root page is empty */
+	trx_id_t	trx_id)	/*!< in: PAGE_MAX_TRX_ID of the
+				secondary index leaf pages */
+{
+	mem_heap_t*	heap;
+	btr_bulk_t*	bulk;
+	ulint		i;
+
+	ut_ad(!dict_table_zip_size(index->table));
+	ut_ad(!dict_index_is_ibuf(index));
+
+	heap = mem_heap_create(sizeof *bulk + 1024);
+
+	bulk = static_cast<btr_bulk_t*>(mem_heap_zalloc(heap, sizeof *bulk));
+
+	bulk->index = index;
+	bulk->trx_id = trx_id;
+	bulk->heap = heap;
+	bulk->tuple_heap = mem_heap_create(UNIV_PAGE_SIZE);
+	bulk->last_heap = mem_heap_create(1024);
+	bulk->max_tuples = UNIV_PAGE_SIZE / REC_N_NEW_EXTRA_BYTES;
+	bulk->tuples = static_cast<const dtuple_t**>(
+		mem_heap_alloc(heap, bulk->max_tuples * sizeof *bulk->tuples));
+	bulk->space_limit = page_get_free_space_of_empty(
+		dict_table_is_comp(index->table)) - BTR_BULK_PAGE_RESERVE;
+
+	for (i = 0; i < BTR_MAX_LEVELS; i++) {
+		bulk->levels[i].page_no = FIL_NULL;
+	}
+
+	return(bulk);
+}
+
+/**************************************************************//**
+Copies a tuple and its data to a heap.
+@return	the copy */
+static __attribute__((nonnull, warn_unused_result))
+dtuple_t*
+btr_bulk_tuple_copy(
+/*================*/
+	const dtuple_t*	tuple,	/*!< in: tuple */
+	mem_heap_t*	heap)	/*!< in/out: memory heap */
+{
+	dtuple_t*	copy = dtuple_copy(tuple, heap);
+	ulint		i;
+
+	for (i = 0; i < dtuple_get_n_fields(copy); i++) {
+		dfield_dup(dtuple_get_nth_field(copy, i), heap);
+	}
+
+	return(copy);
+}
+
+/**************************************************************//**
+Allocates and creates the next page of a level and links it after the
+rightmost page of the level.
+@return	the new page, x-latched, or NULL if the tablespace is full */
+static __attribute__((nonnull, warn_unused_result))
+buf_block_t*
+btr_bulk_page_create(
+/*=================*/
+	btr_bulk_t*	bulk,	/*!< in/out: tree builder */
+	ulint		level,	/*!< in: level of the page */
+	mtr_t*		mtr)	/*!< in/out: mini-transaction */
+{
+	dict_index_t*		index = bulk->index;
+	btr_bulk_level_t*	lvl = &bulk->levels[level];
+	buf_block_t*		block;
+	page_t*			page;
+
+	ut_a(level < BTR_MAX_LEVELS);
+
+	block = btr_page_alloc(index,
+			       lvl->page_no == FIL_NULL ? 0 : lvl->page_no + 1,
+			       FSP_UP, level, mtr, mtr);
+
+	if (block == NULL) {
+		return(NULL);
+	}
+
+	btr_page_create(block, NULL, index, level, mtr);
+
+	page = buf_block_get_frame(block);
+
+	btr_page_set_next(page, NULL, FIL_NULL, mtr);
+	btr_page_set_prev(page, NULL, lvl->page_no, mtr);
+
+	if (lvl->page_no != FIL_NULL) {
+		buf_block_t*	prev_block = btr_block_get(
+			index->space, 0, lvl->page_no, RW_X_LATCH, index, mtr);
+
+		btr_page_set_next(buf_block_get_frame(prev_block), NULL,
+				  buf_block_get_page_no(block), mtr);
+	}
+
+	lvl->page_no = buf_block_get_page_no(block);
+	lvl->n_pages++;
+
+	if (bulk->n_levels <= level) {
+		bulk->n_levels = level + 1;
+	}
+
+	return(block);
+}
+
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+btr_bulk_add_node_ptr(
+/*==================*/
+	btr_bulk_t*	bulk,
+	ulint		level,
+	dtuple_t*	node_ptr,
+	mtr_t*		mtr);
+
+/**************************************************************//**
+Appends a node pointer to the rightmost page of a non-leaf level, or to
+a new page if it does not fit there. The node pointer to a new page is
+added to the level above.
+@return	DB_SUCCESS or error code */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+btr_bulk_append_node_ptr(
+/*=====================*/
+	btr_bulk_t*	bulk,	/*!< in/out: tree builder */
+	ulint		level,	/*!< in: non-leaf level */
+	const dtuple_t*	node_ptr,/*!< in: node pointer */
+	mtr_t*		mtr)	/*!< in/out: mini-transaction */
+{
+	dict_index_t*		index = bulk->index;
+	btr_bulk_level_t*	lvl = &bulk->levels[level];
+	ulint			size = rec_get_converted_size(
+		index, node_ptr, 0);
+	buf_block_t*		block = NULL;
+	bool			new_page = false;
+	mem_heap_t*		heap = NULL;
+	ulint*			offsets = NULL;
+	page_cur_t		cur;
+	rec_t*			rec;
+	dberr_t			err = DB_SUCCESS;
+
+	ut_ad(level > 0);
+
+	if (lvl->page_no != FIL_NULL) {
+		block = btr_block_get(index->space, 0, lvl->page_no,
+				      RW_X_LATCH, index, mtr);
+
+		if (page_get_max_insert_size(buf_block_get_frame(block), 1)
+		    < size + BTR_BULK_PAGE_RESERVE) {
+			block = NULL;
+		}
+	}
+
+	if (block == NULL) {
+		block = btr_bulk_page_create(bulk, level, mtr);
+
+		if (block == NULL) {
+			return(DB_OUT_OF_FILE_SPACE);
+		}
+
+		new_page = true;
+	}
+
+	page_cur_position(
+		page_rec_get_prev(page_get_supremum_rec(
+					  buf_block_get_frame(block))),
+		block, &cur);
+
+	rec = page_cur_tuple_insert(&cur, node_ptr, index,
+				    &offsets, &heap, 0, mtr);
+	ut_a(rec != NULL);
+
+	if (new_page) {
+		if (lvl->n_pages == 1) {
+			/* The first record on a non-leaf level must be
+			the minimum record. */
+			btr_set_min_rec_mark(rec, mtr);
+		}
+
+		err = btr_bulk_add_node_ptr(
+			bulk, level + 1,
+			dict_index_build_node_ptr(
+				index, rec, buf_block_get_page_no(block),
+				heap, level),
+			mtr);
+	}
+
+	mem_heap_free(heap);
+
+	return(err);
+}
+
+/**************************************************************//**
+Adds the node pointer to a new page of the child level to a level.
+@return	DB_SUCCESS or error code */
+static
+dberr_t
+btr_bulk_add_node_ptr(
+/*==================*/
+	btr_bulk_t*	bulk,	/*!< in/out: tree builder */
+	ulint		level,	/*!< in: level of the node pointer */
+	dtuple_t*	node_ptr,/*!< in/out: node pointer */
+	mtr_t*		mtr)	/*!< in/out: mini-transaction */
+{
+	btr_bulk_level_t*	child = &bulk->levels[level - 1];
+	dberr_t			err;
+
+	ut_ad(child->n_pages > 0);
+
+	/* Do not copy the minimum record flag from the child page. */
+	dtuple_set_info_bits(node_ptr, REC_STATUS_NODE_PTR);
+
+	switch (child->n_pages) {
+	case 1:
+		/* A child level with a single page needs no parent:
+		the page may become the root. */
+		child->first_node_ptr = btr_bulk_tuple_copy(
+			node_ptr, bulk->heap);
+		return(DB_SUCCESS);
+	case 2:
+		err = btr_bulk_append_node_ptr(
+			bulk, level, child->first_node_ptr, mtr);
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+
+		child->first_node_ptr = NULL;
+	}
+
+	return(btr_bulk_append_node_ptr(bulk, level, node_ptr, mtr));
+}
+
+/**************************************************************//**
+Writes the records of a page that was filled without logging them to
+the redo log: the used part of the page and the page directory. */
+static __attribute__((nonnull))
+void
+btr_bulk_log_page(
+/*==============*/
+	buf_block_t*	block,	/*!< in: filled page */
+	mtr_t*		mtr)	/*!< in/out: mini-transaction */
+{
+	page_t*		page = buf_block_get_frame(block);
+	byte*		slot = page_dir_get_nth_slot(
+		page, page_dir_get_n_slots(page) - 1);
+
+	mlog_log_string(page + PAGE_HEADER,
+			page_header_get_field(page, PAGE_HEAP_TOP)
+			- PAGE_HEADER, mtr);
+	mlog_log_string(slot, page + UNIV_PAGE_SIZE - PAGE_DIR - slot, mtr);
+}
+
+/**************************************************************//**
+Writes the buffered records to new leaf pages.
+@return	DB_SUCCESS or error code */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+btr_bulk_flush(
+/*===========*/
+	btr_bulk_t*	bulk)	/*!< in/out: tree builder */
+{
+	dict_index_t*	index = bulk->index;
+	mem_heap_t*	heap = mem_heap_create(UNIV_PAGE_SIZE);
+	ulint*		offsets = NULL;
+	ulint		i = 0;
+	dberr_t		err = DB_SUCCESS;
+
+	while (i < bulk->n_tuples) {
+		buf_block_t*	block;
+		page_cur_t	cur;
+		const rec_t*	first;
+		ulint		n_reserved;
+		mtr_t		mtr;
+
+		log_free_check();
+
+		mtr_start(&mtr);
+
+		/* The new pages are not reachable from the root, so
+		readers of the index need not be blocked. */
+		mtr_sx_lock(dict_index_get_lock(index), &mtr);
+
+		if (!fsp_reserve_free_extents(&n_reserved, index->space,
+					      bulk->n_levels / 16 + 3,
+					      FSP_NORMAL, &mtr)) {
+			mtr_commit(&mtr);
+			err = DB_OUT_OF_FILE_SPACE;
+			break;
+		}
+
+		block = btr_bulk_page_create(bulk, 0, &mtr);
+
+		if (block == NULL) {
+			err = DB_OUT_OF_FILE_SPACE;
+			goto func_exit;
+		}
+
+		page_cur_set_before_first(block, &cur);
+
+		/* The records are not logged one by one:
+		btr_bulk_log_page() logs the filled page. */
+		for (; i < bulk->n_tuples; i++) {
+			rec_t*	rec = page_cur_tuple_insert(
+				&cur, bulk->tuples[i], index,
+				&offsets, &heap, 0, NULL);
+
+			if (rec == NULL) {
+				break;
+			}
+
+			page_cur_position(rec, block, &cur);
+		}
+
+		first = page_rec_get_next_const(
+			page_get_infimum_rec(buf_block_get_frame(block)));
+
+		if (page_rec_is_supremum(first)) {
+			err = DB_TOO_BIG_RECORD;
+			goto func_exit;
+		}
+
+		if (!dict_index_is_clust(index)) {
+			page_set_max_trx_id(block, NULL, bulk->trx_id, NULL);
+		}
+
+		btr_bulk_log_page(block, &mtr);
+
+		if (!dict_index_is_clust(index)) {
+			ibuf_reset_free_bits(block);
+		}
+
+		err = btr_bulk_add_node_ptr(
+			bulk, 1,
+			dict_index_build_node_ptr(
+				index, first, buf_block_get_page_no(block),
+				heap, 0),
+			&mtr);
+func_exit:
+		fil_space_release_free_extents(index->space, n_reserved);
+		mtr_commit(&mtr);
+
+		mem_heap_empty(heap);
+		offsets = NULL;
+
+		if (err != DB_SUCCESS) {
+			break;
+		}
+	}
+
+	mem_heap_free(heap);
+
+	/* Keep the last record for the order check of the next one. */
+	mem_heap_empty(bulk->last_heap);
+	bulk->last = btr_bulk_tuple_copy(bulk->last, bulk->last_heap);
+
+	mem_heap_empty(bulk->tuple_heap);
+	bulk->n_tuples = 0;
+	bulk->data_size = 0;
+
+	return(err);
+}
+
+/**************************************************************//**
+Compares a record to the previously appended one on the fields that
+identify a record in the index tree.
+@return	1, 0, -1, if tuple is greater, equal, less than bulk->last */
+static __attribute__((nonnull, warn_unused_result))
+int
+btr_bulk_cmp_last(
+/*==============*/
+	const btr_bulk_t*	bulk,	/*!< in: tree builder */
+	const dtuple_t*		tuple)	/*!< in: record */
+{
+	ulint	n = dict_index_get_n_unique_in_tree(bulk->index);
+	ulint	i;
+
+	for (i = 0; i < n; i++) {
+		int	cmp = cmp_dfield_dfield(
+			dtuple_get_nth_field(tuple, i),
+			dtuple_get_nth_field(bulk->last, i));
+
+		if (cmp) {
+			return(cmp);
+		}
+	}
+
+	return(0);
+}
+
+/**************************************************************//**
+Appends a record to the tree being built. The record must be greater
+than the previously appended one and it must not need external storage.
+@return	DB_SUCCESS, DB_FAIL if the record is not greater than the
+previous one, or error code */
+UNIV_INTERN
+dberr_t
+btr_bulk_insert(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in/out: tree builder */
+	const dtuple_t*	tuple)	/*!< in: record to append; the
+				data is copied */
+{
+	ulint		size = rec_get_converted_size(bulk->index, tuple, 0);
+	dtuple_t*	copy;
+
+	if (bulk->last != NULL && btr_bulk_cmp_last(bulk, tuple) <= 0) {
+		return(DB_FAIL);
+	}
+
+	if (bulk->n_tuples == bulk->max_tuples
+	    || bulk->data_size + size
+	    + PAGE_DIR_SLOT_SIZE
+	    * (bulk->n_tuples / PAGE_DIR_SLOT_MIN_N_OWNED + 1)
+	    > bulk->space_limit) {
+		dberr_t	err = btr_bulk_flush(bulk);
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+	}
+
+	copy = btr_bulk_tuple_copy(tuple, bulk->tuple_heap);
+
+	bulk->tuples[bulk->n_tuples++] = copy;
+	bulk->data_size += size;
+	bulk->last = copy;
+
+	return(DB_SUCCESS);
+}
+
+/**************************************************************//**
+Writes the remaining records and attaches the built tree to the root
+page of the index.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+dberr_t
+btr_bulk_finish(
+/*============*/
+	btr_bulk_t*	bulk)	/*!< in/out: tree builder */
+{
+	dict_index_t*	index = bulk->index;
+	ulint		top;
+	buf_block_t*	root_block;
+	buf_block_t*	block;
+	mtr_t		mtr;
+
+	if (bulk->n_tuples > 0) {
+		dberr_t	err = btr_bulk_flush(bulk);
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+	}
+
+	if (bulk->n_levels == 0) {
+		return(DB_SUCCESS);
+	}
+
+	top = bulk->n_levels - 1;
+	ut_ad(bulk->levels[top].n_pages == 1);
+
+	log_free_check();
+
+	mtr_start(&mtr);
+	mtr_x_lock(dict_index_get_lock(index), &mtr);
+
+	root_block = btr_root_block_get(index, RW_X_LATCH, &mtr);
+	ut_ad(page_is_empty(buf_block_get_frame(root_block)));
+	ut_ad(page_is_leaf(buf_block_get_frame(root_block)));
+
+	block = btr_block_get(index->space, 0, bulk->levels[top].page_no,
+			      RW_X_LATCH, index, &mtr);
+
+	/* Move the records of the top page to the root page. */
+	btr_page_empty(root_block, NULL, index, top, &mtr);
+
+	ut_a(page_copy_rec_list_end(
+		     root_block, block,
+		     page_get_infimum_rec(buf_block_get_frame(block)),
+		     index, &mtr));
+
+	if (top == 0 && !dict_index_is_clust(index)) {
+		ibuf_reset_free_bits(root_block);
+	}
+
+	btr_page_free_low(index, block, top, &mtr);
+
+	mtr_commit(&mtr);
+
+	bulk->n_levels = 0;
+
+	return(DB_SUCCESS);
+}
+
+/**************************************************************//**
+Frees a tree builder. The pages of an unfinished tree stay allocated
+to the index until it is emptied or dropped. */
+UNIV_INTERN
+void
+btr_bulk_free(
+/*==========*/
+	btr_bulk_t*	bulk)	/*!< in, own: tree builder */
+{
+	mem_heap_free(bulk->tuple_heap);
+	mem_heap_free(bulk->last_heap);
+	mem_heap_free(bulk->heap);
+}
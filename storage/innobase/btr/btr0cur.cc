@@ -56,6 +56,7 @@ Created 10/16/1994 Heikki Tuuri
 #include "rem0rec.h"
 #include "rem0cmp.h"
 #include "buf0lru.h"
+#include "buf0rea.h"
 #include "btr0btr.h"
 #include "btr0sea.h"
 #include "row0log.h"
@@ -252,6 +253,62 @@ btr_rec_set_deleted_flag(
 #ifndef UNIV_HOTBACKUP
 /*==================== B-TREE SEARCH =========================*/
 
+/********************************************************************//**
+Latches the left neighbor of a page and then the page itself. Unless the
+caller holds an x- or sx-latch on the index tree, the left neighbor may
+be split between reading its page number and latching it, and then we
+retry with the page that the split inserted between them.
+@return	left neighbor, or NULL if the page is the leftmost on its level */
+static
+buf_block_t*
+btr_cur_latch_left_and_page(
+/*========================*/
+	page_t*		page,		/*!< in: buffer-fixed page */
+	ulint		space,		/*!< in: space id */
+	ulint		zip_size,	/*!< in: compressed page size in bytes
+					or 0 for uncompressed pages */
+	ulint		page_no,	/*!< in: page number of the page */
+	ulint		mode,		/*!< in: RW_S_LATCH or RW_X_LATCH */
+	btr_cur_t*	cursor,		/*!< in: cursor */
+	mtr_t*		mtr)		/*!< in: mtr */
+{
+	for (;;) {
+		ulint		savepoint = mtr_set_savepoint(mtr);
+		ulint		left_page_no = btr_page_get_prev(page, mtr);
+		buf_block_t*	left_block = NULL;
+		buf_block_t*	get_block;
+
+		if (left_page_no != FIL_NULL) {
+			left_block = btr_block_get(
+				space, zip_size, left_page_no,
+				mode, cursor->index, mtr);
+			left_block->check_index_page_at_flush = TRUE;
+		}
+
+		get_block = btr_block_get(
+			space, zip_size, page_no, mode, cursor->index, mtr);
+		get_block->check_index_page_at_flush = TRUE;
+
+		if (btr_page_get_prev(get_block->frame, mtr)
+		    == left_page_no) {
+#ifdef UNIV_BTR_DEBUG
+			ut_a(page_is_comp(get_block->frame)
+			     == page_is_comp(page));
+			ut_a(!left_block
+			     || page_is_comp(left_block->frame)
+			     == page_is_comp(page));
+			ut_a(!left_block
+			     || btr_page_get_next(left_block->frame, mtr)
+			     == page_get_page_no(page));
+#endif /* UNIV_BTR_DEBUG */
+			return(left_block);
+		}
+
+		mtr_release_blocks_between_savepoints(
+			mtr, savepoint, mtr_set_savepoint(mtr));
+	}
+}
+
 /********************************************************************//**
 Latches the leaf page or pages requested. */
 static
@@ -269,7 +326,6 @@ btr_cur_latch_leaves(
 	mtr_t*		mtr)		/*!< in: mtr */
 {
 	ulint		mode;
-	ulint		left_page_no;
 	ulint		right_page_no;
 	buf_block_t*	get_block;
 
@@ -293,28 +349,8 @@ btr_cur_latch_leaves(
 		mode = latch_mode == BTR_SEARCH_TREE ? RW_S_LATCH : RW_X_LATCH;
 
 		/* x-latch also brothers from left to right */
-		left_page_no = btr_page_get_prev(page, mtr);
-
-		if (left_page_no != FIL_NULL) {
-			get_block = btr_block_get(
-				space, zip_size, left_page_no,
-				mode, cursor->index, mtr);
-#ifdef UNIV_BTR_DEBUG
-			ut_a(page_is_comp(get_block->frame)
-			     == page_is_comp(page));
-			ut_a(btr_page_get_next(get_block->frame, mtr)
-			     == page_get_page_no(page));
-#endif /* UNIV_BTR_DEBUG */
-			get_block->check_index_page_at_flush = TRUE;
-		}
-
-		get_block = btr_block_get(
-			space, zip_size, page_no,
-			mode, cursor->index, mtr);
-#ifdef UNIV_BTR_DEBUG
-		ut_a(page_is_comp(get_block->frame) == page_is_comp(page));
-#endif /* UNIV_BTR_DEBUG */
-		get_block->check_index_page_at_flush = TRUE;
+		btr_cur_latch_left_and_page(page, space, zip_size, page_no,
+					    mode, cursor, mtr);
 
 		right_page_no = btr_page_get_next(page, mtr);
 
@@ -337,34 +373,115 @@ btr_cur_latch_leaves(
 	case BTR_MODIFY_PREV:
 		mode = latch_mode == BTR_SEARCH_PREV ? RW_S_LATCH : RW_X_LATCH;
 		/* latch also left brother */
-		left_page_no = btr_page_get_prev(page, mtr);
+		get_block = btr_cur_latch_left_and_page(
+			page, space, zip_size, page_no, mode, cursor, mtr);
 
-		if (left_page_no != FIL_NULL) {
-			get_block = btr_block_get(
-				space, zip_size,
-				left_page_no, mode, cursor->index, mtr);
+		if (get_block) {
 			cursor->left_block = get_block;
-#ifdef UNIV_BTR_DEBUG
-			ut_a(page_is_comp(get_block->frame)
-			     == page_is_comp(page));
-			ut_a(btr_page_get_next(get_block->frame, mtr)
-			     == page_get_page_no(page));
-#endif /* UNIV_BTR_DEBUG */
-			get_block->check_index_page_at_flush = TRUE;
 		}
 
-		get_block = btr_block_get(
-			space, zip_size, page_no, mode, cursor->index, mtr);
-#ifdef UNIV_BTR_DEBUG
-		ut_a(page_is_comp(get_block->frame) == page_is_comp(page));
-#endif /* UNIV_BTR_DEBUG */
-		get_block->check_index_page_at_flush = TRUE;
 		return;
 	}
 
 	ut_error;
 }
 
+/********************************************************************//**
+Gets the latch that btr_cur_latch_leaves() acquires on the page where the
+search converged.
+@return	RW_S_LATCH or RW_X_LATCH */
+static
+ulint
+btr_cur_leaf_page_latch(
+/*====================*/
+	ulint	latch_mode)	/*!< in: BTR_SEARCH_LEAF, ... */
+{
+	switch (latch_mode) {
+	case BTR_SEARCH_LEAF:
+	case BTR_SEARCH_PREV:
+	case BTR_SEARCH_TREE:
+		return(RW_S_LATCH);
+	default:
+		return(RW_X_LATCH);
+	}
+}
+
+/********************************************************************//**
+Gets an upper bound of the size of a node pointer record of an index.
+@return	maximum size in bytes, or ULINT_UNDEFINED if a node pointer may be
+too big to tell whether a non-leaf page has room for it */
+static
+ulint
+btr_cur_node_ptr_max_size(
+/*======================*/
+	const dict_index_t*	index)	/*!< in: index */
+{
+	ulint	n_fields = dict_index_get_n_unique_in_tree(index);
+	ulint	max_size = page_get_free_space_of_empty(
+		dict_table_is_comp(index->table)) / 2;
+	/* The record header, the field offsets of the old-style format,
+	which are at least as big as the null flags and the field
+	lengths of the compact format, and the child page number */
+	ulint	size = REC_N_OLD_EXTRA_BYTES + 2 * (n_fields + 1)
+		+ REC_NODE_PTR_SIZE;
+
+	for (ulint i = 0; i < n_fields; i++) {
+		const dict_field_t*	field
+			= dict_index_get_nth_field(index, i);
+		ulint			field_size;
+
+		if (field->prefix_len) {
+			field_size = field->prefix_len;
+		} else if (field->fixed_len) {
+			field_size = field->fixed_len;
+		} else {
+			field_size = dict_col_get_max_size(
+				dict_field_get_col(field));
+		}
+
+		if (field_size >= max_size) {
+			return(ULINT_UNDEFINED);
+		}
+
+		size += field_size;
+	}
+
+	return(size < max_size ? size : ULINT_UNDEFINED);
+}
+
+/********************************************************************//**
+Checks if a non-leaf page surely has room for the node pointers that a
+split of its child inserts, so that the split cannot propagate above it.
+As a split may have to split the page once more to fit the record, leave
+room for two node pointers.
+@return	true if the page has room */
+static
+bool
+btr_cur_page_has_room_for_node_ptrs(
+/*================================*/
+	const buf_block_t*	block,		/*!< in: x-latched page */
+	ulint			node_ptr_max_size)/*!< in: see
+					btr_cur_node_ptr_max_size() */
+{
+	const page_t*	page = buf_block_get_frame(block);
+	ulint		max_size;
+
+	if (node_ptr_max_size == ULINT_UNDEFINED
+	    || buf_block_get_page_zip(block)) {
+		/* The insert of a node pointer to a compressed page
+		may fail to compress it whatever its free space */
+		return(false);
+	}
+
+	LIMIT_OPTIMISTIC_INSERT_DEBUG(page_get_n_recs(page) + 1,
+				      return(false));
+
+	max_size = page_get_max_insert_size_after_reorganize(page, 2);
+
+	return(max_size >= 2 * node_ptr_max_size
+	       && max_size >= BTR_CUR_PAGE_REORGANIZE_LIMIT);
+}
+
 /********************************************************************//**
 Searches an index tree and positions a tree cursor on a given level.
 NOTE: n_fields_cmp in tuple must be set so that it cannot be compared
@@ -420,7 +537,12 @@ btr_cur_search_to_nth_level(
 	ulint		low_match;
 	ulint		low_bytes;
 	ulint		savepoint;
+	ulint		tree_savepoint;
+	ulint		parent_savepoint;
+	ulint		block_savepoint;
 	ulint		rw_latch;
+	ulint		upper_rw_latch;
+	ulint		root_rw_latch;
 	ulint		page_mode;
 	ulint		buf_mode;
 	ulint		estimate;
@@ -428,6 +550,8 @@ btr_cur_search_to_nth_level(
 	page_cur_t*	page_cursor;
 	btr_op_t	btr_op;
 	ulint		root_height = 0; /* remove warning */
+	bool		sx_tree = false;
+	ulint		node_ptr_max_size = ULINT_UNDEFINED;
 
 #ifdef BTR_CUR_ADAPT
 	btr_search_t*	info;
@@ -497,12 +621,15 @@ btr_cur_search_to_nth_level(
 
 	estimate = latch_mode & BTR_ESTIMATE;
 
+	const bool	latch_for_insert = latch_mode & BTR_LATCH_FOR_INSERT;
+
 	/* Turn the flags unrelated to the latch mode off. */
 	latch_mode = BTR_LATCH_MODE_WITHOUT_FLAGS(latch_mode);
 
 	ut_ad(!s_latch_by_caller
 	      || latch_mode == BTR_SEARCH_LEAF
 	      || latch_mode == BTR_MODIFY_LEAF);
+	ut_ad(!latch_for_insert || latch_mode == BTR_MODIFY_TREE);
 
 	cursor->flag = BTR_CUR_BINARY;
 	cursor->index = index;
@@ -566,19 +693,42 @@ btr_cur_search_to_nth_level(
 
 	switch (latch_mode) {
 	case BTR_MODIFY_TREE:
-		mtr_x_lock(dict_index_get_lock(index), mtr);
+		if (latch_for_insert && !dict_index_is_ibuf(index)) {
+			/* Let other threads search the tree while we
+			split pages. We x-latch the non-leaf pages that
+			the split may modify on the way down, see below. */
+			mtr_sx_lock(dict_index_get_lock(index), mtr);
+			sx_tree = true;
+			node_ptr_max_size = btr_cur_node_ptr_max_size(index);
+		} else {
+			mtr_x_lock(dict_index_get_lock(index), mtr);
+		}
+		upper_rw_latch = RW_NO_LATCH;
 		break;
 	case BTR_CONT_MODIFY_TREE:
 		/* Do nothing */
 		ut_ad(mtr_memo_contains(mtr, dict_index_get_lock(index),
-					MTR_MEMO_X_LOCK));
+					MTR_MEMO_X_LOCK)
+		      || mtr_memo_contains(mtr, dict_index_get_lock(index),
+					   MTR_MEMO_SX_LOCK));
+		upper_rw_latch = RW_NO_LATCH;
 		break;
 	default:
 		if (!s_latch_by_caller) {
 			mtr_s_lock(dict_index_get_lock(index), mtr);
 		}
+
+		/* A thread that holds an sx-latch on the index tree may
+		split the non-leaf pages: s-latch them, and release the
+		latch on each page once its child is latched. The insert
+		buffer tree is never sx-latched. */
+		upper_rw_latch = dict_index_is_ibuf(index)
+			? RW_NO_LATCH : RW_S_LATCH;
 	}
 
+	root_rw_latch = upper_rw_latch;
+	tree_savepoint = parent_savepoint = mtr_set_savepoint(mtr);
+
 	page_cursor = btr_cur_get_page_cur(cursor);
 
 	space = dict_index_get_space(index);
@@ -618,9 +768,16 @@ btr_cur_search_to_nth_level(
 search_loop:
 	buf_mode = BUF_GET;
 	rw_latch = RW_NO_LATCH;
-
-	if (height != 0) {
-		/* We are about to fetch the root or a non-leaf page. */
+	block_savepoint = mtr_set_savepoint(mtr);
+
+	if (height == ULINT_UNDEFINED) {
+		/* We are about to fetch the root page. */
+		rw_latch = root_rw_latch;
+	} else if (height != 0) {
+		/* We are about to fetch a non-leaf page. If the search
+		ends on it, we x-latch it, see below. */
+		rw_latch = height != level || upper_rw_latch == RW_NO_LATCH
+			? upper_rw_latch : RW_X_LATCH;
 	} else if (latch_mode <= BTR_MODIFY_LEAF) {
 		rw_latch = latch_mode;
 
@@ -746,6 +903,49 @@ retry_page_get:
 			info->root_guess = block;
 		}
 #endif
+
+		if (height == level && rw_latch != RW_NO_LATCH) {
+			/* The search ends on the root page, which we
+			latched as a non-leaf page. If the latch does
+			not suffice, latch the root page again. It may
+			have been split meanwhile, but then we simply
+			go on searching with a stronger latch on it. */
+			ulint	target_rw_latch = level == 0
+				? btr_cur_leaf_page_latch(latch_mode)
+				: RW_X_LATCH;
+
+			if (rw_latch != target_rw_latch) {
+				ut_ad(rw_latch == RW_S_LATCH);
+				ut_ad(root_rw_latch == upper_rw_latch);
+
+				mtr_release_blocks_between_savepoints(
+					mtr, block_savepoint,
+					mtr_set_savepoint(mtr));
+
+				root_rw_latch = target_rw_latch;
+				height = ULINT_UNDEFINED;
+				guess = NULL;
+				goto search_loop;
+			}
+		}
+	}
+
+	if (sx_tree && height != 0) {
+		/* A split of the child page may split this page, and
+		modify its neighbors: x-latch them from left to right */
+		ut_ad(rw_latch == RW_NO_LATCH);
+
+		btr_cur_latch_leaves(
+			page, space, zip_size, page_no, BTR_MODIFY_TREE,
+			cursor, mtr);
+
+		if (btr_cur_page_has_room_for_node_ptrs(
+			    block, node_ptr_max_size)) {
+			/* A split below cannot split this page or
+			modify the pages above it: release them. */
+			mtr_release_blocks_between_savepoints(
+				mtr, tree_savepoint, block_savepoint);
+		}
 	}
 
 	if (height == 0) {
@@ -772,6 +972,13 @@ retry_page_get:
 		page_mode = mode;
 	}
 
+	if (upper_rw_latch == RW_S_LATCH) {
+		/* Release the latch on the parent page */
+		mtr_release_blocks_between_savepoints(
+			mtr, parent_savepoint, block_savepoint);
+		parent_savepoint = block_savepoint;
+	}
+
 	page_cur_search_with_match(
 		block, index, tuple, page_mode, &up_match, &up_bytes,
 		&low_match, &low_bytes, page_cursor);
@@ -883,6 +1090,9 @@ btr_cur_open_at_index_side_func(
 	rec_t*		node_ptr;
 	ulint		estimate;
 	ulint		savepoint;
+	ulint		parent_savepoint;
+	ulint		upper_rw_latch;
+	ulint		root_rw_latch;
 	mem_heap_t*	heap		= NULL;
 	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
 	ulint*		offsets		= offsets_;
@@ -900,19 +1110,32 @@ btr_cur_open_at_index_side_func(
 
 	switch (latch_mode) {
 	case BTR_CONT_MODIFY_TREE:
+		upper_rw_latch = RW_NO_LATCH;
 		break;
 	case BTR_MODIFY_TREE:
 		mtr_x_lock(dict_index_get_lock(index), mtr);
+		upper_rw_latch = RW_NO_LATCH;
 		break;
 	case BTR_SEARCH_LEAF | BTR_ALREADY_S_LATCHED:
 	case BTR_MODIFY_LEAF | BTR_ALREADY_S_LATCHED:
 		ut_ad(mtr_memo_contains(mtr, dict_index_get_lock(index),
 					MTR_MEMO_S_LOCK));
-		break;
+		/* fall through */
 	default:
-		mtr_s_lock(dict_index_get_lock(index), mtr);
+		if (!(latch_mode & BTR_ALREADY_S_LATCHED)) {
+			mtr_s_lock(dict_index_get_lock(index), mtr);
+		}
+
+		/* S-latch the non-leaf pages that a thread holding an
+		sx-latch on the index tree may split, as in
+		btr_cur_search_to_nth_level() */
+		upper_rw_latch = dict_index_is_ibuf(index)
+			? RW_NO_LATCH : RW_S_LATCH;
 	}
 
+	root_rw_latch = upper_rw_latch;
+	parent_savepoint = mtr_set_savepoint(mtr);
+
 	page_cursor = btr_cur_get_page_cur(cursor);
 	cursor->index = index;
 
@@ -925,8 +1148,19 @@ btr_cur_open_at_index_side_func(
 	for (;;) {
 		buf_block_t*	block;
 		page_t*		page;
+		ulint		block_savepoint = mtr_set_savepoint(mtr);
+		ulint		rw_latch;
+
+		if (height == ULINT_UNDEFINED) {
+			rw_latch = root_rw_latch;
+		} else if (height != level) {
+			rw_latch = upper_rw_latch;
+		} else {
+			rw_latch = RW_NO_LATCH;
+		}
+
 		block = buf_page_get_gen(space, zip_size, page_no,
-					 RW_NO_LATCH, NULL, BUF_GET,
+					 rw_latch, NULL, BUF_GET,
 					 file, line, mtr);
 		page = buf_block_get_frame(block);
 		ut_ad(fil_page_get_type(page) == FIL_PAGE_INDEX);
@@ -934,22 +1168,43 @@ btr_cur_open_at_index_side_func(
 
 		block->check_index_page_at_flush = TRUE;
 
+		if (rw_latch != RW_NO_LATCH) {
+			buf_block_dbg_add_level(block, SYNC_TREE_NODE);
+		}
+
 		if (height == ULINT_UNDEFINED) {
 			/* We are in the root node */
 
 			height = btr_page_get_level(page, mtr);
 			root_height = height;
 			ut_a(height >= level);
+
+			if (height == level && rw_latch != RW_NO_LATCH
+			    && rw_latch != btr_cur_leaf_page_latch(
+				    latch_mode & ~BTR_ALREADY_S_LATCHED)) {
+				/* Latch the root page again the way
+				btr_cur_latch_leaves() would */
+				mtr_release_blocks_between_savepoints(
+					mtr, block_savepoint,
+					mtr_set_savepoint(mtr));
+
+				root_rw_latch = btr_cur_leaf_page_latch(
+					latch_mode & ~BTR_ALREADY_S_LATCHED);
+				height = ULINT_UNDEFINED;
+				continue;
+			}
 		} else {
 			/* TODO: flag the index corrupted if this fails */
 			ut_ad(height == btr_page_get_level(page, mtr));
 		}
 
 		if (height == level) {
-			btr_cur_latch_leaves(
-				page, space, zip_size, page_no,
-				latch_mode & ~BTR_ALREADY_S_LATCHED,
-				cursor, mtr);
+			if (rw_latch == RW_NO_LATCH) {
+				btr_cur_latch_leaves(
+					page, space, zip_size, page_no,
+					latch_mode & ~BTR_ALREADY_S_LATCHED,
+					cursor, mtr);
+			}
 
 			if (height == 0) {
 				/* In versions <= 3.23.52 we had
@@ -976,6 +1231,13 @@ btr_cur_open_at_index_side_func(
 			}
 		}
 
+		if (upper_rw_latch == RW_S_LATCH) {
+			/* Release the latch on the parent page */
+			mtr_release_blocks_between_savepoints(
+				mtr, parent_savepoint, block_savepoint);
+			parent_savepoint = block_savepoint;
+		}
+
 		if (from_left) {
 			page_cur_set_before_first(block, page_cursor);
 		} else {
@@ -1036,6 +1298,9 @@ btr_cur_open_at_rnd_pos_func(
 	ulint		zip_size;
 	ulint		height;
 	rec_t*		node_ptr;
+	ulint		parent_savepoint;
+	ulint		upper_rw_latch;
+	ulint		root_rw_latch;
 	mem_heap_t*	heap		= NULL;
 	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
 	ulint*		offsets		= offsets_;
@@ -1044,12 +1309,22 @@ btr_cur_open_at_rnd_pos_func(
 	switch (latch_mode) {
 	case BTR_MODIFY_TREE:
 		mtr_x_lock(dict_index_get_lock(index), mtr);
+		upper_rw_latch = RW_NO_LATCH;
 		break;
 	default:
 		ut_ad(latch_mode != BTR_CONT_MODIFY_TREE);
 		mtr_s_lock(dict_index_get_lock(index), mtr);
+
+		/* S-latch the non-leaf pages that a thread holding an
+		sx-latch on the index tree may split, as in
+		btr_cur_search_to_nth_level() */
+		upper_rw_latch = dict_index_is_ibuf(index)
+			? RW_NO_LATCH : RW_S_LATCH;
 	}
 
+	root_rw_latch = upper_rw_latch;
+	parent_savepoint = mtr_set_savepoint(mtr);
+
 	page_cursor = btr_cur_get_page_cur(cursor);
 	cursor->index = index;
 
@@ -1062,25 +1337,61 @@ btr_cur_open_at_rnd_pos_func(
 	for (;;) {
 		buf_block_t*	block;
 		page_t*		page;
+		ulint		block_savepoint = mtr_set_savepoint(mtr);
+		ulint		rw_latch;
+
+		if (height == ULINT_UNDEFINED) {
+			rw_latch = root_rw_latch;
+		} else if (height != 0) {
+			rw_latch = upper_rw_latch;
+		} else {
+			rw_latch = RW_NO_LATCH;
+		}
 
 		block = buf_page_get_gen(space, zip_size, page_no,
-					 RW_NO_LATCH, NULL, BUF_GET,
+					 rw_latch, NULL, BUF_GET,
 					 file, line, mtr);
 		page = buf_block_get_frame(block);
 		ut_ad(fil_page_get_type(page) == FIL_PAGE_INDEX);
 		ut_ad(index->id == btr_page_get_index_id(page));
 
+		if (rw_latch != RW_NO_LATCH) {
+			buf_block_dbg_add_level(block, SYNC_TREE_NODE);
+		}
+
 		if (height == ULINT_UNDEFINED) {
 			/* We are in the root node */
 
 			height = btr_page_get_level(page, mtr);
+
+			if (height == 0 && rw_latch != RW_NO_LATCH
+			    && rw_latch != btr_cur_leaf_page_latch(
+				    latch_mode)) {
+				/* Latch the root page again the way
+				btr_cur_latch_leaves() would */
+				mtr_release_blocks_between_savepoints(
+					mtr, block_savepoint,
+					mtr_set_savepoint(mtr));
+
+				root_rw_latch = btr_cur_leaf_page_latch(
+					latch_mode);
+				height = ULINT_UNDEFINED;
+				continue;
+			}
 		}
 
-		if (height == 0) {
+		if (height == 0 && rw_latch == RW_NO_LATCH) {
 			btr_cur_latch_leaves(page, space, zip_size, page_no,
 					     latch_mode, cursor, mtr);
 		}
 
+		if (upper_rw_latch == RW_S_LATCH) {
+			/* Release the latch on the parent page */
+			mtr_release_blocks_between_savepoints(
+				mtr, parent_savepoint, block_savepoint);
+			parent_savepoint = block_savepoint;
+		}
+
 		page_cur_open_on_rnd_user_rec(block, page_cursor);
 
 		if (height == 0) {
@@ -1580,7 +1891,9 @@ btr_cur_pessimistic_insert(
 	*big_rec = NULL;
 
 	ut_ad((thr && thr_get_trx(thr)->fake_changes) || mtr_memo_contains(mtr,
-				dict_index_get_lock(btr_cur_get_index(cursor)), MTR_MEMO_X_LOCK));
+				dict_index_get_lock(btr_cur_get_index(cursor)), MTR_MEMO_X_LOCK)
+	      || mtr_memo_contains(mtr, dict_index_get_lock(index),
+				   MTR_MEMO_SX_LOCK));
 	ut_ad((thr && thr_get_trx(thr)->fake_changes) || mtr_memo_contains(mtr,
 				btr_cur_get_block(cursor), MTR_MEMO_PAGE_X_FIX));
 	ut_ad(!dict_index_is_online_ddl(index)
@@ -5303,6 +5616,69 @@ btr_rec_free_updated_extern_fields(
 	}
 }
 
+/*******************************************************************//**
+Reads ahead the pages of a BLOB that btr_copy_blob_prefix() or
+btr_copy_zblob_prefix() is going to read, when the next page of the BLOB
+is not in the buffer pool and was not covered by an earlier read-ahead of
+the same copy. Only the pages that are needed for the remaining len bytes
+are read; for compressed BLOBs this is an upper bound. */
+static
+void
+btr_blob_read_ahead(
+/*================*/
+	ulint	space_id,	/*!< in: space id of the BLOB pages */
+	ulint	zip_size,	/*!< in: compressed BLOB page size, or 0 */
+	ulint	page_no,	/*!< in: next BLOB page to read */
+	ulint	offset,		/*!< in: offset of the BLOB data on the
+				page */
+	ulint	len,		/*!< in: number of bytes left to copy */
+	ulint*	ra_low,		/*!< in/out: first page read ahead by
+				the previous call */
+	ulint*	ra_high,	/*!< in/out: end of the pages read ahead
+				by the previous call */
+	trx_t*	trx)		/*!< in: transaction handle, or NULL */
+{
+	ulint	page_size;
+	ulint	first_len;
+	ulint	part_len;
+	ulint	n_pages;
+
+	if (page_no >= *ra_low && page_no < *ra_high) {
+		srv_stats.n_blob_read_ahead_hits.inc();
+		return;
+	}
+
+	if (srv_blob_read_ahead_pages < 2
+	    || buf_page_peek(space_id, page_no)) {
+		return;
+	}
+
+	page_size = zip_size ? zip_size : UNIV_PAGE_SIZE;
+	part_len = page_size - FIL_PAGE_DATA - BTR_BLOB_HDR_SIZE
+		- FIL_PAGE_DATA_END;
+	first_len = page_size - offset - BTR_BLOB_HDR_SIZE
+		- FIL_PAGE_DATA_END;
+
+	n_pages = 1;
+
+	if (len > first_len) {
+		n_pages += (len - first_len + part_len - 1) / part_len;
+	}
+
+	if (n_pages > srv_blob_read_ahead_pages) {
+		n_pages = srv_blob_read_ahead_pages;
+	}
+
+	if (n_pages < 2) {
+		return;
+	}
+
+	buf_read_ahead_blob(space_id, zip_size, page_no, n_pages, trx);
+
+	*ra_low = page_no + 1;
+	*ra_high = page_no + n_pages;
+}
+
 /*******************************************************************//**
 Copies the prefix of an uncompressed BLOB.  The clustered index record
 that points to this BLOB must be protected by a lock or a page latch.
@@ -5320,6 +5696,8 @@ btr_copy_blob_prefix(
 	trx_t*		trx)	/*!< in: transaction handle */
 {
 	ulint	copied_len	= 0;
+	ulint	ra_low		= 0;
+	ulint	ra_high		= 0;
 
 	for (;;) {
 		mtr_t		mtr;
@@ -5329,6 +5707,9 @@ btr_copy_blob_prefix(
 		ulint		part_len;
 		ulint		copy_len;
 
+		btr_blob_read_ahead(space_id, 0, page_no, offset,
+				    len - copied_len, &ra_low, &ra_high, trx);
+
 		mtr_start_trx(&mtr, trx);
 
 		block = buf_page_get(space_id, 0, page_no, RW_S_LATCH, &mtr);
@@ -5384,6 +5765,8 @@ btr_copy_zblob_prefix(
 	int		err;
 	z_stream	d_stream;
 	ibool		inflate_inited = FALSE;
+	ulint		ra_low = 0;
+	ulint		ra_high = 0;
 
 	d_stream.next_out = buf;
 	d_stream.avail_out = len;
@@ -5407,6 +5790,10 @@ btr_copy_zblob_prefix(
 		buf_page_t*	bpage;
 		ulint		next_page_no;
 
+		btr_blob_read_ahead(space_id, zip_size, page_no, offset,
+				    d_stream.avail_out, &ra_low, &ra_high,
+				    NULL);
+
 		/* There is no latch on bpage directly.  Instead,
 		bpage is protected by the B-tree page latch that
 		is being held on the clustered index record, or,
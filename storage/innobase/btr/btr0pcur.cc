@@ -171,6 +171,7 @@ btr_pcur_store_position(
 
 	cursor->block_when_stored = block;
 	cursor->modify_clock = buf_block_get_modify_clock(block);
+	cursor->withdraw_clock = buf_withdraw_clock;
 }
 
 /**************************************************************//**
@@ -281,9 +282,11 @@ btr_pcur_restore_position_func(
 #endif
 	    && (UNIV_LIKELY(latch_mode == BTR_SEARCH_LEAF)
 	    || UNIV_LIKELY(latch_mode == BTR_MODIFY_LEAF))) {
-		/* Try optimistic restoration */
+		/* Try optimistic restoration, unless a buffer pool
+		resize may have freed the stored block */
 
-		if (UNIV_LIKELY(buf_page_optimistic_get(
+		if (!buf_pool_is_obsolete(cursor->withdraw_clock)
+		    && UNIV_LIKELY(buf_page_optimistic_get(
 					latch_mode,
 					cursor->block_when_stored,
 					cursor->modify_clock,
@@ -378,6 +381,7 @@ btr_pcur_restore_position_func(
 			cursor->modify_clock =
 				buf_block_get_modify_clock(
 					cursor->block_when_stored);
+			cursor->withdraw_clock = buf_withdraw_clock;
 			cursor->old_stored = BTR_PCUR_OLD_STORED;
 
 			mem_heap_free(heap);
@@ -199,6 +199,33 @@ btr_search_sys_free(void)
 	btr_search_sys = NULL;
 }
 
+/*****************************************************************//**
+Recreates the hash table of the adaptive search system with a new size
+after a buffer pool resize. Does nothing if the adaptive hash index has
+been enabled meanwhile. */
+UNIV_INTERN
+void
+btr_search_sys_resize(
+/*==================*/
+	ulint	hash_size)	/*!< in: hash index hash table size */
+{
+	rw_lock_x_lock(&btr_search_latch);
+
+	if (!btr_search_enabled) {
+		/* btr_search_disable() emptied the hash table. */
+		mem_heap_free(btr_search_sys->hash_index->heap);
+		hash_table_free(btr_search_sys->hash_index);
+
+		btr_search_sys->hash_index = ha_create(
+			hash_size, 0, MEM_HEAP_FOR_BTR_SEARCH, 0);
+#if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
+		btr_search_sys->hash_index->adaptive = TRUE;
+#endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
+	}
+
+	rw_lock_x_unlock(&btr_search_latch);
+}
+
 /********************************************************************//**
 Set index->ref_count = 0 on all indexes of a table. */
 static
@@ -324,6 +324,16 @@ buf_buddy_alloc_zip(
 
 	buf = UT_LIST_GET_FIRST(buf_pool->zip_free[i]);
 
+	if (UNIV_UNLIKELY(buf_pool_withdrawing)) {
+		/* Do not hand out the memory of the chunks that
+		are being removed. */
+		while (buf != NULL
+		       && buf_frame_will_withdrawn(
+			       buf_pool, reinterpret_cast<byte*>(buf))) {
+			buf = UT_LIST_GET_NEXT(list, buf);
+		}
+	}
+
 	if (buf) {
 		buf_buddy_remove_from_free(buf_pool, buf, i);
 	} else if (i + 1 < BUF_BUDDY_SIZES) {
@@ -639,8 +649,11 @@ recombine:
 
 	/* Do not recombine blocks if there are few free blocks.
 	We may waste up to 15360*max_len bytes to free blocks
-	(1024 + 2048 + 4096 + 8192 = 15360) */
-	if (UT_LIST_GET_LEN(buf_pool->zip_free[i]) < 16) {
+	(1024 + 2048 + 4096 + 8192 = 15360). While the buffer pool
+	is being shrunk, recombine whenever possible, so that the
+	frames of the removed chunks can be freed. */
+	if (UT_LIST_GET_LEN(buf_pool->zip_free[i]) < 16
+	    && !buf_pool_withdrawing) {
 		goto func_exit;
 	}
 
@@ -696,3 +709,128 @@ func_exit:
 			      reinterpret_cast<buf_buddy_free_t*>(buf),
 			      i);
 }
+
+/**********************************************************************//**
+Moves a compressed page frame that was allocated from the buddy system
+out of the chunks that a buffer pool resize is removing. The thread
+calling this function must hold buf_pool->mutex and must not hold
+buf_pool->zip_mutex or any block->mutex.
+@return	false if there was no free block to move the frame to */
+UNIV_INTERN
+bool
+buf_buddy_realloc(
+/*==============*/
+	buf_pool_t*	buf_pool,	/*!< in/out: buffer pool instance */
+	void*		buf,		/*!< in: allocated block */
+	ulint		size)		/*!< in: block size,
+					up to UNIV_PAGE_SIZE */
+{
+	buf_block_t*	block = NULL;
+	ulint		i = buf_buddy_get_slot(size);
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+	ut_ad(!mutex_own(&buf_pool->zip_mutex));
+	ut_ad(i <= BUF_BUDDY_SIZES);
+	ut_ad(i >= buf_buddy_get_slot(UNIV_ZIP_SIZE_MIN));
+
+	if (i < BUF_BUDDY_SIZES) {
+		/* Try to allocate from the buddy system. */
+		block = reinterpret_cast<buf_block_t*>(
+			buf_buddy_alloc_zip(buf_pool, i));
+	}
+
+	if (block == NULL) {
+		/* Try allocating from the buf_pool->free list. */
+		block = buf_LRU_get_free_only(buf_pool);
+
+		if (block == NULL) {
+			return(false);
+		}
+
+		buf_buddy_block_register(block);
+
+		block = reinterpret_cast<buf_block_t*>(
+			buf_buddy_alloc_from(
+				buf_pool, block->frame, i, BUF_BUDDY_SIZES));
+	}
+
+	buf_pool->buddy_stat[i].used++;
+
+	/* Try to relocate the page frame to the new block. Free
+	whichever of the two ends up unused. */
+	if (buf_buddy_relocate(buf_pool, buf, block, i)) {
+		buf_buddy_free_low(buf_pool, buf, i);
+	} else {
+		buf_buddy_free_low(buf_pool, block, i);
+	}
+
+	return(true);
+}
+
+/**********************************************************************//**
+Combines the free buddies in the chunks that a buffer pool resize is
+removing, so that whole frames can be returned to the buffer pool. */
+UNIV_INTERN
+void
+buf_buddy_condense_free(
+/*====================*/
+	buf_pool_t*	buf_pool)	/*!< in/out: buffer pool instance */
+{
+	ut_ad(buf_pool_mutex_own(buf_pool));
+	ut_ad(buf_pool_withdrawing);
+
+	for (ulint i = buf_buddy_get_slot(UNIV_ZIP_SIZE_MIN);
+	     i < BUF_BUDDY_SIZES; ++i) {
+		buf_buddy_free_t* buf =
+			UT_LIST_GET_FIRST(buf_pool->zip_free[i]);
+
+		/* Seek to the first free block to be withdrawn. */
+		while (buf != NULL
+		       && !buf_frame_will_withdrawn(
+			       buf_pool, reinterpret_cast<byte*>(buf))) {
+			buf = UT_LIST_GET_NEXT(list, buf);
+		}
+
+		while (buf != NULL) {
+			buf_buddy_free_t* next =
+				UT_LIST_GET_NEXT(list, buf);
+
+			buf_buddy_free_t* buddy =
+				reinterpret_cast<buf_buddy_free_t*>(
+					buf_buddy_get(
+						reinterpret_cast<byte*>(buf),
+						BUF_BUDDY_LOW << i));
+
+			/* Seek to the next free block to be withdrawn
+			that is not the buddy, because the buddy will
+			be removed from the list by the recombining. */
+			for (;;) {
+				while (next != NULL
+				       && !buf_frame_will_withdrawn(
+					       buf_pool,
+					       reinterpret_cast<byte*>(
+						       next))) {
+					next = UT_LIST_GET_NEXT(list, next);
+				}
+
+				if (buddy != next) {
+					break;
+				}
+
+				next = UT_LIST_GET_NEXT(list, next);
+			}
+
+			if (buf_buddy_is_free(buddy, i)
+			    == BUF_BUDDY_STATE_FREE) {
+				/* Both buf and buddy are free.
+				Try to combine them. */
+				buf_buddy_remove_from_free(buf_pool, buf, i);
+				buf_pool->buddy_stat[i].used++;
+
+				buf_buddy_free_low(buf_pool, buf, i);
+			}
+
+			buf = next;
+		}
+	}
+}
@@ -48,6 +48,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "log0log.h"
 #endif /* !UNIV_HOTBACKUP */
 #include "srv0srv.h"
+#include "srv0start.h"
 #include "dict0dict.h"
 #include "log0recv.h"
 #include "page0zip.h"
@@ -240,6 +241,26 @@ of its random access area (for instance, 32 consecutive pages
 in a tablespace) have recently been referenced, we may predict
 that the whole area may be needed in the near future, and issue
 the read requests for the whole area.
+
+		Resizing the buffer pool
+		------------------------
+
+Each buffer pool instance consists of chunks of
+innodb_buffer_pool_chunk_size bytes, and changing
+innodb_buffer_pool_size adds or removes chunks at the end of
+buf_pool->chunks[] while the server is running.  The resize is done
+by buf_resize_thread.  To remove chunks, it first withdraws all
+their blocks: while buf_pool_withdrawing is set, free blocks of
+those chunks are moved to buf_pool->withdraw instead of being
+handed out, and the pages and buddy allocations that the chunks hold
+are flushed, evicted or copied to blocks of the remaining chunks.
+Only then all the buffer pool mutexes and page_hash latches are
+held for a short while to replace the chunks array and to resize
+page_hash and zip_hash; a thread that looks up the page_hash lock
+without holding buf_pool->mutex must confirm it after acquiring it,
+because the lock of a page depends on the size of page_hash.  Stored
+block pointers that are not protected by a latch or a buffer-fix
+are checked with buf_pool_is_obsolete() before they are used.
 */
 
 #ifndef UNIV_HOTBACKUP
@@ -251,6 +272,18 @@ static const ulint BUF_PAGE_READ_MAX_RETRIES = 100;
 /** The buffer pools of the database */
 UNIV_INTERN buf_pool_t*	buf_pool_ptr;
 
+/** true while the blocks of the chunks that are being removed by a
+buffer pool resize are withdrawn from the free list */
+UNIV_INTERN volatile bool	buf_pool_withdrawing;
+
+/** Incremented whenever a buffer pool resize freed the memory of some
+blocks */
+UNIV_INTERN volatile ulint	buf_withdraw_clock;
+
+/** Number of rounds of buf_pool_withdraw_blocks() before a resize
+reports that the blocks could not be withdrawn yet and retries */
+static const ulint BUF_POOL_WITHDRAW_MAX_LOOPS = 10;
+
 #if defined UNIV_DEBUG || defined UNIV_BUF_DEBUG
 static ulint	buf_dbg_counter	= 0; /*!< This is used to insert validation
 					operations in execution in the
@@ -1086,7 +1119,8 @@ buf_block_init(
 }
 
 /********************************************************************//**
-Allocates a chunk of buffer frames.
+Allocates a chunk of buffer frames. The blocks are not added to the
+free list; see buf_chunk_add_to_free().
 @return	chunk, or NULL on failure */
 static
 buf_chunk_t*
@@ -1151,10 +1185,6 @@ buf_chunk_init(
 		buf_block_init(buf_pool, block, frame);
 		UNIV_MEM_INVALID(block->frame, UNIV_PAGE_SIZE);
 
-		/* Add the block to the free list */
-		UT_LIST_ADD_LAST(list, buf_pool->free, (&block->page));
-
-		ut_d(block->page.in_free_list = TRUE);
 		ut_ad(buf_pool_from_block(block) == buf_pool);
 
 		block++;
@@ -1167,6 +1197,50 @@ buf_chunk_init(
 	return(chunk);
 }
 
+/********************************************************************//**
+Adds the blocks of a chunk that was allocated by buf_chunk_init() to
+the free list. */
+static
+void
+buf_chunk_add_to_free(
+/*==================*/
+	buf_pool_t*	buf_pool,	/*!< in/out: buffer pool instance */
+	buf_chunk_t*	chunk)		/*!< in: chunk of buffers */
+{
+	buf_block_t*	block = chunk->blocks;
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+
+	for (ulint i = chunk->size; i--; block++) {
+		ut_ad(buf_block_get_state(block) == BUF_BLOCK_NOT_USED);
+
+		UT_LIST_ADD_LAST(list, buf_pool->free, (&block->page));
+		ut_d(block->page.in_free_list = TRUE);
+	}
+}
+
+/********************************************************************//**
+Frees the latches and the memory of a chunk whose blocks are not in use
+any more. */
+static
+void
+buf_chunk_free(
+/*===========*/
+	buf_chunk_t*	chunk)		/*!< in/out: chunk of buffers */
+{
+	buf_block_t*	block = chunk->blocks;
+
+	for (ulint i = chunk->size; i--; block++) {
+		mutex_free(&block->mutex);
+		rw_lock_free(&block->lock);
+#ifdef UNIV_SYNC_DEBUG
+		rw_lock_free(&block->debug_latch);
+#endif /* UNIV_SYNC_DEBUG */
+	}
+
+	os_mem_free_large(chunk->mem, chunk->mem_size);
+}
+
 #ifdef UNIV_DEBUG
 /*********************************************************************//**
 Finds a block in the given buffer chunk that points to a
@@ -1321,27 +1395,45 @@ buf_pool_init_instance(
 	buf_pool_mutex_enter(buf_pool);
 
 	if (buf_pool_size > 0) {
-		buf_pool->n_chunks = 1;
+		ulint	n_chunks = buf_pool_size / srv_buf_pool_chunk_unit;
+
+		ut_a(n_chunks > 0);
 
 		buf_pool->chunks = chunk =
-			(buf_chunk_t*) mem_zalloc(sizeof *chunk);
+			(buf_chunk_t*) mem_zalloc(n_chunks * sizeof *chunk);
 
 		UT_LIST_INIT(buf_pool->free);
+		UT_LIST_INIT(buf_pool->withdraw);
 		UT_LIST_INIT(buf_pool->buf_malloc_cache);
 
-		if (!buf_chunk_init(buf_pool, chunk, buf_pool_size)) {
-			mem_free(chunk);
-			mem_free(buf_pool);
+		buf_pool->curr_size = 0;
 
-			buf_pool_mutex_exit(buf_pool);
+		for (buf_pool->n_chunks = 0; buf_pool->n_chunks < n_chunks;
+		     buf_pool->n_chunks++, chunk++) {
 
-			return(DB_ERROR);
+			if (!buf_chunk_init(buf_pool, chunk,
+					    srv_buf_pool_chunk_unit)) {
+
+				while (--chunk >= buf_pool->chunks) {
+					buf_chunk_free(chunk);
+				}
+
+				mem_free(buf_pool->chunks);
+
+				buf_pool_mutex_exit(buf_pool);
+
+				return(DB_ERROR);
+			}
+
+			buf_chunk_add_to_free(buf_pool, chunk);
+			buf_pool->curr_size += chunk->size;
 		}
 
+		buf_pool->n_chunks_new = buf_pool->n_chunks;
 		buf_pool->instance_no = instance_no;
 		buf_pool->old_pool_size = buf_pool_size;
-		buf_pool->curr_size = chunk->size;
 		buf_pool->curr_pool_size = buf_pool->curr_size * UNIV_PAGE_SIZE;
+		buf_pool->old_size = buf_pool->curr_size;
 
 		/* Number of locks protecting page_hash must be a
 		power of two */
@@ -1447,6 +1539,11 @@ buf_pool_free_instance(
 	}
 
 	mem_free(buf_pool->chunks);
+
+	if (buf_pool->chunks_old != NULL) {
+		mem_free(buf_pool->chunks_old);
+	}
+
 	ha_clear(buf_pool->page_hash);
 	hash_table_free(buf_pool->page_hash);
 	hash_table_free(buf_pool->zip_hash);
@@ -1565,7 +1662,10 @@ buf_relocate(
 /*=========*/
 	buf_page_t*	bpage,	/*!< in/out: control block being relocated;
 				buf_page_get_state(bpage) must be
-				BUF_BLOCK_ZIP_DIRTY or BUF_BLOCK_ZIP_PAGE */
+				BUF_BLOCK_ZIP_DIRTY or BUF_BLOCK_ZIP_PAGE,
+				or BUF_BLOCK_FILE_PAGE when a buffer
+				pool resize moves the page out of a
+				chunk that is being removed */
 	buf_page_t*	dpage)	/*!< in/out: destination control block */
 {
 	buf_page_t*	b;
@@ -1593,10 +1693,12 @@ buf_relocate(
 	case BUF_BLOCK_POOL_WATCH:
 	case BUF_BLOCK_NOT_USED:
 	case BUF_BLOCK_READY_FOR_USE:
-	case BUF_BLOCK_FILE_PAGE:
 	case BUF_BLOCK_MEMORY:
 	case BUF_BLOCK_REMOVE_HASH:
 		ut_error;
+	case BUF_BLOCK_FILE_PAGE:
+		ut_ad(buf_pool_withdrawing);
+		break;
 	case BUF_BLOCK_ZIP_DIRTY:
 	case BUF_BLOCK_ZIP_PAGE:
 		break;
@@ -1726,6 +1828,9 @@ page_found:
 	buf_pool_mutex_enter(buf_pool);
 	hash_lock_x_all(buf_pool->page_hash);
 
+	/* The page_hash may have been resized meanwhile. */
+	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
+
 	/* We have to recheck that the page
 	was not loaded or a watch set by some other
 	purge thread. This is because of the small
@@ -1835,8 +1940,7 @@ buf_pool_watch_unset(
 	buf_page_t*	bpage;
 	buf_pool_t*	buf_pool = buf_pool_get(space, offset);
 	ulint		fold = buf_page_address_fold(space, offset);
-	rw_lock_t*	hash_lock = buf_page_hash_lock_get(buf_pool,
-							     fold);
+	rw_lock_t*	hash_lock;
 
 	/* We only need to have buf_pool mutex in case where we end
 	up calling buf_pool_watch_remove but to obey latching order
@@ -1845,6 +1949,9 @@ buf_pool_watch_unset(
 	called from the purge thread. */
 	buf_pool_mutex_enter(buf_pool);
 
+	/* The page_hash cannot be resized while we hold
+	buf_pool->mutex. */
+	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 	rw_lock_x_lock(hash_lock);
 
 	bpage = buf_page_hash_get_low(buf_pool, space, offset, fold);
@@ -1892,6 +1999,9 @@ buf_pool_watch_occurred(
 
 	rw_lock_s_lock(hash_lock);
 
+	/* The page_hash may have been resized meanwhile. */
+	hash_lock = hash_lock_s_confirm(hash_lock, buf_pool->page_hash, fold);
+
 	bpage = buf_page_hash_get_low(buf_pool, space, offset, fold);
 	/* The page must exist because buf_pool_watch_set()
 	increments buf_fix_count. */
@@ -2225,6 +2335,724 @@ buf_block_init_low(
 	block->left_side	= TRUE;
 	block->db_stats_index = 0;
 }
+
+/********************************************************************//**
+Determines if a block belongs to a chunk that is being removed by a
+buffer pool resize.
+@return	true if the block will be withdrawn */
+UNIV_INTERN
+bool
+buf_block_will_withdrawn(
+/*=====================*/
+	buf_pool_t*		buf_pool,	/*!< in: buffer pool instance */
+	const buf_block_t*	block)		/*!< in: block */
+{
+	const buf_chunk_t*	chunk;
+	const buf_chunk_t*	echunk;
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+	ut_ad(buf_pool_withdrawing);
+
+	chunk = buf_pool->chunks + buf_pool->n_chunks_new;
+	echunk = buf_pool->chunks + buf_pool->n_chunks;
+
+	for (; chunk < echunk; chunk++) {
+		if (block >= chunk->blocks
+		    && block < chunk->blocks + chunk->size) {
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/********************************************************************//**
+Determines if a frame or a part of a frame belongs to a chunk that is
+being removed by a buffer pool resize.
+@return	true if the frame will be withdrawn */
+UNIV_INTERN
+bool
+buf_frame_will_withdrawn(
+/*=====================*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	const byte*	ptr)		/*!< in: pointer within a frame */
+{
+	const buf_chunk_t*	chunk;
+	const buf_chunk_t*	echunk;
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+	ut_ad(buf_pool_withdrawing);
+
+	chunk = buf_pool->chunks + buf_pool->n_chunks_new;
+	echunk = buf_pool->chunks + buf_pool->n_chunks;
+
+	for (; chunk < echunk; chunk++) {
+		if (ptr >= chunk->blocks->frame
+		    && ptr < (chunk->blocks + chunk->size - 1)->frame
+		    + UNIV_PAGE_SIZE) {
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/*****************************************************************//**
+Sets the global variable that feeds MySQL's
+innodb_buffer_pool_resize_status to the specified string and writes
+it to the error log. The format and the following parameters are the
+same as the ones used for printf(3). */
+static __attribute__((nonnull, format(printf, 1, 2)))
+void
+buf_resize_status(
+/*==============*/
+	const char*	fmt,	/*!< in: format */
+	...)			/*!< in: extra parameters according
+				to fmt */
+{
+	va_list	ap;
+
+	va_start(ap, fmt);
+
+	ut_vsnprintf(
+		export_vars.innodb_buffer_pool_resize_status,
+		sizeof(export_vars.innodb_buffer_pool_resize_status),
+		fmt, ap);
+
+	ut_print_timestamp(stderr);
+	fprintf(stderr, " InnoDB: %s\n",
+		export_vars.innodb_buffer_pool_resize_status);
+
+	va_end(ap);
+}
+
+/********************************************************************//**
+Copies a file page out of a chunk that is being removed by a buffer pool
+resize to a free block of the remaining chunks, and puts the old block
+to the withdraw list. The page is left alone if it is buffer-fixed, has
+pending I/O or is hashed by the adaptive hash index.
+@return	false if there was no free block to copy the page to */
+static
+bool
+buf_page_realloc(
+/*=============*/
+	buf_pool_t*	buf_pool,	/*!< in/out: buffer pool instance */
+	buf_block_t*	block)		/*!< in/out: block to relocate */
+{
+	buf_block_t*	new_block;
+	rw_lock_t*	hash_lock;
+	ulint		fold;
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+	ut_ad(buf_pool_withdrawing);
+	ut_ad(buf_block_get_state(block) == BUF_BLOCK_FILE_PAGE);
+
+	new_block = buf_LRU_get_free_only(buf_pool);
+
+	if (new_block == NULL) {
+		return(false);
+	}
+
+	/* The page cannot be evicted or moved while we hold
+	buf_pool->mutex, and neither can page_hash be resized. */
+	fold = buf_page_address_fold(block->page.space, block->page.offset);
+	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
+
+	rw_lock_x_lock(hash_lock);
+	mutex_enter(&block->mutex);
+
+	if (!buf_page_can_relocate(&block->page) || block->index != NULL) {
+		rw_lock_x_unlock(hash_lock);
+		mutex_exit(&block->mutex);
+
+		/* Return the block to the free list. */
+		mutex_enter(&new_block->mutex);
+		buf_LRU_block_free_non_file_page(new_block);
+		mutex_exit(&new_block->mutex);
+
+		return(true);
+	}
+
+	mutex_enter(&new_block->mutex);
+
+	memcpy(new_block->frame, block->frame, UNIV_PAGE_SIZE);
+
+	/* Relocate LRU and page_hash. This copies block->page,
+	including the compressed page frame, to new_block->page. */
+	buf_relocate(&block->page, &new_block->page);
+
+	if (block->page.zip.data != NULL) {
+		buf_block_t*	prev_block = UT_LIST_GET_PREV(
+			unzip_LRU, block);
+
+		ut_ad(block->in_unzip_LRU_list);
+		UT_LIST_REMOVE(unzip_LRU, buf_pool->unzip_LRU, block);
+		ut_d(block->in_unzip_LRU_list = FALSE);
+
+		if (prev_block != NULL) {
+			UT_LIST_INSERT_AFTER(unzip_LRU, buf_pool->unzip_LRU,
+					     prev_block, new_block);
+		} else {
+			UT_LIST_ADD_FIRST(unzip_LRU, buf_pool->unzip_LRU,
+					  new_block);
+		}
+		ut_d(new_block->in_unzip_LRU_list = TRUE);
+
+		/* The compressed page frame now belongs to new_block. */
+		block->page.zip.data = NULL;
+		page_zip_set_size(&block->page.zip, 0);
+	} else {
+		ut_ad(!block->in_unzip_LRU_list);
+		ut_d(new_block->in_unzip_LRU_list = FALSE);
+	}
+
+	if (block->page.oldest_modification != 0) {
+		buf_flush_relocate_on_flush_list(&block->page,
+						 &new_block->page);
+	}
+
+	buf_block_init_low(new_block);
+	new_block->check_index_page_at_flush
+		= block->check_index_page_at_flush;
+	new_block->db_stats_index = block->db_stats_index;
+	new_block->lock_hash_val = block->lock_hash_val;
+	new_block->modify_clock = block->modify_clock;
+
+	rw_lock_x_unlock(hash_lock);
+	mutex_exit(&new_block->mutex);
+
+	/* Invalidate the stored cursor positions on the old block,
+	and put the block to the withdraw list. */
+	buf_block_modify_clock_inc(block);
+	buf_block_set_state(block, BUF_BLOCK_REMOVE_HASH);
+	buf_block_set_state(block, BUF_BLOCK_MEMORY);
+	buf_LRU_block_free_non_file_page(block);
+
+	mutex_exit(&block->mutex);
+
+	return(true);
+}
+
+/********************************************************************//**
+Withdraws the blocks of the chunks that a buffer pool resize is removing:
+moves the free blocks of those chunks to buf_pool->withdraw, and flushes,
+evicts or copies to the remaining chunks the pages that those chunks hold.
+@return	true if not enough blocks could be withdrawn yet and the caller
+should retry later */
+static
+bool
+buf_pool_withdraw_blocks(
+/*=====================*/
+	buf_pool_t*	buf_pool)	/*!< in/out: buffer pool instance */
+{
+	ulint	loop_count = 0;
+
+	ut_ad(buf_pool_withdrawing);
+
+	while (UT_LIST_GET_LEN(buf_pool->withdraw)
+	       < buf_pool->withdraw_target) {
+
+		buf_page_t*	bpage;
+		ulint		n_free = 0;
+		ulint		n_moved = 0;
+
+		buf_pool_mutex_enter(buf_pool);
+
+		/* Combine the free buddies, so that whole frames of the
+		removed chunks can be freed. */
+		buf_buddy_condense_free(buf_pool);
+
+		bpage = UT_LIST_GET_FIRST(buf_pool->free);
+
+		while (bpage != NULL
+		       && UT_LIST_GET_LEN(buf_pool->withdraw)
+		       < buf_pool->withdraw_target) {
+
+			buf_page_t*	next = UT_LIST_GET_NEXT(list, bpage);
+
+			ut_ad(bpage->in_free_list);
+
+			if (buf_block_will_withdrawn(
+				    buf_pool,
+				    reinterpret_cast<buf_block_t*>(bpage))) {
+
+				UT_LIST_REMOVE(list, buf_pool->free, bpage);
+				UT_LIST_ADD_LAST(list, buf_pool->withdraw,
+						 bpage);
+				n_free++;
+			}
+
+			bpage = next;
+		}
+
+		buf_pool_mutex_exit(buf_pool);
+
+		if (UT_LIST_GET_LEN(buf_pool->withdraw)
+		    >= buf_pool->withdraw_target) {
+			break;
+		}
+
+		/* Replenish the free list; buf_flush_LRU_list_batch()
+		scans deeper while blocks are being withdrawn. */
+		buf_flush_LRU_tail();
+
+		/* Copy the pages and the compressed page frames that
+		remain in the removed chunks to the other chunks. */
+		buf_pool_mutex_enter(buf_pool);
+
+		bpage = UT_LIST_GET_FIRST(buf_pool->LRU);
+
+		while (bpage != NULL) {
+			buf_page_t*	next_bpage;
+			ib_mutex_t*	block_mutex;
+			bool		can_relocate;
+
+			next_bpage = UT_LIST_GET_NEXT(LRU, bpage);
+
+			block_mutex = buf_page_get_mutex(bpage);
+			mutex_enter(block_mutex);
+			can_relocate = buf_page_can_relocate(bpage);
+			mutex_exit(block_mutex);
+
+			if (!can_relocate) {
+				bpage = next_bpage;
+				continue;
+			}
+
+			if (bpage->zip.data != NULL
+			    && buf_frame_will_withdrawn(
+				    buf_pool,
+				    static_cast<byte*>(bpage->zip.data))) {
+
+				buf_pool_mutex_exit_forbid(buf_pool);
+
+				if (!buf_buddy_realloc(
+					    buf_pool, bpage->zip.data,
+					    page_zip_get_size(&bpage->zip))) {
+
+					buf_pool_mutex_exit_allow(buf_pool);
+					break;
+				}
+
+				buf_pool_mutex_exit_allow(buf_pool);
+				n_moved++;
+			}
+
+			if (buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE
+			    && buf_block_will_withdrawn(
+				    buf_pool,
+				    reinterpret_cast<buf_block_t*>(bpage))) {
+
+				buf_pool_mutex_exit_forbid(buf_pool);
+
+				if (!buf_page_realloc(
+					    buf_pool,
+					    reinterpret_cast<buf_block_t*>(
+						    bpage))) {
+
+					buf_pool_mutex_exit_allow(buf_pool);
+					break;
+				}
+
+				buf_pool_mutex_exit_allow(buf_pool);
+				n_moved++;
+			}
+
+			bpage = next_bpage;
+		}
+
+		buf_pool_mutex_exit(buf_pool);
+
+		buf_resize_status(
+			"buffer pool %lu: withdrew %lu free blocks and"
+			" relocated %lu pages (%lu/%lu)",
+			buf_pool->instance_no, n_free, n_moved,
+			UT_LIST_GET_LEN(buf_pool->withdraw),
+			buf_pool->withdraw_target);
+
+		if (++loop_count >= BUF_POOL_WITHDRAW_MAX_LOOPS) {
+			/* Some blocks are still in use, for example
+			by the heaps of active transactions. */
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/********************************************************************//**
+Rebuilds a hash table of a buffer pool instance with a number of cells
+that suits the resized buffer pool. The caller must hold the latches of
+the hash table. */
+static
+void
+buf_pool_resize_hash_table(
+/*=======================*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	hash_table_t*	table,		/*!< in/out: page_hash or
+					zip_hash of buf_pool */
+	bool		zip)		/*!< in: true if table is zip_hash */
+{
+	hash_table_t*	new_table;
+	hash_cell_t*	array;
+	ulint		n_cells;
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+
+	new_table = hash_create(2 * buf_pool->curr_size);
+
+	for (ulint i = 0; i < hash_get_n_cells(table); i++) {
+		buf_page_t*	bpage = static_cast<buf_page_t*>(
+			HASH_GET_FIRST(table, i));
+
+		while (bpage != NULL) {
+			buf_page_t*	next_bpage = static_cast<buf_page_t*>(
+				HASH_GET_NEXT(hash, bpage));
+			ulint		fold = zip
+				? BUF_POOL_ZIP_FOLD_BPAGE(bpage)
+				: buf_page_address_fold(bpage->space,
+							bpage->offset);
+
+			HASH_INSERT(buf_page_t, hash, new_table, fold, bpage);
+
+			bpage = next_bpage;
+		}
+	}
+
+	/* Swap the cell arrays, so that the latches of the table
+	stay in place, and free the old array. */
+	array = table->array;
+	n_cells = table->n_cells;
+	table->array = new_table->array;
+	table->n_cells = new_table->n_cells;
+	new_table->array = array;
+	new_table->n_cells = n_cells;
+
+	hash_table_free(new_table);
+}
+
+/********************************************************************//**
+Gives the blocks that were withdrawn back to the free lists after a
+buffer pool shrink was aborted. */
+static
+void
+buf_pool_withdraw_cancel(void)
+/*==========================*/
+{
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool_t*	buf_pool = buf_pool_from_array(i);
+		buf_page_t*	bpage;
+
+		buf_pool_mutex_enter(buf_pool);
+
+		while ((bpage = UT_LIST_GET_FIRST(buf_pool->withdraw))
+		       != NULL) {
+			UT_LIST_REMOVE(list, buf_pool->withdraw, bpage);
+			UT_LIST_ADD_LAST(list, buf_pool->free, bpage);
+		}
+
+		buf_pool->n_chunks_new = buf_pool->n_chunks;
+
+		buf_pool_mutex_exit(buf_pool);
+	}
+
+	buf_pool_withdrawing = false;
+}
+
+/********************************************************************//**
+Resizes the buffer pool to srv_buf_pool_size by adding or removing
+chunks in each buffer pool instance. Called by buf_resize_thread. */
+UNIV_INTERN
+void
+buf_pool_resize(void)
+/*=================*/
+{
+	ulint		new_n_chunks;
+	bool		ahi_disabled = false;
+	bool		shrink = false;
+	ulint		retry_interval = 1;
+	ulint		old_size = srv_buf_pool_old_size;
+	ulint		new_size = srv_buf_pool_size;
+	ib_time_t	start_time = ut_time();
+
+	ut_ad(!buf_pool_withdrawing);
+	ut_ad(srv_buf_pool_size % (srv_buf_pool_instances
+				   * srv_buf_pool_chunk_unit) == 0);
+
+	new_n_chunks = srv_buf_pool_size / srv_buf_pool_instances
+		/ srv_buf_pool_chunk_unit;
+
+	buf_resize_status("Resizing buffer pool from %lu to %lu.",
+			  old_size, new_size);
+
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool_t*	buf_pool = buf_pool_from_array(i);
+
+		buf_pool_mutex_enter(buf_pool);
+
+		/* Free the chunks array that the previous resize
+		replaced; nobody can be reading it any more. */
+		if (buf_pool->chunks_old != NULL) {
+			mem_free(buf_pool->chunks_old);
+			buf_pool->chunks_old = NULL;
+		}
+
+		ut_ad(buf_pool->n_chunks_new == buf_pool->n_chunks);
+		ut_ad(UT_LIST_GET_LEN(buf_pool->withdraw) == 0);
+
+		buf_pool->withdraw_target = 0;
+
+		if (new_n_chunks < buf_pool->n_chunks) {
+			buf_pool->n_chunks_new = new_n_chunks;
+
+			for (ulint j = new_n_chunks;
+			     j < buf_pool->n_chunks; j++) {
+				buf_pool->withdraw_target
+					+= buf_pool->chunks[j].size;
+			}
+
+			shrink = true;
+		}
+
+		buf_pool_mutex_exit(buf_pool);
+	}
+
+	/* The adaptive hash index would keep block->index set on the
+	pages that have to be copied, and its hash table has to be
+	resized as well. */
+	if (btr_search_enabled) {
+		buf_resize_status("Disabling adaptive hash index.");
+		btr_search_disable();
+		ahi_disabled = true;
+	}
+
+	if (shrink) {
+		buf_resize_status("Withdrawing blocks to be shrunken.");
+
+		buf_pool_withdrawing = true;
+
+		for (;;) {
+			bool	should_retry = false;
+
+			for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+				buf_pool_t*	buf_pool
+					= buf_pool_from_array(i);
+
+				if (buf_pool->n_chunks_new
+				    < buf_pool->n_chunks
+				    && buf_pool_withdraw_blocks(buf_pool)) {
+					should_retry = true;
+				}
+			}
+
+			if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
+				buf_pool_withdraw_cancel();
+				srv_buf_pool_size = srv_buf_pool_old_size;
+
+				if (ahi_disabled) {
+					btr_search_enable();
+				}
+
+				buf_resize_status(
+					"Resizing buffer pool was aborted.");
+				return;
+			}
+
+			if (!should_retry) {
+				break;
+			}
+
+			buf_resize_status(
+				"Will retry to withdraw %lu seconds later.",
+				retry_interval);
+
+			for (ulint s = 0; s < retry_interval
+				     && srv_shutdown_state
+				     == SRV_SHUTDOWN_NONE; s++) {
+				os_thread_sleep(1000000);
+			}
+
+			retry_interval = ut_min(retry_interval * 2, 10);
+		}
+	}
+
+	/* Allocate the new chunks before freezing the buffer pool. */
+	buf_chunk_t**	new_chunks = static_cast<buf_chunk_t**>(
+		mem_zalloc(srv_buf_pool_instances * sizeof *new_chunks));
+	ulint*		n_new_chunks = static_cast<ulint*>(
+		mem_zalloc(srv_buf_pool_instances * sizeof *n_new_chunks));
+
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool_t*	buf_pool = buf_pool_from_array(i);
+		ulint		n_chunks = buf_pool->n_chunks;
+
+		n_new_chunks[i] = n_chunks;
+
+		if (new_n_chunks <= n_chunks) {
+			continue;
+		}
+
+		buf_resize_status("buffer pool %lu: adding %lu chunks.",
+				  i, new_n_chunks - n_chunks);
+
+		new_chunks[i] = static_cast<buf_chunk_t*>(
+			mem_zalloc(new_n_chunks * sizeof **new_chunks));
+		memcpy(new_chunks[i], buf_pool->chunks,
+		       n_chunks * sizeof **new_chunks);
+
+		for (ulint j = n_chunks; j < new_n_chunks; j++) {
+			if (!buf_chunk_init(buf_pool, new_chunks[i] + j,
+					    srv_buf_pool_chunk_unit)) {
+
+				ut_print_timestamp(stderr);
+				fprintf(stderr,
+					" InnoDB: Cannot allocate memory"
+					" for a buffer pool chunk of"
+					" %lu bytes.\n",
+					srv_buf_pool_chunk_unit);
+				break;
+			}
+
+			n_new_chunks[i] = j + 1;
+		}
+
+		if (n_new_chunks[i] == n_chunks) {
+			mem_free(new_chunks[i]);
+			new_chunks[i] = NULL;
+		}
+	}
+
+	/* Freeze the buffer pool, and replace the chunks and the hash
+	tables. */
+	buf_pool_mutex_enter_all();
+
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool_t*	buf_pool = buf_pool_from_array(i);
+
+		hash_lock_x_all(buf_pool->page_hash);
+
+		if (buf_pool->n_chunks_new < buf_pool->n_chunks) {
+			ut_a(UT_LIST_GET_LEN(buf_pool->withdraw)
+			     == buf_pool->withdraw_target);
+
+			/* The withdrawn blocks are forgotten; their
+			memory is freed after the buffer pool has been
+			unfrozen. The array entries past n_chunks stay
+			valid until then. */
+			UT_LIST_INIT(buf_pool->withdraw);
+			buf_pool->n_chunks = buf_pool->n_chunks_new;
+		} else if (new_chunks[i] != NULL) {
+			buf_chunk_t*	chunk;
+
+			buf_pool->chunks_old = buf_pool->chunks;
+			buf_pool->chunks = new_chunks[i];
+
+			for (chunk = buf_pool->chunks + buf_pool->n_chunks;
+			     chunk < buf_pool->chunks + n_new_chunks[i];
+			     chunk++) {
+				buf_chunk_add_to_free(buf_pool, chunk);
+			}
+
+			/* Publish the chunks before their number; both
+			fields are volatile. */
+			buf_pool->n_chunks = buf_pool->n_chunks_new
+				= n_new_chunks[i];
+		}
+
+		buf_pool->curr_size = 0;
+
+		for (ulint j = 0; j < buf_pool->n_chunks; j++) {
+			buf_pool->curr_size += buf_pool->chunks[j].size;
+		}
+
+		buf_pool->old_size = buf_pool->curr_size;
+		buf_pool->curr_pool_size = buf_pool->curr_size
+			* UNIV_PAGE_SIZE;
+		buf_pool->old_pool_size = buf_pool->curr_pool_size;
+
+		buf_pool_resize_hash_table(buf_pool, buf_pool->page_hash,
+					   false);
+		buf_pool_resize_hash_table(buf_pool, buf_pool->zip_hash,
+					   true);
+
+		hash_unlock_x_all(buf_pool->page_hash);
+	}
+
+	buf_withdraw_clock++;
+	buf_pool_withdrawing = false;
+
+	buf_pool_mutex_exit_all();
+
+	/* Free the memory of the removed chunks. */
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool_t*	buf_pool = buf_pool_from_array(i);
+
+		for (ulint j = buf_pool->n_chunks; j < n_new_chunks[i]; j++) {
+			buf_chunk_free(buf_pool->chunks + j);
+		}
+	}
+
+	mem_free(n_new_chunks);
+	mem_free(new_chunks);
+
+	/* Size the adaptive hash index for the new buffer pool size. */
+	btr_search_sys_resize(buf_pool_get_curr_size() / sizeof(void*) / 64);
+
+	buf_pool_set_sizes();
+
+	if (ahi_disabled) {
+		btr_search_enable();
+	}
+
+	buf_resize_status("Completed resizing buffer pool from %lu to %lu"
+			  " in %lu seconds.",
+			  old_size, new_size,
+			  (ulint) (ut_time() - start_time));
+}
+
+/********************************************************************//**
+This is the thread for resizing the buffer pool. It waits for an event
+and when waked up performs a resize and sleeps again.
+@return this function does not return, it calls os_thread_exit() */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(buf_resize_thread)(
+/*==============================*/
+	void*	arg __attribute__((unused)))	/*!< in: a dummy parameter
+						required by os_thread_create */
+{
+	ut_ad(!srv_read_only_mode);
+
+	srv_buf_resize_thread_active = TRUE;
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+
+		os_event_wait(srv_buf_resize_event);
+		os_event_reset(srv_buf_resize_event);
+
+		if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
+			break;
+		}
+
+		if (srv_buf_pool_old_size == srv_buf_pool_size) {
+			buf_resize_status(
+				"Size did not change (old size = new size"
+				" = %lu). Nothing to do.",
+				srv_buf_pool_size);
+			continue;
+		}
+
+		buf_pool_resize();
+	}
+
+	srv_buf_resize_thread_active = FALSE;
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
 #endif /* !UNIV_HOTBACKUP */
 
 /********************************************************************//**
@@ -2312,9 +3140,13 @@ buf_block_align_instance(
 	buf_chunk_t*	chunk;
 	ulint		i;
 
-	/* TODO: protect buf_pool->chunks with a mutex (it will
-	currently remain constant after buf_pool_init()) */
-	for (chunk = buf_pool->chunks, i = buf_pool->n_chunks; i--; chunk++) {
+	/* A buffer pool resize publishes a longer chunks array before
+	it increases n_chunks, and it removes chunks only from the end
+	of the array after their blocks were withdrawn, so that the
+	chunk of a frame that the caller has latched or buffer-fixed
+	is always found here without holding buf_pool->mutex. */
+	i = buf_pool->n_chunks;
+	for (chunk = buf_pool->chunks; i--; chunk++) {
 		ulint	offs;
 
 		if (UNIV_UNLIKELY(ptr < chunk->blocks->frame)) {
@@ -2426,11 +3258,11 @@ buf_pointer_is_block_field_instance(
 	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
 	const void*	ptr)		/*!< in: pointer not dereferenced */
 {
+	/* Read n_chunks before chunks; see buf_block_align_instance() */
+	const ulint			n_chunks = buf_pool->n_chunks;
 	const buf_chunk_t*		chunk	= buf_pool->chunks;
-	const buf_chunk_t* const	echunk	= chunk + buf_pool->n_chunks;
+	const buf_chunk_t* const	echunk	= chunk + n_chunks;
 
-	/* TODO: protect buf_pool->chunks with a mutex (it will
-	currently remain constant after buf_pool_init()) */
 	while (chunk < echunk) {
 		if (ptr >= (void*) chunk->blocks
 		    && ptr < (void*) (chunk->blocks + chunk->size)) {
@@ -2570,11 +3402,15 @@ buf_page_get_gen(
 #endif
 	buf_pool->stat.n_page_gets++;
 	fold = buf_page_address_fold(space, offset);
-	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 loop:
 	block = guess;
 
+	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 	rw_lock_s_lock(hash_lock);
+
+	/* The page_hash may have been resized meanwhile. */
+	hash_lock = hash_lock_s_confirm(hash_lock, buf_pool->page_hash, fold);
+
 	if (block) {
 		/* If the guess is a compressed page descriptor that
 		has been allocated by buf_page_alloc_descriptor(),
@@ -2608,9 +3444,16 @@ loop:
 
 		if (mode == BUF_GET_IF_IN_POOL_OR_WATCH) {
 			rw_lock_x_lock(hash_lock);
+			hash_lock = hash_lock_x_confirm(
+				hash_lock, buf_pool->page_hash, fold);
+
 			block = (buf_block_t*) buf_pool_watch_set(
 				space, offset, fold);
 
+			/* buf_pool_watch_set() may have switched to
+			the lock of a resized page_hash. */
+			hash_lock = buf_page_hash_lock_get(buf_pool, fold);
+
 			if (UNIV_LIKELY_NULL(block)) {
 				/* We can release hash_lock after we
 				acquire block_mutex to make sure that
@@ -2749,7 +3592,9 @@ wait_until_unfixed:
 		possible that page_hash might have changed. We do
 		another lookup here while holding the hash_lock
 		to verify that bpage is indeed still a part of
-		page_hash. */
+		page_hash. The page_hash may also have been resized,
+		but not while we hold buf_pool->mutex. */
+		hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 		rw_lock_x_lock(hash_lock);
 
 		mutex_enter(&block->mutex);
@@ -2912,7 +3757,10 @@ wait_until_unfixed:
 
 		if (buf_LRU_free_page(&block->page, true, &removed)) {
 			buf_pool_mutex_exit(buf_pool);
+			hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 			rw_lock_x_lock(hash_lock);
+			hash_lock = hash_lock_x_confirm(
+				hash_lock, buf_pool->page_hash, fold);
 
 			if (mode == BUF_GET_IF_IN_POOL_OR_WATCH) {
 				/* Set the watch, as it would have
@@ -2920,6 +3768,8 @@ wait_until_unfixed:
 				buffer pool in the first place. */
 				block = (buf_block_t*) buf_pool_watch_set(
 					space, offset, fold);
+				hash_lock = buf_page_hash_lock_get(
+					buf_pool, fold);
 			} else {
 				block = (buf_block_t*) buf_page_hash_get_low(
 					buf_pool, space, offset, fold);
@@ -2969,6 +3819,14 @@ wait_until_unfixed:
 
 	buf_page_set_accessed(&block->page);
 
+	if (UNIV_UNLIKELY(block->page.fake_changes_read)
+	    && mtr->trx && !mtr->trx->fake_changes) {
+		/* A real transaction uses a page that a fake changes
+		transaction, such as the slave prefetcher, read in. */
+		block->page.fake_changes_read = FALSE;
+		srv_stats.buf_pool_fake_changes_hits.inc();
+	}
+
 	mutex_exit(&block->mutex);
 
 	if (mode != BUF_PEEK_IF_IN_POOL) {
@@ -3374,6 +4232,7 @@ buf_page_init_low(
 	bpage->buf_fix_count = 0;
 	bpage->freed_page_clock = 0;
 	bpage->access_time = 0;
+	bpage->fake_changes_read = FALSE;
 	bpage->newest_modification = 0;
 	bpage->oldest_modification = 0;
 	HASH_INVALIDATE(bpage, hash);
@@ -3534,9 +4393,12 @@ buf_page_init_for_read(
 	}
 
 	fold = buf_page_address_fold(space, offset);
-	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 
 	buf_pool_mutex_enter(buf_pool);
+
+	/* The page_hash cannot be resized while we hold
+	buf_pool->mutex. */
+	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 	rw_lock_x_lock(hash_lock);
 
 	watch_page = buf_page_hash_get_low(buf_pool, space, offset, fold);
@@ -3623,6 +4485,7 @@ err_exit:
 		uninitialized data. */
 		data = buf_buddy_alloc(buf_pool, zip_size, &lru);
 
+		hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 		rw_lock_x_lock(hash_lock);
 
 		/* If buf_buddy_alloc() allocated storage from the LRU list,
@@ -3766,9 +4629,12 @@ buf_page_create(
 	free_block = buf_LRU_get_free_block(buf_pool);
 
 	fold = buf_page_address_fold(space, offset);
-	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 
 	buf_pool_mutex_enter(buf_pool);
+
+	/* The page_hash cannot be resized while we hold
+	buf_pool->mutex. */
+	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 	rw_lock_x_lock(hash_lock);
 
 	block = (buf_block_t*) buf_page_hash_get_low(
@@ -4704,9 +5570,15 @@ assert_s_latched:
 	}
 
 	ut_a(UT_LIST_GET_LEN(buf_pool->LRU) == n_lru);
-	if (UT_LIST_GET_LEN(buf_pool->free) != n_free) {
-		fprintf(stderr, "Free list len %lu, free blocks %lu\n",
+
+	/* The blocks that a buffer pool resize has withdrawn are in
+	the state BUF_BLOCK_NOT_USED as well. */
+	if (UT_LIST_GET_LEN(buf_pool->free)
+	    + UT_LIST_GET_LEN(buf_pool->withdraw) != n_free) {
+		fprintf(stderr, "Free list len %lu, withdraw list len %lu,"
+			" free blocks %lu\n",
 			(ulong) UT_LIST_GET_LEN(buf_pool->free),
+			(ulong) UT_LIST_GET_LEN(buf_pool->withdraw),
 			(ulong) n_free);
 		ut_error;
 	}
@@ -808,7 +808,10 @@ buf_dblwr_update(
 	const buf_page_t*	bpage,	/*!< in: buffer block descriptor */
 	buf_flush_t		flush_type)/*!< in: flush type */
 {
-	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
+	if (!srv_use_doublewrite_buf || buf_dblwr == NULL
+	    || fsp_is_system_temporary(buf_page_get_space(bpage))) {
+		/* The pages of the temporary tablespace are written
+		without the doublewrite buffer. */
 		return;
 	}
 
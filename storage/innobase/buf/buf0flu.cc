@@ -890,6 +890,10 @@ buf_flush_write_block_low(
 {
 	ulint	zip_size	= buf_page_get_zip_size(bpage);
 	page_t*	frame		= NULL;
+	/* Pages of the shared temporary tablespace are never recovered:
+	they do not need the redo log flushed or the doublewrite buffer. */
+	bool	is_temp		= fsp_is_system_temporary(
+		buf_page_get_space(bpage));
 
 #ifdef UNIV_DEBUG
 	buf_pool_t*	buf_pool = buf_pool_from_bpage(bpage);
@@ -928,8 +932,11 @@ buf_flush_write_block_low(
 	}
 #else
 	/* Force the log to the disk before writing the modified block */
-	log_write_up_to(bpage->newest_modification, LOG_WAIT_ALL_GROUPS, TRUE,
-			LOG_WRITE_FROM_DIRTY_BUFFER);
+	if (!is_temp) {
+		log_write_up_to(bpage->newest_modification,
+				LOG_WAIT_ALL_GROUPS, TRUE,
+				LOG_WRITE_FROM_DIRTY_BUFFER);
+	}
 #endif
 	switch (buf_page_get_state(bpage)) {
 	case BUF_BLOCK_POOL_WATCH:
@@ -962,7 +969,7 @@ buf_flush_write_block_low(
 		break;
 	}
 
-	if (!srv_use_doublewrite_buf || !buf_dblwr) {
+	if (!srv_use_doublewrite_buf || !buf_dblwr || is_temp) {
 		fil_io(OS_FILE_WRITE | OS_AIO_SIMULATED_WAKE_LATER,
 		       sync, buf_page_get_space(bpage), zip_size,
 		       buf_page_get_page_no(bpage), 0,
@@ -1487,6 +1494,28 @@ buf_free_from_unzip_LRU_list_batch(
 	return(count);
 }
 
+/*******************************************************************//**
+Gets the number of blocks that the current buffer pool resize still
+has to withdraw from a buffer pool instance. An LRU batch frees that
+many blocks more than usual, because the pages of the chunks that
+are removed are moved to free blocks of the other chunks.
+@return number of blocks, 0 if no blocks are being withdrawn */
+static
+ulint
+buf_flush_LRU_withdraw_depth(
+/*=========================*/
+	const buf_pool_t*	buf_pool)	/*!< in: buffer pool instance */
+{
+	ulint	withdraw_len = UT_LIST_GET_LEN(buf_pool->withdraw);
+
+	if (UNIV_LIKELY(!buf_pool_withdrawing)
+	    || withdraw_len >= buf_pool->withdraw_target) {
+		return(0);
+	}
+
+	return(buf_pool->withdraw_target - withdraw_len);
+}
+
 /*******************************************************************//**
 This utility flushes dirty blocks from the end of the LRU list.
 The calling thread is not allowed to own any latches on pages!
@@ -1507,12 +1536,13 @@ buf_flush_LRU_list_batch(
 	ulint		count = 0;
 	ulint		free_len = UT_LIST_GET_LEN(buf_pool->free);
 	ulint		lru_len = UT_LIST_GET_LEN(buf_pool->LRU);
+	ulint		withdraw_depth = buf_flush_LRU_withdraw_depth(buf_pool);
 
 	ut_ad(buf_pool_mutex_own(buf_pool));
 
 	bpage = UT_LIST_GET_LAST(buf_pool->LRU);
 	while (bpage != NULL && count < max
-	       && free_len < srv_LRU_scan_depth
+	       && free_len < srv_LRU_scan_depth + withdraw_depth
 	       && lru_len > BUF_LRU_MIN_LEN) {
 
 		ib_mutex_t* block_mutex = buf_page_get_mutex(bpage);
@@ -2116,7 +2146,9 @@ buf_flush_LRU_tail(void)
 		scan_depth = UT_LIST_GET_LEN(buf_pool->LRU);
 		buf_pool_mutex_exit(buf_pool);
 
-		scan_depth = ut_min(srv_LRU_scan_depth, scan_depth);
+		scan_depth = ut_min(srv_LRU_scan_depth
+				    + buf_flush_LRU_withdraw_depth(buf_pool),
+				    scan_depth);
 
 		/* We divide LRU flush into smaller chunks because
 		there may be user threads waiting for the flush to
@@ -1154,15 +1154,27 @@ buf_LRU_get_free_only(
 
 	block = (buf_block_t*) UT_LIST_GET_FIRST(buf_pool->free);
 
-	if (block) {
+	while (block != NULL) {
 
 		ut_ad(block->page.in_free_list);
-		ut_d(block->page.in_free_list = FALSE);
 		ut_ad(!block->page.in_flush_list);
 		ut_ad(!block->page.in_LRU_list);
 		ut_a(!buf_page_in_file(&block->page));
 		UT_LIST_REMOVE(list, buf_pool->free, (&block->page));
 
+		if (UNIV_UNLIKELY(buf_pool_withdrawing)
+		    && buf_block_will_withdrawn(buf_pool, block)) {
+			/* This block belongs to a chunk that a buffer
+			pool resize is removing. */
+			UT_LIST_ADD_LAST(list, buf_pool->withdraw,
+					 &block->page);
+			block = (buf_block_t*)
+				UT_LIST_GET_FIRST(buf_pool->free);
+			continue;
+		}
+
+		ut_d(block->page.in_free_list = FALSE);
+
 		mutex_enter(&block->mutex);
 
 		buf_block_set_state(block, BUF_BLOCK_READY_FOR_USE);
@@ -1171,6 +1183,7 @@ buf_LRU_get_free_only(
 		ut_ad(buf_pool_from_block(block) == buf_pool);
 
 		mutex_exit(&block->mutex);
+		break;
 	}
 
 	return(block);
@@ -1189,6 +1202,12 @@ buf_LRU_check_size_of_non_data_objects(
 {
 	ut_ad(buf_pool_mutex_own(buf_pool));
 
+	if (UNIV_UNLIKELY(buf_pool_withdrawing)) {
+		/* The blocks that a buffer pool resize withdraws are
+		neither free nor in the LRU list. */
+		return;
+	}
+
 	if (!recv_recovery_on && UT_LIST_GET_LEN(buf_pool->free)
 	    + UT_LIST_GET_LEN(buf_pool->LRU) < buf_pool->curr_size / 20) {
 		ut_print_timestamp(stderr);
@@ -2182,7 +2201,14 @@ buf_LRU_block_free_non_file_page(
 		page_zip_set_size(&block->page.zip, 0);
 	}
 
-	UT_LIST_ADD_FIRST(list, buf_pool->free, (&block->page));
+	if (UNIV_UNLIKELY(buf_pool_withdrawing)
+	    && buf_block_will_withdrawn(buf_pool, block)) {
+		/* This block belongs to a chunk that a buffer pool
+		resize is removing. */
+		UT_LIST_ADD_LAST(list, buf_pool->withdraw, (&block->page));
+	} else {
+		UT_LIST_ADD_FIRST(list, buf_pool->free, (&block->page));
+	}
 	ut_d(block->page.in_free_list = TRUE);
 
 	UNIV_MEM_ASSERT_AND_FREE(block->frame, UNIV_PAGE_SIZE);
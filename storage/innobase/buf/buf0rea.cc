@@ -224,6 +224,16 @@ not_to_recover:
 
 	ut_ad(buf_page_in_file(bpage));
 
+	if (trx && UNIV_UNLIKELY(trx->fake_changes)) {
+		ib_mutex_t*	block_mutex = buf_page_get_mutex(bpage);
+
+		mutex_enter(block_mutex);
+		bpage->fake_changes_read = TRUE;
+		mutex_exit(block_mutex);
+
+		srv_stats.buf_pool_fake_changes_reads.inc();
+	}
+
 	if (sync) {
 		thd_wait_begin(NULL, THD_WAIT_DISKIO);
 	}
@@ -816,6 +826,95 @@ buf_read_ahead_linear(
 	return(count);
 }
 
+/********************************************************************//**
+Issues asynchronous reads for the pages of an externally stored field that
+the caller is about to read, assuming that they follow each other in the
+tablespace, as btr_store_big_rec_extern_fields() allocates them. The reads
+are submitted together. NOTE: the calling thread may own latches on pages:
+this function does not wait for any page latch.
+@return	number of page read requests issued */
+UNIV_INTERN
+ulint
+buf_read_ahead_blob(
+/*================*/
+	ulint	space,		/*!< in: space id */
+	ulint	zip_size,	/*!< in: compressed page size in bytes, or 0 */
+	ulint	offset,		/*!< in: page number of the first page */
+	ulint	n_pages,	/*!< in: number of pages to read */
+	trx_t*	trx)		/*!< in: transaction, or NULL */
+{
+	buf_pool_t*	buf_pool = buf_pool_get(space, offset);
+	ib_int64_t	tablespace_version;
+	ulint		count;
+	ulint		high;
+	dberr_t		err;
+	ulint		i;
+
+	if (srv_startup_is_before_trx_rollback_phase) {
+		/* No read-ahead to avoid thread deadlocks */
+		return(0);
+	}
+
+	tablespace_version = fil_space_get_version(space);
+
+	high = offset + n_pages;
+
+	if (high > fil_space_get_size(space)) {
+
+		high = fil_space_get_size(space);
+	}
+
+	/* A dirty read is enough for this limit */
+
+	if (buf_pool->n_pend_reads
+	    > buf_pool->curr_size / BUF_READ_AHEAD_PEND_LIMIT) {
+
+		return(0);
+	}
+
+	count = 0;
+
+	for (i = offset; i < high; i++) {
+		/* A wrong guess must not read the pages that ibuf
+		accesses in a fixed order */
+
+		if (ibuf_bitmap_page(zip_size, i)
+		    || trx_sys_hdr_page(space, i)) {
+
+			continue;
+		}
+
+		count += buf_read_page_low(
+			&err, false,
+			BUF_READ_ANY_PAGE | OS_AIO_SIMULATED_WAKE_LATER
+			| BUF_READ_IGNORE_NONEXISTENT_PAGES,
+			space, zip_size, FALSE, tablespace_version, i,
+			trx, TRUE);
+
+		if (err == DB_TABLESPACE_DELETED) {
+			break;
+		}
+	}
+#if defined(LINUX_NATIVE_AIO)
+	/* Tell aio to submit all buffered requests. */
+	ut_a(os_aio_linux_dispatch_read_array_submit());
+#endif
+
+	/* In simulated aio we wake the aio handler threads only after
+	queuing all aio requests, in native aio the following call does
+	nothing: */
+
+	os_aio_simulated_wake_handler_threads();
+
+	/* Read ahead is considered one I/O operation for the purpose of
+	LRU policy decision. */
+	buf_LRU_stat_inc_io();
+
+	srv_stats.buf_pool_reads.add(count);
+	srv_stats.n_blob_read_ahead_prefetched.add(count);
+	return(count);
+}
+
 /********************************************************************//**
 Issues read requests for pages which the ibuf module wants to read in, in
 order to contract the insert buffer tree. Technically, this function is like
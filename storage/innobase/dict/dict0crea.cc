@@ -270,7 +270,13 @@ dict_build_table_def_step(
 
 	thr_get_trx(thr)->table_id = table->id;
 
-	if (use_tablespace) {
+	if (dict_table_is_temporary(table)
+	    && srv_tmp_space_id != ULINT_UNDEFINED
+	    && !dict_table_zip_size(table)) {
+		/* Create in the shared temporary tablespace. It has no
+		compressed pages, but it can hold any other row format. */
+		table->space = (unsigned int) srv_tmp_space_id;
+	} else if (use_tablespace) {
 		/* This table will not use the system tablespace.
 		Get a new space id. */
 		dict_hdr_get_new_id(NULL, NULL, &space);
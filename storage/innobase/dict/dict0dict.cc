@@ -2262,6 +2262,47 @@ add_field_size:
 	return(FALSE);
 }
 
+/**********************************************************************//**
+Determines dict_index_t::search_prefix_len of an index.
+@return	length of the first field if page_cur_search_with_match() can
+compare it as an integer, 0 if not */
+static
+ulint
+dict_index_get_search_prefix_len(
+/*=============================*/
+	const dict_index_t*	index)	/*!< in: index */
+{
+	const dict_field_t*	field;
+	const dict_col_t*	col;
+
+	if (dict_index_is_ibuf(index) || index->type & DICT_FTS
+	    || index->n_fields == 0) {
+		return(0);
+	}
+
+	field = dict_index_get_nth_field(index, 0);
+	col = dict_field_get_col(field);
+
+	if (field->fixed_len == 0 || field->fixed_len > 8
+	    || field->prefix_len != 0
+	    || !(col->prtype & DATA_NOT_NULL)) {
+		return(0);
+	}
+
+	/* cmp_dtuple_rec_with_match() compares these types byte by byte
+	without a collation, and they have no padding when the lengths
+	are equal */
+
+	switch (col->mtype) {
+	case DATA_INT:
+	case DATA_SYS:
+	case DATA_FIXBINARY:
+		return(field->fixed_len);
+	}
+
+	return(0);
+}
+
 /**********************************************************************//**
 Adds an index to the dictionary cache.
 @return	DB_SUCCESS, DB_TOO_BIG_RECORD, or DB_CORRUPTION */
@@ -2313,6 +2354,8 @@ dict_index_add_to_cache(
 
 	new_index->n_fields = new_index->n_def;
 	new_index->trx_id = index->trx_id;
+	new_index->search_prefix_len = dict_index_get_search_prefix_len(
+		new_index);
 
 	if (strict && dict_index_too_big_for_tree(table, new_index)) {
 too_big:
@@ -2337,8 +2337,9 @@ err_exit:
 	btr_pcur_close(&pcur);
 	mtr_commit(&mtr);
 
-	if (table->space == 0) {
-		/* The system tablespace is always available. */
+	if (table->space == 0 || fsp_is_system_temporary(table->space)) {
+		/* The system tablespace is always available, and so is
+		the temporary tablespace while the server is running. */
 	} else if (table->flags2 & DICT_TF2_DISCARDED) {
 
 		ib_logf(IB_LOG_LEVEL_WARN,
@@ -153,14 +153,17 @@ fil_system_t*	fil_system	= NULL;
 /** Determine if (i) is a user tablespace id or not. */
 # define fil_is_user_tablespace_id(i) ((i) > srv_undo_tablespaces_open)
 
-/** Determine if user has explicitly disabled fsync(). */
+/** Determine if user has explicitly disabled fsync(), or if the space is
+the shared temporary tablespace, which does not survive a crash. */
 #ifndef __WIN__
 # define fil_buffering_disabled(s)	\
 	((s)->purpose == FIL_TABLESPACE	\
-	 && srv_unix_file_flush_method	\
-	 == SRV_UNIX_O_DIRECT_NO_FSYNC)
+	 && (srv_unix_file_flush_method	\
+	     == SRV_UNIX_O_DIRECT_NO_FSYNC	\
+	     || fsp_is_system_temporary((s)->id)))
 #else /* __WIN__ */
-# define fil_buffering_disabled(s)	(0)
+# define fil_buffering_disabled(s)	\
+	fsp_is_system_temporary((s)->id)
 #endif /* __WIN__ */
 
 /** Count usage of the doublewrite buffer separate from other activity to
@@ -3914,6 +3917,82 @@ error_exit_3:
 	return(err);
 }
 
+/*******************************************************************//**
+Creates the shared temporary tablespace, replacing the file that a
+previous server instance may have left behind. Unlike for a single-table
+tablespace, no MLOG_FILE_CREATE record is written: the tablespace is
+never recovered, it is created again at the next startup.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+dberr_t
+fil_create_temporary_tablespace(
+/*============================*/
+	ulint		space_id,	/*!< in: space id */
+	const char*	path,		/*!< in: file path */
+	ulint		size)		/*!< in: the initial size of the
+					tablespace file in pages */
+{
+	os_file_t	file;
+	ibool		ret;
+	byte*		buf2;
+	byte*		page;
+	ulint		flags = fsp_flags_set_page_size(0, UNIV_PAGE_SIZE);
+
+	ut_a(space_id > 0);
+	ut_a(space_id < SRV_LOG_SPACE_FIRST_ID);
+	ut_ad(!srv_read_only_mode);
+
+	os_file_delete_if_exists(innodb_file_data_key, path);
+
+	file = os_file_create(
+		innodb_file_data_key, path,
+		OS_FILE_CREATE | OS_FILE_ON_ERROR_NO_EXIT,
+		OS_FILE_NORMAL, OS_DATA_FILE, &ret);
+
+	if (!ret) {
+		ib_logf(IB_LOG_LEVEL_ERROR,
+			"Cannot create the temporary tablespace '%s'", path);
+		return(DB_ERROR);
+	}
+
+	ret = os_file_set_size(path, file, size * UNIV_PAGE_SIZE);
+
+	if (ret) {
+		/* Write the space id so that fil_node_open_file() can
+		check the file when it is opened for the first i/o. */
+		buf2 = static_cast<byte*>(ut_malloc(2 * UNIV_PAGE_SIZE));
+		page = static_cast<byte*>(ut_align(buf2, UNIV_PAGE_SIZE));
+
+		memset(page, '\0', UNIV_PAGE_SIZE);
+
+		fsp_header_init_fields(page, space_id, flags);
+		mach_write_to_4(page + FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID,
+				space_id);
+		buf_flush_init_for_writing(page, NULL, 0);
+
+		ret = os_file_write(path, file, page, 0, UNIV_PAGE_SIZE);
+
+		ut_free(buf2);
+	}
+
+	os_file_close(file);
+
+	if (!ret) {
+		ib_logf(IB_LOG_LEVEL_ERROR,
+			"Could not write the temporary tablespace '%s'", path);
+		os_file_delete(innodb_file_data_key, path);
+		return(DB_OUT_OF_FILE_SPACE);
+	}
+
+	if (!fil_space_create(path, space_id, flags, FIL_TABLESPACE)
+	    || !fil_node_create(path, size, space_id, FALSE)) {
+		os_file_delete(innodb_file_data_key, path);
+		return(DB_ERROR);
+	}
+
+	return(DB_SUCCESS);
+}
+
 #ifndef UNIV_HOTBACKUP
 /********************************************************************//**
 Report information about a bad tablespace. */
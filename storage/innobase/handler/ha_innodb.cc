@@ -60,6 +60,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "trx0sys.h"
 #include "mtr0mtr.h"
 #include "rem0types.h"
+#include "row0bulk.h"
 #include "row0ins.h"
 #include "row0mysql.h"
 #include "row0sel.h"
@@ -216,6 +217,22 @@ static TYPELIB innodb_stats_method_typelib = {
 	NULL
 };
 
+/** Possible values for system variable "innodb_lock_schedule_algorithm". */
+static const char* innodb_lock_schedule_algorithm_names[] = {
+	"fcfs",
+	"cats",
+	NullS
+};
+
+/** Used to define an enumerate type of the system variable
+innodb_lock_schedule_algorithm. */
+static TYPELIB innodb_lock_schedule_algorithm_typelib = {
+	array_elements(innodb_lock_schedule_algorithm_names) - 1,
+	"innodb_lock_schedule_algorithm_typelib",
+	innodb_lock_schedule_algorithm_names,
+	NULL
+};
+
 /** Possible values for system variable "innodb_checksum_algorithm". */
 static const char* innodb_checksum_algorithm_names[] = {
 	"crc32",
@@ -521,6 +538,12 @@ static MYSQL_THDVAR_BOOL(strict_mode, PLUGIN_VAR_OPCMDARG,
   "Use strict mode when evaluating create options.",
   NULL, NULL, FALSE);
 
+static MYSQL_THDVAR_BOOL(bulk_load, PLUGIN_VAR_OPCMDARG,
+  "Build the indexes bottom-up when a multi-row INSERT, REPLACE or"
+  " LOAD DATA statement starts on an empty table. The table is locked"
+  " exclusively until the end of the transaction.",
+  NULL, NULL, FALSE);
+
 static MYSQL_THDVAR_BOOL(ft_enable_stopword, PLUGIN_VAR_OPCMDARG,
   "Create FTS index with stopword.",
   NULL, NULL,
@@ -576,6 +599,8 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_buffer_pool_dump_status,	  SHOW_CHAR},
   {"buffer_pool_load_status",
   (char*) &export_vars.innodb_buffer_pool_load_status,	  SHOW_CHAR},
+  {"buffer_pool_resize_status",
+  (char*) &export_vars.innodb_buffer_pool_resize_status,  SHOW_CHAR},
   {"buffer_pool_pages_data",
   (char*) &export_vars.innodb_buffer_pool_pages_data,	  SHOW_LONG},
   {"buffer_pool_bytes_data",
@@ -614,6 +639,10 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_buffer_pool_read_ahead,	  SHOW_LONG},
   {"buffer_pool_read_ahead_evicted",
   (char*) &export_vars.innodb_buffer_pool_read_ahead_evicted, SHOW_LONG},
+  {"buffer_pool_fake_changes_reads",
+  (char*) &export_vars.innodb_buffer_pool_fake_changes_reads, SHOW_LONG},
+  {"buffer_pool_fake_changes_hits",
+  (char*) &export_vars.innodb_buffer_pool_fake_changes_hits, SHOW_LONG},
   {"buffer_pool_read_requests",
   (char*) &export_vars.innodb_buffer_pool_read_requests,  SHOW_LONG},
   {"buffer_pool_reads",
@@ -826,6 +855,8 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_lock_wait_timeouts,	  SHOW_LONG},
   {"row_lock_waits",
   (char*) &export_vars.innodb_row_lock_waits,		  SHOW_LONG},
+  {"rows_bulk_loaded",
+  (char*) &export_vars.innodb_rows_bulk_loaded,		  SHOW_LONG},
   {"rows_deleted",
   (char*) &export_vars.innodb_rows_deleted,		  SHOW_LONG},
   {"rows_inserted",
@@ -946,6 +977,10 @@ static SHOW_VAR innodb_status_variables[]= {
    (char*) &export_vars.innodb_logical_read_ahead_prefetched, SHOW_LONG},
   {"logical_read_ahead_in_buf_pool",
    (char*) &export_vars.innodb_logical_read_ahead_in_buf_pool, SHOW_LONG},
+  {"blob_read_ahead_prefetched",
+   (char*) &export_vars.innodb_blob_read_ahead_prefetched, SHOW_LONG},
+  {"blob_read_ahead_hits",
+   (char*) &export_vars.innodb_blob_read_ahead_hits, SHOW_LONG},
   {"zip_1024_compressed",
   (char*) &export_vars.zip1024_compressed,                SHOW_LONG},
   {"zip_1024_compressed_ok",
@@ -3900,6 +3935,9 @@ innobase_change_buffering_inited_ok:
 		goto mem_free_and_error;
 	}
 
+	/* The buffer pool size was aligned to the chunk size. */
+	innobase_buffer_pool_size = (long long) srv_buf_pool_size;
+
 	/* Adjust the innodb_undo_logs config object */
 	innobase_undo_logs_init_default_max();
 
@@ -7202,6 +7240,61 @@ ha_innobase::innobase_set_max_autoinc(
 	return(error);
 }
 
+/********************************************************************//**
+MySQL calls this before inserting many rows with one statement. Requests
+a bulk load, which the first row will start if the table is empty. */
+UNIV_INTERN
+void
+ha_innobase::start_bulk_insert(
+/*===========================*/
+	ha_rows	rows)	/*!< in: estimated number of rows, or 0 if
+			not known */
+{
+	switch (thd_sql_command(user_thd)) {
+	case SQLCOM_INSERT:
+	case SQLCOM_INSERT_SELECT:
+	case SQLCOM_REPLACE:
+	case SQLCOM_REPLACE_SELECT:
+	case SQLCOM_LOAD:
+		/* ALTER TABLE commits every 10000 rows, which would end
+		the bulk load, so it is not requested for it. */
+		break;
+	default:
+		return;
+	}
+
+	prebuilt->bulk_requested = rows != 1
+		&& THDVAR(user_thd, bulk_load)
+		&& !srv_read_only_mode
+		&& !prebuilt->trx->fake_changes;
+}
+
+/********************************************************************//**
+MySQL calls this after inserting the rows of start_bulk_insert(). Ends
+the bulk load, if any.
+@return	error code */
+UNIV_INTERN
+int
+ha_innobase::end_bulk_insert()
+/*==========================*/
+{
+	dberr_t	error;
+
+	if (prebuilt->bulk == NULL) {
+		prebuilt->bulk_requested = 0;
+		return(0);
+	}
+
+	innobase_srv_conc_enter_innodb(prebuilt->trx, true);
+
+	error = row_bulk_finish(prebuilt);
+
+	innobase_srv_conc_exit_innodb(prebuilt->trx, true);
+
+	return(convert_error_code_to_mysql(
+		       error, prebuilt->table->flags, user_thd));
+}
+
 /********************************************************************//**
 Stores a row in an InnoDB database, to the table specified in this
 handle.
@@ -10559,7 +10652,8 @@ ha_innobase::discard_or_import_tablespace(
 
 	dict_table = prebuilt->table;
 
-	if (dict_table->space == TRX_SYS_SPACE) {
+	if (dict_table->space == TRX_SYS_SPACE
+	    || fsp_is_system_temporary(dict_table->space)) {
 
 		ib_senderrf(
 			prebuilt->trx->mysql_thd, IB_LOG_LEVEL_ERROR,
@@ -12743,6 +12837,15 @@ ha_innobase::reset()
 		row_mysql_prebuilt_free_blob_heap(prebuilt);
 	}
 
+	/* A bulk load that was not ended by end_bulk_insert() is
+	abandoned: the statement will be rolled back. */
+	if (prebuilt->bulk) {
+		row_bulk_free(prebuilt->bulk);
+		prebuilt->bulk = NULL;
+	}
+
+	prebuilt->bulk_requested = 0;
+
 	reset_template();
 	ds_mrr.reset();
 
@@ -13406,6 +13509,60 @@ innodb_mutex_show_status(
 
 	mutex_exit(&rw_lock_list_mutex);
 
+	/* Wait time histograms by the place the latches are created at.
+	Each bucket is shown as the upper bound of the wait time in
+	microseconds and the number of waits, "inf" for the last one. */
+	for (ulint i = 0; i < SYNC_WAIT_N_CLASSES; i++) {
+		const sync_wait_class_t*	wait_class
+			= &sync_wait_classes[i];
+
+		if (wait_class->cfile_name == NULL) {
+			continue;
+		}
+
+		buf2len = (uint) my_snprintf(buf2, sizeof buf2,
+					     "wait_histogram=");
+
+		uint	n_buckets = 0;
+
+		for (ulint b = 0; b < SYNC_WAIT_HIST_N_BUCKETS; b++) {
+			ib_uint64_t	n_waits = wait_class->n_waits[b];
+
+			if (n_waits == 0) {
+				continue;
+			}
+
+			if (b == SYNC_WAIT_HIST_N_BUCKETS - 1) {
+				buf2len += (uint) my_snprintf(
+					buf2 + buf2len, sizeof buf2 - buf2len,
+					"%sinf:%llu", n_buckets ? "," : "",
+					(ulonglong) n_waits);
+			} else {
+				buf2len += (uint) my_snprintf(
+					buf2 + buf2len, sizeof buf2 - buf2len,
+					"%s%llu:%llu", n_buckets ? "," : "",
+					1ULL << b, (ulonglong) n_waits);
+			}
+
+			n_buckets++;
+		}
+
+		if (n_buckets == 0) {
+			continue;
+		}
+
+		buf1len = (uint) my_snprintf(buf1, sizeof buf1, "%s:%lu",
+					     innobase_basename(
+						wait_class->cfile_name),
+					     (ulong) wait_class->cline);
+
+		if (stat_print(thd, innobase_hton_name,
+			       hton_name_len, buf1, buf1len,
+			       buf2, buf2len)) {
+			DBUG_RETURN(1);
+		}
+	}
+
 #ifdef UNIV_DEBUG
 	buf2len = my_snprintf(buf2, sizeof buf2,
 			     "count=%lu, spin_waits=%lu, spin_rounds=%lu, "
@@ -14571,6 +14728,61 @@ ha_innobase::check_if_incompatible_data(
 	return(COMPATIBLE_DATA_YES);
 }
 
+/****************************************************************//**
+Update the system variable innodb_buffer_pool_size using the "saved"
+value, and wake up buf_resize_thread to resize the buffer pool. This
+function is registered as a callback with MySQL. */
+static
+void
+innodb_buffer_pool_size_update(
+/*===========================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to
+						system variable */
+	void*				var_ptr,/*!< out: where the
+						formal string goes */
+	const void*			save)	/*!< in: immediate result
+						from check function */
+{
+	longlong	in_val = *static_cast<const longlong*>(save);
+	ulint		aligned;
+
+	if (srv_read_only_mode) {
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    ER_WRONG_ARGUMENTS,
+				    "innodb_buffer_pool_size cannot be"
+				    " changed in read-only mode.");
+		return;
+	}
+
+	if (srv_buf_pool_old_size != srv_buf_pool_size) {
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    ER_WRONG_ARGUMENTS,
+				    "Another buffer pool resize is already"
+				    " in progress.");
+		return;
+	}
+
+	aligned = buf_pool_size_align((ulint) in_val);
+
+	if (aligned != (ulint) in_val) {
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    ER_WRONG_ARGUMENTS,
+				    "innodb_buffer_pool_size must be a"
+				    " multiple of innodb_buffer_pool_chunk_size"
+				    " * innodb_buffer_pool_instances.");
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    ER_WRONG_ARGUMENTS,
+				    "Setting innodb_buffer_pool_size to %lu",
+				    aligned);
+	}
+
+	*static_cast<longlong*>(var_ptr) = (longlong) aligned;
+	srv_buf_pool_size = aligned;
+
+	os_event_set(srv_buf_resize_event);
+}
+
 /****************************************************************//**
 Update the system variable innodb_io_capacity_max using the "saved"
 value. This function is registered as a callback with MySQL. */
@@ -16557,6 +16769,13 @@ static MYSQL_SYSVAR_BOOL(file_per_table, srv_file_per_table,
   "Stores each InnoDB table to an .ibd file in the database dir.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(temp_tablespace, srv_tmp_tablespace,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Stores the InnoDB temporary tables, except the compressed ones, in the "
+  "shared tablespace " SRV_TMP_SPACE_NAME " that is created again at "
+  "every startup and is not redo logged.",
+  NULL, NULL, TRUE);
+
 static MYSQL_SYSVAR_STR(file_format, innobase_file_format_name,
   PLUGIN_VAR_RQCMDARG,
   "File format to use for new tables in .ibd files.",
@@ -16832,9 +17051,17 @@ static MYSQL_SYSVAR_ULONG(autoextend_increment, srv_auto_extend_increment,
   NULL, NULL, 64L, 1L, 1000L, 0);
 
 static MYSQL_SYSVAR_LONGLONG(buffer_pool_size, innobase_buffer_pool_size,
-  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  PLUGIN_VAR_RQCMDARG,
   "The size of the memory buffer InnoDB uses to cache data and indexes of its tables.",
-  NULL, NULL, 128*1024*1024L, 5*1024*1024L, LONGLONG_MAX, 1024*1024L);
+  NULL, innodb_buffer_pool_size_update,
+  128*1024*1024L, 5*1024*1024L, LONGLONG_MAX, 1024*1024L);
+
+static MYSQL_SYSVAR_ULONG(buffer_pool_chunk_size, srv_buf_pool_chunk_unit,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Size of a single memory chunk within each buffer pool instance"
+  " for resizing the buffer pool. The online buffer pool resize"
+  " adds or removes whole chunks.",
+  NULL, NULL, 128 * 1024 * 1024, 1024 * 1024, LONG_MAX, 1024 * 1024);
 
 static MYSQL_SYSVAR_ULONG(sync_pool_size, innobase_sync_pool_size,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
@@ -17118,6 +17345,14 @@ static MYSQL_SYSVAR_BOOL(deadlock_detect, srv_deadlock_detect,
   " timeout resolves deadlock.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_ENUM(lock_schedule_algorithm, srv_lock_schedule_algorithm,
+  PLUGIN_VAR_RQCMDARG,
+  "The order in which waiting record locks are granted when a lock is"
+  " released. FCFS grants them in the order they were requested, CATS"
+  " first grants the lock of the transaction that blocks the most other"
+  " transactions.",
+  NULL, NULL, SRV_LOCK_SCHEDULE_FCFS, &innodb_lock_schedule_algorithm_typelib);
+
 static MYSQL_SYSVAR_ULONG(thread_sleep_delay, srv_thread_sleep_delay,
   PLUGIN_VAR_RQCMDARG,
   "Time of innodb thread sleeping before joining InnoDB queue (usec). "
@@ -17267,6 +17502,13 @@ static MYSQL_SYSVAR_ULONG(read_ahead_threshold, srv_read_ahead_threshold,
   "trigger a readahead.",
   NULL, NULL, 56, 0, 64, 0);
 
+static MYSQL_SYSVAR_ULONG(blob_read_ahead_pages, srv_blob_read_ahead_pages,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum number of pages of a BLOB that are read ahead at once when the"
+  " BLOB is read and its pages are not in the buffer pool. 0 disables"
+  " BLOB read-ahead.",
+  NULL, NULL, 64, 0, 1024, 0);
+
 static MYSQL_SYSVAR_ULONG(trx_log_write_block_size,
   srv_trx_log_write_block_size,
   PLUGIN_VAR_RQCMDARG,
@@ -17439,6 +17681,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(api_bk_commit_interval),
   MYSQL_SYSVAR(autoextend_increment),
   MYSQL_SYSVAR(buffer_pool_size),
+  MYSQL_SYSVAR(buffer_pool_chunk_size),
   MYSQL_SYSVAR(sync_pool_size),
   MYSQL_SYSVAR(buffer_pool_instances),
   MYSQL_SYSVAR(buffer_pool_filename),
@@ -17469,6 +17712,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(read_io_threads),
   MYSQL_SYSVAR(write_io_threads),
   MYSQL_SYSVAR(file_per_table),
+  MYSQL_SYSVAR(temp_tablespace),
   MYSQL_SYSVAR(file_format),
   MYSQL_SYSVAR(file_format_check),
   MYSQL_SYSVAR(file_format_max),
@@ -17529,6 +17773,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(replication_delay),
   MYSQL_SYSVAR(status_file),
   MYSQL_SYSVAR(strict_mode),
+  MYSQL_SYSVAR(bulk_load),
   MYSQL_SYSVAR(support_xa),
   MYSQL_SYSVAR(sort_buffer_size),
   MYSQL_SYSVAR(online_alter_log_max_size),
@@ -17555,6 +17800,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(random_read_ahead),
   MYSQL_SYSVAR(trx_log_write_block_size),
   MYSQL_SYSVAR(read_ahead_threshold),
+  MYSQL_SYSVAR(blob_read_ahead_pages),
   MYSQL_SYSVAR(read_only),
   MYSQL_SYSVAR(sync_checkpoint_limit),
   MYSQL_SYSVAR(enable_slave_update_table_stats),
@@ -17595,6 +17841,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(lra_test),
 #endif /* UNIV_DEBUG */
   MYSQL_SYSVAR(deadlock_detect),
+  MYSQL_SYSVAR(lock_schedule_algorithm),
   MYSQL_SYSVAR(aio_slow_usecs),
   MYSQL_SYSVAR(aio_old_usecs),
 #ifdef UNIV_DEBUG
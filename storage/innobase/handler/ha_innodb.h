@@ -138,6 +138,8 @@ class ha_innobase: public handler
 	longlong get_memory_buffer_size() const;
 	my_bool is_fake_change_enabled(THD *thd);
 
+	void start_bulk_insert(ha_rows rows);
+	int end_bulk_insert();
 	int write_row(uchar * buf);
 	int update_row(const uchar * old_data, uchar * new_data);
 	int delete_row(const uchar * buf);
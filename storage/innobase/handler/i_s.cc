@@ -5418,20 +5418,24 @@ i_s_innodb_fill_buffer_pool(
 
 	heap = mem_heap_create(10000);
 
-	/* Go through each chunk of buffer pool. Currently, we only
-	have one single chunk for each buffer pool */
+	/* Go through each chunk of buffer pool. The chunks can be
+	removed by a buffer pool resize while we do not hold
+	buf_pool->mutex. */
 	for (ulint n = 0; n < buf_pool->n_chunks; n++) {
+		const buf_block_t*	chunk_start;
 		const buf_block_t*	block;
 		ulint			n_blocks;
 		buf_page_info_t*	info_buffer;
 		ulint			num_page;
 		ulint			mem_size;
 		ulint			chunk_size;
+		ulint			curr_chunk_size;
 		ulint			num_to_process = 0;
 		ulint			block_id = 0;
 
 		/* Get buffer block of the nth chunk */
-		block = buf_get_nth_chunk_block(buf_pool, n, &chunk_size);
+		chunk_start = block = buf_get_nth_chunk_block(
+			buf_pool, n, &chunk_size);
 		num_page = 0;
 
 		while (chunk_size > 0) {
@@ -5454,6 +5458,15 @@ i_s_innodb_fill_buffer_pool(
 			release mutex periodically */
 			buf_pool_mutex_enter(buf_pool);
 
+			if (n >= buf_pool->n_chunks
+			    || buf_get_nth_chunk_block(
+				    buf_pool, n, &curr_chunk_size)
+			    != chunk_start) {
+				/* The chunk was removed meanwhile. */
+				buf_pool_mutex_exit(buf_pool);
+				break;
+			}
+
 			/* GO through each block in the chunk */
 			for (n_blocks = num_to_process; n_blocks--; block++) {
 				i_s_innodb_buffer_page_get_info(
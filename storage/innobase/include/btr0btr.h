@@ -99,13 +99,20 @@ buffer when the record is not in the buffer pool. */
 already holding an S latch on the index tree */
 #define BTR_ALREADY_S_LATCHED	16384
 
+/** This flag ORed to BTR_MODIFY_TREE says that the tree is modified only
+to insert the search tuple, so that it is enough to sx-latch the index
+tree and x-latch the non-leaf pages that a page split may change; other
+threads may keep searching the tree meanwhile */
+#define BTR_LATCH_FOR_INSERT	32768
+
 #define BTR_LATCH_MODE_WITHOUT_FLAGS(latch_mode)	\
 	((latch_mode) & ~(BTR_INSERT			\
 			  | BTR_DELETE_MARK		\
 			  | BTR_DELETE			\
 			  | BTR_ESTIMATE		\
 			  | BTR_IGNORE_SEC_UNIQUE	\
-			  | BTR_ALREADY_S_LATCHED))
+			  | BTR_ALREADY_S_LATCHED	\
+			  | BTR_LATCH_FOR_INSERT))
 
 /* Max number of pages to consider at once during defragmentation. */
 #define BTR_DEFRAGMENT_MAX_N_PAGES	32
@@ -263,6 +270,19 @@ btr_root_get(
 	mtr_t*			mtr)	/*!< in: mtr */
 	__attribute__((nonnull));
 
+/**************************************************************//**
+Gets the root node of a tree and x- or s-latches or buffer-fixes it.
+@return	root page, x- or s-latched or buffer-fixed */
+UNIV_INTERN
+buf_block_t*
+btr_root_block_get(
+/*===============*/
+	const dict_index_t*	index,	/*!< in: index tree */
+	ulint			mode,	/*!< in: RW_S_LATCH, RW_X_LATCH
+					or RW_NO_LATCH */
+	mtr_t*			mtr)	/*!< in: mtr */
+	__attribute__((nonnull));
+
 /**************************************************************//**
 Checks and adjusts the root node of a tree during IMPORT TABLESPACE.
 @return error code, or DB_SUCCESS */
@@ -752,6 +772,31 @@ btr_page_alloc(
 					the page */
 	__attribute__((nonnull, warn_unused_result));
 /**************************************************************//**
+Creates a new index page (not the root, and also not
+used in page reorganization).  @see btr_page_empty(). */
+UNIV_INTERN
+void
+btr_page_create(
+/*============*/
+	buf_block_t*	block,	/*!< in/out: page to be created */
+	page_zip_des_t*	page_zip,/*!< in/out: compressed page, or NULL */
+	dict_index_t*	index,	/*!< in: index */
+	ulint		level,	/*!< in: the B-tree level of the page */
+	mtr_t*		mtr)	/*!< in: mtr */
+	__attribute__((nonnull(1,3,5)));
+/*************************************************************//**
+Empties an index page.  @see btr_page_create(). */
+UNIV_INTERN
+void
+btr_page_empty(
+/*===========*/
+	buf_block_t*	block,	/*!< in: page to be emptied */
+	page_zip_des_t*	page_zip,/*!< out: compressed page, or NULL */
+	dict_index_t*	index,	/*!< in: index of the page */
+	ulint		level,	/*!< in: the B-tree level of the page */
+	mtr_t*		mtr)	/*!< in: mtr */
+	__attribute__((nonnull(1,3,5)));
+/**************************************************************//**
 Frees a file page used in an index tree. NOTE: cannot free field external
 storage pages because the page must contain info on its level. */
 UNIV_INTERN
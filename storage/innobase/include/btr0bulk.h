@@ -0,0 +1,87 @@
+/*****************************************************************************
+
+Copyright (c) 2013, Facebook Inc.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/btr0bulk.h
+Bottom-up building of an index tree from sorted records
+
+The records are appended to the rightmost leaf page, which is built
+without logging the individual records: the finished page is logged as a
+whole. The node pointers of the finished pages are appended to the upper
+levels in the same way as the records to the leaf level. The pages are not
+reachable from the root until btr_bulk_finish() copies the top page of the
+new tree to the root page, which must be empty.
+*******************************************************/
+
+#ifndef btr0bulk_h
+#define btr0bulk_h
+
+#include "univ.i"
+#include "dict0types.h"
+#include "data0types.h"
+#include "trx0types.h"
+
+/** Bottom-up index tree builder */
+struct btr_bulk_t;
+
+/**************************************************************//**
+Creates a builder of the tree of an empty index.
+@return	own: tree builder */
+UNIV_INTERN
+btr_bulk_t*
+btr_bulk_create(
+/*============*/
+	dict_index_t*	index,	/*!< in: uncompressed index whose
+				root page is empty */
+	trx_id_t	trx_id)	/*!< in: PAGE_MAX_TRX_ID of the
+				secondary index leaf pages */
+	__attribute__((nonnull, malloc, warn_unused_result));
+/**************************************************************//**
+Appends a record to the tree being built. The record must be greater
+than the previously appended one and it must not need external storage.
+@return	DB_SUCCESS, DB_FAIL if the record is not greater than the
+previous one, or error code */
+UNIV_INTERN
+dberr_t
+btr_bulk_insert(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in/out: tree builder */
+	const dtuple_t*	tuple)	/*!< in: record to append; the
+				data is copied */
+	__attribute__((nonnull, warn_unused_result));
+/**************************************************************//**
+Writes the remaining records and attaches the built tree to the root
+page of the index.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+dberr_t
+btr_bulk_finish(
+/*============*/
+	btr_bulk_t*	bulk)	/*!< in/out: tree builder */
+	__attribute__((nonnull, warn_unused_result));
+/**************************************************************//**
+Frees a tree builder. The pages of an unfinished tree stay allocated
+to the index until it is emptied or dropped. */
+UNIV_INTERN
+void
+btr_bulk_free(
+/*==========*/
+	btr_bulk_t*	bulk)	/*!< in, own: tree builder */
+	__attribute__((nonnull));
+
+#endif /* btr0bulk_h */
@@ -46,6 +46,15 @@ Frees the adaptive search system at a database shutdown. */
 UNIV_INTERN
 void
 btr_search_sys_free(void);
+/*****************************************************************//**
+Recreates the hash table of the adaptive search system with a new size
+after a buffer pool resize. Does nothing if the adaptive hash index has
+been enabled meanwhile. */
+UNIV_INTERN
+void
+btr_search_sys_resize(
+/*==================*/
+	ulint	hash_size);	/*!< in: hash index hash table size */
 /*=====================*/
 
 /********************************************************************//**
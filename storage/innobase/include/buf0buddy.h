@@ -70,6 +70,32 @@ buf_buddy_free(
 					up to UNIV_PAGE_SIZE */
 	__attribute__((nonnull));
 
+/**********************************************************************//**
+Moves a compressed page frame that was allocated from the buddy system
+out of the chunks that a buffer pool resize is removing. The thread
+calling this function must hold buf_pool->mutex and must not hold
+buf_pool->zip_mutex or any block->mutex.
+@return	false if there was no free block to move the frame to */
+UNIV_INTERN
+bool
+buf_buddy_realloc(
+/*==============*/
+	buf_pool_t*	buf_pool,	/*!< in/out: buffer pool instance */
+	void*		buf,		/*!< in: allocated block */
+	ulint		size)		/*!< in: block size,
+					up to UNIV_PAGE_SIZE */
+	__attribute__((nonnull));
+
+/**********************************************************************//**
+Combines the free buddies in the chunks that a buffer pool resize is
+removing, so that whole frames can be returned to the buffer pool. */
+UNIV_INTERN
+void
+buf_buddy_condense_free(
+/*====================*/
+	buf_pool_t*	buf_pool)	/*!< in/out: buffer pool instance */
+	__attribute__((nonnull));
+
 #ifndef UNIV_NONINL
 # include "buf0buddy.ic"
 #endif
@@ -91,6 +91,14 @@ extern ibool		buf_debug_prints;/*!< If this is set TRUE, the program
 #endif /* UNIV_DEBUG */
 extern ulint srv_buf_pool_instances;
 extern ulint srv_buf_pool_curr_size;
+extern ulint srv_buf_pool_chunk_unit;
+
+/** true while the blocks of the chunks that are being removed by a
+buffer pool resize are withdrawn from the free list */
+extern volatile bool	buf_pool_withdrawing;
+/** Incremented whenever a buffer pool resize freed the memory of some
+blocks; see buf_pool_is_obsolete() */
+extern volatile ulint	buf_withdraw_clock;
 #else /* !UNIV_HOTBACKUP */
 extern buf_block_t*	back_block1;	/*!< first block, for --apply-log */
 extern buf_block_t*	back_block2;	/*!< second block, for page reorganize */
@@ -249,6 +257,48 @@ buf_pool_free(
 /*==========*/
 	ulint	n_instances);	/*!< in: numbere of instances to free */
 
+/********************************************************************//**
+Rounds a requested buffer pool size up to a multiple of the chunk size
+times the number of buffer pool instances.
+@return	the aligned size in bytes */
+UNIV_INLINE
+ulint
+buf_pool_size_align(
+/*================*/
+	ulint	size);	/*!< in: requested size in bytes */
+
+/********************************************************************//**
+Resizes the buffer pool to srv_buf_pool_size by adding or removing
+chunks. Only the buffer pool resize thread calls this. */
+UNIV_INTERN
+void
+buf_pool_resize(void);
+/*=================*/
+
+/*****************************************************************//**
+This is the thread for resizing the buffer pool. It waits for
+srv_buf_resize_event and resizes the buffer pool to the new
+innodb_buffer_pool_size.
+@return	this function does not return, it calls os_thread_exit() */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(buf_resize_thread)(
+/*==============================*/
+	void*	arg);	/*!< in: a dummy parameter required by
+			os_thread_create */
+
+/********************************************************************//**
+Checks whether a position that was stored at the given
+buf_withdraw_clock may point to memory that a buffer pool resize
+has freed since.
+@return	true if the stored block pointers must not be used */
+UNIV_INLINE
+bool
+buf_pool_is_obsolete(
+/*=================*/
+	ulint	withdraw_clock);	/*!< in: buf_withdraw_clock
+					at the time of storing */
+
 /********************************************************************//**
 Clears the adaptive hash index on all pages in the buffer pool. */
 UNIV_INTERN
@@ -266,9 +316,34 @@ buf_relocate(
 /*=========*/
 	buf_page_t*	bpage,	/*!< in/out: control block being relocated;
 				buf_page_get_state(bpage) must be
-				BUF_BLOCK_ZIP_DIRTY or BUF_BLOCK_ZIP_PAGE */
+				BUF_BLOCK_ZIP_DIRTY or BUF_BLOCK_ZIP_PAGE,
+				or BUF_BLOCK_FILE_PAGE when a buffer
+				pool resize moves the page out of a
+				chunk that is being removed */
 	buf_page_t*	dpage)	/*!< in/out: destination control block */
 	__attribute__((nonnull));
+/********************************************************************//**
+Determines whether a block belongs to the chunks that the current
+buffer pool resize is removing.
+@return	true if the block will be withdrawn */
+UNIV_INTERN
+bool
+buf_block_will_withdrawn(
+/*=====================*/
+	buf_pool_t*		buf_pool,	/*!< in: buffer pool instance */
+	const buf_block_t*	block)		/*!< in: block */
+	__attribute__((nonnull, warn_unused_result));
+/********************************************************************//**
+Determines whether a pointer points into the frames of the chunks
+that the current buffer pool resize is removing.
+@return	true if the frame will be withdrawn */
+UNIV_INTERN
+bool
+buf_frame_will_withdrawn(
+/*=====================*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	const byte*	ptr)		/*!< in: pointer into a frame */
+	__attribute__((nonnull, warn_unused_result));
 /*********************************************************************//**
 Gets the current size of buffer buf_pool in bytes.
 @return	size in bytes */
@@ -1505,7 +1580,7 @@ struct buf_page_t{
 					in one of the following lists in
 					buf_pool:
 
-					- BUF_BLOCK_NOT_USED:	free
+					- BUF_BLOCK_NOT_USED:	free, withdraw
 					- BUF_BLOCK_FILE_PAGE:	flush_list
 					- BUF_BLOCK_ZIP_DIRTY:	flush_list
 					- BUF_BLOCK_ZIP_PAGE:	zip_clean
@@ -1536,7 +1611,8 @@ struct buf_page_t{
 					and buf_pool->flush_list_mutex. Hence
 					reads can happen while holding
 					any one of the two mutexes */
-	ibool		in_free_list;	/*!< TRUE if in buf_pool->free; when
+	ibool		in_free_list;	/*!< TRUE if in buf_pool->free or
+					buf_pool->withdraw; when
 					buf_pool->mutex is free, the following
 					should hold: in_free_list
 					== (state == BUF_BLOCK_NOT_USED) */
@@ -1591,6 +1667,13 @@ struct buf_page_t{
 					0 if the block was never accessed
 					in the buffer pool. Protected by
 					block mutex */
+	ibool		fake_changes_read;
+					/*!< TRUE if the page was read in
+					by a transaction running with
+					innodb_fake_changes and has not
+					been accessed by any other
+					transaction since. Protected by
+					block mutex */
 # if defined UNIV_DEBUG_FILE_ACCESSES || defined UNIV_DEBUG
 	ibool		file_page_was_freed;
 					/*!< this is set to TRUE when
@@ -1898,9 +1981,24 @@ struct buf_pool_t{
 #if defined UNIV_DEBUG || defined UNIV_BUF_DEBUG
 	ulint		mutex_exit_forbidden; /*!< Forbid release mutex */
 #endif
-	ulint		n_chunks;	/*!< number of buffer pool chunks */
-	buf_chunk_t*	chunks;		/*!< buffer pool chunks */
+	volatile ulint	n_chunks;	/*!< number of buffer pool chunks */
+	volatile ulint	n_chunks_new;	/*!< new number of buffer pool chunks
+					while the buffer pool is resized */
+	buf_chunk_t* volatile chunks;	/*!< buffer pool chunks; the array
+					is replaced and n_chunks changed
+					while the buffer pool is resized,
+					so that the readers that do not
+					hold buf_pool->mutex must read
+					n_chunks before chunks */
+	buf_chunk_t*	chunks_old;	/*!< the chunks array that was
+					replaced by the last resize, kept
+					for such readers and freed by the
+					next resize or at shutdown */
 	ulint		curr_size;	/*!< current pool size in pages */
+	ulint		old_size;	/*!< previous pool size in pages */
+	ulint		withdraw_target;/*!< target length of the withdraw
+					list while the buffer pool is
+					shrunk */
 	hash_table_t*	page_hash;	/*!< hash table of buf_page_t or
 					buf_block_t file pages,
 					buf_page_in_file() == TRUE,
@@ -2009,6 +2107,13 @@ struct buf_pool_t{
 	UT_LIST_BASE_NODE_T(buf_page_t) free;
 					/*!< base node of the free
 					block list */
+	UT_LIST_BASE_NODE_T(buf_page_t) withdraw;
+					/*!< base node of the blocks of
+					the chunks that are being removed
+					by a buffer pool resize; the
+					blocks are linked through
+					buf_page_t::list like the free
+					list */
 	UT_LIST_BASE_NODE_T(buf_page_t) LRU;
 					/*!< base node of the LRU list */
 	buf_page_t*	LRU_old;	/*!< pointer to the about
@@ -153,6 +153,22 @@ buf_read_ahead_linear(
 	ibool	inside_ibuf,	/*!< in: TRUE if we are inside ibuf routine */
 	trx_t*	trx);
 /********************************************************************//**
+Issues asynchronous reads for the pages of an externally stored field that
+the caller is about to read, assuming that they follow each other in the
+tablespace, as btr_store_big_rec_extern_fields() allocates them. The reads
+are submitted together. NOTE: the calling thread may own latches on pages:
+this function does not wait for any page latch.
+@return	number of page read requests issued */
+UNIV_INTERN
+ulint
+buf_read_ahead_blob(
+/*================*/
+	ulint	space,		/*!< in: space id */
+	ulint	zip_size,	/*!< in: compressed page size in bytes, or 0 */
+	ulint	offset,		/*!< in: page number of the first page */
+	ulint	n_pages,	/*!< in: number of pages to read */
+	trx_t*	trx);		/*!< in: transaction, or NULL */
+/********************************************************************//**
 Issues read requests for pages which the ibuf module wants to read in, in
 order to contract the insert buffer tree. Technically, this function is like
 a read-ahead function. */
@@ -594,6 +594,13 @@ struct dict_index_t{
 				by dict_operation_lock and
 				dict_sys->mutex. Other changes are
 				protected by index->lock. */
+	unsigned	search_prefix_len:4;
+				/*!< 0 or the length of the first field,
+				when it is a NOT NULL fixed-length
+				field of at most 8 bytes whose values
+				order like the bytes (integer or binary);
+				page_cur_search_with_match() then
+				compares it as an integer */
 	dict_field_t*	fields;	/*!< array of field descriptions */
 #ifndef UNIV_HOTBACKUP
 	UT_LIST_NODE_T(dict_index_t)
@@ -850,6 +850,21 @@ fil_create_new_single_table_tablespace(
 					tablespace file in pages,
 					must be >= FIL_IBD_FILE_INITIAL_SIZE */
 	__attribute__((nonnull, warn_unused_result));
+/*******************************************************************//**
+Creates the shared temporary tablespace, replacing the file that a
+previous server instance may have left behind. Unlike for a single-table
+tablespace, no MLOG_FILE_CREATE record is written: the tablespace is
+never recovered, it is created again at the next startup.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+dberr_t
+fil_create_temporary_tablespace(
+/*============================*/
+	ulint		space_id,	/*!< in: space id */
+	const char*	path,		/*!< in: file path */
+	ulint		size)		/*!< in: the initial size of the
+					tablespace file in pages */
+	__attribute__((nonnull, warn_unused_result));
 #ifndef UNIV_HOTBACKUP
 /********************************************************************//**
 Tries to open a single-table tablespace and optionally checks the space id is
@@ -608,6 +608,15 @@ fsp_descr_page(
 	ulint	zip_size,/*!< in: compressed page size in bytes;
 			0 for uncompressed pages */
 	ulint	page_no);/*!< in: page number */
+/***********************************************************************//**
+Checks if a tablespace is the shared temporary tablespace, whose pages
+are neither redo logged nor written through the doublewrite buffer.
+@return	true if the space is the shared temporary tablespace */
+UNIV_INLINE
+bool
+fsp_is_system_temporary(
+/*====================*/
+	ulint	space);	/*!< in: space id */
 /***********************************************************//**
 Parses a redo log record of a file page init.
 @return	end of log record or NULL */
@@ -424,6 +424,31 @@ hash_get_lock(
 	hash_table_t*	table,	/*!< in: hash table */
 	ulint		fold);	/*!< in: fold */
 /************************************************************//**
+Makes sure that an s-locked rw_lock is still the lock of a fold value
+in a hash table whose array can be resized, that is, that the number
+of cells did not change before the lock was acquired. Otherwise
+releases it and s-locks the right lock.
+@return	the s-locked rw_lock for the fold value */
+UNIV_INLINE
+rw_lock_t*
+hash_lock_s_confirm(
+/*================*/
+	rw_lock_t*	hash_lock,	/*!< in: s-locked rw_lock */
+	hash_table_t*	table,		/*!< in: hash table */
+	ulint		fold);		/*!< in: fold */
+/************************************************************//**
+Makes sure that an x-locked rw_lock is still the lock of a fold value
+in a hash table whose array can be resized. Otherwise releases it and
+x-locks the right lock.
+@return	the x-locked rw_lock for the fold value */
+UNIV_INLINE
+rw_lock_t*
+hash_lock_x_confirm(
+/*================*/
+	rw_lock_t*	hash_lock,	/*!< in: x-locked rw_lock */
+	hash_table_t*	table,		/*!< in: hash table */
+	ulint		fold);		/*!< in: fold */
+/************************************************************//**
 Reserves the mutex for a fold value in a hash table. */
 UNIV_INTERN
 void
@@ -299,7 +299,7 @@ lock_rec_insert_check_and_lock(
 				inserted record maybe should inherit
 				LOCK_GAP type locks from the successor
 				record */
-	__attribute__((nonnull, warn_unused_result));
+	__attribute__((nonnull(2,3,4,6,7), warn_unused_result));
 /*********************************************************************//**
 Checks if locks of other transactions prevent an immediate modify (update,
 delete mark, or delete unmark) of a clustered index record. If they do,
@@ -477,13 +477,15 @@ lock_table(
 	que_thr_t*	thr)	/*!< in: query thread */
 	__attribute__((nonnull, warn_unused_result));
 /*********************************************************************//**
-Creates a table IX lock object for a resurrected transaction. */
+Creates a table IX or X lock object for a resurrected transaction. */
 UNIV_INTERN
 void
-lock_table_ix_resurrect(
-/*====================*/
+lock_table_resurrect(
+/*=================*/
 	dict_table_t*	table,	/*!< in/out: table */
-	trx_t*		trx);	/*!< in/out: transaction */
+	trx_t*		trx,	/*!< in/out: transaction */
+	enum lock_mode	mode);	/*!< in: LOCK_IX, or LOCK_X for a bulk
+				load into an empty table */
 /*************************************************************//**
 Removes a granted record lock of a transaction from the queue and grants
 locks to other transactions waiting in the queue if they now are entitled
@@ -758,6 +760,16 @@ lock_table_has_locks(
 					held on records in this table or on the
 					table itself */
 
+/*********************************************************************//**
+Computes the scheduling weights used by innodb_lock_schedule_algorithm=cats.
+The weight of a transaction is the number of waiting transactions whose
+chain of record lock waits goes through it. The caller must hold
+lock_sys->wait_mutex. */
+UNIV_INTERN
+void
+lock_update_schedule_weights(void);
+/*==============================*/
+
 /*********************************************************************//**
 A thread which wakes up threads whose lock wait may have lasted too long.
 @return	a dummy parameter */
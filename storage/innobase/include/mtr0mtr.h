@@ -58,6 +58,7 @@ first 3 values must be RW_S_LATCH, RW_X_LATCH, RW_NO_LATCH */
 #endif /* UNIV_DEBUG */
 #define	MTR_MEMO_S_LOCK		55
 #define	MTR_MEMO_X_LOCK		56
+#define	MTR_MEMO_SX_LOCK	57
 
 /** @name Log item types
 The log items are declared 'byte' so that the compiler can warn if val
@@ -248,6 +249,19 @@ mtr_release_s_latch_at_savepoint(
 	mtr_t*		mtr,		/*!< in: mtr */
 	ulint		savepoint,	/*!< in: savepoint */
 	rw_lock_t*	lock);		/*!< in: latch to release */
+/**********************************************************//**
+Releases the page latches and buffer fixes that were stored in an mtr
+memo between two savepoints. None of the pages may have been modified
+in the mtr. */
+UNIV_INTERN
+void
+mtr_release_blocks_between_savepoints(
+/*==================================*/
+	mtr_t*		mtr,		/*!< in/out: mtr */
+	ulint		start,		/*!< in: savepoint of the first
+					block to release */
+	ulint		end);		/*!< in: savepoint after the last
+					block to release */
 #else /* !UNIV_HOTBACKUP */
 # define mtr_release_s_latch_at_savepoint(mtr,savepoint,lock) ((void) 0)
 #endif /* !UNIV_HOTBACKUP */
@@ -288,6 +302,10 @@ This macro locks an rw-lock in x-mode. */
 #define mtr_x_lock(B, MTR)	mtr_x_lock_func((B), __FILE__, __LINE__,\
 						(MTR))
 /*********************************************************************//**
+This macro locks an rw-lock in sx-mode. */
+#define mtr_sx_lock(B, MTR)	mtr_sx_lock_func((B), __FILE__, __LINE__,\
+						 (MTR))
+/*********************************************************************//**
 NOTE! Use the macro above!
 Locks a lock in s-mode. */
 UNIV_INLINE
@@ -309,6 +327,17 @@ mtr_x_lock_func(
 	const char*	file,	/*!< in: file name */
 	ulint		line,	/*!< in: line number */
 	mtr_t*		mtr);	/*!< in: mtr */
+/*********************************************************************//**
+NOTE! Use the macro above!
+Locks a lock in sx-mode. */
+UNIV_INLINE
+void
+mtr_sx_lock_func(
+/*=============*/
+	rw_lock_t*	lock,	/*!< in: rw-lock */
+	const char*	file,	/*!< in: file name */
+	ulint		line,	/*!< in: line number */
+	mtr_t*		mtr);	/*!< in: mtr */
 #endif /* !UNIV_HOTBACKUP */
 
 /***************************************************//**
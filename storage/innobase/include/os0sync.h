@@ -427,8 +427,13 @@ compare to, new_val is the value to swap in. */
 #  define os_compare_and_swap_thread_id(ptr, old_val, new_val) \
 	os_compare_and_swap(ptr, old_val, new_val)
 #  define INNODB_RW_LOCKS_USE_ATOMICS
-#  define IB_ATOMICS_STARTUP_MSG \
+#  ifdef UNIV_FUTEX_LATCHES
+#   define IB_ATOMICS_STARTUP_MSG \
+	"Mutexes and rw_locks use GCC atomic builtins and wait on futexes"
+#  else /* UNIV_FUTEX_LATCHES */
+#   define IB_ATOMICS_STARTUP_MSG \
 	"Mutexes and rw_locks use GCC atomic builtins"
+#  endif /* UNIV_FUTEX_LATCHES */
 # else /* HAVE_IB_ATOMIC_PTHREAD_T_GCC */
 #  define IB_ATOMICS_STARTUP_MSG \
 	"Mutexes use GCC atomic builtins, rw_locks do not"
@@ -474,6 +479,16 @@ Returns the old value of *ptr, atomically sets *ptr to new_val */
 # define os_atomic_test_and_set_ulint(ptr, new_val) \
 	__sync_lock_test_and_set(ptr, new_val)
 
+# define os_atomic_test_and_set_uint32(ptr, new_val) \
+	__sync_lock_test_and_set(ptr, (ib_uint32_t) new_val)
+
+/**********************************************************//**
+Returns the old value of *ptr, sets *ptr to new_val if it was old_val */
+
+# define os_atomic_val_compare_and_swap_uint32(ptr, old_val, new_val) \
+	__sync_val_compare_and_swap(ptr, (ib_uint32_t) old_val, \
+				    (ib_uint32_t) new_val)
+
 #elif defined(HAVE_IB_SOLARIS_ATOMICS)
 
 # define HAVE_ATOMIC_BUILTINS
@@ -698,6 +713,27 @@ for synchronization */
 	} while (0)
 #endif  /* HAVE_ATOMIC_BUILTINS */
 
+#ifdef UNIV_FUTEX_LATCHES
+/**********************************************************//**
+Suspends the calling thread while *word == val, or until it is woken up
+by os_futex_wake() on the same word. May return spuriously. */
+UNIV_INLINE
+void
+os_futex_wait(
+/*==========*/
+	volatile ib_uint32_t*	word,	/*!< in: futex word */
+	ib_uint32_t		val);	/*!< in: value of *word that
+					makes the caller wait */
+/**********************************************************//**
+Wakes up at most n threads waiting on a futex word. */
+UNIV_INLINE
+void
+os_futex_wake(
+/*==========*/
+	volatile ib_uint32_t*	word,	/*!< in: futex word */
+	ulint			n);	/*!< in: number of threads to wake */
+#endif /* UNIV_FUTEX_LATCHES */
+
 #define os_inc_counter(mutex, counter)				\
 	os_increment_counter_by_amount(mutex, counter, 1)
 
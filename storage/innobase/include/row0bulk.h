@@ -0,0 +1,77 @@
+/*****************************************************************************
+
+Copyright (c) 2013, Facebook Inc.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/row0bulk.h
+Bulk load of sorted rows into an empty table
+
+When a multi-row insert statement starts on an empty table and
+innodb_bulk_load is set, the table is locked exclusively and a single
+TRX_UNDO_EMPTY undo log record is written, whose rollback empties the
+table. The clustered index is then built bottom-up from the rows as they
+arrive (btr0bulk.h), and the entries of the secondary indexes are sorted
+(row0merge.h) and built bottom-up at the end of the statement. Rows that
+do not arrive in the order of the clustered index end the bulk load, and
+they and the rest of the rows are inserted one by one.
+*******************************************************/
+
+#ifndef row0bulk_h
+#define row0bulk_h
+
+#include "univ.i"
+#include "data0types.h"
+#include "row0types.h"
+
+struct row_prebuilt_t;
+
+/*********************************************************************//**
+Inserts a row into the table in bulk, starting the bulk load on the first
+row if it was requested.
+@return	DB_SUCCESS, DB_FAIL if the row must be inserted one by one,
+or error code */
+UNIV_INTERN
+dberr_t
+row_bulk_insert(
+/*============*/
+	row_prebuilt_t*	prebuilt,	/*!< in/out: prebuilt struct in
+					MySQL handle */
+	dtuple_t*	row)		/*!< in/out: row to insert;
+					DB_ROW_ID may be assigned */
+	__attribute__((nonnull, warn_unused_result));
+/*********************************************************************//**
+Ends the bulk load of the statement, if any: writes the remaining rows
+and builds the secondary indexes.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+dberr_t
+row_bulk_finish(
+/*============*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct in
+					MySQL handle */
+	__attribute__((nonnull));
+/*********************************************************************//**
+Frees a bulk load without writing the remaining rows. The pages that
+were already built are freed by the rollback of the transaction. */
+UNIV_INTERN
+void
+row_bulk_free(
+/*==========*/
+	row_bulk_t*	bulk)		/*!< in, own: bulk load */
+	__attribute__((nonnull));
+
+#endif /* row0bulk_h */
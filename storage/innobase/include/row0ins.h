@@ -92,7 +92,9 @@ row_ins_clust_index_entry_low(
 	ulint		flags,	/*!< in: undo logging and locking flags */
 	ulint		mode,	/*!< in: BTR_MODIFY_LEAF or BTR_MODIFY_TREE,
 				depending on whether we wish optimistic or
-				pessimistic descent down the index tree */
+				pessimistic descent down the index tree;
+				BTR_MODIFY_TREE may be ORed with
+				BTR_LATCH_FOR_INSERT */
 	dict_index_t*	index,	/*!< in: clustered index */
 	ulint		n_uniq,	/*!< in: 0 or index->n_uniq */
 	dtuple_t*	entry,	/*!< in/out: index entry to insert */
@@ -130,7 +132,9 @@ row_ins_sec_index_entry_low(
 	ulint		flags,	/*!< in: undo logging and locking flags */
 	ulint		mode,	/*!< in: BTR_MODIFY_LEAF or BTR_MODIFY_TREE,
 				depending on whether we wish optimistic or
-				pessimistic descent down the index tree */
+				pessimistic descent down the index tree;
+				BTR_MODIFY_TREE may be ORed with
+				BTR_LATCH_FOR_INSERT */
 	dict_index_t*	index,	/*!< in: secondary index */
 	mem_heap_t*	offsets_heap,
 				/*!< in/out: memory heap that can be emptied */
@@ -381,6 +381,16 @@ row_merge_buf_create(
 /*=================*/
 	dict_index_t*	index)	/*!< in: secondary index */
 	__attribute__((warn_unused_result, nonnull, malloc));
+/******************************************************//**
+Insert an index entry into a sort buffer.
+@return	TRUE if added, FALSE if out of space */
+UNIV_INTERN
+ibool
+row_merge_buf_add_entry(
+/*====================*/
+	row_merge_buf_t*	buf,	/*!< in/out: sort buffer */
+	const dtuple_t*		entry)	/*!< in: entry of buf->index */
+	__attribute__((nonnull, warn_unused_result));
 /*********************************************************************//**
 Deallocate a sort buffer. */
 UNIV_INTERN
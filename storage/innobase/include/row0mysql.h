@@ -867,6 +867,12 @@ struct row_prebuilt_t {
 					store it here so that we can return
 					it to MySQL */
 	/*----------------------*/
+	unsigned	bulk_requested:1;/*!< set when a multi-row insert
+					statement starts with innodb_bulk_load;
+					the first row may start a bulk load */
+	row_bulk_t*	bulk;		/*!< bulk load into the empty table,
+					or NULL */
+	/*----------------------*/
 	void*		idx_cond;	/*!< In ICP, pointer to a ha_innobase,
 					passed to innobase_index_cond().
 					NULL if index condition pushdown is
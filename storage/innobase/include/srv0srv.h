@@ -102,6 +102,14 @@ struct srv_stats_t {
 	a disk page */
 	ulint_ctr_1_t		buf_pool_reads;
 
+	/** Number of pages read into the buffer pool by transactions
+	running with innodb_fake_changes */
+	ulint_ctr_1_t		buf_pool_fake_changes_reads;
+
+	/** Number of pages read by fake changes transactions that
+	were later used by another transaction */
+	ulint_ctr_1_t		buf_pool_fake_changes_hits;
+
 	/** Number of data read in total (in bytes) */
 	ulint_ctr_1_t		data_read;
 
@@ -126,6 +134,9 @@ struct srv_stats_t {
 	/** Number of rows inserted */
 	ulint_ctr_64_t		n_rows_inserted;
 
+	/** Number of rows inserted by bulk load into empty tables */
+	ulint_ctr_64_t		n_rows_bulk_loaded;
+
 	/** Number of buffered aio requests submitted */
 	ulint_ctr_64_t		n_aio_submitted;
 
@@ -142,6 +153,11 @@ struct srv_stats_t {
 	number is the total for all transactions that used a non-zero
 	innodb_lra_size. */
 	ulint_ctr_64_t n_logical_read_ahead_in_buf_pool;
+	/** Number of pages read by BLOB read-ahead */
+	ulint_ctr_64_t n_blob_read_ahead_prefetched;
+	/** Number of BLOB pages that were then read while reading the
+	BLOB, out of those that BLOB read-ahead covered */
+	ulint_ctr_64_t n_blob_read_ahead_hits;
 };
 
 extern const char*	srv_main_thread_op_info;
@@ -158,6 +174,9 @@ extern os_event_t	srv_error_event;
 /** The buffer pool dump/load thread waits on this event. */
 extern os_event_t	srv_buf_dump_event;
 
+/** The buffer pool resize thread waits on this event. */
+extern os_event_t	srv_buf_resize_event;
+
 /** The buffer pool dump/load file name */
 #define SRV_BUF_DUMP_FILENAME_DEFAULT	"ib_buffer_pool"
 extern char*		srv_buf_dump_filename;
@@ -210,6 +229,12 @@ extern my_bool	srv_read_only_mode;
 /** store to its own file each table created by an user; data
 dictionary tables are in the system tablespace 0 */
 extern my_bool	srv_file_per_table;
+/** store the temporary tables in a shared tablespace that is created
+at startup and never redo logged */
+extern my_bool	srv_tmp_tablespace;
+/** Space id of the shared temporary tablespace, or ULINT_UNDEFINED if
+it has not been created */
+extern ulint	srv_tmp_space_id;
 /** Sleep delay for threads waiting to enter InnoDB. In micro-seconds. */
 extern	ulong	srv_thread_sleep_delay;
 #if defined(HAVE_ATOMIC_BUILTINS)
@@ -276,6 +301,10 @@ extern my_bool	srv_prefix_index_cluster_optimization;
 /* Detect deadlocks on lock wait */
 extern my_bool	srv_deadlock_detect;
 
+/* How record locks are granted when they are released, one of
+srv_lock_schedule_t */
+extern ulong	srv_lock_schedule_algorithm;
+
 /** Maximum number of srv_n_log_files, or innodb_log_files_in_group */
 #define SRV_N_LOG_FILES_MAX 100
 extern ulong	srv_n_log_files;
@@ -300,6 +329,8 @@ extern my_bool	srv_use_sys_malloc;
 extern ibool	srv_use_sys_malloc;
 #endif /* UNIV_HOTBACKUP */
 extern ulint	srv_buf_pool_size;	/*!< requested size in bytes */
+extern ulint	srv_buf_pool_chunk_unit;/*!< size of a buffer pool chunk,
+					the unit of resizing, in bytes */
 extern ulint    srv_buf_pool_instances; /*!< requested number of buffer pool instances */
 extern ulong	srv_n_page_hash_locks;	/*!< number of locks to
 					protect buf_pool->page_hash */
@@ -316,6 +347,7 @@ extern ulint	srv_lock_table_size;
 extern ulint	srv_n_file_io_threads;
 extern my_bool	srv_random_read_ahead;
 extern ulong	srv_read_ahead_threshold;
+extern ulong	srv_blob_read_ahead_pages;
 extern ulong	srv_trx_log_write_block_size;
 extern ulint	srv_n_read_io_threads;
 extern ulint	srv_n_write_io_threads;
@@ -415,6 +447,9 @@ extern ibool	srv_error_monitor_active;
 /* TRUE during the lifetime of the buffer pool dump/load thread */
 extern ibool	srv_buf_dump_thread_active;
 
+/* TRUE during the lifetime of the buffer pool resize thread */
+extern ibool	srv_buf_resize_thread_active;
+
 /* TRUE during the lifetime of the stats thread */
 extern ibool	srv_dict_stats_thread_active;
 
@@ -678,6 +713,17 @@ enum srv_stats_method_name_enum {
 
 typedef enum srv_stats_method_name_enum		srv_stats_method_name_t;
 
+/** Alternatives for srv_lock_schedule_algorithm, which could be changed by
+setting innodb_lock_schedule_algorithm */
+enum srv_lock_schedule_t {
+	SRV_LOCK_SCHEDULE_FCFS,		/*!< Grant the waiting record locks
+					in the order they were requested */
+	SRV_LOCK_SCHEDULE_CATS		/*!< Contention-aware: grant first
+					the waiting record lock of the
+					transaction that blocks the most
+					other transactions */
+};
+
 #ifndef UNIV_HOTBACKUP
 /** Types of threads existing in the system. */
 enum srv_thread_type {
@@ -958,6 +1004,8 @@ struct export_var_t{
 	ulint innodb_data_double_write_slow_ios;/*!< # with slow svc time */
 	char  innodb_buffer_pool_dump_status[512];/*!< Buf pool dump status */
 	char  innodb_buffer_pool_load_status[512];/*!< Buf pool load status */
+	char  innodb_buffer_pool_resize_status[512];/*!< Buf pool resize
+						status */
 	ulint innodb_buffer_pool_flushed_lru;	/*!< #pages flushed from LRU */
 	ulint innodb_buffer_pool_flushed_list;	/*!< #pages flushed from flush list */
 	ulint innodb_buffer_pool_flushed_page;	/*!< #pages flushed from other */
@@ -982,6 +1030,10 @@ struct export_var_t{
 	ulint innodb_buffer_pool_read_ahead_rnd;/*!< srv_read_ahead_rnd */
 	ulint innodb_buffer_pool_read_ahead;	/*!< srv_read_ahead */
 	ulint innodb_buffer_pool_read_ahead_evicted;/*!< srv_read_ahead evicted*/
+	ulint innodb_buffer_pool_fake_changes_reads;
+					/*!< srv_stats.buf_pool_fake_changes_reads */
+	ulint innodb_buffer_pool_fake_changes_hits;
+					/*!< srv_stats.buf_pool_fake_changes_hits */
 
 	ulint innodb_buffer_pool_neighbors_flushed_list;/*!< srv_neighbors_flushed_list */
 	ulint innodb_buffer_pool_neighbors_flushed_lru;/*!< srv_neighbors_flushed_lru */
@@ -1043,6 +1095,7 @@ struct export_var_t{
 						/ 1000 */
 	ulint innodb_rows_read;			/*!< srv_n_rows_read */
 	ulint innodb_rows_inserted;		/*!< srv_n_rows_inserted */
+	ulint innodb_rows_bulk_loaded;		/*!< srv_n_rows_bulk_loaded */
 	ulint innodb_rows_updated;		/*!< srv_n_rows_updated */
 	ulint innodb_rows_deleted;		/*!< srv_n_rows_deleted */
 	ulint innodb_num_open_files;		/*!< fil_n_file_opened */
@@ -1143,6 +1196,10 @@ struct export_var_t{
 						used a non-zero
 						innodb_lra_size.
 						*/
+	ulint innodb_blob_read_ahead_prefetched;
+					/*!< n_blob_read_ahead_prefetched */
+	ulint innodb_blob_read_ahead_hits;
+					/*!< n_blob_read_ahead_hits */
 	/* The following are per-page size stats from page_zip_stat */
 	ulint		zip1024_compressed;
 	ulint		zip1024_compressed_ok;
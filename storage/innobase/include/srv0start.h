@@ -164,4 +164,10 @@ extern	enum srv_shutdown_state	srv_shutdown_state;
 /** Log 'spaces' have id's >= this */
 #define SRV_LOG_SPACE_FIRST_ID		0xFFFFFFF0UL
 
+/** File name of the shared temporary tablespace, in innodb_data_home_dir */
+#define SRV_TMP_SPACE_NAME		"ibtmp1"
+
+/** Initial size of the shared temporary tablespace in bytes */
+#define SRV_TMP_SPACE_INITIAL_SIZE	(12 * 1024 * 1024)
+
 #endif
@@ -94,6 +94,10 @@ start value for the lock_word, meaning that it limits the maximum number
 of concurrent read locks before the rw_lock breaks. The current value of
 0x00100000 allows 1,048,575 concurrent readers and 2047 recursive writers.*/
 #define X_LOCK_DECR		0x00100000
+/* We decrement lock_word by this amount for an sx_lock. An sx-lock is
+compatible with s-locks but not with other sx-locks or x-locks: it can be
+granted only while lock_word > X_LOCK_HALF_DECR. */
+#define X_LOCK_HALF_DECR	0x00080000
 
 struct rw_lock_t;
 #ifdef UNIV_SYNC_DEBUG
@@ -213,6 +217,18 @@ unlocking, not the corresponding function. */
 #  define rw_lock_x_unlock_gen(L, P)	rw_lock_x_unlock_func(L)
 # endif
 
+# define rw_lock_sx_lock(M)					\
+	rw_lock_sx_lock_func((M), 0, __FILE__, __LINE__)
+
+# define rw_lock_sx_lock_inline(M, P, F, L)			\
+	rw_lock_sx_lock_func((M), (P), (F), (L))
+
+# ifdef UNIV_SYNC_DEBUG
+#  define rw_lock_sx_unlock_gen(L, P)	rw_lock_sx_unlock_func(P, L)
+# else
+#  define rw_lock_sx_unlock_gen(L, P)	rw_lock_sx_unlock_func(L)
+# endif
+
 # define rw_lock_free(M)		rw_lock_free_func(M)
 
 #else /* !UNIV_PFS_RWLOCK */
@@ -274,12 +290,25 @@ unlocking, not the corresponding function. */
 #  define rw_lock_x_unlock_gen(L, P)	pfs_rw_lock_x_unlock_func(L)
 # endif
 
+# define rw_lock_sx_lock(M)					\
+	pfs_rw_lock_sx_lock_func((M), 0, __FILE__, __LINE__)
+
+# define rw_lock_sx_lock_inline(M, P, F, L)			\
+	pfs_rw_lock_sx_lock_func((M), (P), (F), (L))
+
+# ifdef UNIV_SYNC_DEBUG
+#  define rw_lock_sx_unlock_gen(L, P)	pfs_rw_lock_sx_unlock_func(P, L)
+# else
+#  define rw_lock_sx_unlock_gen(L, P)	pfs_rw_lock_sx_unlock_func(L)
+# endif
+
 # define rw_lock_free(M)		pfs_rw_lock_free_func(M)
 
 #endif /* UNIV_PFS_RWLOCK */
 
 #define rw_lock_s_unlock(L)		rw_lock_s_unlock_gen(L, 0)
 #define rw_lock_x_unlock(L)		rw_lock_x_unlock_gen(L, 0)
+#define rw_lock_sx_unlock(L)		rw_lock_sx_unlock_gen(L, 0)
 
 /******************************************************************//**
 Creates, or rather, initializes an rw-lock object in a specified memory
@@ -403,6 +432,35 @@ rw_lock_x_unlock_func(
 #endif
 	rw_lock_t*	lock);	/*!< in/out: rw-lock */
 /******************************************************************//**
+NOTE! Use the corresponding macro, not directly this function! Lock an
+rw-lock in shared exclusive mode for the current thread. The sx-lock is
+compatible with s-locks, but not with another sx-lock or an x-lock: if
+the rw-lock is sx- or x-locked, or there is an exclusive lock request
+waiting, the function spins a preset time (controlled by
+SYNC_SPIN_ROUNDS), waiting for the lock before suspending the thread.
+An sx-lock is not recursive, and the holder must not s- or x-lock the
+same rw-lock. */
+UNIV_INTERN
+void
+rw_lock_sx_lock_func(
+/*=================*/
+	rw_lock_t*	lock,	/*!< in: pointer to rw-lock */
+	ulint		pass,	/*!< in: pass value; != 0, if the lock will
+				be passed to another thread to unlock */
+	const char*	file_name,/*!< in: file name where lock requested */
+	ulint		line);	/*!< in: line where requested */
+/******************************************************************//**
+Releases a shared exclusive mode lock. */
+UNIV_INLINE
+void
+rw_lock_sx_unlock_func(
+/*===================*/
+#ifdef UNIV_SYNC_DEBUG
+	ulint		pass,	/*!< in: pass value; != 0, if the lock may have
+				been passed to another thread to unlock */
+#endif
+	rw_lock_t*	lock);	/*!< in/out: rw-lock */
+/******************************************************************//**
 This function is used in the insert buffer to move the ownership of an
 x-latch on a buffer frame to the current thread. The x-latch was set by
 the buffer read operation and it protected the buffer frame while the
@@ -425,6 +483,15 @@ ulint
 rw_lock_get_x_lock_count(
 /*=====================*/
 	const rw_lock_t*	lock);	/*!< in: rw-lock */
+/******************************************************************//**
+Returns 1 if the lock is sx-locked, 0 otherwise. Does not reserve the
+lock mutex, so the caller must be sure it is not changed during the call.
+@return	number of sx-locks */
+UNIV_INLINE
+ulint
+rw_lock_get_sx_lock_count(
+/*======================*/
+	const rw_lock_t*	lock);	/*!< in: rw-lock */
 /********************************************************************//**
 Check if there are threads waiting for the rw-lock.
 @return	1 if waiters, 0 otherwise */
@@ -451,15 +518,16 @@ rw_lock_get_reader_count(
 /*=====================*/
 	const rw_lock_t*	lock);	/*!< in: rw-lock */
 /******************************************************************//**
-Decrements lock_word the specified amount if it is greater than 0.
-This is used by both s_lock and x_lock operations.
+Decrements lock_word the specified amount if it is greater than the
+threshold. This is used by s_lock, sx_lock and x_lock operations.
 @return	TRUE if decr occurs */
 UNIV_INLINE
 ibool
 rw_lock_lock_word_decr(
 /*===================*/
 	rw_lock_t*	lock,		/*!< in/out: rw-lock */
-	ulint		amount);	/*!< in: amount to decrement */
+	ulint		amount,		/*!< in: amount to decrement */
+	lint		threshold);	/*!< in: threshold of judgement */
 /******************************************************************//**
 Increments lock_word the specified amount and returns new value.
 @return	lock->lock_word after increment */
@@ -470,6 +538,21 @@ rw_lock_lock_word_incr(
 	rw_lock_t*	lock,		/*!< in/out: rw-lock */
 	ulint		amount);	/*!< in: amount to increment */
 /******************************************************************//**
+Wakes up the threads waiting for the lock to become free. The caller
+must have reset the waiter flag. */
+UNIV_INLINE
+void
+rw_lock_signal_waiters(
+/*===================*/
+	rw_lock_t*	lock);		/*!< in/out: rw-lock */
+/******************************************************************//**
+Wakes up the next writer waiting for the readers to exit. */
+UNIV_INLINE
+void
+rw_lock_signal_wait_ex(
+/*===================*/
+	rw_lock_t*	lock);		/*!< in/out: rw-lock */
+/******************************************************************//**
 This function sets the lock->writer_thread and lock->recursive fields.
 For platforms where we are using atomic builtins instead of lock->mutex
 it sets the lock->writer_thread field using atomics to ensure memory
@@ -495,7 +578,7 @@ rw_lock_own(
 /*========*/
 	rw_lock_t*	lock,		/*!< in: rw-lock */
 	ulint		lock_type)	/*!< in: lock type: RW_LOCK_SHARED,
-					RW_LOCK_EX */
+					RW_LOCK_EX, RW_LOCK_SX */
 	__attribute__((warn_unused_result));
 #endif /* UNIV_SYNC_DEBUG */
 /******************************************************************//**
@@ -506,7 +589,7 @@ rw_lock_is_locked(
 /*==============*/
 	rw_lock_t*	lock,		/*!< in: rw-lock */
 	ulint		lock_type);	/*!< in: lock type: RW_LOCK_SHARED,
-					RW_LOCK_EX */
+					RW_LOCK_EX, RW_LOCK_SX */
 #ifdef UNIV_SYNC_DEBUG
 /***************************************************************//**
 Prints debug info of an rw-lock. */
@@ -594,6 +677,13 @@ struct rw_lock_t {
 	os_event_struct_t	wait_ex_event;
 				/*!< Event for next-writer to wait on. A thread
 				must decrement lock_word before waiting. */
+#ifdef UNIV_FUTEX_LATCHES
+	volatile ib_uint32_t	futex_event;
+				/*!< Futex that replaces event: incremented
+				whenever the waiters are woken up */
+	volatile ib_uint32_t	futex_wait_ex;
+				/*!< Futex that replaces wait_ex_event */
+#endif /* UNIV_FUTEX_LATCHES */
 #ifndef INNODB_RW_LOCKS_USE_ATOMICS
 	ib_mutex_t	mutex;		/*!< The mutex protecting rw_lock_t */
 #endif /* INNODB_RW_LOCKS_USE_ATOMICS */
@@ -611,6 +701,9 @@ struct rw_lock_t {
 	struct PSI_rwlock *pfs_psi;/*!< The instrumentation hook */
 #endif
 	ulint count_os_wait;	/*!< Count of os_waits. May not be accurate */
+	sync_wait_class_t*	wait_class;
+				/*!< wait histogram of the rw-locks created
+				at cfile_name:cline, or NULL */
 	const char*	cfile_name;/*!< File name where lock created */
         /* last s-lock file/line is not guaranteed to be correct */
 	const char*	last_s_file_name;/*!< File name where last s-locked */
@@ -790,6 +883,33 @@ pfs_rw_lock_x_unlock_func(
 #endif
 	rw_lock_t*	lock);	/*!< in/out: rw-lock */
 /******************************************************************//**
+Performance schema instrumented wrap function for rw_lock_sx_lock_func()
+NOTE! Please use the corresponding macro rw_lock_sx_lock(), not directly
+this function! */
+UNIV_INLINE
+void
+pfs_rw_lock_sx_lock_func(
+/*=====================*/
+	rw_lock_t*	lock,	/*!< in: pointer to rw-lock */
+	ulint		pass,	/*!< in: pass value; != 0, if the lock will
+				be passed to another thread to unlock */
+	const char*	file_name,/*!< in: file name where lock requested */
+	ulint		line);	/*!< in: line where requested */
+/******************************************************************//**
+Performance schema instrumented wrap function for rw_lock_sx_unlock_func()
+NOTE! Please use the corresponding macro rw_lock_sx_unlock(), not directly
+this function! */
+UNIV_INLINE
+void
+pfs_rw_lock_sx_unlock_func(
+/*=======================*/
+#ifdef UNIV_SYNC_DEBUG
+	ulint		pass,	/*!< in: pass value; != 0, if the
+				lock may have been passed to another
+				thread to unlock */
+#endif
+	rw_lock_t*	lock);	/*!< in/out: rw-lock */
+/******************************************************************//**
 Performance schema instrumented wrap function for rw_lock_free_func()
 NOTE! Please use the corresponding macro rw_lock_free(), not directly
 this function! */
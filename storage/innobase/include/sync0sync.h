@@ -60,6 +60,8 @@ extern "C" my_bool	timed_mutexes;
 #ifdef HAVE_WINDOWS_ATOMICS
 typedef LONG lock_word_t;	/*!< On Windows, InterlockedExchange operates
 				on LONG variable */
+#elif defined(UNIV_FUTEX_LATCHES)
+typedef ib_uint32_t lock_word_t;	/*!< A futex is a 32-bit word */
 #else
 typedef byte lock_word_t;
 #endif
@@ -399,6 +401,51 @@ void
 sync_print(
 /*=======*/
 	FILE*	file);		/*!< in: file where to print */
+
+/** Number of buckets in a latch wait time histogram. Bucket 0 counts the
+waits that took less than a microsecond, bucket N the waits that took
+[2^(N-1), 2^N) microseconds and the last bucket all the longer waits. */
+#define SYNC_WAIT_HIST_N_BUCKETS	24
+
+/** Maximum number of latch classes whose waits are counted. The latches
+created at further places in the source are not counted. */
+#define SYNC_WAIT_N_CLASSES		1024
+
+/** Wait time histogram of a latch class: the mutexes or rw-locks created
+at one place in the source */
+struct sync_wait_class_t {
+	const char*	cfile_name;	/*!< File name where the latches
+					are created, NULL if the slot is
+					free */
+	ulint		cline;		/*!< Line where created */
+	ib_uint64_t	n_waits[SYNC_WAIT_HIST_N_BUCKETS];
+					/*!< Number of waits by wait time */
+};
+
+/** Latch classes, filled in as latches get created */
+extern sync_wait_class_t	sync_wait_classes[SYNC_WAIT_N_CLASSES];
+
+/*******************************************************************//**
+Looks up the wait class of latches created at a place in the source and
+creates it if it does not exist yet.
+@return wait class, NULL if there are too many classes */
+UNIV_INTERN
+sync_wait_class_t*
+sync_wait_class_get(
+/*================*/
+	const char*	cfile_name,	/*!< in: file name where created */
+	ulint		cline);		/*!< in: line where created */
+/*******************************************************************//**
+Counts a latch wait in the histogram of its wait class. */
+UNIV_INTERN
+void
+sync_wait_class_add(
+/*================*/
+	sync_wait_class_t*	wait_class,	/*!< in/out: wait class of
+						the latch, or NULL */
+	ullint			start_time);	/*!< in: ut_time_us() when
+						the wait started, 0 if
+						there was no wait */
 #ifdef UNIV_DEBUG
 /******************************************************************//**
 Checks that the mutex has been initialized.
@@ -747,6 +794,7 @@ or row lock! */
 #define RW_LOCK_SHARED		352
 #define RW_LOCK_WAIT_EX		353
 #define SYNC_MUTEX		354
+#define RW_LOCK_SX		355
 
 /* NOTE! The structure appears here only for the compiler to know its size.
 Do not use its fields directly! The structure used in the spin lock
@@ -758,7 +806,10 @@ struct ib_mutex_t {
 				/*!< Used by sync0arr.cc for the wait queue */
 	volatile lock_word_t	lock_word;	/*!< lock_word is the target
 				of the atomic test-and-set instruction when
-				atomic operations are enabled. */
+				atomic operations are enabled. With
+				UNIV_FUTEX_LATCHES it is also the futex
+				word: 0 if free, 1 if locked, 2 if locked
+				and there may be waiters. */
 
 #if !defined(HAVE_ATOMIC_BUILTINS)
 	os_fast_mutex_t
@@ -779,6 +830,13 @@ struct ib_mutex_t {
 	const char*	cfile_name;/*!< File name where mutex created */
 	ulint		cline;	/*!< Line where created */
 	ulong		count_os_wait;	/*!< count of os_wait */
+	sync_wait_class_t*	wait_class;
+				/*!< wait histogram of the mutexes created
+				at cfile_name:cline, or NULL */
+#ifdef UNIV_FUTEX_LATCHES
+	lint		spin_rounds_avg;/*!< Moving average of the spin
+				rounds it took to acquire the mutex */
+#endif /* UNIV_FUTEX_LATCHES */
 #ifdef UNIV_DEBUG
 
 /** Value of mutex_t::magic_n */
@@ -625,6 +625,14 @@ struct trx_lock_t {
 	ib_uint64_t	deadlock_mark;	/*!< A mark field that is initialized
 					to and checked against lock_mark_counter
 					by lock_deadlock_recursive(). */
+	ulint		schedule_weight;/*!< number of transactions whose
+					lock wait goes through this one, valid
+					when schedule_mark is equal to
+					lock_schedule_counter; computed by
+					lock_update_schedule_weights() and
+					protected by lock_sys->mutex */
+	ib_uint64_t	schedule_mark;	/*!< value of lock_schedule_counter
+					when schedule_weight was set */
 	ibool		was_chosen_as_deadlock_victim;
 					/*!< when the transaction decides to
 					wait for a lock, it sets this to FALSE;
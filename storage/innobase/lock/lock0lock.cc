@@ -2449,6 +2449,188 @@ lock_rec_cancel(
 	trx_mutex_exit(lock->trx);
 }
 
+/** Used in lock scheduling. Protected by lock_sys->mutex. */
+static ib_uint64_t	lock_schedule_counter = 0;
+
+/** Maximum length of a chain of lock waits that is followed when
+computing the scheduling weights */
+#define LOCK_SCHEDULE_MAX_DEPTH	16
+
+/*********************************************************************//**
+Gets the scheduling weight of a transaction, computed by the last call of
+lock_update_schedule_weights().
+@return number of transactions that wait for trx */
+static
+ulint
+lock_trx_get_schedule_weight(
+/*=========================*/
+	const trx_t*	trx)	/*!< in: transaction */
+{
+	ut_ad(lock_mutex_own());
+
+	return(trx->lock.schedule_mark == lock_schedule_counter
+	       ? trx->lock.schedule_weight : 0);
+}
+
+/*********************************************************************//**
+Computes the scheduling weights used by innodb_lock_schedule_algorithm=cats.
+The weight of a transaction is the number of waiting transactions whose
+chain of record lock waits goes through it. */
+UNIV_INTERN
+void
+lock_update_schedule_weights(void)
+/*==============================*/
+{
+	const srv_slot_t*	slot;
+
+	ut_ad(lock_wait_mutex_own());
+
+	lock_mutex_enter();
+
+	++lock_schedule_counter;
+
+	for (slot = lock_sys->waiting_threads;
+	     slot < lock_sys->last_slot;
+	     ++slot) {
+
+		const lock_t*	lock;
+		ulint		depth;
+
+		if (!slot->in_use) {
+			continue;
+		}
+
+		/* The slot can't be freed without the lock wait mutex,
+		and the wait lock can't be granted without the lock
+		mutex. */
+
+		lock = thr_get_trx(slot->thr)->lock.wait_lock;
+
+		for (depth = 0;
+		     lock != NULL
+		     && lock_get_type_low(lock) == LOCK_REC
+		     && depth < LOCK_SCHEDULE_MAX_DEPTH;
+		     ++depth) {
+
+			const lock_t*	blocking;
+			trx_lock_t*	trx_lock;
+
+			blocking = lock_rec_has_to_wait_in_queue(lock);
+
+			if (blocking == NULL) {
+				break;
+			}
+
+			trx_lock = &blocking->trx->lock;
+
+			if (trx_lock->schedule_mark != lock_schedule_counter) {
+				trx_lock->schedule_mark = lock_schedule_counter;
+				trx_lock->schedule_weight = 0;
+			}
+
+			++trx_lock->schedule_weight;
+
+			lock = trx_lock->wait_lock;
+		}
+	}
+
+	lock_mutex_exit();
+}
+
+/*********************************************************************//**
+Checks if a waiting record lock request conflicts with a granted lock
+anywhere in the queue of its record.
+@return	TRUE if the lock cannot be granted */
+static
+ibool
+lock_rec_conflicts_with_granted(
+/*============================*/
+	const lock_t*	wait_lock)	/*!< in: waiting record lock */
+{
+	const lock_t*	lock;
+	ulint		heap_no;
+
+	ut_ad(lock_mutex_own());
+	ut_ad(lock_get_wait(wait_lock));
+
+	heap_no = lock_rec_find_set_bit(wait_lock);
+
+	for (lock = lock_rec_get_first_on_page_addr(
+			wait_lock->un_member.rec_lock.space,
+			wait_lock->un_member.rec_lock.page_no);
+	     lock != NULL;
+	     lock = lock_rec_get_next_on_page_const(lock)) {
+
+		if (lock != wait_lock
+		    && !lock_get_wait(lock)
+		    && lock_rec_get_nth_bit(lock, heap_no)
+		    && lock_has_to_wait(wait_lock, lock)) {
+
+			return(TRUE);
+		}
+	}
+
+	return(FALSE);
+}
+
+/*********************************************************************//**
+Grants the waiting record locks on a page that no granted lock conflicts
+with, heaviest transaction first, for innodb_lock_schedule_algorithm=cats.
+Each granted lock is moved ahead of the other locks on the page, so that
+the waiting requests it conflicts with keep waiting for it. */
+static
+void
+lock_rec_grant_by_weight(
+/*=====================*/
+	ulint	space,	/*!< in: space */
+	ulint	page_no)/*!< in: page number */
+{
+	ut_ad(lock_mutex_own());
+
+	for (;;) {
+		lock_t*		lock;
+		lock_t*		best = NULL;
+		ulint		best_weight = 0;
+		hash_cell_t*	cell;
+
+		/* Ties go to the lock that has waited the longest, that
+		is, the first one in the queue. */
+
+		for (lock = lock_rec_get_first_on_page_addr(space, page_no);
+		     lock != NULL;
+		     lock = lock_rec_get_next_on_page(lock)) {
+
+			ulint	weight;
+
+			if (!lock_get_wait(lock)
+			    || lock_rec_conflicts_with_granted(lock)) {
+				continue;
+			}
+
+			weight = lock_trx_get_schedule_weight(lock->trx);
+
+			if (best == NULL || weight > best_weight) {
+				best = lock;
+				best_weight = weight;
+			}
+		}
+
+		if (best == NULL) {
+			return;
+		}
+
+		HASH_DELETE(lock_t, hash, lock_sys->rec_hash,
+			    lock_rec_fold(space, page_no), best);
+
+		cell = hash_get_nth_cell(lock_sys->rec_hash,
+					 lock_rec_hash(space, page_no));
+		best->hash = static_cast<lock_t*>(cell->node);
+		cell->node = best;
+
+		lock_grant(best);
+	}
+}
+
 /*************************************************************//**
 Removes a record lock request, waiting or granted, from the queue and
 grants locks to other transactions in the queue if they now are entitled
@@ -2492,6 +2674,11 @@ lock_rec_dequeue_from_page(
 	locks if there are no conflicting locks ahead. Stop at the first
 	X lock that is waiting or has been granted. */
 
+	if (srv_lock_schedule_algorithm == SRV_LOCK_SCHEDULE_CATS) {
+		lock_rec_grant_by_weight(space, page_no);
+		return;
+	}
+
 	for (lock = lock_rec_get_first_on_page_addr(space, page_no);
 	     lock != NULL;
 	     lock = lock_rec_get_next_on_page(lock)) {
@@ -4488,17 +4675,20 @@ lock_table(
 }
 
 /*********************************************************************//**
-Creates a table IX lock object for a resurrected transaction. */
+Creates a table IX or X lock object for a resurrected transaction. */
 UNIV_INTERN
 void
-lock_table_ix_resurrect(
-/*====================*/
+lock_table_resurrect(
+/*=================*/
 	dict_table_t*	table,	/*!< in/out: table */
-	trx_t*		trx)	/*!< in/out: transaction */
+	trx_t*		trx,	/*!< in/out: transaction */
+	enum lock_mode	mode)	/*!< in: LOCK_IX, or LOCK_X for a bulk
+				load into an empty table */
 {
 	ut_ad(trx->is_recovered);
+	ut_ad(mode == LOCK_IX || mode == LOCK_X);
 
-	if (lock_table_has(trx, table, LOCK_IX)) {
+	if (lock_table_has(trx, table, mode)) {
 		return;
 	}
 
@@ -4508,10 +4698,10 @@ lock_table_ix_resurrect(
 	other transactions have in the table lock queue. */
 
 	ut_ad(!lock_table_other_has_incompatible(
-		      trx, LOCK_WAIT, table, LOCK_IX));
+		      trx, LOCK_WAIT, table, mode));
 
 	trx_mutex_enter(trx);
-	lock_table_create(table, LOCK_IX, trx);
+	lock_table_create(table, mode, trx);
 	lock_mutex_exit();
 	trx_mutex_exit(trx);
 }
@@ -4650,6 +4840,12 @@ released:
 
 	/* Check if we can now grant waiting lock requests */
 
+	if (srv_lock_schedule_algorithm == SRV_LOCK_SCHEDULE_CATS) {
+		lock_rec_grant_by_weight(buf_block_get_space(block),
+					 buf_block_get_page_no(block));
+		goto func_exit;
+	}
+
 	for (lock = first_lock; lock != NULL;
 	     lock = lock_rec_get_next(heap_no, lock)) {
 		if (lock_get_wait(lock)
@@ -4661,6 +4857,7 @@ released:
 		}
 	}
 
+func_exit:
 	lock_mutex_exit();
 	trx_mutex_exit(trx);
 }
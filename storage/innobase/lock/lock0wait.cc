@@ -528,6 +528,10 @@ DECLARE_THREAD(lock_wait_timeout_thread)(
 			}
 		}
 
+		if (srv_lock_schedule_algorithm == SRV_LOCK_SCHEDULE_CATS) {
+			lock_update_schedule_weights();
+		}
+
 		sig_count = os_event_reset(event);
 
 		lock_wait_mutex_exit();
@@ -34,6 +34,7 @@ Created 11/26/1995 Heikki Tuuri
 #include "page0types.h"
 #include "mtr0log.h"
 #include "log0log.h"
+#include "fsp0fsp.h"
 
 #ifndef UNIV_HOTBACKUP
 # include "log0recv.h"
@@ -87,6 +88,9 @@ mtr_memo_slot_release_func(
 	case MTR_MEMO_X_LOCK:
 		rw_lock_x_unlock((rw_lock_t*) object);
 		break;
+	case MTR_MEMO_SX_LOCK:
+		rw_lock_sx_unlock((rw_lock_t*) object);
+		break;
 #ifdef UNIV_DEBUG
 	default:
 		ut_ad(slot->type == MTR_MEMO_MODIFY);
@@ -296,6 +300,56 @@ mtr_log_reserve_and_write(
 
 	mtr_add_dirtied_pages_to_flush_list(mtr);
 }
+
+/*****************************************************************//**
+Checks if all the pages that a mini-transaction has x-latched belong to
+the shared temporary tablespace. That tablespace is created again at
+every startup, so the redo log of such a mini-transaction would never
+be applied.
+@return true if the mtr only x-latched pages of the temporary tablespace */
+static
+bool
+mtr_is_temporary(
+/*=============*/
+	const mtr_t*	mtr)	/*!< in: mtr */
+{
+	bool	found = false;
+
+	if (srv_tmp_space_id == ULINT_UNDEFINED) {
+		return(false);
+	}
+
+	for (const dyn_block_t* block = dyn_array_get_first_block(&mtr->memo);
+	     block;
+	     block = dyn_array_get_next_block(&mtr->memo, block)) {
+		const mtr_memo_slot_t*	slot
+			= reinterpret_cast<const mtr_memo_slot_t*>(
+				dyn_block_get_data(block));
+		const mtr_memo_slot_t*	end
+			= reinterpret_cast<const mtr_memo_slot_t*>(
+				dyn_block_get_data(block)
+				+ dyn_block_get_used(block));
+
+		for (; slot != end; slot++) {
+			if (slot->object == NULL
+			    || slot->type != MTR_MEMO_PAGE_X_FIX) {
+				continue;
+			}
+
+			const buf_block_t*	page = static_cast<
+				const buf_block_t*>(slot->object);
+
+			if (!fsp_is_system_temporary(
+				    buf_block_get_space(page))) {
+				return(false);
+			}
+
+			found = true;
+		}
+	}
+
+	return(found);
+}
 #endif /* !UNIV_HOTBACKUP */
 
 /***************************************************************//**
@@ -318,6 +372,12 @@ mtr_commit(
 
 	if (mtr->modifications && mtr->n_log_recs) {
 		ut_ad(!srv_read_only_mode);
+
+		if (mtr->log_mode == MTR_LOG_ALL && mtr_is_temporary(mtr)) {
+			/* Only add the pages to the flush list. */
+			mtr->log_mode = MTR_LOG_NO_REDO;
+		}
+
 		mtr_log_reserve_and_write(mtr);
 	}
 
@@ -381,6 +441,48 @@ mtr_memo_release(
 
 	return(false);
 }
+
+/**********************************************************//**
+Releases the page latches and buffer fixes that were stored in an mtr
+memo between two savepoints. None of the pages may have been modified
+in the mtr. */
+UNIV_INTERN
+void
+mtr_release_blocks_between_savepoints(
+/*==================================*/
+	mtr_t*		mtr,		/*!< in/out: mtr */
+	ulint		start,		/*!< in: savepoint of the first
+					block to release */
+	ulint		end)		/*!< in: savepoint after the last
+					block to release */
+{
+	dyn_array_t*	memo;
+
+	ut_ad(mtr);
+	ut_ad(mtr->magic_n == MTR_MAGIC_N);
+	ut_ad(mtr->state == MTR_ACTIVE);
+	ut_ad(start <= end);
+
+	memo = &(mtr->memo);
+
+	ut_ad(dyn_array_get_data_size(memo) >= end);
+
+	for (ulint offset = start; offset < end;
+	     offset += sizeof(mtr_memo_slot_t)) {
+		mtr_memo_slot_t* slot = (mtr_memo_slot_t*)
+			dyn_array_get_element(memo, offset);
+
+		if (slot->object == NULL) {
+			continue;
+		}
+
+		ut_ad(slot->type == MTR_MEMO_PAGE_S_FIX
+		      || slot->type == MTR_MEMO_PAGE_X_FIX
+		      || slot->type == MTR_MEMO_BUF_FIX);
+
+		mtr_memo_slot_release(mtr, slot);
+	}
+}
 #endif /* !UNIV_HOTBACKUP */
 
 /********************************************************//**
@@ -241,6 +241,126 @@ page_cur_rec_field_extends(
 }
 #endif /* PAGE_CUR_LE_OR_EXTENDS */
 
+/****************************************************************//**
+Reads the first field of an index entry, when the index has
+dict_index_t::search_prefix_len set.
+@return	the field, left aligned so that the values order like the bytes */
+UNIV_INLINE
+ib_uint64_t
+page_cur_read_prefix(
+/*=================*/
+	const byte*	ptr,	/*!< in: field data */
+	ulint		len)	/*!< in: dict_index_t::search_prefix_len */
+{
+	ib_uint64_t	prefix;
+
+	ut_ad(len > 0);
+	ut_ad(len <= 8);
+
+	switch (len) {
+	case 8:
+		return(mach_read_from_8(ptr));
+	case 4:
+		return((ib_uint64_t) mach_read_from_4(ptr) << 32);
+	}
+
+	prefix = 0;
+
+	for (ulint i = 0; i < len; i++) {
+		prefix = prefix << 8 | ptr[i];
+	}
+
+	return(prefix << (64 - 8 * len));
+}
+
+/****************************************************************//**
+Compares a data tuple to a physical record for page_cur_search_with_match().
+When the index has dict_index_t::search_prefix_len set, the first field is
+compared as an integer at the record origin, which avoids rec_get_offsets()
+and the generic comparison for the records that differ from the tuple on
+the first field, as most of the records visited by a search do.
+@return	1, 0, -1, if dtuple is greater, equal, less than rec,
+respectively, when only the common first fields are compared */
+UNIV_INLINE
+int
+page_cur_cmp_dtuple_rec(
+/*====================*/
+	const dtuple_t*		tuple,	/*!< in: data tuple */
+	ib_uint64_t		tuple_prefix,
+					/*!< in: first field of tuple, from
+					page_cur_read_prefix() */
+	ulint			prefix_len,
+					/*!< in: search_prefix_len, or 0 if
+					the tuple must be compared field by
+					field */
+	const rec_t*		rec,	/*!< in: physical record */
+	const dict_index_t*	index,	/*!< in: record descriptor */
+	ulint**			offsets,/*!< in/out: rec_get_offsets() */
+	mem_heap_t**		heap,	/*!< in/out: heap for offsets */
+	ulint*			matched_fields,
+					/*!< in/out: number of already
+					completely matched fields */
+	ulint*			matched_bytes)
+					/*!< in/out: number of already
+					matched bytes within the first field
+					not completely matched */
+{
+	if (prefix_len != 0 && *matched_fields == 0
+	    && (*matched_bytes != 0
+		|| !(rec_get_info_bits(rec, dict_table_is_comp(index->table))
+		     & REC_INFO_MIN_REC_FLAG))) {
+
+		ib_uint64_t	rec_prefix;
+		ib_uint64_t	diff;
+		int		cmp;
+		ulint		n_bytes;
+
+		rec_prefix = page_cur_read_prefix(rec, prefix_len);
+		cmp = (tuple_prefix > rec_prefix) - (tuple_prefix < rec_prefix);
+
+		if (cmp != 0) {
+			diff = tuple_prefix ^ rec_prefix;
+
+			for (n_bytes = 0; !(diff >> 56); n_bytes++) {
+				diff <<= 8;
+			}
+
+#ifdef UNIV_DEBUG
+			ulint	dbg_matched_fields = 0;
+			ulint	dbg_matched_bytes = *matched_bytes;
+
+			*offsets = rec_get_offsets(
+				rec, index, *offsets,
+				dtuple_get_n_fields_cmp(tuple), heap);
+			ut_ad(cmp == cmp_dtuple_rec_with_match(
+				      tuple, rec, *offsets,
+				      &dbg_matched_fields,
+				      &dbg_matched_bytes));
+			ut_ad(dbg_matched_fields == 0);
+			ut_ad(dbg_matched_bytes == n_bytes);
+#endif /* UNIV_DEBUG */
+
+			*matched_bytes = n_bytes;
+
+			return(cmp);
+		}
+
+		*matched_fields = 1;
+		*matched_bytes = 0;
+
+		if (dtuple_get_n_fields_cmp(tuple) == 1) {
+
+			return(0);
+		}
+	}
+
+	*offsets = rec_get_offsets(rec, index, *offsets,
+				   dtuple_get_n_fields_cmp(tuple), heap);
+
+	return(cmp_dtuple_rec_with_match(tuple, rec, *offsets,
+					 matched_fields, matched_bytes));
+}
+
 /****************************************************************//**
 Searches the right position for a page cursor. */
 UNIV_INTERN
@@ -293,6 +413,8 @@ page_cur_search_with_match(
 	mem_heap_t*	heap		= NULL;
 	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
 	ulint*		offsets		= offsets_;
+	ulint		prefix_len	= index->search_prefix_len;
+	ib_uint64_t	tuple_prefix	= 0;
 	rec_offs_init(offsets_);
 
 	ut_ad(block && tuple && iup_matched_fields && iup_matched_bytes
@@ -359,6 +481,21 @@ page_cur_search_with_match(
 	directory, after that as a linear search in the list of records
 	owned by the upper limit directory slot. */
 
+	if (prefix_len != 0) {
+		const dfield_t*	dfield = dtuple_get_nth_field(tuple, 0);
+
+		if (dfield_get_len(dfield) == prefix_len
+		    && !(dtuple_get_info_bits(tuple)
+			 & REC_INFO_MIN_REC_FLAG)) {
+			tuple_prefix = page_cur_read_prefix(
+				static_cast<const byte*>(
+					dfield_get_data(dfield)),
+				prefix_len);
+		} else {
+			prefix_len = 0;
+		}
+	}
+
 	low = 0;
 	up = page_dir_get_n_slots(page) - 1;
 
@@ -374,13 +511,10 @@ page_cur_search_with_match(
 			    low_matched_fields, low_matched_bytes,
 			    up_matched_fields, up_matched_bytes);
 
-		offsets = rec_get_offsets(mid_rec, index, offsets,
-					  dtuple_get_n_fields_cmp(tuple),
-					  &heap);
-
-		cmp = cmp_dtuple_rec_with_match(tuple, mid_rec, offsets,
-						&cur_matched_fields,
-						&cur_matched_bytes);
+		cmp = page_cur_cmp_dtuple_rec(tuple, tuple_prefix, prefix_len,
+					      mid_rec, index, &offsets, &heap,
+					      &cur_matched_fields,
+					      &cur_matched_bytes);
 		if (UNIV_LIKELY(cmp > 0)) {
 low_slot_match:
 			low = mid;
@@ -431,13 +565,10 @@ up_slot_match:
 			    low_matched_fields, low_matched_bytes,
 			    up_matched_fields, up_matched_bytes);
 
-		offsets = rec_get_offsets(mid_rec, index, offsets,
-					  dtuple_get_n_fields_cmp(tuple),
-					  &heap);
-
-		cmp = cmp_dtuple_rec_with_match(tuple, mid_rec, offsets,
-						&cur_matched_fields,
-						&cur_matched_bytes);
+		cmp = page_cur_cmp_dtuple_rec(tuple, tuple_prefix, prefix_len,
+					      mid_rec, index, &offsets, &heap,
+					      &cur_matched_fields,
+					      &cur_matched_bytes);
 		if (UNIV_LIKELY(cmp > 0)) {
 low_rec_match:
 			low_rec = mid_rec;
@@ -0,0 +1,639 @@
+/*****************************************************************************
+
+Copyright (c) 2013, Facebook Inc.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file row/row0bulk.cc
+Bulk load of sorted rows into an empty table
+*******************************************************/
+
+#include "row0bulk.h"
+
+#include "btr0btr.h"
+#include "btr0bulk.h"
+#include "dict0boot.h"
+#include "dict0dict.h"
+#include "lock0lock.h"
+#include "os0proc.h"
+#include "page0zip.h"
+#include "que0que.h"
+#include "rem0rec.h"
+#include "row0merge.h"
+#include "row0mysql.h"
+#include "row0row.h"
+#include "trx0rec.h"
+#include "trx0sys.h"
+#include "trx0undo.h"
+
+/** Sorting of the entries of a secondary index */
+struct row_bulk_index_t {
+	dict_index_t*		index;	/*!< secondary index */
+	row_merge_buf_t*	buf;	/*!< sort buffer */
+	merge_file_t		file;	/*!< sorted runs that did not fit
+					in buf, or file.fd == -1 */
+};
+
+/** Bulk load into an empty table */
+struct row_bulk_t {
+	trx_t*		trx;		/*!< the loading transaction */
+	trx_id_t	trx_id;		/*!< trx->id when the load started */
+	undo_no_t	undo_no;	/*!< undo number of the TRX_UNDO_EMPTY
+					record; a rollback to it or before it
+					abandons the load */
+	byte		trx_id_buf[DATA_TRX_ID_LEN];
+					/*!< DB_TRX_ID of the loaded rows */
+	byte		roll_ptr_buf[DATA_ROLL_PTR_LEN];
+					/*!< DB_ROLL_PTR of the loaded rows,
+					pointing to TRX_UNDO_EMPTY */
+	mem_heap_t*	heap;		/*!< memory heap for this struct */
+	mem_heap_t*	row_heap;	/*!< memory heap for the index entries
+					of a row */
+	btr_bulk_t*	clust;		/*!< builder of the clustered index */
+	row_bulk_index_t* indexes;	/*!< secondary indexes */
+	ulint		n_indexes;	/*!< number of secondary indexes */
+	row_merge_block_t* block;	/*!< merge sort buffers, or NULL */
+	ulint		block_size;	/*!< size of block */
+	int		tmpfd;		/*!< merge sort output file, or -1 */
+	dberr_t		error;		/*!< the error that ended the load */
+};
+
+/*********************************************************************//**
+Checks if the table can be bulk loaded.
+@return	true if bulk load is possible */
+static __attribute__((nonnull, warn_unused_result))
+bool
+row_bulk_is_possible(
+/*=================*/
+	dict_table_t*	table)	/*!< in: table */
+{
+	const dict_index_t*	index;
+
+	if (dict_table_is_temporary(table)
+	    || dict_table_zip_size(table)
+	    || dict_table_has_fts_index(table)
+	    || DICT_TF2_FLAG_IS_SET(table, DICT_TF2_FTS_HAS_DOC_ID)
+	    || UT_LIST_GET_LEN(table->foreign_list)
+	    || UT_LIST_GET_LEN(table->referenced_list)) {
+		return(false);
+	}
+
+	for (index = dict_table_get_first_index(table);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+
+		/* A unique secondary index would need a duplicate
+		check for every row. */
+		if (index->page == FIL_NULL
+		    || (index->type & DICT_FTS)
+		    || dict_index_is_corrupted(index)
+		    || dict_index_is_online_ddl(index)
+		    || (dict_index_is_unique(index)
+			&& !dict_index_is_clust(index))) {
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/*********************************************************************//**
+Checks if all the index trees of the table are empty.
+@return	true if the table is empty */
+static __attribute__((nonnull, warn_unused_result))
+bool
+row_bulk_table_is_empty(
+/*====================*/
+	dict_table_t*	table)	/*!< in: table */
+{
+	dict_index_t*	index;
+
+	for (index = dict_table_get_first_index(table);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+		const page_t*	root;
+		bool		empty;
+		mtr_t		mtr;
+
+		mtr_start(&mtr);
+		mtr_s_lock(dict_index_get_lock(index), &mtr);
+
+		root = buf_block_get_frame(
+			btr_root_block_get(index, RW_S_LATCH, &mtr));
+
+		/* Delete-marked records that were not purged yet make
+		the table non-empty. */
+		empty = page_is_leaf(root) && page_is_empty(root);
+
+		mtr_commit(&mtr);
+
+		if (!empty) {
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/*********************************************************************//**
+Starts a bulk load into the table of the prebuilt struct: locks the table
+and writes the TRX_UNDO_EMPTY undo log record if the table is empty.
+@return	DB_SUCCESS, DB_FAIL if bulk load is not possible, or error code */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+row_bulk_start(
+/*===========*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct in
+					MySQL handle */
+{
+	trx_t*		trx = prebuilt->trx;
+	dict_table_t*	table = prebuilt->table;
+	dict_index_t*	clust = dict_table_get_first_index(table);
+	row_bulk_t*	bulk;
+	mem_heap_t*	heap;
+	dict_index_t*	index;
+	undo_no_t	undo_no;
+	roll_ptr_t	roll_ptr;
+	dberr_t		err;
+
+	ut_ad(prebuilt->bulk == NULL);
+
+	if (!row_bulk_is_possible(table)) {
+		return(DB_FAIL);
+	}
+
+	err = row_lock_table_for_mysql(prebuilt, table, LOCK_X);
+
+	trx->op_info = "inserting";
+
+	if (err != DB_SUCCESS) {
+		return(err);
+	}
+
+	if (!row_bulk_table_is_empty(table)) {
+		return(DB_FAIL);
+	}
+
+	undo_no = trx->undo_no;
+
+	err = trx_undo_report_row_operation(
+		0, TRX_UNDO_INSERT_OP,
+		que_fork_get_first_thr(prebuilt->ins_graph),
+		clust, NULL, NULL, 0, NULL, NULL, &roll_ptr);
+
+	if (err != DB_SUCCESS) {
+		return(err);
+	}
+
+	heap = mem_heap_create(sizeof *bulk + 256);
+
+	bulk = static_cast<row_bulk_t*>(mem_heap_zalloc(heap, sizeof *bulk));
+
+	bulk->trx = trx;
+	bulk->trx_id = trx->id;
+	bulk->undo_no = undo_no;
+	bulk->heap = heap;
+	bulk->row_heap = mem_heap_create(UNIV_PAGE_SIZE / 4);
+	bulk->tmpfd = -1;
+	bulk->error = DB_SUCCESS;
+
+	trx_write_trx_id(bulk->trx_id_buf, trx->id);
+	trx_write_roll_ptr(bulk->roll_ptr_buf, roll_ptr);
+
+	bulk->clust = btr_bulk_create(clust, trx->id);
+
+	bulk->indexes = static_cast<row_bulk_index_t*>(
+		mem_heap_alloc(heap, UT_LIST_GET_LEN(table->indexes)
+			       * sizeof *bulk->indexes));
+
+	for (index = dict_table_get_next_index(clust);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+		row_bulk_index_t*	b = &bulk->indexes[bulk->n_indexes++];
+
+		b->index = index;
+		b->buf = row_merge_buf_create(index);
+		b->file.fd = -1;
+		b->file.offset = 0;
+		b->file.n_rec = 0;
+	}
+
+	prebuilt->bulk = bulk;
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Writes the sort buffer of a secondary index to the merge file.
+@return	DB_SUCCESS or error code */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+row_bulk_spill(
+/*===========*/
+	row_bulk_t*		bulk,	/*!< in/out: bulk load */
+	row_bulk_index_t*	b)	/*!< in/out: secondary index */
+{
+	if (bulk->block == NULL) {
+		bulk->block_size = 3 * srv_sort_buf_size;
+		bulk->block = static_cast<row_merge_block_t*>(
+			os_mem_alloc_large(&bulk->block_size));
+
+		if (bulk->block == NULL) {
+			return(DB_OUT_OF_MEMORY);
+		}
+	}
+
+	if (b->file.fd < 0 && row_merge_file_create(&b->file) < 0) {
+		return(DB_OUT_OF_MEMORY);
+	}
+
+	row_merge_buf_sort(b->buf, NULL);
+	row_merge_buf_write(b->buf, &b->file, bulk->block);
+
+	if (!row_merge_write(b->file.fd, b->file.offset++, bulk->block)) {
+		return(DB_OUT_OF_FILE_SPACE);
+	}
+
+	UNIV_MEM_INVALID(&bulk->block[0], srv_sort_buf_size);
+
+	b->file.n_rec += b->buf->n_tuples;
+	b->buf = row_merge_buf_empty(b->buf);
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Adds a row to the clustered index and to the sort buffers of the
+secondary indexes.
+@return	DB_SUCCESS, DB_FAIL if the row cannot be bulk loaded, or
+error code */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+row_bulk_add(
+/*=========*/
+	row_bulk_t*	bulk,	/*!< in/out: bulk load */
+	dict_table_t*	table,	/*!< in: table */
+	dtuple_t*	row)	/*!< in/out: row */
+{
+	dict_index_t*	clust = dict_table_get_first_index(table);
+	dtuple_t*	entry;
+	dberr_t		err;
+	ulint		i;
+
+	if (!dict_index_is_unique(clust)) {
+		dict_sys_write_row_id(
+			static_cast<byte*>(dfield_get_data(
+				dtuple_get_nth_field(
+					row, dict_table_get_sys_col_no(
+						table, DATA_ROW_ID)))),
+			dict_sys_get_new_row_id());
+	}
+
+	entry = row_build_index_entry(row, NULL, clust, bulk->row_heap);
+
+	dfield_set_data(dtuple_get_nth_field(
+				entry, dict_index_get_sys_col_pos(
+					clust, DATA_TRX_ID)),
+			bulk->trx_id_buf, DATA_TRX_ID_LEN);
+	dfield_set_data(dtuple_get_nth_field(
+				entry, dict_index_get_sys_col_pos(
+					clust, DATA_ROLL_PTR)),
+			bulk->roll_ptr_buf, DATA_ROLL_PTR_LEN);
+
+	if (page_zip_rec_needs_ext(rec_get_converted_size(clust, entry, 0),
+				   dict_table_is_comp(table),
+				   dtuple_get_n_fields(entry), 0)) {
+		/* Columns would have to be stored off-page. */
+		err = DB_FAIL;
+		goto func_exit;
+	}
+
+	err = btr_bulk_insert(bulk->clust, entry);
+
+	if (err != DB_SUCCESS) {
+		goto func_exit;
+	}
+
+	for (i = 0; i < bulk->n_indexes; i++) {
+		row_bulk_index_t*	b = &bulk->indexes[i];
+
+		entry = row_build_index_entry(
+			row, NULL, b->index, bulk->row_heap);
+
+		while (!row_merge_buf_add_entry(b->buf, entry)) {
+			ut_a(b->buf->n_tuples > 0);
+
+			err = row_bulk_spill(bulk, b);
+
+			if (err != DB_SUCCESS) {
+				goto func_exit;
+			}
+		}
+	}
+
+func_exit:
+	mem_heap_empty(bulk->row_heap);
+
+	return(err);
+}
+
+/*********************************************************************//**
+Appends the merge sorted entries of a secondary index to its tree.
+@return	DB_SUCCESS or error code */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+row_bulk_insert_merged(
+/*===================*/
+	row_bulk_t*		bulk,	/*!< in/out: bulk load */
+	row_bulk_index_t*	b,	/*!< in: secondary index */
+	btr_bulk_t*		tree)	/*!< in/out: tree builder */
+{
+	dict_index_t*	index = b->index;
+	mem_heap_t*	heap;
+	mem_heap_t*	tuple_heap;
+	mrec_buf_t*	buf;
+	ulint*		offsets;
+	const byte*	rec;
+	ulint		foffs = 0;
+	dberr_t		err = DB_SUCCESS;
+	ulint		i = 1 + REC_OFFS_HEADER_SIZE
+		+ dict_index_get_n_fields(index);
+
+	heap = mem_heap_create(sizeof *buf + i * sizeof *offsets);
+	tuple_heap = mem_heap_create(1000);
+
+	offsets = static_cast<ulint*>(
+		mem_heap_alloc(heap, i * sizeof *offsets));
+	offsets[0] = i;
+	offsets[1] = dict_index_get_n_fields(index);
+
+	buf = static_cast<mrec_buf_t*>(mem_heap_alloc(heap, sizeof *buf));
+
+	rec = bulk->block;
+
+	if (!row_merge_read(b->file.fd, foffs, bulk->block)) {
+		err = DB_CORRUPTION;
+	}
+
+	while (err == DB_SUCCESS) {
+		const mrec_t*	mrec;
+		ulint		n_ext;
+
+		rec = row_merge_read_rec(bulk->block, buf, rec, index,
+					 b->file.fd, &foffs, &mrec, offsets);
+
+		if (rec == NULL) {
+			/* End of list, or I/O error */
+			if (mrec != NULL) {
+				err = DB_CORRUPTION;
+			}
+
+			break;
+		}
+
+		err = btr_bulk_insert(
+			tree, row_rec_to_index_entry_low(
+				mrec, index, offsets, &n_ext, tuple_heap));
+		ut_ad(!n_ext);
+
+		mem_heap_empty(tuple_heap);
+	}
+
+	mem_heap_free(tuple_heap);
+	mem_heap_free(heap);
+
+	return(err);
+}
+
+/*********************************************************************//**
+Builds the tree of a secondary index from its sorted entries.
+@return	DB_SUCCESS or error code */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+row_bulk_build_index(
+/*=================*/
+	row_bulk_t*		bulk,	/*!< in/out: bulk load */
+	row_bulk_index_t*	b)	/*!< in/out: secondary index */
+{
+	btr_bulk_t*	tree = btr_bulk_create(b->index, bulk->trx_id);
+	dberr_t		err = DB_SUCCESS;
+
+	if (b->file.fd < 0) {
+		/* All the entries fit in the sort buffer. */
+		row_merge_buf_t*	buf = b->buf;
+		ulint			n_fields
+			= dict_index_get_n_fields(b->index);
+		dtuple_t*		tuple
+			= dtuple_create(bulk->row_heap, n_fields);
+		ulint			i;
+
+		row_merge_buf_sort(buf, NULL);
+
+		for (i = 0; err == DB_SUCCESS && i < buf->n_tuples; i++) {
+			memcpy(tuple->fields, buf->tuples[i].fields,
+			       n_fields * sizeof *tuple->fields);
+
+			err = btr_bulk_insert(tree, tuple);
+		}
+
+		mem_heap_empty(bulk->row_heap);
+	} else {
+		row_merge_dup_t	dup = { b->index, NULL, NULL, 0 };
+
+		if (b->buf->n_tuples > 0) {
+			err = row_bulk_spill(bulk, b);
+		}
+
+		if (err == DB_SUCCESS && bulk->tmpfd < 0) {
+			bulk->tmpfd = row_merge_file_create_low();
+
+			if (bulk->tmpfd < 0) {
+				err = DB_OUT_OF_MEMORY;
+			}
+		}
+
+		if (err == DB_SUCCESS) {
+			err = row_merge_sort(bulk->trx, &dup, &b->file,
+					     bulk->block, &bulk->tmpfd);
+		}
+
+		if (err == DB_SUCCESS) {
+			err = row_bulk_insert_merged(bulk, b, tree);
+		}
+	}
+
+	/* The entries include the unique clustered index key. */
+	ut_ad(err != DB_FAIL);
+
+	if (err == DB_SUCCESS) {
+		err = btr_bulk_finish(tree);
+	}
+
+	btr_bulk_free(tree);
+
+	return(err);
+}
+
+/*********************************************************************//**
+Checks if the transaction has committed or rolled back the bulk load.
+@return	true if the bulk load must be abandoned */
+static __attribute__((nonnull, warn_unused_result))
+bool
+row_bulk_is_stale(
+/*==============*/
+	const row_bulk_t*	bulk,	/*!< in: bulk load */
+	const trx_t*		trx)	/*!< in: transaction of the handle */
+{
+	return(trx != bulk->trx
+	       || trx->id != bulk->trx_id
+	       || trx->undo_no <= bulk->undo_no);
+}
+
+/*********************************************************************//**
+Inserts a row into the table in bulk, starting the bulk load on the first
+row if it was requested.
+@return	DB_SUCCESS, DB_FAIL if the row must be inserted one by one,
+or error code */
+UNIV_INTERN
+dberr_t
+row_bulk_insert(
+/*============*/
+	row_prebuilt_t*	prebuilt,	/*!< in/out: prebuilt struct in
+					MySQL handle */
+	dtuple_t*	row)		/*!< in/out: row to insert;
+					DB_ROW_ID may be assigned */
+{
+	row_bulk_t*	bulk = prebuilt->bulk;
+	dberr_t		err;
+
+	if (bulk != NULL && row_bulk_is_stale(bulk, prebuilt->trx)) {
+		row_bulk_free(bulk);
+		prebuilt->bulk = bulk = NULL;
+	}
+
+	if (bulk == NULL) {
+		if (!prebuilt->bulk_requested) {
+			return(DB_FAIL);
+		}
+
+		/* Only the first row of the statement may start
+		a bulk load. */
+		prebuilt->bulk_requested = 0;
+
+		err = row_bulk_start(prebuilt);
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+
+		bulk = prebuilt->bulk;
+	} else if (bulk->error != DB_SUCCESS) {
+		return(bulk->error);
+	}
+
+	err = row_bulk_add(bulk, prebuilt->table, row);
+
+	switch (err) {
+	case DB_SUCCESS:
+		return(err);
+	case DB_FAIL:
+		/* Insert the rest of the rows one by one, after the
+		rows that were bulk loaded. */
+		err = row_bulk_finish(prebuilt);
+		return(err == DB_SUCCESS ? DB_FAIL : err);
+	default:
+		bulk->error = err;
+		return(err);
+	}
+}
+
+/*********************************************************************//**
+Ends the bulk load of the statement, if any: writes the remaining rows
+and builds the secondary indexes.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+dberr_t
+row_bulk_finish(
+/*============*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct in
+					MySQL handle */
+{
+	row_bulk_t*	bulk = prebuilt->bulk;
+	dberr_t		err;
+	ulint		i;
+
+	prebuilt->bulk_requested = 0;
+
+	if (bulk == NULL) {
+		return(DB_SUCCESS);
+	}
+
+	prebuilt->bulk = NULL;
+
+	if (row_bulk_is_stale(bulk, prebuilt->trx)) {
+		row_bulk_free(bulk);
+		return(DB_SUCCESS);
+	}
+
+	/* After an error the statement will be rolled back. */
+	err = bulk->error;
+
+	if (err == DB_SUCCESS) {
+		err = btr_bulk_finish(bulk->clust);
+	}
+
+	for (i = 0; err == DB_SUCCESS && i < bulk->n_indexes; i++) {
+		err = row_bulk_build_index(bulk, &bulk->indexes[i]);
+	}
+
+	row_bulk_free(bulk);
+
+	return(err);
+}
+
+/*********************************************************************//**
+Frees a bulk load without writing the remaining rows. The pages that
+were already built are freed by the rollback of the transaction. */
+UNIV_INTERN
+void
+row_bulk_free(
+/*==========*/
+	row_bulk_t*	bulk)		/*!< in, own: bulk load */
+{
+	ulint	i;
+
+	for (i = 0; i < bulk->n_indexes; i++) {
+		row_bulk_index_t*	b = &bulk->indexes[i];
+
+		row_merge_buf_free(b->buf);
+
+		if (b->file.fd >= 0) {
+			row_merge_file_destroy(&b->file);
+		}
+	}
+
+	if (bulk->tmpfd >= 0) {
+		row_merge_file_destroy_low(bulk->tmpfd);
+	}
+
+	if (bulk->block != NULL) {
+		os_mem_free_large(bulk->block, bulk->block_size);
+	}
+
+	btr_bulk_free(bulk->clust);
+	mem_heap_free(bulk->row_heap);
+	mem_heap_free(bulk->heap);
+}
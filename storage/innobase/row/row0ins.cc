@@ -2327,7 +2327,9 @@ row_ins_clust_index_entry_low(
 	ulint		flags,	/*!< in: undo logging and locking flags */
 	ulint		mode,	/*!< in: BTR_MODIFY_LEAF or BTR_MODIFY_TREE,
 				depending on whether we wish optimistic or
-				pessimistic descent down the index tree */
+				pessimistic descent down the index tree;
+				BTR_MODIFY_TREE may be ORed with
+				BTR_LATCH_FOR_INSERT */
 	dict_index_t*	index,	/*!< in: clustered index */
 	ulint		n_uniq,	/*!< in: 0 or index->n_uniq */
 	dtuple_t*	entry,	/*!< in/out: index entry to insert */
@@ -2358,6 +2360,10 @@ row_ins_clust_index_entry_low(
 	mem_heap_t*	offsets_heap	= NULL;
 	ulint		use_mode;
 
+	const ulint	latch_for_insert = mode & BTR_LATCH_FOR_INSERT;
+
+	mode &= ~BTR_LATCH_FOR_INSERT;
+
 	ut_ad(dict_index_is_clust(index));
 	ut_ad(!dict_index_is_unique(index)
 	      || n_uniq == dict_index_get_n_unique(index));
@@ -2373,6 +2379,8 @@ row_ins_clust_index_entry_low(
 	} else if (mode == BTR_MODIFY_LEAF && dict_index_is_online_ddl(index)) {
 		use_mode = mode = BTR_MODIFY_LEAF | BTR_ALREADY_S_LATCHED;
 		mtr_s_lock(dict_index_get_lock(index), &mtr);
+	} else if (mode == BTR_MODIFY_TREE && !dict_index_is_online_ddl(index)) {
+		use_mode = mode | latch_for_insert;
 	} else {
 		use_mode = mode;
 	}
@@ -2439,7 +2447,16 @@ err_exit:
 		/* There is already an index entry with a long enough common
 		prefix, we must convert the insert into a modify of an
 		existing record */
-		mem_heap_t*	entry_heap	= mem_heap_create(1024);
+		mem_heap_t*	entry_heap;
+
+		if (use_mode & BTR_LATCH_FOR_INSERT) {
+			/* The update may free pages, which needs an
+			x-latch on the index tree. Let the caller retry. */
+			err = DB_FAIL;
+			goto err_exit;
+		}
+
+		entry_heap = mem_heap_create(1024);
 
 		err = row_ins_clust_index_entry_by_modify(
 			flags, mode, &cursor, &offsets, &offsets_heap,
@@ -2661,7 +2678,9 @@ row_ins_sec_index_entry_low(
 	ulint		flags,	/*!< in: undo logging and locking flags */
 	ulint		mode,	/*!< in: BTR_MODIFY_LEAF or BTR_MODIFY_TREE,
 				depending on whether we wish optimistic or
-				pessimistic descent down the index tree */
+				pessimistic descent down the index tree;
+				BTR_MODIFY_TREE may be ORed with
+				BTR_LATCH_FOR_INSERT */
 	dict_index_t*	index,	/*!< in: secondary index */
 	mem_heap_t*	offsets_heap,
 				/*!< in/out: memory heap that can be emptied */
@@ -2695,6 +2714,9 @@ row_ins_sec_index_entry_low(
 	mtr_t		mtr;
 	ulint*		offsets	= NULL;
 	trx_t*		trx=thr_get_trx(thr);
+	const ulint	latch_for_insert = mode & BTR_LATCH_FOR_INSERT;
+
+	mode &= ~BTR_LATCH_FOR_INSERT;
 
 	ut_ad(!dict_index_is_clust(index));
 	ut_ad(mode == BTR_MODIFY_LEAF || mode == BTR_MODIFY_TREE);
@@ -2737,6 +2759,11 @@ row_ins_sec_index_entry_low(
 		search_mode |= mode | BTR_INSERT;
 	}
 
+	if (mode == BTR_MODIFY_TREE && !check
+	    && UNIV_LIKELY(!trx->fake_changes)) {
+		search_mode |= latch_for_insert;
+	}
+
 	if (UNIV_UNLIKELY(trx->fake_changes)) {
 		use_mode = (mode & BTR_MODIFY_TREE) ? BTR_SEARCH_TREE : BTR_SEARCH_LEAF;
 	} else {
@@ -2827,6 +2854,13 @@ row_ins_sec_index_entry_low(
 		/* There is already an index entry with a long enough common
 		prefix, we must convert the insert into a modify of an
 		existing record */
+		if (search_mode & BTR_LATCH_FOR_INSERT) {
+			/* The update may merge pages, which needs an
+			x-latch on the index tree. Let the caller retry. */
+			err = DB_FAIL;
+			goto func_exit;
+		}
+
 		offsets = rec_get_offsets(
 			btr_cur_get_rec(&cursor), index, offsets,
 			ULINT_UNDEFINED, &offsets_heap);
@@ -3008,6 +3042,16 @@ row_ins_clust_index_entry(
 
 	log_free_check();
 
+	err = row_ins_clust_index_entry_low(
+		0, BTR_MODIFY_TREE | BTR_LATCH_FOR_INSERT, index, n_uniq,
+		entry, n_ext, thr, &page_no, &modify_clock);
+
+	if (err != DB_FAIL) {
+		return(err);
+	}
+
+	/* The insert must update a delete-marked record */
+
 	return(row_ins_clust_index_entry_low(
 		0, BTR_MODIFY_TREE, index, n_uniq, entry, n_ext, thr,
 		&page_no, &modify_clock));
@@ -3061,6 +3105,16 @@ row_ins_sec_index_entry(
 
 		log_free_check();
 
+		err = row_ins_sec_index_entry_low(
+			0, BTR_MODIFY_TREE | BTR_LATCH_FOR_INSERT, index,
+			offsets_heap, heap, entry, 0, thr,
+			&page_no, &modify_clock);
+	}
+
+	if (err == DB_FAIL) {
+		/* The insert must update a delete-marked record */
+		mem_heap_empty(heap);
+
 		err = row_ins_sec_index_entry_low(
 			0, BTR_MODIFY_TREE, index,
 			offsets_heap, heap, entry, 0, thr,
@@ -505,6 +505,59 @@ row_merge_buf_add(
 	return(n_row_added);
 }
 
+/******************************************************//**
+Insert an index entry into a sort buffer.
+@return	TRUE if added, FALSE if out of space */
+UNIV_INTERN
+ibool
+row_merge_buf_add_entry(
+/*====================*/
+	row_merge_buf_t*	buf,	/*!< in/out: sort buffer */
+	const dtuple_t*		entry)	/*!< in: entry of buf->index */
+{
+	ulint		n_fields	= dtuple_get_n_fields(entry);
+	mtuple_t*	tuple;
+	dfield_t*	field;
+	ulint		data_size;
+	ulint		extra_size;
+
+	ut_ad(n_fields == dict_index_get_n_fields(buf->index));
+	ut_ad(!(buf->index->type & DICT_FTS));
+
+	if (buf->n_tuples >= buf->max_tuples) {
+		return(FALSE);
+	}
+
+	data_size = rec_get_converted_size_temp(
+		buf->index, entry->fields, n_fields, &extra_size);
+
+	/* Add the encoded length of extra_size, as in
+	row_merge_buf_add(). */
+	data_size += 1 + ((extra_size + 1) >= 0x80);
+
+	ut_ad(data_size < srv_sort_buf_size);
+
+	/* Reserve one byte for the end marker of row_merge_block_t. */
+	if (buf->total_size + data_size >= srv_sort_buf_size - 1) {
+		return(FALSE);
+	}
+
+	buf->total_size += data_size;
+
+	tuple = &buf->tuples[buf->n_tuples++];
+	field = tuple->fields = static_cast<dfield_t*>(
+		mem_heap_dup(buf->heap, entry->fields,
+			     n_fields * sizeof *entry->fields));
+
+	/* Copy the data fields. */
+
+	do {
+		dfield_dup(field++, buf->heap);
+	} while (--n_fields);
+
+	return(TRUE);
+}
+
 /*************************************************************//**
 Report a duplicate key. */
 UNIV_INTERN
@@ -33,6 +33,7 @@ Created 9/17/2000 Heikki Tuuri
 #include <debug_sync.h>
 #include <my_dbug.h>
 
+#include "row0bulk.h"
 #include "row0ins.h"
 #include "row0merge.h"
 #include "row0sel.h"
@@ -856,6 +857,10 @@ row_prebuilt_free(
 		mem_heap_free(prebuilt->blob_heap);
 	}
 
+	if (prebuilt->bulk) {
+		row_bulk_free(prebuilt->bulk);
+	}
+
 	if (prebuilt->old_vers_heap) {
 		mem_heap_free(prebuilt->old_vers_heap);
 	}
@@ -1303,6 +1308,25 @@ row_insert_for_mysql(
 
 	row_mysql_convert_row_to_innobase(node->row, prebuilt, mysql_rec);
 
+	if (prebuilt->bulk_requested || prebuilt->bulk) {
+		err = row_bulk_insert(prebuilt, node->row);
+
+		switch (err) {
+		case DB_FAIL:
+			/* Insert the row one by one. */
+			break;
+		case DB_SUCCESS:
+			dict_table_n_rows_inc(table);
+			row_update_statistics_if_needed(table, trx);
+			srv_stats.n_rows_inserted.add((size_t)trx->id, 1);
+			srv_stats.n_rows_bulk_loaded.add((size_t)trx->id, 1);
+			/* fall through */
+		default:
+			trx->op_info = "";
+			return(err);
+		}
+	}
+
 	savept = trx_savept_take(trx);
 
 	thr = que_fork_get_first_thr(prebuilt->ins_graph);
@@ -2266,7 +2290,8 @@ err_exit:
 
 	err = trx->error_state;
 
-	if (table->space != TRX_SYS_SPACE) {
+	if (table->space != TRX_SYS_SPACE
+	    && !fsp_is_system_temporary(table->space)) {
 		ut_a(DICT_TF2_FLAG_IS_SET(table, DICT_TF2_USE_TABLESPACE));
 
 		/* Update SYS_TABLESPACES and SYS_DATAFILES if a new
@@ -2328,6 +2353,7 @@ err_exit:
 		/* We already have .ibd file here. it should be deleted. */
 
 		if (table->space
+		    && !fsp_is_system_temporary(table->space)
 		    && fil_delete_tablespace(
 			    table->space,
 			    BUF_REMOVE_FLUSH_NO_WRITE)
@@ -4141,9 +4167,10 @@ check_next_foreign:
 		not know the temp path */
 		ut_a(table->dir_path_of_temp_table == NULL || is_temp);
 		if (dict_table_is_discarded(table)
-		    || table->ibd_file_missing) {
+		    || table->ibd_file_missing
+		    || fsp_is_system_temporary(space_id)) {
 			/* Do not attempt to drop known-to-be-missing
-			tablespaces. */
+			tablespaces, or the shared temporary tablespace. */
 			space_id = 0;
 		}
 
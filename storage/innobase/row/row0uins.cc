@@ -312,7 +312,7 @@ row_undo_ins_parse_undo_rec(
 
 	ptr = trx_undo_rec_get_pars(node->undo_rec, &type, &dummy,
 				    &dummy_extern, &undo_no, &table_id);
-	ut_ad(type == TRX_UNDO_INSERT_REC);
+	ut_ad(type == TRX_UNDO_INSERT_REC || type == TRX_UNDO_EMPTY);
 	node->rec_type = type;
 
 	node->update = NULL;
@@ -325,6 +325,9 @@ row_undo_ins_parse_undo_rec(
 close_table:
 		dict_table_close(node->table, dict_locked, FALSE);
 		node->table = NULL;
+	} else if (type == TRX_UNDO_EMPTY) {
+		/* There is no record to look up: the whole table
+		will be emptied. */
 	} else {
 		clust_index = dict_table_get_first_index(node->table);
 
@@ -406,6 +409,58 @@ func_exit:
 	return(err);
 }
 
+/***********************************************************//**
+Undoes a bulk load into an empty table (TRX_UNDO_EMPTY) by emptying all
+the indexes of the table. The loading transaction holds an exclusive lock
+on the table, which was empty when the load started, so the indexes can
+only contain records written by it. */
+static __attribute__((nonnull))
+void
+row_undo_ins_empty(
+/*===============*/
+	dict_table_t*	table)	/*!< in/out: bulk loaded table */
+{
+	ulint		zip_size = dict_table_zip_size(table);
+	dict_index_t*	index;
+
+	for (index = dict_table_get_first_index(table);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+		buf_block_t*	block;
+		mtr_t		mtr;
+
+		if (index->page == FIL_NULL) {
+			continue;
+		}
+
+		log_free_check();
+
+		rw_lock_x_lock(dict_index_get_lock(index));
+
+		/* This also frees the pages of a bulk load that had
+		not been attached to the root yet. */
+		btr_free_but_not_root(index->space, zip_size, index->page);
+
+		mtr_start(&mtr);
+
+		block = btr_block_get(index->space, zip_size, index->page,
+				      RW_X_LATCH, index, &mtr);
+
+		btr_page_empty(block, buf_block_get_page_zip(block),
+			       index, 0, &mtr);
+
+		if (!dict_index_is_clust(index)) {
+			ibuf_reset_free_bits(block);
+		}
+
+		mtr_commit(&mtr);
+
+		rw_lock_x_unlock(dict_index_get_lock(index));
+	}
+
+	table->stat_n_rows = 0;
+}
+
 /***********************************************************//**
 Undoes a fresh insert of a row to a table. A fresh insert means that
 the same clustered index unique key did not have any record, even delete
@@ -434,6 +489,18 @@ row_undo_ins(
 		return(DB_SUCCESS);
 	}
 
+	if (node->rec_type == TRX_UNDO_EMPTY) {
+		row_undo_ins_empty(node->table);
+
+		trx_undo_rec_release(node->trx, node->undo_no);
+
+		dict_table_close(node->table, dict_locked, FALSE);
+
+		node->table = NULL;
+
+		return(DB_SUCCESS);
+	}
+
 	/* Iterate over all the indexes and undo the insert.*/
 
 	node->index = dict_table_get_first_index(node->table);
@@ -70,6 +70,9 @@ UNIV_INTERN ulong	srv_thread_concurrency	= 0;
 /* When != 0, detect deadlocks for row-lock waits */
 UNIV_INTERN my_bool	srv_deadlock_detect = 1;
 
+/* How record locks are granted when they are released */
+UNIV_INTERN ulong	srv_lock_schedule_algorithm = SRV_LOCK_SCHEDULE_FCFS;
+
 #ifndef HAVE_ATOMIC_BUILTINS
 
 /** This mutex protects srv_conc data structures */
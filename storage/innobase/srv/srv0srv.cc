@@ -85,6 +85,8 @@ UNIV_INTERN ibool	srv_error_monitor_active = FALSE;
 
 UNIV_INTERN ibool	srv_buf_dump_thread_active = FALSE;
 
+UNIV_INTERN ibool	srv_buf_resize_thread_active = FALSE;
+
 UNIV_INTERN ibool	srv_dict_stats_thread_active = FALSE;
 
 UNIV_INTERN const char*	srv_main_thread_op_info = "";
@@ -122,6 +124,12 @@ UNIV_INTERN my_bool	srv_read_only_mode;
 /** store to its own file each table created by an user; data
 dictionary tables are in the system tablespace 0 */
 UNIV_INTERN my_bool	srv_file_per_table;
+/** store the temporary tables in a shared tablespace that is created
+at startup and never redo logged */
+UNIV_INTERN my_bool	srv_tmp_tablespace = TRUE;
+/** Space id of the shared temporary tablespace, or ULINT_UNDEFINED if
+it has not been created */
+UNIV_INTERN ulint	srv_tmp_space_id = ULINT_UNDEFINED;
 /** The file format to use on new *.ibd files. */
 UNIV_INTERN ulint	srv_file_format = 0;
 /** Whether to check file format during startup.  A value of
@@ -225,6 +233,8 @@ UNIV_INTERN my_bool	srv_use_sys_malloc	= TRUE;
 UNIV_INTERN ulint	srv_buf_pool_size	= ULINT_MAX;
 /* requested number of buffer pool instances */
 UNIV_INTERN ulint       srv_buf_pool_instances  = 1;
+/* size of a buffer pool chunk, the unit of resizing, in bytes */
+UNIV_INTERN ulint	srv_buf_pool_chunk_unit;
 /* number of locks to protect buf_pool->page_hash */
 UNIV_INTERN ulong	srv_n_page_hash_locks = 16;
 /** Scan depth for LRU flush batch i.e.: number of blocks scanned*/
@@ -255,6 +265,9 @@ UNIV_INTERN ulint	srv_n_write_io_threads	= ULINT_MAX;
 
 /* Switch to enable random read ahead. */
 UNIV_INTERN my_bool	srv_random_read_ahead	= FALSE;
+/* Maximum number of pages of an externally stored field that are read
+ahead at once when the field is read; 0 disables BLOB read-ahead. */
+UNIV_INTERN ulong	srv_blob_read_ahead_pages = 64;
 /* User settable value of the number of pages that must be present
 in the buffer cache and accessed sequentially for InnoDB to trigger a
 readahead request. */
@@ -707,6 +720,9 @@ UNIV_INTERN os_event_t	srv_error_event;
 /** Event to signal the buffer pool dump/load thread */
 UNIV_INTERN os_event_t	srv_buf_dump_event;
 
+/** Event to signal the buffer pool resize thread */
+UNIV_INTERN os_event_t	srv_buf_resize_event;
+
 /** The buffer pool dump/load file name */
 UNIV_INTERN char*	srv_buf_dump_filename;
 
@@ -1084,6 +1100,8 @@ srv_init(void)
 
 		srv_buf_dump_event = os_event_create();
 
+		srv_buf_resize_event = os_event_create();
+
 		UT_LIST_INIT(srv_sys->tasks);
 	}
 
@@ -1130,6 +1148,9 @@ srv_free(void)
 	if (!srv_read_only_mode) {
 		os_event_free(srv_buf_dump_event);
 		srv_buf_dump_event = NULL;
+
+		os_event_free(srv_buf_resize_event);
+		srv_buf_resize_event = NULL;
 	}
 }
 
@@ -1649,6 +1670,12 @@ srv_export_innodb_status(void)
 	export_vars.innodb_buffer_pool_read_ahead_evicted =
 		stat.n_ra_pages_evicted;
 
+	export_vars.innodb_buffer_pool_fake_changes_reads =
+		srv_stats.buf_pool_fake_changes_reads;
+
+	export_vars.innodb_buffer_pool_fake_changes_hits =
+		srv_stats.buf_pool_fake_changes_hits;
+
 	export_vars.innodb_buffer_pool_pages_data = LRU_len;
 
 	export_vars.innodb_buffer_pool_bytes_data =
@@ -1830,6 +1857,8 @@ srv_export_innodb_status(void)
 
 	export_vars.innodb_rows_inserted = srv_stats.n_rows_inserted;
 
+	export_vars.innodb_rows_bulk_loaded = srv_stats.n_rows_bulk_loaded;
+
 	export_vars.innodb_rows_updated = srv_stats.n_rows_updated;
 
 	export_vars.innodb_rows_deleted = srv_stats.n_rows_deleted;
@@ -1929,6 +1958,10 @@ srv_export_innodb_status(void)
 		srv_stats.n_logical_read_ahead_prefetched;
 	export_vars.innodb_logical_read_ahead_in_buf_pool =
 		srv_stats.n_logical_read_ahead_in_buf_pool;
+	export_vars.innodb_blob_read_ahead_prefetched =
+		srv_stats.n_blob_read_ahead_prefetched;
+	export_vars.innodb_blob_read_ahead_hits =
+		srv_stats.n_blob_read_ahead_hits;
 
 	for (i = 0; i < PAGE_ZIP_SSIZE_MAX - 1; i++) {
 		page_zip_stat_t*        zip_stat = &page_zip_stat[i];
@@ -2435,6 +2468,8 @@ srv_any_background_threads_are_active(void)
 		thread_active = "srv_monitor_thread";
 	} else if (srv_buf_dump_thread_active) {
 		thread_active = "buf_dump_thread";
+	} else if (srv_buf_resize_thread_active) {
+		thread_active = "buf_resize_thread";
 	} else if (srv_dict_stats_thread_active) {
 		thread_active = "dict_stats_thread";
 	}
@@ -2442,6 +2477,7 @@ srv_any_background_threads_are_active(void)
 	os_event_set(srv_error_event);
 	os_event_set(srv_monitor_event);
 	os_event_set(srv_buf_dump_event);
+	os_event_set(srv_buf_resize_event);
 	os_event_set(lock_sys->timeout_event);
 	os_event_set(dict_stats_event);
 
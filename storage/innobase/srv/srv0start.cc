@@ -1439,6 +1439,75 @@ srv_start_wait_for_purge_to_start()
 	}
 }
 
+/*********************************************************************//**
+Creates the shared temporary tablespace for the temporary tables. It gets
+a new space id at every startup, so that neither the temporary tables of
+a crashed server instance that are still in SYS_TABLES nor stray redo log
+records can refer to it.
+@return	DB_SUCCESS or error code */
+static
+dberr_t
+srv_open_tmp_tablespace(void)
+/*=========================*/
+{
+	char	name[10000];
+	ulint	dirnamelen;
+	ulint	space;
+	ulint	size = SRV_TMP_SPACE_INITIAL_SIZE >> UNIV_PAGE_SIZE_SHIFT;
+	mtr_t	mtr;
+	trx_t*	trx;
+	dberr_t	err;
+
+	ut_a(srv_tmp_space_id == ULINT_UNDEFINED);
+
+	dirnamelen = strlen(srv_data_home);
+
+	ut_a(dirnamelen + strlen(SRV_TMP_SPACE_NAME) < (sizeof name) - 1);
+
+	memcpy(name, srv_data_home, dirnamelen);
+
+	/* Add a path separator if needed. */
+	if (dirnamelen && name[dirnamelen - 1] != SRV_PATH_SEPARATOR) {
+		name[dirnamelen++] = SRV_PATH_SEPARATOR;
+	}
+
+	strcpy(name + dirnamelen, SRV_TMP_SPACE_NAME);
+
+	dict_hdr_get_new_id(NULL, NULL, &space);
+
+	if (space == ULINT_UNDEFINED) {
+		return(DB_ERROR);
+	}
+
+	err = fil_create_temporary_tablespace(space, name, size);
+
+	if (err != DB_SUCCESS) {
+		return(err);
+	}
+
+	/* From now on, the mini-transactions that only modify pages of
+	the tablespace will not write any redo log. */
+	srv_tmp_space_id = space;
+
+	mtr_start(&mtr);
+
+	fsp_header_init(space, size, &mtr);
+
+	mtr_commit(&mtr);
+
+	/* Write the few pages that were initialized above, so that
+	the startup does not leave them for the page cleaner. */
+	trx = trx_allocate_for_background();
+	buf_LRU_flush_or_remove_pages(space, BUF_REMOVE_FLUSH_WRITE, trx);
+	trx_free_for_background(trx);
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Created the temporary tablespace '%s' with space id %lu",
+		name, (ulong) space);
+
+	return(DB_SUCCESS);
+}
+
 /********************************************************************
 Starts InnoDB and creates a new database if database files
 are not found and the user wants.
@@ -1848,6 +1917,16 @@ innobase_start_or_create_for_mysql(void)
 
 	fil_init(srv_file_per_table ? 50000 : 5000, srv_max_n_open_files);
 
+	/* The buffer pool consists of chunks of srv_buf_pool_chunk_unit
+	bytes in each instance, and its size is a multiple of them. */
+	if (srv_buf_pool_chunk_unit * srv_buf_pool_instances
+	    > srv_buf_pool_size) {
+		srv_buf_pool_chunk_unit
+			= srv_buf_pool_size / srv_buf_pool_instances;
+	}
+
+	srv_buf_pool_size = buf_pool_size_align(srv_buf_pool_size);
+
 	double	size;
 	char	unit;
 
@@ -2587,6 +2666,15 @@ files_checked:
 		return(err);
 	}
 
+	if (srv_tmp_tablespace
+	    && !srv_read_only_mode
+	    && srv_force_recovery < SRV_FORCE_NO_TRX_UNDO) {
+		err = srv_open_tmp_tablespace();
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+	}
+
 	srv_is_being_started = FALSE;
 
 	ut_a(trx_purge_state() == PURGE_STATE_INIT);
@@ -2774,6 +2862,9 @@ files_checked:
 		/* Create the buffer pool dump/load thread */
 		os_thread_create(buf_dump_thread, NULL, NULL);
 
+		/* Create the thread that resizes the buffer pool */
+		os_thread_create(buf_resize_thread, NULL, NULL);
+
 		/* Create the dict stats gathering thread */
 		os_thread_create(dict_stats_thread, NULL, NULL);
 
@@ -2984,6 +3075,7 @@ innobase_shutdown_for_mysql(void)
 	sync_close();
 	srv_free();
 	fil_close();
+	srv_tmp_space_id = ULINT_UNDEFINED;
 
 	/* 4. Free the os_conc_mutex and all os_events and os_mutexes */
 
@@ -297,7 +297,8 @@ sync_cell_get_event(
 		return(&((ib_mutex_t*) cell->wait_object)->event);
 	} else if (type == RW_LOCK_WAIT_EX) {
 		return(&((rw_lock_t*) cell->wait_object)->wait_ex_event);
-	} else { /* RW_LOCK_SHARED and RW_LOCK_EX wait on the same event */
+	} else { /* RW_LOCK_SHARED, RW_LOCK_SX and RW_LOCK_EX wait on the
+		 same event */
 		return(&((rw_lock_t*) cell->wait_object)->event);
 	}
 }
@@ -470,10 +471,12 @@ sync_array_cell_print(
 
 	} else if (type == RW_LOCK_EX
 		   || type == RW_LOCK_WAIT_EX
+		   || type == RW_LOCK_SX
 		   || type == RW_LOCK_SHARED) {
 
 		fputs(type == RW_LOCK_EX ? "X-lock on"
 		      : type == RW_LOCK_WAIT_EX ? "X-lock (wait_ex) on"
+		      : type == RW_LOCK_SX ? "SX-lock on"
 		      : "S-lock on", file);
 
 		rwlock = cell->old_wait_rw_lock;
@@ -663,13 +666,14 @@ sync_array_detect_deadlock(
 			     && !os_thread_eq(thread, cell->thread))
 			    || ((debug->lock_type == RW_LOCK_WAIT_EX)
 				&& !os_thread_eq(thread, cell->thread))
+			    || (debug->lock_type == RW_LOCK_SX)
 			    || (debug->lock_type == RW_LOCK_SHARED)) {
 
 				/* The (wait) x-lock request can block
 				infinitely only if someone (can be also cell
-				thread) is holding s-lock, or someone
-				(cannot be cell thread) (wait) x-lock, and
-				he is blocked by start thread */
+				thread) is holding s-lock or sx-lock, or
+				someone (cannot be cell thread) (wait)
+				x-lock, and he is blocked by start thread */
 
 				ret = sync_array_deadlock_step(
 					arr, start, thread, debug->pass,
@@ -687,6 +691,36 @@ print:
 
 		return(FALSE);
 
+	} else if (cell->request_type == RW_LOCK_SX) {
+
+		lock = static_cast<rw_lock_t*>(cell->wait_object);
+
+		for (debug = UT_LIST_GET_FIRST(lock->debug_list);
+		     debug != 0;
+		     debug = UT_LIST_GET_NEXT(list, debug)) {
+
+			thread = debug->thread_id;
+
+			if ((debug->lock_type == RW_LOCK_EX)
+			    || (debug->lock_type == RW_LOCK_WAIT_EX)
+			    || (debug->lock_type == RW_LOCK_SX)) {
+
+				/* The sx-lock request can block infinitely
+				only if someone (can also be cell thread) is
+				holding sx-lock or (wait) x-lock, and he is
+				blocked by start thread */
+
+				ret = sync_array_deadlock_step(
+					arr, start, thread, debug->pass,
+					depth);
+				if (ret) {
+					goto print;
+				}
+			}
+		}
+
+		return(FALSE);
+
 	} else if (cell->request_type == RW_LOCK_SHARED) {
 
 		lock = static_cast<rw_lock_t*>(cell->wait_object);
@@ -755,6 +789,17 @@ sync_arr_cell_can_wake_up(
 			return(TRUE);
 		}
 
+	} else if (cell->request_type == RW_LOCK_SX) {
+
+		lock = static_cast<rw_lock_t*>(cell->wait_object);
+
+		/* lock_word > X_LOCK_HALF_DECR means no sx-locker,
+		no writer and no reserved writer */
+		if (lock->lock_word > X_LOCK_HALF_DECR) {
+
+			return(TRUE);
+		}
+
         } else if (cell->request_type == RW_LOCK_WAIT_EX) {
 
 		lock = static_cast<rw_lock_t*>(cell->wait_object);
@@ -64,6 +64,24 @@ lock_word <= -X_LOCK_DECR:     Recursively write locked. lock_word has been
 			       So the number of locks is:
 			       (lock_copy == 0) ? 1 : 2 - (lock_copy + X_LOCK_DECR)
 
+An sx-lock decrements lock_word by X_LOCK_HALF_DECR. It is granted only
+while lock_word > X_LOCK_HALF_DECR, that is, when the lock is neither
+sx-locked nor x-locked and there is no waiting writer, so that readers
+may share the lock with the single sx-lock holder:
+
+0 < lock_word <= X_LOCK_HALF_DECR:
+			       Sx-locked, no waiting writer.
+			       (X_LOCK_HALF_DECR - lock_word) is the
+			       number of readers that hold the lock.
+-X_LOCK_DECR < lock_word <= -X_LOCK_HALF_DECR:
+			       Sx-locked, with a waiting writer that waits
+			       for the readers and the sx-lock holder to
+			       exit. (-lock_word - X_LOCK_HALF_DECR) is the
+			       number of readers that hold the lock.
+
+An sx-lock is not recursive, and the sx-lock holder must not s-lock or
+x-lock the same rw-lock.
+
 The lock_word is always read and updated atomically and consistently, so that
 it always represents the state of the lock, and the state of the lock changes
 with a single atomic operation. This lock_word holds all of the information
@@ -260,12 +278,17 @@ rw_lock_create_func(
 	lock->cline = (unsigned int) cline;
 
 	lock->count_os_wait = 0;
+	lock->wait_class = sync_wait_class_get(cfile_name, cline);
 	lock->last_s_file_name = "not yet reserved";
 	lock->last_x_file_name = "not yet reserved";
 	lock->last_s_line = 0;
 	lock->last_x_line = 0;
 	os_event_create2(&lock->event);
 	os_event_create2(&lock->wait_ex_event);
+#ifdef UNIV_FUTEX_LATCHES
+	lock->futex_event = 0;
+	lock->futex_wait_ex = 0;
+#endif /* UNIV_FUTEX_LATCHES */
 
 	mutex_enter(&rw_lock_list_mutex);
 
@@ -367,10 +390,13 @@ rw_lock_s_lock_spin(
 	const char*	file_name, /*!< in: file name where lock requested */
 	ulint		line)	/*!< in: line where requested */
 {
-	ulint		index;	/* index of the reserved wait cell */
 	ulint		i = 0;	/* spin round count */
+#ifndef UNIV_FUTEX_LATCHES
+	ulint		index;	/* index of the reserved wait cell */
 	sync_array_t*	sync_arr;
+#endif /* !UNIV_FUTEX_LATCHES */
 	size_t		counter_index;
+	ullint		wait_start = 0;	/* when the first OS wait started */
 
 	/* We reuse the thread id to index into the counter, cache
 	it here for efficiency. */
@@ -398,6 +424,7 @@ lock_loop:
 	/* We try once again to obtain the lock */
 	if (TRUE == rw_lock_s_lock_low(lock, pass, file_name, line)) {
 		rw_lock_stats.rw_s_spin_round_count.add(counter_index, i);
+		sync_wait_class_add(lock->wait_class, wait_start);
 
 		return; /* Success */
 	} else {
@@ -408,6 +435,26 @@ lock_loop:
 
 		rw_lock_stats.rw_s_spin_round_count.add(counter_index, i);
 
+#ifdef UNIV_FUTEX_LATCHES
+		ib_uint32_t	seq = os_atomic_increment(
+			&lock->futex_event, 0);
+
+		rw_lock_set_waiter_flag(lock);
+
+		if (TRUE == rw_lock_s_lock_low(lock, pass, file_name, line)) {
+			sync_wait_class_add(lock->wait_class, wait_start);
+			return; /* Success */
+		}
+
+		lock->count_os_wait++;
+		rw_lock_stats.rw_s_os_wait_count.add(counter_index, 1);
+
+		if (!wait_start) {
+			wait_start = ut_time_us(NULL);
+		}
+
+		os_futex_wait(&lock->futex_event, seq);
+#else /* UNIV_FUTEX_LATCHES */
 		sync_arr = sync_array_get();
 
 		sync_array_reserve_cell(
@@ -420,6 +467,7 @@ lock_loop:
 
 		if (TRUE == rw_lock_s_lock_low(lock, pass, file_name, line)) {
 			sync_array_free_cell(sync_arr, index);
+			sync_wait_class_add(lock->wait_class, wait_start);
 			return; /* Success */
 		}
 
@@ -427,7 +475,12 @@ lock_loop:
 		lock->count_os_wait++;
 		rw_lock_stats.rw_s_os_wait_count.add(counter_index, 1);
 
+		if (!wait_start) {
+			wait_start = ut_time_us(NULL);
+		}
+
 		sync_array_wait_event(sync_arr, index);
+#endif /* UNIV_FUTEX_LATCHES */
 
 		i = 0;
 		goto lock_loop;
@@ -469,10 +522,13 @@ rw_lock_x_lock_wait(
 	const char*	file_name,/*!< in: file name where lock requested */
 	ulint		line)	/*!< in: line where requested */
 {
-	ulint		index;
 	ulint		i = 0;
+#ifndef UNIV_FUTEX_LATCHES
+	ulint		index;
 	sync_array_t*	sync_arr;
+#endif /* !UNIV_FUTEX_LATCHES */
 	size_t		counter_index;
+	ullint		wait_start = 0;	/* when the first OS wait started */
 
 	/* We reuse the thread id to index into the counter, cache
 	it here for efficiency. */
@@ -493,14 +549,32 @@ rw_lock_x_lock_wait(
 		/* If there is still a reader, then go to sleep.*/
 		rw_lock_stats.rw_x_spin_round_count.add(counter_index, i);
 
+		i = 0;
+
+		if (!wait_start) {
+			wait_start = ut_time_us(NULL);
+		}
+
+#ifdef UNIV_FUTEX_LATCHES
+		ib_uint32_t	seq = os_atomic_increment(
+			&lock->futex_wait_ex, 0);
+
+		/* Check lock_word to ensure wake-up isn't missed.*/
+		if (lock->lock_word < 0) {
+
+			/* these stats may not be accurate */
+			lock->count_os_wait++;
+			rw_lock_stats.rw_x_os_wait_count.add(counter_index, 1);
+
+			os_futex_wait(&lock->futex_wait_ex, seq);
+		}
+#else /* UNIV_FUTEX_LATCHES */
 		sync_arr = sync_array_get();
 
 		sync_array_reserve_cell(
 			sync_arr, lock, RW_LOCK_WAIT_EX,
 			file_name, line, &index);
 
-		i = 0;
-
 		/* Check lock_word to ensure wake-up isn't missed.*/
 		if (lock->lock_word < 0) {
 
@@ -526,8 +600,10 @@ rw_lock_x_lock_wait(
 		} else {
 			sync_array_free_cell(sync_arr, index);
 		}
+#endif /* UNIV_FUTEX_LATCHES */
 	}
 	rw_lock_stats.rw_x_spin_round_count.add(counter_index, i);
+	sync_wait_class_add(lock->wait_class, wait_start);
 }
 
 /******************************************************************//**
@@ -543,7 +619,7 @@ rw_lock_x_lock_low(
 	const char*	file_name,/*!< in: file name where lock requested */
 	ulint		line)	/*!< in: line where requested */
 {
-	if (rw_lock_lock_word_decr(lock, X_LOCK_DECR)) {
+	if (rw_lock_lock_word_decr(lock, X_LOCK_DECR, 0)) {
 
 		/* lock->recursive also tells us if the writer_thread
 		field is stale or active. As we are going to write
@@ -608,10 +684,13 @@ rw_lock_x_lock_func(
 	ulint		line)	/*!< in: line where requested */
 {
 	ulint		i;	/*!< spin round count */
+#ifndef UNIV_FUTEX_LATCHES
 	ulint		index;	/*!< index of the reserved wait cell */
 	sync_array_t*	sync_arr;
+#endif /* !UNIV_FUTEX_LATCHES */
 	ibool		spinning = FALSE;
 	size_t		counter_index;
+	ullint		wait_start = 0;	/*!< when the first OS wait started */
 
 	/* We reuse the thread id to index into the counter, cache
 	it here for efficiency. */
@@ -621,6 +700,7 @@ rw_lock_x_lock_func(
 	ut_ad(rw_lock_validate(lock));
 #ifdef UNIV_SYNC_DEBUG
 	ut_ad(!rw_lock_own(lock, RW_LOCK_SHARED));
+	ut_ad(!rw_lock_own(lock, RW_LOCK_SX));
 #endif /* UNIV_SYNC_DEBUG */
 
 	i = 0;
@@ -629,6 +709,7 @@ lock_loop:
 
 	if (rw_lock_x_lock_low(lock, pass, file_name, line)) {
 		rw_lock_stats.rw_x_spin_round_count.add(counter_index, i);
+		sync_wait_class_add(lock->wait_class, wait_start);
 
 		return;	/* Locking succeeded */
 
@@ -660,17 +741,24 @@ lock_loop:
 
 	rw_lock_stats.rw_x_spin_round_count.add(counter_index, i);
 
+#ifdef UNIV_FUTEX_LATCHES
+	ib_uint32_t	seq = os_atomic_increment(&lock->futex_event, 0);
+#else /* UNIV_FUTEX_LATCHES */
 	sync_arr = sync_array_get();
 
 	sync_array_reserve_cell(
 		sync_arr, lock, RW_LOCK_EX, file_name, line, &index);
+#endif /* UNIV_FUTEX_LATCHES */
 
 	/* Waiters must be set before checking lock_word, to ensure signal
 	is sent. This could lead to a few unnecessary wake-up signals. */
 	rw_lock_set_waiter_flag(lock);
 
 	if (rw_lock_x_lock_low(lock, pass, file_name, line)) {
+#ifndef UNIV_FUTEX_LATCHES
 		sync_array_free_cell(sync_arr, index);
+#endif /* !UNIV_FUTEX_LATCHES */
+		sync_wait_class_add(lock->wait_class, wait_start);
 		return; /* Locking succeeded */
 	}
 
@@ -678,7 +766,154 @@ lock_loop:
 	lock->count_os_wait++;
 	rw_lock_stats.rw_x_os_wait_count.add(counter_index, 1);
 
+	if (!wait_start) {
+		wait_start = ut_time_us(NULL);
+	}
+
+#ifdef UNIV_FUTEX_LATCHES
+	os_futex_wait(&lock->futex_event, seq);
+#else /* UNIV_FUTEX_LATCHES */
 	sync_array_wait_event(sync_arr, index);
+#endif /* UNIV_FUTEX_LATCHES */
+
+	i = 0;
+	goto lock_loop;
+}
+
+/******************************************************************//**
+Low-level function for acquiring a shared exclusive lock.
+@return	FALSE if did not succeed, TRUE if success. */
+UNIV_INLINE
+ibool
+rw_lock_sx_lock_low(
+/*================*/
+	rw_lock_t*	lock,	/*!< in: pointer to rw-lock */
+	ulint		pass __attribute__((unused)),
+				/*!< in: pass value; != 0, if the lock will
+				be passed to another thread to unlock */
+	const char*	file_name,/*!< in: file name where lock requested */
+	ulint		line)	/*!< in: line where requested */
+{
+	if (!rw_lock_lock_word_decr(lock, X_LOCK_HALF_DECR,
+				    X_LOCK_HALF_DECR)) {
+		/* Another thread has sx- or x-locked the lock, or is
+		waiting for the x-lock */
+		return(FALSE);
+	}
+
+#ifdef UNIV_SYNC_DEBUG
+	rw_lock_add_debug_info(lock, pass, RW_LOCK_SX, file_name, line);
+#endif
+	lock->last_x_file_name = file_name;
+	lock->last_x_line = (unsigned int) line;
+
+	return(TRUE);
+}
+
+/******************************************************************//**
+NOTE! Use the corresponding macro, not directly this function! Lock an
+rw-lock in shared exclusive mode for the current thread. If the rw-lock
+is sx- or x-locked, or there is an exclusive lock request waiting, the
+function spins a preset time (controlled by SYNC_SPIN_ROUNDS), waiting
+for the lock before suspending the thread. */
+UNIV_INTERN
+void
+rw_lock_sx_lock_func(
+/*=================*/
+	rw_lock_t*	lock,	/*!< in: pointer to rw-lock */
+	ulint		pass,	/*!< in: pass value; != 0, if the lock will
+				be passed to another thread to unlock */
+	const char*	file_name,/*!< in: file name where lock requested */
+	ulint		line)	/*!< in: line where requested */
+{
+	ulint		i = 0;	/*!< spin round count */
+#ifndef UNIV_FUTEX_LATCHES
+	ulint		index;	/*!< index of the reserved wait cell */
+	sync_array_t*	sync_arr;
+#endif /* !UNIV_FUTEX_LATCHES */
+	ibool		spinning = FALSE;
+	size_t		counter_index;
+	ullint		wait_start = 0;	/*!< when the first OS wait started */
+
+	/* We reuse the thread id to index into the counter, cache
+	it here for efficiency. */
+
+	counter_index = (size_t) os_thread_get_curr_id();
+
+	ut_ad(rw_lock_validate(lock));
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(!rw_lock_own(lock, RW_LOCK_SHARED));
+	ut_ad(!rw_lock_own(lock, RW_LOCK_EX));
+	ut_ad(!rw_lock_own(lock, RW_LOCK_SX));
+#endif /* UNIV_SYNC_DEBUG */
+
+lock_loop:
+
+	if (rw_lock_sx_lock_low(lock, pass, file_name, line)) {
+		rw_lock_stats.rw_x_spin_round_count.add(counter_index, i);
+		sync_wait_class_add(lock->wait_class, wait_start);
+
+		return;	/* Locking succeeded */
+	}
+
+	if (!spinning) {
+		spinning = TRUE;
+
+		rw_lock_stats.rw_x_spin_wait_count.add(counter_index, 1);
+	}
+
+	/* Spin waiting for the sx-lock or the x-lock to be released */
+	while (i < SYNC_SPIN_ROUNDS
+	       && lock->lock_word <= X_LOCK_HALF_DECR) {
+		if (srv_spin_wait_delay) {
+			ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
+		}
+
+		i++;
+	}
+
+	if (i < SYNC_SPIN_ROUNDS) {
+		goto lock_loop;
+	}
+
+	os_thread_yield();
+
+	rw_lock_stats.rw_x_spin_round_count.add(counter_index, i);
+
+#ifdef UNIV_FUTEX_LATCHES
+	ib_uint32_t	seq = os_atomic_increment(&lock->futex_event, 0);
+#else /* UNIV_FUTEX_LATCHES */
+	sync_arr = sync_array_get();
+
+	sync_array_reserve_cell(
+		sync_arr, lock, RW_LOCK_SX, file_name, line, &index);
+#endif /* UNIV_FUTEX_LATCHES */
+
+	/* Waiters must be set before checking lock_word, to ensure signal
+	is sent. This could lead to a few unnecessary wake-up signals. */
+	rw_lock_set_waiter_flag(lock);
+
+	if (rw_lock_sx_lock_low(lock, pass, file_name, line)) {
+#ifndef UNIV_FUTEX_LATCHES
+		sync_array_free_cell(sync_arr, index);
+#endif /* !UNIV_FUTEX_LATCHES */
+		sync_wait_class_add(lock->wait_class, wait_start);
+		return; /* Locking succeeded */
+	}
+
+	/* these stats may not be accurate */
+	lock->count_os_wait++;
+	rw_lock_stats.rw_x_os_wait_count.add(counter_index, 1);
+
+	if (!wait_start) {
+		wait_start = ut_time_us(NULL);
+	}
+
+#ifdef UNIV_FUTEX_LATCHES
+	os_futex_wait(&lock->futex_event, seq);
+#else /* UNIV_FUTEX_LATCHES */
+	sync_array_wait_event(sync_arr, index);
+#endif /* UNIV_FUTEX_LATCHES */
 
 	i = 0;
 	goto lock_loop;
@@ -823,7 +1058,7 @@ rw_lock_own(
 /*========*/
 	rw_lock_t*	lock,		/*!< in: rw-lock */
 	ulint		lock_type)	/*!< in: lock type: RW_LOCK_SHARED,
-					RW_LOCK_EX */
+					RW_LOCK_EX, RW_LOCK_SX */
 {
 	rw_lock_debug_t*	info;
 
@@ -863,7 +1098,7 @@ rw_lock_is_locked(
 /*==============*/
 	rw_lock_t*	lock,		/*!< in: rw-lock */
 	ulint		lock_type)	/*!< in: lock type: RW_LOCK_SHARED,
-					RW_LOCK_EX */
+					RW_LOCK_EX, RW_LOCK_SX */
 {
 	ibool	ret	= FALSE;
 
@@ -878,6 +1113,10 @@ rw_lock_is_locked(
 		if (rw_lock_get_writer(lock) == RW_LOCK_EX) {
 			ret = TRUE;
 		}
+	} else if (lock_type == RW_LOCK_SX) {
+		if (rw_lock_get_sx_lock_count(lock) > 0) {
+			ret = TRUE;
+		}
 	} else {
 		ut_error;
 	}
@@ -1005,6 +1244,8 @@ rw_lock_debug_print(
 		fputs("X-LOCK", f);
 	} else if (rwt == RW_LOCK_WAIT_EX) {
 		fputs("WAIT X-LOCK", f);
+	} else if (rwt == RW_LOCK_SX) {
+		fputs("SX-LOCK", f);
 	} else {
 		ut_error;
 	}
@@ -214,6 +214,13 @@ UNIV_INTERN ib_mutex_t mutex_list_mutex;
 UNIV_INTERN mysql_pfs_key_t	mutex_list_mutex_key;
 #endif /* UNIV_PFS_MUTEX */
 
+/** Latch classes, filled in as latches get created */
+UNIV_INTERN sync_wait_class_t	sync_wait_classes[SYNC_WAIT_N_CLASSES];
+
+/** Protects adding classes to sync_wait_classes. This is an OS mutex
+because it is needed for creating the very first InnoDB mutexes. */
+static os_fast_mutex_t		sync_wait_class_mutex;
+
 #ifdef UNIV_SYNC_DEBUG
 /** Latching order checks start when this is set TRUE */
 UNIV_INTERN ibool	sync_order_checks_on	= FALSE;
@@ -291,6 +298,10 @@ mutex_create_func(
 	mutex->cfile_name = cfile_name;
 	mutex->cline = cline;
 	mutex->count_os_wait = 0;
+	mutex->wait_class = sync_wait_class_get(cfile_name, cline);
+#ifdef UNIV_FUTEX_LATCHES
+	mutex->spin_rounds_avg = 0;
+#endif /* UNIV_FUTEX_LATCHES */
 
 	/* Check that lock_word is aligned; this is important on Intel */
 	ut_ad(((ulint)(&(mutex->lock_word))) % 4 == 0);
@@ -435,7 +446,7 @@ mutex_own(
 {
 	ut_ad(mutex_validate(mutex));
 
-	return(mutex_get_lock_word(mutex) == 1
+	return(mutex_get_lock_word(mutex) != 0
 	       && os_thread_eq(mutex->thread_id, os_thread_get_curr_id()));
 }
 #endif /* UNIV_DEBUG */
@@ -459,6 +470,92 @@ mutex_set_waiters(
 				word in memory is atomic */
 }
 
+#ifdef UNIV_FUTEX_LATCHES
+/******************************************************************//**
+Reserves a mutex for the current thread. If the mutex is reserved, the
+function spins for a while, waiting for the mutex before suspending the
+thread on the futex of the mutex. The spin is adaptive: it is at most a
+little over twice the average number of rounds it took to get the mutex
+by spinning, so that a mutex that is held for long is not spun on in
+vain. When the mutex is released, mutex_exit() wakes up a single
+waiter. */
+UNIV_INTERN
+void
+mutex_spin_wait(
+/*============*/
+	ib_mutex_t*	mutex,		/*!< in: pointer to mutex */
+	const char*	file_name,	/*!< in: file name where mutex
+					requested */
+	ulint		line)		/*!< in: line where requested */
+{
+	ulint		i;		/* spin round count */
+	ulint		max_rounds;
+	ullint		wait_start;
+	size_t		counter_index;
+
+	counter_index = (size_t) os_thread_get_curr_id();
+
+	ut_ad(mutex);
+
+	mutex_spin_wait_count.add(counter_index, 1);
+
+	max_rounds = ut_min(SYNC_SPIN_ROUNDS,
+			    2 * (ulint) mutex->spin_rounds_avg + 10);
+
+	for (i = 0; i < max_rounds; i++) {
+		if (mutex_get_lock_word(mutex) == 0
+		    && ib_mutex_test_and_set(mutex) == 0) {
+
+			break;
+		}
+
+		if (srv_spin_wait_delay) {
+			ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
+		}
+	}
+
+	mutex_spin_round_count.add(counter_index, i);
+
+	/* The average is only a hint: races on updating it do not
+	matter. */
+	mutex->spin_rounds_avg += ((lint) i - mutex->spin_rounds_avg) / 8;
+
+	if (i == max_rounds) {
+		wait_start = ut_time_us(NULL);
+
+		/* Mark the mutex as having waiters before sleeping. The
+		thread that gets it this way keeps that mark, so that the
+		remaining waiters get woken up one by one. */
+		while (os_atomic_test_and_set_uint32(
+			       &mutex->lock_word, 2) != 0) {
+
+			mutex_os_wait_count.add(counter_index, 1);
+
+			mutex->count_os_wait++;
+
+			os_futex_wait(&mutex->lock_word, 2);
+		}
+
+		sync_wait_class_add(mutex->wait_class, wait_start);
+	}
+
+	ut_d(mutex->thread_id = os_thread_get_curr_id());
+#ifdef UNIV_SYNC_DEBUG
+	mutex_set_debug_info(mutex, file_name, line);
+#endif
+}
+
+/******************************************************************//**
+Wakes up one of the threads waiting on the futex of this mutex. */
+UNIV_INTERN
+void
+mutex_signal_object(
+/*================*/
+	ib_mutex_t*	mutex)	/*!< in: mutex */
+{
+	os_futex_wake(&mutex->lock_word, 1);
+}
+#else /* UNIV_FUTEX_LATCHES */
 /******************************************************************//**
 Reserves a mutex for the current thread. If the mutex is reserved, the
 function spins a preset time (controlled by SYNC_SPIN_ROUNDS), waiting
@@ -476,6 +573,7 @@ mutex_spin_wait(
 	ulint		index;		/* index of the reserved wait cell */
 	sync_array_t*	sync_arr;
 	size_t		counter_index;
+	ullint		wait_start = 0;	/* when the first OS wait started */
 
 	counter_index = (size_t) os_thread_get_curr_id();
 
@@ -520,6 +618,7 @@ spin_loop:
 #ifdef UNIV_SYNC_DEBUG
 		mutex_set_debug_info(mutex, file_name, line);
 #endif
+		sync_wait_class_add(mutex->wait_class, wait_start);
 		return;
 	}
 
@@ -560,6 +659,7 @@ spin_loop:
 #ifdef UNIV_SYNC_DEBUG
 			mutex_set_debug_info(mutex, file_name, line);
 #endif
+			sync_wait_class_add(mutex->wait_class, wait_start);
 
 			return;
 
@@ -577,6 +677,10 @@ spin_loop:
 
 	mutex->count_os_wait++;
 
+	if (!wait_start) {
+		wait_start = ut_time_us(NULL);
+	}
+
 	sync_array_wait_event(sync_arr, index);
 
 	goto mutex_loop;
@@ -597,6 +701,7 @@ mutex_signal_object(
 	os_event_set2(&mutex->event);
 	sync_array_object_signalled();
 }
+#endif /* UNIV_FUTEX_LATCHES */
 
 #ifdef UNIV_SYNC_DEBUG
 /******************************************************************//**
@@ -1441,6 +1546,10 @@ sync_init(void)
 {
 	ut_a(sync_initialized == FALSE);
 
+	/* The mutexes created below already have a wait class */
+	memset(sync_wait_classes, 0, sizeof sync_wait_classes);
+	os_fast_mutex_init(PFS_NOT_INSTRUMENTED, &sync_wait_class_mutex);
+
 	sync_initialized = TRUE;
 
 	sync_array_init(OS_THREAD_MAX_N);
@@ -1546,9 +1655,97 @@ sync_close(void)
 	sync_thread_level_arrays_free();
 #endif /* UNIV_SYNC_DEBUG */
 
+	os_fast_mutex_free(&sync_wait_class_mutex);
+
 	sync_initialized = FALSE;
 }
 
+/*******************************************************************//**
+Looks up the wait class of latches created at a place in the source and
+creates it if it does not exist yet.
+@return wait class, NULL if there are too many classes */
+UNIV_INTERN
+sync_wait_class_t*
+sync_wait_class_get(
+/*================*/
+	const char*	cfile_name,	/*!< in: file name where created */
+	ulint		cline)		/*!< in: line where created */
+{
+	sync_wait_class_t*	wait_class = NULL;
+	ulint			i;
+
+	if (!sync_initialized) {
+		return(NULL);
+	}
+
+	/* The same header may be compiled into several translation
+	units, so compare the file names and not their addresses */
+	i = ut_fold_ulint_pair(ut_fold_string(cfile_name), cline)
+		% SYNC_WAIT_N_CLASSES;
+
+	os_fast_mutex_lock(&sync_wait_class_mutex);
+
+	for (ulint n = 0; n < SYNC_WAIT_N_CLASSES; n++) {
+		sync_wait_class_t*	slot = &sync_wait_classes[i];
+
+		if (slot->cfile_name == NULL) {
+			slot->cline = cline;
+			slot->cfile_name = cfile_name;
+			wait_class = slot;
+			break;
+		}
+
+		if (slot->cline == cline
+		    && !strcmp(slot->cfile_name, cfile_name)) {
+			wait_class = slot;
+			break;
+		}
+
+		i = (i + 1) % SYNC_WAIT_N_CLASSES;
+	}
+
+	os_fast_mutex_unlock(&sync_wait_class_mutex);
+
+	return(wait_class);
+}
+
+/*******************************************************************//**
+Counts a latch wait in the histogram of its wait class. */
+UNIV_INTERN
+void
+sync_wait_class_add(
+/*================*/
+	sync_wait_class_t*	wait_class,	/*!< in/out: wait class of
+						the latch, or NULL */
+	ullint			start_time)	/*!< in: ut_time_us() when
+						the wait started, 0 if
+						there was no wait */
+{
+	ullint	now;
+	ullint	wait_time;
+	ulint	bucket;
+
+	if (wait_class == NULL || start_time == 0) {
+		return;
+	}
+
+	now = ut_time_us(NULL);
+	wait_time = now > start_time ? now - start_time : 0;
+
+	for (bucket = 0;
+	     wait_time != 0 && bucket < SYNC_WAIT_HIST_N_BUCKETS - 1;
+	     bucket++) {
+		wait_time >>= 1;
+	}
+
+#ifdef HAVE_ATOMIC_BUILTINS_64
+	os_atomic_increment_uint64(&wait_class->n_waits[bucket], 1);
+#else
+	/* Not exact, but good enough for monitoring */
+	wait_class->n_waits[bucket]++;
+#endif /* HAVE_ATOMIC_BUILTINS_64 */
+}
+
 /*******************************************************************//**
 Prints wait info of the sync system. */
 UNIV_INTERN
@@ -664,6 +664,7 @@ trx_resurrect_table_locks(
 	page_t*			undo_page;
 	trx_undo_rec_t*		undo_rec;
 	table_id_set		tables;
+	table_id_set		emptied;
 
 	ut_ad(undo == trx->insert_undo || undo == trx->update_undo);
 
@@ -707,6 +708,11 @@ trx_resurrect_table_locks(
 			&updated_extern, &undo_no, &table_id);
 		tables.insert(table_id);
 
+		if (type == TRX_UNDO_EMPTY) {
+			/* The rollback will empty the table. */
+			emptied.insert(table_id);
+		}
+
 		undo_rec = trx_undo_get_prev_rec(
 			undo_rec, undo->hdr_page_no,
 			undo->hdr_offset, false, &mtr);
@@ -727,12 +733,15 @@ trx_resurrect_table_locks(
 				continue;
 			}
 
-			lock_table_ix_resurrect(table, trx);
+			bool	x = emptied.count(*i) > 0;
+
+			lock_table_resurrect(table, trx,
+					     x ? LOCK_X : LOCK_IX);
 
 			DBUG_PRINT("ib_trx",
 				   ("resurrect" TRX_ID_FMT
-				    "  table '%s' IX lock from %s undo",
-				    trx->id, table->name,
+				    "  table '%s' %s lock from %s undo",
+				    trx->id, table->name, x ? "X" : "IX",
 				    undo == trx->insert_undo
 				    ? "insert" : "update"));
 
@@ -0,0 +1,267 @@
+/* Copyright (c) 2013, Facebook, Inc. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/**
+   Micro-benchmark and unit test of the InnoDB mutexes and rw-locks.
+
+   Several threads increment counters protected by a single mutex or
+   rw-lock, the test checks the totals and prints the throughput, so that
+   the sync array latches and the futex latches (WITH_INNODB_FUTEX_LATCHES)
+   can be compared on the same machine. The number of threads and
+   iterations can be changed with the LATCH_BENCH_THREADS and
+   LATCH_BENCH_LOOPS environment variables.
+*/
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+
+#include "univ.i"
+#include "os0sync.h"
+#include "os0thread.h"
+#include "srv0srv.h"
+#include "sync0rw.h"
+#include "sync0sync.h"
+#include "ut0ut.h"
+
+#include "thread_utils.h"
+
+namespace innodb_sync_unittest {
+
+using thread::Thread;
+
+#ifdef UNIV_PFS_MUTEX
+static mysql_pfs_key_t	test_mutex_key = PFS_NOT_INSTRUMENTED;
+#endif /* UNIV_PFS_MUTEX */
+#ifdef UNIV_PFS_RWLOCK
+static mysql_pfs_key_t	test_rw_lock_key = PFS_NOT_INSTRUMENTED;
+#endif /* UNIV_PFS_RWLOCK */
+
+static ulint get_env(const char *name, ulint default_value)
+{
+  const char *value= getenv(name);
+  return value ? strtoul(value, NULL, 10) : default_value;
+}
+
+class SyncTest : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    srv_max_n_threads= 1000;
+    os_sync_init();
+    sync_init();
+  }
+
+  static void TearDownTestCase()
+  {
+    sync_close();
+    os_sync_free();
+  }
+
+  virtual void SetUp()
+  {
+    m_n_threads= get_env("LATCH_BENCH_THREADS", 8);
+    m_n_loops= get_env("LATCH_BENCH_LOOPS", 100000);
+    m_counter= 0;
+    m_other= 0;
+  }
+
+  /** Runs m_n_threads threads and prints the lock operations per second */
+  template <class T> void run_threads(const char *what)
+  {
+    T **threads= new T*[m_n_threads];
+    ullint start= ut_time_us(NULL);
+
+    for (ulint i= 0; i < m_n_threads; i++)
+    {
+      threads[i]= new T(this, i);
+      threads[i]->start();
+    }
+    for (ulint i= 0; i < m_n_threads; i++)
+    {
+      threads[i]->join();
+      delete threads[i];
+    }
+    delete[] threads;
+
+    ullint elapsed= ut_time_us(NULL) - start;
+    printf("# %s: %lu threads, %.0f locks/s\n", what, (ulong) m_n_threads,
+           elapsed ? 1e6 * m_n_threads * m_n_loops / elapsed : 0.0);
+  }
+
+public:
+  ulint m_n_threads;
+  ulint m_n_loops;
+  ib_mutex_t m_mutex;
+  rw_lock_t m_rw_lock;
+  /** Counters that the latches protect; never updated atomically */
+  volatile ulint m_counter;
+  volatile ulint m_other;
+};
+
+class MutexThread : public Thread
+{
+public:
+  MutexThread(SyncTest *test, ulint) : m_test(test) {}
+
+  virtual void run()
+  {
+    for (ulint i= 0; i < m_test->m_n_loops; i++)
+    {
+      mutex_enter(&m_test->m_mutex);
+      m_test->m_counter++;
+      m_test->m_other++;
+      mutex_exit(&m_test->m_mutex);
+    }
+  }
+
+private:
+  SyncTest *m_test;
+};
+
+/** Takes one lock in ten in x mode, one in sx mode and the others in s mode */
+class RwLockThread : public Thread
+{
+public:
+  RwLockThread(SyncTest *test, ulint id) : m_test(test), m_id(id) {}
+
+  virtual void run()
+  {
+    for (ulint i= 0; i < m_test->m_n_loops; i++)
+    {
+      if ((i + m_id) % 10 == 0)
+      {
+        rw_lock_x_lock(&m_test->m_rw_lock);
+        m_test->m_counter++;
+        m_test->m_other++;
+        rw_lock_x_unlock(&m_test->m_rw_lock);
+      }
+      else if ((i + m_id) % 10 == 5)
+      {
+        rw_lock_sx_lock(&m_test->m_rw_lock);
+        m_test->m_counter++;
+        m_test->m_other++;
+        rw_lock_sx_unlock(&m_test->m_rw_lock);
+      }
+      else
+      {
+        rw_lock_s_lock(&m_test->m_rw_lock);
+        /* Readers must never see a half done update */
+        ulint counter= m_test->m_counter;
+        ulint other= m_test->m_other;
+        rw_lock_s_unlock(&m_test->m_rw_lock);
+        if (counter > other)
+          ADD_FAILURE() << counter << " > " << other;
+      }
+    }
+  }
+
+private:
+  SyncTest *m_test;
+  ulint m_id;
+};
+
+TEST_F(SyncTest, MutexThroughput)
+{
+  mutex_create(test_mutex_key, &m_mutex, SYNC_NO_ORDER_CHECK);
+  run_threads<MutexThread>("mutex");
+  EXPECT_EQ(m_n_threads * m_n_loops, m_counter);
+  EXPECT_EQ(m_counter, m_other);
+  mutex_free(&m_mutex);
+}
+
+TEST_F(SyncTest, RwLockThroughput)
+{
+  rw_lock_create(test_rw_lock_key, &m_rw_lock, SYNC_NO_ORDER_CHECK);
+  run_threads<RwLockThread>("rw_lock");
+
+  /* Each thread takes one x-lock and one sx-lock in every ten */
+  ulint expected= 0;
+  for (ulint id= 0; id < m_n_threads; id++)
+    for (ulint i= 0; i < m_n_loops; i++)
+      if ((i + id) % 10 == 0 || (i + id) % 10 == 5)
+        expected++;
+  EXPECT_EQ(expected, m_counter);
+  EXPECT_EQ(m_counter, m_other);
+  rw_lock_free(&m_rw_lock);
+}
+
+/** Holds the mutex of the test for a while */
+class MutexHolder : public Thread
+{
+public:
+  MutexHolder(SyncTest *test) : m_test(test) {}
+
+  virtual void run()
+  {
+    mutex_enter(&m_test->m_mutex);
+    m_locked.notify();
+    os_thread_sleep(200000);
+    mutex_exit(&m_test->m_mutex);
+  }
+
+  thread::Notification m_locked;
+
+private:
+  SyncTest *m_test;
+};
+
+TEST_F(SyncTest, WaitHistogram)
+{
+  ib_mutex_t other;
+  ib_mutex_t *mutexes[2]= { &m_mutex, &other };
+  const ulint create_line= __LINE__ + 2;
+  for (int i= 0; i < 2; i++)
+    mutex_create(test_mutex_key, mutexes[i], SYNC_NO_ORDER_CHECK);
+
+  /* The mutexes created at the same place share their wait class */
+  sync_wait_class_t *wait_class= m_mutex.wait_class;
+  ASSERT_TRUE(wait_class != NULL);
+  EXPECT_EQ(wait_class, other.wait_class);
+  EXPECT_EQ(create_line, wait_class->cline);
+  EXPECT_STREQ(__FILE__, wait_class->cfile_name);
+
+  ib_uint64_t before[SYNC_WAIT_HIST_N_BUCKETS];
+  memcpy(before, wait_class->n_waits, sizeof before);
+
+  /* Block on a mutex that another thread holds for 0.2 seconds */
+  MutexHolder holder(this);
+  holder.start();
+  holder.m_locked.wait_for_notification();
+  mutex_enter(&m_mutex);
+  mutex_exit(&m_mutex);
+  holder.join();
+
+  ulint n_waits= 0;
+  ulint n_long_waits= 0;
+  for (ulint b= 0; b < SYNC_WAIT_HIST_N_BUCKETS; b++)
+  {
+    ulint n= (ulint) (wait_class->n_waits[b] - before[b]);
+    n_waits+= n;
+    /* Bucket 17 and up: at least 2^16 microseconds */
+    if (b > 16)
+      n_long_waits+= n;
+  }
+  EXPECT_EQ(1U, n_waits);
+  EXPECT_EQ(1U, n_long_waits);
+
+  mutex_free(&other);
+  mutex_free(&m_mutex);
+}
+
+}
@@ -0,0 +1,471 @@
+/* Copyright (c) 2013, Facebook, Inc. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include <gtest/gtest.h>
+
+#include "test_utils.h"
+
+#include "rpl_gtid.h"
+
+#include <vector>
+
+namespace rpl_gtid_set_unittest {
+
+using my_testing::Server_initializer;
+
+/*
+  The Gtid_set tests compare the results of the set operations with a
+  bitmap of GNOs per SIDNO.  The benchmarks at the end compare Gtid_set
+  with List_gtid_set, the previous representation of a Gtid_set, on
+  sets like the gtid_executed of a server that has seen many failovers:
+  hundreds of SIDs with a few intervals each.
+*/
+
+typedef std::vector<bool> Gno_bitmap;
+
+class GtidSetTest : public ::testing::Test
+{
+protected:
+  // Number of SIDs in the sets.
+  static const int num_sids= 8;
+  // GNOs of the random sets are below this.
+  static const int max_gno= 200;
+  // Do each benchmark this many times. Increase value for benchmarking!
+  static const int num_iterations= 1;
+  // Number of SIDs in the benchmarked sets.
+  static const int bench_sids= 500;
+
+  GtidSetTest() : sid_map(NULL) {}
+
+  virtual void SetUp()
+  {
+    initializer.SetUp();
+    srand(42);
+    for (int i= 0; i < bench_sids; i++)
+    {
+      char text[rpl_sid::TEXT_LENGTH + 1];
+      rpl_sid sid;
+      my_snprintf(text, sizeof(text), "%08x-1111-2222-3333-444444444444",
+                  (bench_sids - i) * 7919);
+      ASSERT_EQ(RETURN_STATUS_OK, sid.parse(text));
+      sidnos[i]= sid_map.add_sid(sid);
+      ASSERT_LT(0, sidnos[i]);
+    }
+  }
+  virtual void TearDown() { initializer.TearDown(); }
+
+  // Fill a bitmap per SIDNO with random runs of GNOs.
+  void random_bitmaps(std::vector<Gno_bitmap> *bitmaps)
+  {
+    bitmaps->assign(num_sids, Gno_bitmap(max_gno, false));
+    for (int i= 0; i < num_sids; i++)
+    {
+      bool in_set= rand() % 2;
+      for (int gno= 1; gno < max_gno; gno++)
+      {
+        if (rand() % 8 == 0)
+          in_set= !in_set;
+        (*bitmaps)[i][gno]= in_set;
+      }
+    }
+  }
+
+  // Add the GNOs of the bitmaps to a Gtid_set in random order.
+  void add_bitmaps(Gtid_set *gs, const std::vector<Gno_bitmap> &bitmaps)
+  {
+    std::vector<Gtid> gtids;
+    for (int i= 0; i < num_sids; i++)
+      for (int gno= 1; gno < max_gno; gno++)
+        if (bitmaps[i][gno])
+        {
+          Gtid gtid= { sidnos[i], gno };
+          gtids.push_back(gtid);
+        }
+    std::random_shuffle(gtids.begin(), gtids.end());
+    for (size_t i= 0; i < gtids.size(); i++)
+    {
+      ASSERT_EQ(RETURN_STATUS_OK, gs->ensure_sidno(gtids[i].sidno));
+      ASSERT_EQ(RETURN_STATUS_OK, gs->_add_gtid(gtids[i]));
+    }
+  }
+
+  // Check that a Gtid_set has the GNOs of the bitmaps, as minimal intervals.
+  void check_set(const Gtid_set *gs, const std::vector<Gno_bitmap> &bitmaps)
+  {
+    for (int i= 0; i < num_sids; i++)
+    {
+      rpl_sidno sidno= sidnos[i];
+      int gno= 1;
+      if (sidno <= gs->get_max_sidno())
+      {
+        Gtid_set::Const_interval_iterator ivit(gs, sidno);
+        const Gtid_set::Interval *iv;
+        rpl_gno prev_end= 0;
+        while ((iv= ivit.get()) != NULL)
+        {
+          EXPECT_LT(prev_end, iv->start) << "adjacent intervals";
+          for (; gno < iv->start; gno++)
+            EXPECT_FALSE(bitmaps[i][gno]) << "sidno " << sidno << " gno " << gno;
+          for (; gno < iv->end; gno++)
+          {
+            EXPECT_TRUE(bitmaps[i][gno]) << "sidno " << sidno << " gno " << gno;
+            EXPECT_TRUE(gs->contains_gtid(sidno, gno));
+          }
+          prev_end= iv->end;
+          ivit.next();
+        }
+      }
+      for (; gno < max_gno; gno++)
+      {
+        EXPECT_FALSE(bitmaps[i][gno]) << "sidno " << sidno << " gno " << gno;
+        EXPECT_EQ(bitmaps[i][gno], gs->contains_gtid(sidno, gno));
+      }
+    }
+  }
+
+  // A set like a gtid_executed: a few intervals for each of n_sids SIDs.
+  void bench_set(Gtid_set *gs, int n_sids, int offset)
+  {
+    for (int i= 0; i < n_sids; i++)
+    {
+      rpl_sidno sidno= sidnos[i];
+      ASSERT_EQ(RETURN_STATUS_OK, gs->ensure_sidno(sidno));
+      int n_intervals= 1 + (i + offset) % 4;
+      for (int j= 0; j < n_intervals; j++)
+      {
+        rpl_gno start= 1 + j * 1000 + offset;
+        for (rpl_gno gno= start; gno < start + 100; gno++)
+          ASSERT_EQ(RETURN_STATUS_OK, gs->_add_gtid(sidno, gno));
+      }
+    }
+  }
+
+  Server_initializer initializer;
+  Sid_map sid_map;
+  rpl_sidno sidnos[bench_sids];
+};
+
+
+TEST_F(GtidSetTest, AddRemoveGtids)
+{
+  std::vector<Gno_bitmap> bitmaps;
+  random_bitmaps(&bitmaps);
+  Gtid_set gs(&sid_map);
+  add_bitmaps(&gs, bitmaps);
+  check_set(&gs, bitmaps);
+
+  // Remove random GTIDs and intervals.
+  for (int k= 0; k < 500; k++)
+  {
+    int i= rand() % num_sids;
+    rpl_gno start= 1 + rand() % (max_gno - 1);
+    rpl_gno end= std::min<rpl_gno>(max_gno, start + 1 + rand() % 5);
+    for (rpl_gno gno= start; gno < end; gno++)
+    {
+      bitmaps[i][gno]= false;
+      EXPECT_EQ(RETURN_STATUS_OK, gs._remove_gtid(sidnos[i], gno));
+    }
+  }
+  check_set(&gs, bitmaps);
+
+  gs.clear();
+  EXPECT_TRUE(gs.is_empty());
+}
+
+
+TEST_F(GtidSetTest, SetAlgebra)
+{
+  for (int round= 0; round < 20; round++)
+  {
+    std::vector<Gno_bitmap> bitmaps1, bitmaps2;
+    random_bitmaps(&bitmaps1);
+    random_bitmaps(&bitmaps2);
+    Gtid_set gs1(&sid_map), gs2(&sid_map);
+    add_bitmaps(&gs1, bitmaps1);
+    add_bitmaps(&gs2, bitmaps2);
+
+    std::vector<Gno_bitmap> bitmaps_union= bitmaps1;
+    std::vector<Gno_bitmap> bitmaps_minus= bitmaps1;
+    std::vector<Gno_bitmap> bitmaps_and= bitmaps1;
+    bool subset= true, intersects= false;
+    for (int i= 0; i < num_sids; i++)
+      for (int gno= 1; gno < max_gno; gno++)
+      {
+        bitmaps_union[i][gno]= bitmaps1[i][gno] || bitmaps2[i][gno];
+        bitmaps_minus[i][gno]= bitmaps1[i][gno] && !bitmaps2[i][gno];
+        bitmaps_and[i][gno]= bitmaps1[i][gno] && bitmaps2[i][gno];
+        if (bitmaps_minus[i][gno])
+          subset= false;
+        if (bitmaps_and[i][gno])
+          intersects= true;
+      }
+
+    Gtid_set gs_union(&sid_map), gs_minus(&sid_map), gs_and(&sid_map);
+    EXPECT_EQ(RETURN_STATUS_OK, gs_union.add_gtid_set(&gs1));
+    EXPECT_EQ(RETURN_STATUS_OK, gs_union.add_gtid_set(&gs2));
+    check_set(&gs_union, bitmaps_union);
+    EXPECT_EQ(RETURN_STATUS_OK, gs_minus.add_gtid_set(&gs1));
+    EXPECT_EQ(RETURN_STATUS_OK, gs_minus.remove_gtid_set(&gs2));
+    check_set(&gs_minus, bitmaps_minus);
+    EXPECT_EQ(RETURN_STATUS_OK, gs1.intersection(&gs2, &gs_and));
+    check_set(&gs_and, bitmaps_and);
+
+    EXPECT_EQ(subset, gs1.is_subset(&gs2));
+    EXPECT_TRUE(gs1.is_subset(&gs_union));
+    EXPECT_TRUE(gs_and.is_subset(&gs2));
+    EXPECT_EQ(intersects, gs1.is_intersection_nonempty(&gs2));
+    EXPECT_FALSE(gs_minus.is_intersection_nonempty(&gs2));
+  }
+}
+
+
+TEST_F(GtidSetTest, Text)
+{
+  char *text;
+  Gtid_set gs(&sid_map);
+  EXPECT_EQ(RETURN_STATUS_OK,
+            gs.add_gtid_text("00001ef0-1111-2222-3333-444444444444:7:1-3:5,"
+                             "00001ef0-1111-2222-3333-444444444444:4:10-12"));
+  text= gs.to_string();
+  EXPECT_STREQ("00001ef0-1111-2222-3333-444444444444:1-5:7:10-12", text);
+  EXPECT_EQ((int) strlen(text), gs.get_string_length());
+  my_free(text);
+}
+
+
+TEST_F(GtidSetTest, Encoding)
+{
+  std::vector<Gno_bitmap> bitmaps;
+  random_bitmaps(&bitmaps);
+  Gtid_set gs(&sid_map);
+  add_bitmaps(&gs, bitmaps);
+
+  uint length;
+  uchar *buf= gs.encode(&length);
+  ASSERT_TRUE(buf != NULL);
+  Gtid_set decoded(&sid_map);
+  EXPECT_EQ(RETURN_STATUS_OK, decoded.add_gtid_encoding(buf, length));
+  check_set(&decoded, bitmaps);
+  my_free(buf);
+
+  size_t compact_length= gs.get_compact_encoded_length();
+  EXPECT_GT((size_t) length, compact_length);
+  std::vector<uchar> compact(compact_length);
+  gs.encode_compact(&compact[0]);
+  Gtid_set compact_decoded(&sid_map);
+  size_t actual_length;
+  EXPECT_EQ(RETURN_STATUS_OK,
+            compact_decoded.add_gtid_compact_encoding(&compact[0],
+                                                      compact_length,
+                                                      &actual_length));
+  EXPECT_EQ(compact_length, actual_length);
+  check_set(&compact_decoded, bitmaps);
+
+  // A truncated encoding is an error.
+  Gtid_set truncated(&sid_map);
+  initializer.set_expected_error(ER_MALFORMED_GTID_SET_ENCODING);
+  EXPECT_NE(RETURN_STATUS_OK,
+            truncated.add_gtid_compact_encoding(&compact[0],
+                                                compact_length - 1));
+}
+
+
+/*
+  The previous representation of Gtid_set: a linked list of intervals
+  per SIDNO, allocated in chunks and recycled through a free list.  Only
+  the operations that are benchmarked are implemented.
+*/
+class List_gtid_set
+{
+public:
+  List_gtid_set() : free_intervals(NULL) {}
+  ~List_gtid_set()
+  {
+    for (size_t i= 0; i < chunks.size(); i++)
+      delete [] chunks[i];
+  }
+
+  void add_gtid(rpl_sidno sidno, rpl_gno gno)
+  {
+    Interval **p= head(sidno);
+    add_interval(&p, gno, gno + 1);
+  }
+
+  void add_gtid_set(const List_gtid_set *other)
+  {
+    for (size_t i= 0; i < other->heads.size(); i++)
+    {
+      Interval **p= head(i + 1);
+      for (Interval *iv= other->heads[i]; iv != NULL; iv= iv->next)
+        add_interval(&p, iv->start, iv->end);
+    }
+  }
+
+  bool is_subset(const List_gtid_set *super) const
+  {
+    for (size_t i= 0; i < heads.size(); i++)
+    {
+      Interval *super_iv= i < super->heads.size() ? super->heads[i] : NULL;
+      for (Interval *iv= heads[i]; iv != NULL; iv= iv->next)
+      {
+        while (super_iv != NULL && iv->start > super_iv->end)
+          super_iv= super_iv->next;
+        if (super_iv == NULL ||
+            iv->start < super_iv->start || iv->end > super_iv->end)
+          return false;
+      }
+    }
+    return true;
+  }
+
+  void clear()
+  {
+    for (size_t i= 0; i < heads.size(); i++)
+      while (heads[i] != NULL)
+      {
+        Interval *next= heads[i]->next;
+        put_free(heads[i]);
+        heads[i]= next;
+      }
+  }
+
+private:
+  struct Interval
+  {
+    rpl_gno start;
+    rpl_gno end;
+    Interval *next;
+  };
+
+  Interval **head(rpl_sidno sidno)
+  {
+    if (heads.size() < (size_t) sidno)
+      heads.resize(sidno, NULL);
+    return &heads[sidno - 1];
+  }
+
+  Interval *get_free()
+  {
+    if (free_intervals == NULL)
+    {
+      Interval *chunk= new Interval[8];
+      chunks.push_back(chunk);
+      for (int i= 0; i < 8; i++)
+        put_free(&chunk[i]);
+    }
+    Interval *iv= free_intervals;
+    free_intervals= iv->next;
+    return iv;
+  }
+
+  void put_free(Interval *iv)
+  {
+    iv->next= free_intervals;
+    free_intervals= iv;
+  }
+
+  // The algorithm of the previous Gtid_set::add_gno_interval.
+  void add_interval(Interval ***pp, rpl_gno start, rpl_gno end)
+  {
+    Interval **p= *pp;
+    Interval *iv;
+    while ((iv= *p) != NULL)
+    {
+      if (iv->end >= start)
+      {
+        if (iv->start > end)
+          break;
+        if (iv->start < start)
+          start= iv->start;
+        while (iv->next && end >= iv->next->start)
+        {
+          *p= iv->next;
+          put_free(iv);
+          iv= *p;
+        }
+        iv->start= start;
+        if (iv->end < end)
+          iv->end= end;
+        *pp= p;
+        return;
+      }
+      p= &iv->next;
+    }
+    Interval *new_iv= get_free();
+    new_iv->start= start;
+    new_iv->end= end;
+    new_iv->next= *p;
+    *p= new_iv;
+    *pp= p;
+  }
+
+  std::vector<Interval *> heads;
+  std::vector<Interval *> chunks;
+  Interval *free_intervals;
+};
+
+
+TEST_F(GtidSetTest, BenchAddGtidSet)
+{
+  Gtid_set gs1(&sid_map), gs2(&sid_map), gs(&sid_map);
+  bench_set(&gs1, bench_sids, 0);
+  bench_set(&gs2, bench_sids, 50);
+  for (int i= 0; i < num_iterations * 100; i++)
+  {
+    gs.clear();
+    EXPECT_EQ(RETURN_STATUS_OK, gs.add_gtid_set(&gs1));
+    EXPECT_EQ(RETURN_STATUS_OK, gs.add_gtid_set(&gs2));
+    EXPECT_TRUE(gs1.is_subset(&gs));
+  }
+}
+
+
+TEST_F(GtidSetTest, BenchAddGtidSetList)
+{
+  List_gtid_set gs1, gs2, gs;
+  for (int i= 0; i < bench_sids; i++)
+    for (int j= 0; j < 1 + i % 4; j++)
+      for (rpl_gno gno= 1 + j * 1000; gno < 1 + j * 1000 + 100; gno++)
+        gs1.add_gtid(sidnos[i], gno);
+  for (int i= 0; i < bench_sids; i++)
+    for (int j= 0; j < 1 + (i + 50) % 4; j++)
+      for (rpl_gno gno= 51 + j * 1000; gno < 51 + j * 1000 + 100; gno++)
+        gs2.add_gtid(sidnos[i], gno);
+  for (int i= 0; i < num_iterations * 100; i++)
+  {
+    gs.clear();
+    gs.add_gtid_set(&gs1);
+    gs.add_gtid_set(&gs2);
+    EXPECT_TRUE(gs1.is_subset(&gs));
+  }
+}
+
+
+TEST_F(GtidSetTest, BenchToString)
+{
+  Gtid_set gs(&sid_map);
+  bench_set(&gs, bench_sids, 0);
+  for (int i= 0; i < num_iterations * 100; i++)
+  {
+    char *text= gs.to_string();
+    Gtid_set parsed(&sid_map);
+    EXPECT_EQ(RETURN_STATUS_OK, parsed.add_gtid_text(text));
+    my_free(text);
+  }
+}
+
+}